@@ -0,0 +1,26 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#ifndef _az_DEFLATE_H
+#define _az_DEFLATE_H
+
+#include <stdint.h>
+
+#include <azure/core/_az_cfg_prefix.h>
+
+enum
+{
+  _az_DEFLATE_HASH_SIZE = 1 << 12, // Number of sequences of 3 bytes the encoder remembers.
+};
+
+typedef struct
+{
+  struct
+  {
+    int32_t head[_az_DEFLATE_HASH_SIZE]; // Last position of each hash of 3 bytes, -1 if none.
+  } _internal;
+} _az_deflate_encoder;
+
+#include <azure/core/_az_cfg_suffix.h>
+
+#endif // _az_DEFLATE_H
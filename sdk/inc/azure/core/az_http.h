@@ -20,6 +20,8 @@
 #include <azure/core/az_context.h>
 #include <azure/core/az_result.h>
 #include <azure/core/az_span.h>
+#include <azure/core/_az_deflate.h>
+#include <azure/core/_az_spinlock.h>
 
 #include <stdbool.h>
 #include <stdint.h>
@@ -108,12 +110,140 @@ typedef enum
   AZ_HTTP_STATUS_CODE_END_OF_LIST = -1,
 } az_http_status_code;
 
+/**
+ * @brief A retry budget, shared by all the requests whose retry policy options point to it.
+ *
+ * @details The budget is a token bucket. Each retry spends one token, and each request that gets a
+ * response that isn't retried earns a tenth of a token back, up to the size of the bucket. Once the
+ * bucket is empty, failed requests are no longer retried: retries are limited to about one for ten
+ * successful requests, so that they don't add to the load of a service that is already failing.
+ *
+ * Initialize it with #az_http_policy_retry_budget_init. It is thread-safe.
+ */
+typedef struct
+{
+  struct
+  {
+    _az_spinlock lock;
+    int32_t tokens; // In tenths of a token.
+    int32_t max_tokens; // In tenths of a token.
+  } _internal;
+} az_http_policy_retry_budget;
+
+/**
+ * @brief Initializes an #az_http_policy_retry_budget.
+ *
+ * @param[out] out_budget The budget to initialize. It starts full.
+ * @param[in] max_tokens The size of the bucket, the number of retries that can be made in a burst.
+ * Must be positive.
+ */
+void az_http_policy_retry_budget_init(az_http_policy_retry_budget* out_budget, int32_t max_tokens);
+
+enum
+{
+  // Longest host (and port) the policies keeping a state per host track: a domain name of 253
+  // bytes, and a port.
+  _az_HTTP_POLICY_HOST_MAX_SIZE = 260,
+  _az_HTTP_POLICY_RETRY_CIRCUIT_BREAKER_HOSTS = 8, // Number of hosts a circuit breaker tracks.
+};
+
+typedef struct
+{
+  uint8_t host[_az_HTTP_POLICY_HOST_MAX_SIZE];
+  int32_t host_size;
+  uint32_t host_hash; // 0 when the slot is unused.
+  int32_t failures; // Consecutive failed attempts.
+  int64_t open_until_msec; // 0 while the circuit is closed.
+} _az_http_policy_retry_circuit;
+
+/**
+ * @brief A circuit breaker, shared by all the requests whose retry policy options point to it.
+ *
+ * @details The breaker counts the consecutive failed attempts of requests to each host: the
+ * transport couldn't reach the host or the attempt timed out, or the response status code is
+ * retriable. Requests that fail on the side of the client (e.g. #AZ_ERROR_HTTP_RESPONSE_OVERFLOW,
+ * or a credential failing to get a token) or are canceled aren't counted, as they say nothing
+ * about the host. Once the failed attempts reach the failure threshold, the circuit of the host
+ * opens: requests to it fail fast with #AZ_ERROR_HTTP_CIRCUIT_OPEN, and the ones being retried
+ * stop, for the open duration. After that, a single request is let through as a probe. If it
+ * succeeds, the circuit closes, otherwise it opens again.
+ *
+ * A breaker tracks up to #_az_HTTP_POLICY_RETRY_CIRCUIT_BREAKER_HOSTS hosts, the requests to other
+ * hosts, or to hosts longer than #_az_HTTP_POLICY_HOST_MAX_SIZE bytes, go through. Initialize it
+ * with #az_http_policy_retry_circuit_breaker_init. It is thread-safe.
+ */
+typedef struct
+{
+  struct
+  {
+    _az_spinlock lock;
+    int32_t failure_threshold;
+    int32_t open_msec;
+    _az_http_policy_retry_circuit circuits[_az_HTTP_POLICY_RETRY_CIRCUIT_BREAKER_HOSTS];
+  } _internal;
+} az_http_policy_retry_circuit_breaker;
+
+/**
+ * @brief Initializes an #az_http_policy_retry_circuit_breaker.
+ *
+ * @param[out] out_circuit_breaker The circuit breaker to initialize. All circuits start closed.
+ * @param[in] failure_threshold Number of consecutive failed attempts that opens the circuit of a
+ * host. Must be positive.
+ * @param[in] open_msec Time in milliseconds a circuit stays open before a probe is let through.
+ * Must be positive.
+ */
+void az_http_policy_retry_circuit_breaker_init(
+    az_http_policy_retry_circuit_breaker* out_circuit_breaker,
+    int32_t failure_threshold,
+    int32_t open_msec);
+
+/**
+ * @brief A client-side rate limiter, shared by all the requests whose retry policy options point
+ * to it, that learns the rate a service admits and paces the requests to stay under it.
+ *
+ * @details The limiter doesn't pace anything until a response is throttled (HTTP 429 or 503).
+ * Then it sets its rate to 70% of the rate requests were being sent at, and each request that isn't
+ * throttled raises it again by about one request per second, every second (additive increase,
+ * multiplicative decrease). Every attempt, including retries, waits for its turn: synchronous
+ * requests sleep, asynchronous ones are held by the transport. If a throttled response says when
+ * to retry (`Retry-After`, `retry-after-ms` or `x-ms-retry-after-ms`), no request is sent before
+ * then.
+ *
+ * Initialize it with #az_http_policy_rate_limiter_init. It is thread-safe.
+ */
+typedef struct
+{
+  struct
+  {
+    _az_spinlock lock;
+    int64_t rate; // In thousandths of requests per second, 0 until a response is throttled.
+    int64_t next_send_usec; // Earliest time the next request can be sent at that rate.
+    int64_t blocked_until_msec; // Earliest time any request can be sent, from Retry-After.
+    int64_t last_decrease_msec;
+    int64_t window_start_msec; // Start of the window the sent requests are counted in.
+    int32_t window_sends;
+    int64_t window_rate; // Rate of the previous window, in thousandths of requests per second.
+  } _internal;
+} az_http_policy_rate_limiter;
+
+/**
+ * @brief Initializes an #az_http_policy_rate_limiter.
+ *
+ * @param[out] out_rate_limiter The rate limiter to initialize. It doesn't limit the rate until a
+ * response is throttled.
+ */
+void az_http_policy_rate_limiter_init(az_http_policy_rate_limiter* out_rate_limiter);
+
 /**
  * @brief Allows you to customize the retry policy used by SDK clients whenever they performs an I/O
  * operation.
  * @details Client libraries should acquire an initialized instance of this struct and then modify
  * any fields necessary before passing a pointer to this struct when initializing the specific
  * client.
+ *
+ * Unless the response says when to retry, the delay before a retry is a random value between
+ * `retry_delay_msec` and three times the previous delay, up to `max_retry_delay_msec`
+ * (decorrelated jitter), so that clients that failed at the same time don't retry in lockstep.
  */
 typedef struct
 {
@@ -121,8 +251,78 @@ typedef struct
   int32_t retry_delay_msec;
   int32_t max_retry_delay_msec;
   int32_t max_retries;
+
+  /// Time in milliseconds an attempt can take, from sending the request to receiving the whole
+  /// response, before the transport aborts it and it is retried. `0` (default) means no limit. An
+  /// attempt never takes longer than the time left before the context of the request expires.
+  /// An attempt that timed out after part of its body was streamed to the callback set with
+  /// #az_http_response_set_body_callback isn't retried, since the callback can't take the bytes
+  /// back: set it to the time the largest streamed body takes.
+  int32_t try_timeout_msec;
+
+  /// __[nullable]__ The retry budget shared by the requests using these options, `NULL` (default)
+  /// not to limit retries beyond `max_retries`.
+  az_http_policy_retry_budget* budget;
+
+  /// __[nullable]__ The circuit breaker shared by the requests using these options, `NULL`
+  /// (default) not to use one.
+  az_http_policy_retry_circuit_breaker* circuit_breaker;
+
+  /// __[nullable]__ The rate limiter shared by the requests using these options, `NULL` (default)
+  /// not to use one.
+  az_http_policy_rate_limiter* rate_limiter;
 } az_http_policy_retry_options;
 
+enum
+{
+  _az_HTTP_POLICY_HEDGING_SAMPLES = 64, // Number of latencies the hedging policy keeps.
+};
+
+/**
+ * @brief Hedging of idempotent requests, shared by all the requests of the clients whose options
+ * point to it.
+ *
+ * @details A GET or HEAD request that hasn't started to receive its response after a delay is sent
+ * a second time, and the response that starts first is used, the other request being aborted. This
+ * cuts the tail latency caused by a slow server behind a load balancer, at the cost of a few more
+ * requests. The delay is a percentile of the times to first byte of the latest requests (e.g. 95th,
+ * so that about 5% of the requests are hedged), and no request is hedged until enough of them
+ * completed.
+ *
+ * Only synchronous requests are hedged, and only by transport adapters that support it (`az_curl`).
+ * Requests with other methods aren't, even when the service treats them as idempotent: the
+ * policy can't tell them apart from the ones it doesn't. This includes the POST requests the
+ * credentials send to get their tokens from Azure Active Directory, which go through a pipeline
+ * of their own, without this policy. Initialize it with #az_http_policy_hedging_init. It is
+ * thread-safe.
+ */
+typedef struct
+{
+  struct
+  {
+    _az_spinlock lock;
+    int32_t percentile;
+    int32_t min_delay_msec;
+    int32_t latencies_msec[_az_HTTP_POLICY_HEDGING_SAMPLES]; // Ring buffer of the latest ones.
+    int32_t latencies_count;
+    int32_t next_latency;
+  } _internal;
+} az_http_policy_hedging;
+
+/**
+ * @brief Initializes an #az_http_policy_hedging.
+ *
+ * @param[out] out_hedging The hedging state to initialize.
+ * @param[in] percentile The percentile of the times to first byte after which a request is hedged,
+ * between `1` and `99`.
+ * @param[in] min_delay_msec The minimum delay before a request is hedged, in milliseconds. Must not
+ * be negative.
+ */
+void az_http_policy_hedging_init(
+    az_http_policy_hedging* out_hedging,
+    int32_t percentile,
+    int32_t min_delay_msec);
+
 typedef enum
 {
   _az_HTTP_RESPONSE_KIND_STATUS_LINE = 0,
@@ -131,6 +331,124 @@ typedef enum
   _az_HTTP_RESPONSE_KIND_EOF = 3,
 } _az_http_response_kind;
 
+/**
+ * @brief An entry of the header index of an #az_http_response, see
+ * #az_http_response_set_header_index.
+ */
+typedef struct
+{
+  uint32_t name_hash; // Case-insensitive hash of the header name.
+  int32_t name_offset;
+  int32_t name_length;
+  int32_t value_offset;
+  int32_t value_length;
+} _az_http_response_header_entry;
+
+/**
+ * @brief The header index of an #az_http_response.
+ */
+typedef struct
+{
+  az_span buffer; // Holds the entries, then the hash table of their (index + 1).
+  _az_http_response_header_entry* entries;
+  uint16_t* slots;
+  int32_t entries_count;
+  int32_t max_entries;
+  int32_t slots_count; // A power of 2.
+  int32_t body_offset;
+  bool is_built;
+  bool is_complete; // false when the response has more headers than the index can hold.
+} _az_http_response_header_index;
+
+/**
+ * @brief The size of a buffer to pass to #az_http_response_set_header_index, so that the index
+ * holds up to \p max_headers headers.
+ */
+#define AZ_HTTP_RESPONSE_HEADER_INDEX_BUFFER_SIZE(max_headers) \
+  ((max_headers) * (sizeof(_az_http_response_header_entry) + 4 * sizeof(uint16_t)) \
+   + sizeof(uint32_t))
+
+/**
+ * @brief Reads part of an HTTP request body, see #az_http_body_source_init.
+ *
+ * @param user_context The user context passed to #az_http_body_source_init.
+ * @param offset The position in the body to read from. It is less than the body length. Reads
+ * usually follow each other, but the body is read again from the start when the request is sent
+ * again (e.g. on a retry).
+ * @param destination The buffer to read into. It is never larger than the rest of the body.
+ * @param out_size The number of bytes read into \p destination. It must be greater than 0.
+ *
+ * @return #AZ_OK if bytes were read. Any failure stops the request, which fails with that result.
+ */
+typedef az_result (*az_http_body_source_read_fn)(
+    void* user_context,
+    int64_t offset,
+    az_span destination,
+    int32_t* out_size);
+
+/**
+ * @brief A request body that is read as it is sent, instead of being held in a single #az_span.
+ *
+ * @details It allows sending bodies larger than the memory available (e.g. a file), or larger than
+ * what an #az_span can hold. Use #az_http_body_source_init or
+ * #az_http_body_source_init_from_buffer to initialize it.
+ */
+typedef struct
+{
+  struct
+  {
+    az_http_body_source_read_fn read;
+    void* user_context;
+    int64_t length;
+  } _internal;
+} az_http_body_source;
+
+/**
+ * @brief Initializes a body source that reads \p length bytes with \p read.
+ *
+ * @remarks The body must not change while a request sending it is in flight, since parts of it may
+ * be read more than once.
+ *
+ * @param[out] out_source The body source to initialize.
+ * @param[in] length The length of the body in bytes.
+ * @param[in] read The function reading the body.
+ * @param[in] user_context __[nullable]__ A value passed to \p read, e.g. a file descriptor.
+ *
+ * @return #AZ_OK.
+ */
+AZ_NODISCARD az_result az_http_body_source_init(
+    az_http_body_source* out_source,
+    int64_t length,
+    az_http_body_source_read_fn read,
+    void* user_context);
+
+/**
+ * @brief Initializes a body source that reads \p length bytes from \p buffer, e.g. a memory
+ * mapped file.
+ *
+ * @param[out] out_source The body source to initialize.
+ * @param[in] buffer The body. It must stay valid while a request sending it is in flight.
+ * @param[in] length The length of the body in bytes.
+ *
+ * @return #AZ_OK.
+ */
+AZ_NODISCARD az_result az_http_body_source_init_from_buffer(
+    az_http_body_source* out_source,
+    void const* buffer,
+    int64_t length);
+
+/**
+ * @brief Receives the body of a successful HTTP response as it comes in from the network, instead
+ * of it being written to the #az_http_response buffer.
+ *
+ * @param body_chunk The next bytes of the body. The span is only valid during the call.
+ * @param user_context The user context passed to #az_http_response_set_body_callback.
+ *
+ * @return #AZ_OK to keep receiving the body. Any failure stops the transfer, and the request fails
+ * with that result.
+ */
+typedef az_result (*az_http_response_body_callback)(az_span body_chunk, void* user_context);
+
 /**
  * @brief Allows you to parse an HTTP response's status line, headers, and body.
  *
@@ -152,6 +470,17 @@ typedef struct
       _az_http_response_kind next_kind;
       // After parsing an element, next_kind refers to the next expected element
     } parser;
+    struct
+    {
+      az_http_response_body_callback callback;
+      void* user_context;
+      az_result callback_result;
+      int32_t headers_end_matched; // number of "\r\n\r\n" bytes matched so far.
+      bool is_headers_complete;
+      bool is_body_streamed;
+      bool has_streamed_bytes; // the callback received some of the body.
+    } body;
+    _az_http_response_header_index header_index;
   } _internal;
 } az_http_response;
 
@@ -161,7 +490,8 @@ typedef struct
  *
  * @param response The pointer to an az_http_response instance which is to be initialized.
  * @param buffer A span over the byte buffer that is to be filled with the HTTP response data. This
- * buffer must be large enough to hold the entire response.
+ * buffer must be large enough to hold the entire response, or only its status line and headers when
+ * the body is streamed (see #az_http_response_set_body_callback).
  */
 AZ_NODISCARD AZ_INLINE az_result az_http_response_init(az_http_response* response, az_span buffer)
 {
@@ -173,12 +503,57 @@ AZ_NODISCARD AZ_INLINE az_result az_http_response_init(az_http_response* respons
         .remaining = AZ_SPAN_NULL,
         .next_kind = _az_HTTP_RESPONSE_KIND_STATUS_LINE,
       },
+      .body = {
+        .callback = NULL,
+        .user_context = NULL,
+        .callback_result = AZ_OK,
+        .headers_end_matched = 0,
+        .is_headers_complete = false,
+        .is_body_streamed = false,
+        .has_streamed_bytes = false,
+      },
+      .header_index = {
+        .buffer = AZ_SPAN_NULL,
+        .entries = NULL,
+        .slots = NULL,
+        .entries_count = 0,
+        .max_entries = 0,
+        .slots_count = 0,
+        .body_offset = 0,
+        .is_built = false,
+        .is_complete = false,
+      },
     },
   };
 
   return AZ_OK;
 }
 
+/**
+ * @brief Streams the body of a successful (2xx) response to \p callback, instead of writing it to
+ * the buffer of \p ref_response.
+ *
+ * @details The status line and headers are still written to the buffer passed to
+ * #az_http_response_init, which only needs to be large enough to hold them, so that responses with
+ * bodies of any size can be received with constant memory. The body of any other response (e.g. a
+ * service error, or a response that gets retried) is written to the buffer as usual, and
+ * #az_http_response_get_body returns it. For a successful response, #az_http_response_get_body
+ * returns an empty span.
+ *
+ * @remarks Call this function after #az_http_response_init, before passing the response to an
+ * Azure service client's operation function.
+ *
+ * @param ref_response The az_http_response to stream the body of.
+ * @param callback The function receiving the body. `NULL` writes the body to the buffer again.
+ * @param user_context __[nullable]__ A value passed to \p callback.
+ *
+ * @return #AZ_OK.
+ */
+AZ_NODISCARD az_result az_http_response_set_body_callback(
+    az_http_response* ref_response,
+    az_http_response_body_callback callback,
+    void* user_context);
+
 /**
  * @brief Represents the result of making an HTTP request.
  * An application obtains this initialized structure by calling #az_http_response_get_status_line.
@@ -228,6 +603,43 @@ AZ_NODISCARD az_result az_http_response_get_status_line(
 AZ_NODISCARD az_result
 az_http_response_get_next_header(az_http_response* response, az_pair* out_header);
 
+/**
+ * @brief Makes \p ref_response parse its headers only once, into an index kept in \p buffer, so
+ * that #az_http_response_get_header finds a header in constant time and
+ * #az_http_response_get_body doesn't parse the headers again.
+ *
+ * @details The index is built the first time it is needed, once the response has been received.
+ * Responses with more headers than the index can hold still work, their lookups parse the headers.
+ *
+ * @remarks Call this function after #az_http_response_init, before passing the response to an
+ * Azure service client's operation function. The index is kept for the next attempts of a request.
+ *
+ * @param ref_response The az_http_response to index the headers of.
+ * @param buffer The buffer holding the index. Use #AZ_HTTP_RESPONSE_HEADER_INDEX_BUFFER_SIZE to get
+ * its size for a number of headers. #AZ_SPAN_NULL removes the index.
+ *
+ * @return #AZ_OK.
+ */
+AZ_NODISCARD az_result
+az_http_response_set_header_index(az_http_response* ref_response, az_span buffer);
+
+/**
+ * @brief Gets the value of the first header of an HTTP response that has a given name.
+ *
+ * @details Header names are compared ignoring case. Calling this function doesn't change what
+ * #az_http_response_get_next_header returns next.
+ *
+ * @param ref_response A pointer to an az_http_response instance.
+ * @param name The header name, e.g. `AZ_SPAN_FROM_STR("ETag")`.
+ * @param out_value A pointer to an az_span to receive the header value.
+ *
+ * @return AZ_OK = The header was found<br>
+ * AZ_ERROR_ITEM_NOT_FOUND = The response has no header named \p name<br>
+ * Other value = Error while parsing the response
+ */
+AZ_NODISCARD az_result
+az_http_response_get_header(az_http_response* ref_response, az_span name, az_span* out_value);
+
 /**
  * @brief az_http_response_get_body returns a span over the HTTP body within an HTTP response.
  *
@@ -238,6 +650,198 @@ az_http_response_get_next_header(az_http_response* response, az_pair* out_header
  */
 AZ_NODISCARD az_result az_http_response_get_body(az_http_response* response, az_span* out_body);
 
+enum
+{
+  _az_HTTP_POLICY_SINGLE_FLIGHT_CALLS = 8, // Number of distinct requests tracked at the same time.
+};
+
+typedef struct
+{
+  uint64_t key_hash;
+  az_span key; // Url and headers of the request of the leader, laid out on its stack.
+  az_http_response const* response; // Response of the leader, once is_done is set.
+  az_result result; // Result of the leader, once is_done is set.
+  int32_t followers; // Requests waiting for the response of the leader, or copying it.
+  bool is_used;
+  bool is_done;
+} _az_http_policy_single_flight_call;
+
+/**
+ * @brief Coalesces identical GET requests sent at the same time, shared by all the requests of the
+ * clients whose options point to it.
+ *
+ * @details The first request (the leader) is sent, and the identical requests sent while it is in
+ * flight (the followers) wait for it and get a copy of its response instead of being sent. Requests
+ * are identical when they have the same url and the same headers when the policy runs, before the
+ * retry policy and authentication. A follower sends its own request if the leader fails, or if the
+ * response doesn't fit in its response buffer.
+ *
+ * Responses are shared before the requests are authorized: only share it between clients that use
+ * the same credential. Only synchronous requests whose response is kept in the response buffer are
+ * coalesced, and up to #_az_HTTP_POLICY_SINGLE_FLIGHT_CALLS distinct requests at the same time.
+ * Initialize it with #az_http_policy_single_flight_init. It is thread-safe.
+ */
+typedef struct
+{
+  struct
+  {
+    _az_spinlock lock;
+    _az_http_policy_single_flight_call calls[_az_HTTP_POLICY_SINGLE_FLIGHT_CALLS];
+  } _internal;
+} az_http_policy_single_flight;
+
+/**
+ * @brief Initializes an #az_http_policy_single_flight.
+ *
+ * @param[out] out_single_flight The single-flight state to initialize.
+ */
+void az_http_policy_single_flight_init(az_http_policy_single_flight* out_single_flight);
+
+enum
+{
+  _az_HTTP_POLICY_BULKHEAD_HOSTS = 8, // Number of hosts a bulkhead tracks at the same time.
+};
+
+typedef struct
+{
+  uint8_t host[_az_HTTP_POLICY_HOST_MAX_SIZE];
+  int32_t host_size;
+  uint32_t host_hash; // 0 when the slot is unused.
+  int32_t in_flight; // Requests to the host being sent.
+  int32_t queued; // Requests to the host waiting for one of those to complete.
+} _az_http_policy_bulkhead_host;
+
+/**
+ * @brief Bounds the number of requests in flight to each host, shared by all the requests of the
+ * clients whose options point to it.
+ *
+ * @details Up to `max_in_flight` requests to a host are sent at the same time, retries included.
+ * Up to `max_queued` more wait for one of those to complete, or for their context to expire. The
+ * requests beyond that fail fast with #AZ_ERROR_HTTP_BULKHEAD_FULL, and aren't sent. Waiting
+ * requests are let through in no particular order.
+ *
+ * A bulkhead tracks up to #_az_HTTP_POLICY_BULKHEAD_HOSTS hosts with requests in flight at the
+ * same time, the requests to other hosts are rejected. Asynchronous requests, and the requests to
+ * hosts longer than #_az_HTTP_POLICY_HOST_MAX_SIZE bytes, aren't bounded.
+ * Initialize it with #az_http_policy_bulkhead_init. It is thread-safe.
+ */
+typedef struct
+{
+  struct
+  {
+    _az_spinlock lock;
+    int32_t max_in_flight;
+    int32_t max_queued;
+    _az_http_policy_bulkhead_host hosts[_az_HTTP_POLICY_BULKHEAD_HOSTS];
+  } _internal;
+} az_http_policy_bulkhead;
+
+/**
+ * @brief Initializes an #az_http_policy_bulkhead.
+ *
+ * @param[out] out_bulkhead The bulkhead to initialize.
+ * @param[in] max_in_flight Maximum number of requests to a host sent at the same time. Must be
+ * positive.
+ * @param[in] max_queued Maximum number of requests to a host waiting to be sent. `0` rejects the
+ * requests right away once \p max_in_flight are in flight.
+ */
+void az_http_policy_bulkhead_init(
+    az_http_policy_bulkhead* out_bulkhead,
+    int32_t max_in_flight,
+    int32_t max_queued);
+
+enum
+{
+  _az_HTTP_POLICY_CACHE_ENTRIES = 8, // Number of responses a cache keeps at the same time.
+};
+
+typedef struct
+{
+  uint64_t url_hash;
+  az_span url; // Url of the request, in the slot of the entry.
+  az_span response; // Raw response, in the slot of the entry after the url.
+  az_span etag; // Value of the ETag header of the response, empty if it has none.
+  az_span last_modified; // Value of the Last-Modified header of the response, empty if it has none.
+  uint32_t last_used; // Clock of the cache when the response was last stored or served.
+  bool is_used;
+} _az_http_policy_cache_entry;
+
+/**
+ * @brief Caches the responses to GET requests, shared by all the requests of the clients whose
+ * options point to it.
+ *
+ * @details A `200 OK` response with an `ETag` or a `Last-Modified` header is kept in the buffer of
+ * the cache, along with the url of its request. The next GET requests to that url are sent with
+ * `If-None-Match` and `If-Modified-Since` headers, and when the service replies `304 Not Modified`
+ * the cached response is copied to the response buffer instead. Any other response to that url
+ * replaces or evicts the cached one.
+ *
+ * The buffer is split in #_az_HTTP_POLICY_CACHE_ENTRIES slots of the same size, a response is
+ * cached when it fits in a slot with its url, replacing the least recently used one. Requests
+ * for a range, already conditional, asynchronous or whose response body is streamed aren't
+ * cached. A cached response is only served after the service authorized the request, so it can
+ * be shared between clients using different credentials. Initialize it with
+ * #az_http_policy_cache_init. It is thread-safe.
+ */
+typedef struct
+{
+  struct
+  {
+    _az_spinlock lock;
+    az_span buffer;
+    int32_t entry_size;
+    uint32_t clock;
+    _az_http_policy_cache_entry entries[_az_HTTP_POLICY_CACHE_ENTRIES];
+  } _internal;
+} az_http_policy_cache;
+
+/**
+ * @brief Initializes an #az_http_policy_cache.
+ *
+ * @param[out] out_cache The cache to initialize.
+ * @param[in] buffer Buffer the responses are cached in. It must outlive \p out_cache, and be at
+ * least #_az_HTTP_POLICY_CACHE_ENTRIES bytes.
+ */
+void az_http_policy_cache_init(az_http_policy_cache* out_cache, az_span buffer);
+
+/**
+ * @brief Compresses the bodies of the requests with gzip, shared by all the requests of the
+ * clients whose options point to it.
+ *
+ * @details A request body of `min_size` bytes or more is compressed to the buffer of the policy,
+ * and sent instead with a `Content-Encoding: gzip` header. Its `Content-Length` header, if any, is
+ * set to the compressed size. The body is sent as is when it doesn't get smaller, when the
+ * compressed body doesn't fit in the buffer, or when another request is using the buffer.
+ *
+ * The compression favors speed over ratio: JSON bodies get 4 to 6 times smaller. Requests that
+ * already have a `Content-Encoding` header, whose body is read from an #az_http_body_source, or
+ * that are asynchronous, aren't compressed. Initialize it with #az_http_policy_compression_init.
+ * It is thread-safe.
+ */
+typedef struct
+{
+  struct
+  {
+    _az_spinlock lock;
+    bool is_busy; // A request is using the buffer.
+    az_span buffer;
+    int32_t min_size;
+    _az_deflate_encoder encoder;
+  } _internal;
+} az_http_policy_compression;
+
+/**
+ * @brief Initializes an #az_http_policy_compression.
+ *
+ * @param[out] out_compression The compression policy to initialize.
+ * @param[in] buffer Buffer the bodies are compressed to. It must outlive \p out_compression.
+ * @param[in] min_size Minimum size of the bodies to compress, in bytes. Must not be negative.
+ */
+void az_http_policy_compression_init(
+    az_http_policy_compression* out_compression,
+    az_span buffer,
+    int32_t min_size);
+
 #include <azure/core/_az_cfg_suffix.h>
 
 #endif // _az_HTTP_H
@@ -16,6 +16,7 @@
 #define _az_HTTP_TRANSPORT_H
 
 #include <azure/core/az_http.h>
+#include <azure/core/az_metrics.h>
 #include <azure/core/az_span.h>
 
 #include <azure/core/_az_cfg_prefix.h>
@@ -68,6 +69,11 @@ typedef struct
     int32_t max_headers;
     int32_t retry_headers_start_byte_offset;
     az_span body;
+    az_http_body_source body_source; // Used instead of body when its read function is set.
+    int32_t hedge_delay_msec; // When the transport can send a second copy of the request, 0 never.
+    int64_t* time_to_first_byte_msec; // Set by the transport when it isn't NULL, for the hedging.
+    int32_t try_timeout_msec; // Time the transport can take for one attempt, 0 no limit.
+    _az_http_metrics_state* metrics; // Metrics of the request, NULL when they aren't measured.
   } _internal;
 } az_http_request;
 
@@ -109,6 +115,35 @@ struct _az_http_policy
   } _internal;
 };
 
+/**
+ * @brief State shared by an asynchronous HTTP transport adapter and the HTTP policies about one
+ * request that is in flight.
+ *
+ * @details When a request context is bound to this state, the transport adapter submits the request
+ * and returns #AZ_HTTP_REQUEST_PENDING instead of blocking. The pipeline unwinds, keeping a copy of
+ * the request in this state, and it is resumed by the transport adapter once the response has been
+ * received.
+ *
+ * Users @b should @b not access _internal field. Asynchronous transport adapters embed it in their
+ * own operation type.
+ */
+typedef struct
+{
+  struct
+  {
+    az_context context; // Binds this state to the requests sent with it.
+    az_http_request request; // Copy of the request, replayed when the pipeline is resumed.
+    az_span buffer; // Holds the url and the headers of the request copy.
+    _az_http_policy resume_policy; // Policy to resume with the request copy, if any.
+    _az_http_policy* resume_next_policies;
+    int64_t not_before_msec; // Time before which the transport must not send the request.
+    int32_t attempt; // Current attempt of the retry policy, 0 until the request is first sent.
+    int32_t retry_delay_msec; // Delay before the current attempt, 0 before the first retry.
+    az_result completed_result; // Result of the transport, once is_completed is set.
+    bool is_completed;
+  } _internal;
+} _az_http_async_state;
+
 /**
  * @brief Get the HTTP header by index.
  *
@@ -162,6 +197,55 @@ AZ_NODISCARD az_result az_http_request_get_url(az_http_request const* request, a
  */
 AZ_NODISCARD az_result az_http_request_get_body(az_http_request const* request, az_span* out_body);
 
+/**
+ * @brief Get the body of an HTTP request as a body source, to read it in parts.
+ *
+ * @remarks This function is expected to be used by transport layer only. It works for all
+ * requests: when the body of \p request is an #az_span, the body source reads from it.
+ *
+ * @param[in] request The HTTP request from which to get the body.
+ * @param[out] out_source Pointer to write the body source to.
+ *
+ * @retval An #az_result value indicating the result of the operation:
+ *         - #AZ_OK if successful
+ */
+AZ_NODISCARD az_result
+az_http_request_get_body_source(az_http_request const* request, az_http_body_source* out_source);
+
+/**
+ * @brief Gets the length of a body source.
+ *
+ * @param[in] source The body source.
+ *
+ * @return The length of the body in bytes.
+ */
+AZ_NODISCARD AZ_INLINE int64_t az_http_body_source_get_length(az_http_body_source const* source)
+{
+  return source->_internal.length;
+}
+
+/**
+ * @brief Reads part of a body source.
+ *
+ * @remarks This function is expected to be used by transport layer only.
+ *
+ * @param[in] source The body source to read from.
+ * @param[in] offset The position in the body to read from, between 0 and the body length.
+ * @param[in] destination The buffer to read into.
+ * @param[out] out_size The number of bytes read into \p destination, `0` only when \p offset is
+ * the end of the body or \p destination is empty.
+ *
+ * @retval An #az_result value indicating the result of the operation:
+ *         - #AZ_OK if successful
+ *         - #AZ_ERROR_EOF if the body source read nothing before the end of the body
+ *         - Any failure returned by the read function of the body source
+ */
+AZ_NODISCARD az_result az_http_body_source_read(
+    az_http_body_source const* source,
+    int64_t offset,
+    az_span destination,
+    int32_t* out_size);
+
 /**
  * @brief This function is expected to be used by transport adapters like curl. Use it to write
  * content from \p source to \p response.
@@ -463,6 +463,12 @@ AZ_NODISCARD az_result az_json_writer_append_end_array(az_json_writer* json_writ
  */
 typedef struct
 {
+  /// Checks that the strings are valid UTF-8 (RFC 3629): no overlong encodings, surrogates or
+  /// code points above U+10FFFF. #az_json_reader_next_token() fails with
+  /// #AZ_ERROR_UNEXPECTED_CHAR on a string that is not. The bytes are checked while the reader
+  /// looks for the end of the string, so that strings of ASCII characters cost nothing more.
+  bool validate_utf8;
+
   struct
   {
     // Currently, this is unused, but needed as a placeholder since we can't have an empty struct.
@@ -481,6 +487,7 @@ typedef struct
 AZ_NODISCARD AZ_INLINE az_json_reader_options az_json_reader_options_default()
 {
   az_json_reader_options options = (az_json_reader_options) {
+    .validate_utf8 = false,
     ._internal = {
       .unused = false,
     },
@@ -508,6 +515,34 @@ typedef struct
     bool is_complex_json;
     _az_json_bit_stack bit_stack;
     az_json_reader_options options;
+
+    // The classes of the bytes of a block of up to 64 bytes of json_buffer, found at once with SIMD
+    // instructions, so that the reader looks up where whitespace and strings end instead of
+    // reading them one byte at a time. Bit i of each mask is byte start + i. Unused when the SDK
+    // is built without SIMD instructions.
+    struct
+    {
+      int32_t start;
+      int32_t size; // 0 if no block is indexed.
+      uint64_t whitespace; // ' ', '\t', '\n' and '\r'.
+      // '"', '\\' and control characters, and the bytes above 0x7F when options.validate_utf8 is
+      // true.
+      uint64_t string_ends;
+    } index;
+
+    // Reading JSON from a sequence of buffers (az_json_reader_chunked_init). A token cut by the end
+    // of a buffer is copied to token_buffer, where the start of the next buffer is appended to it,
+    // and json_buffer is token_buffer until that token is read.
+    struct
+    {
+      bool is_chunked;
+      bool is_last_buffer; // No buffer is appended after json_buffer, always true unless chunked.
+      bool needs_buffer; // AZ_ERROR_JSON_READER_NEED_MORE_DATA was returned.
+      az_span token_buffer;
+      int32_t token_size; // The size of the cut token in token_buffer, 0 if there is none.
+      az_span next_buffer; // The buffer to read once the cut token is read.
+      int32_t next_buffer_copied; // The bytes of next_buffer appended to token_buffer.
+    } chunked;
   } _internal;
 } az_json_reader;
 
@@ -530,6 +565,67 @@ AZ_NODISCARD az_result az_json_reader_init(
     az_span json_buffer,
     az_json_reader_options const* options);
 
+/**
+ * @brief Initializes an #az_json_reader to read a JSON payload received in several buffers, e.g.
+ * the MQTT packets of a device twin or the chunks of an HTTP response body, one after the other.
+ *
+ * @param[out] json_reader A pointer to an #az_json_reader instance to initialize.
+ * @param[in] first_json_buffer An #az_span over the first bytes of the JSON text, which can be
+ * empty.
+ * @param[in] token_buffer An #az_span over a byte buffer where the reader copies a token cut by the
+ * end of a buffer, so that the next buffer continues it. It must fit the largest token of the JSON
+ * text, with the whitespace and the separator before it.
+ * @param[in] options __[nullable]__ A reference to an #az_json_reader_options
+ * structure which defines custom behavior of the #az_json_reader. If `NULL` is passed, the reader
+ * will use the default options (i.e. #az_json_reader_options_default()).
+ *
+ * @return An #az_result value indicating the result of the operation:
+ *         - #AZ_OK if the az_json_reader is initialized successfully
+ *
+ * @remarks #az_json_reader_next_token() returns #AZ_ERROR_JSON_READER_NEED_MORE_DATA when it
+ * reaches the end of a buffer. The reader keeps no pointer to it, its memory can be reused for
+ * the next buffer, which #az_json_reader_chunked_append() gives to the reader. The reader resumes
+ * from the token the previous buffer cut, without reading the previous tokens again. Once the last
+ * buffer is appended, #az_json_reader_chunked_end() makes the end of the buffer the end of the JSON
+ * text.
+ *
+ * @remarks The slice of a token cut by the end of a buffer points in \p token_buffer, until the
+ * next call to #az_json_reader_next_token(). The slices of the other tokens point in the buffers.
+ */
+AZ_NODISCARD az_result az_json_reader_chunked_init(
+    az_json_reader* json_reader,
+    az_span first_json_buffer,
+    az_span token_buffer,
+    az_json_reader_options const* options);
+
+/**
+ * @brief Gives the next buffer of the JSON text to an #az_json_reader, after
+ * #az_json_reader_next_token() returned #AZ_ERROR_JSON_READER_NEED_MORE_DATA.
+ *
+ * @param[in,out] json_reader A pointer to an #az_json_reader instance initialized with
+ * #az_json_reader_chunked_init().
+ * @param[in] next_json_buffer An #az_span over the next bytes of the JSON text.
+ *
+ * @return An #az_result value indicating the result of the operation:
+ *         - #AZ_OK if the buffer is appended successfully
+ *         - #AZ_ERROR_JSON_INVALID_STATE if the reader hasn't returned
+ *           #AZ_ERROR_JSON_READER_NEED_MORE_DATA, or the last buffer was already appended
+ */
+AZ_NODISCARD az_result
+az_json_reader_chunked_append(az_json_reader* json_reader, az_span next_json_buffer);
+
+/**
+ * @brief Tells an #az_json_reader that no buffer follows the ones already given to it, so that
+ * the end of the last one is the end of the JSON text.
+ *
+ * @param[in,out] json_reader A pointer to an #az_json_reader instance initialized with
+ * #az_json_reader_chunked_init().
+ *
+ * @remarks It can be called right after the last buffer is appended, or once the reader returned
+ * #AZ_ERROR_JSON_READER_NEED_MORE_DATA for it.
+ */
+void az_json_reader_chunked_end(az_json_reader* json_reader);
+
 /**
  * @brief Reads the next token in the JSON text and updates the reader state.
  *
@@ -537,7 +633,11 @@ AZ_NODISCARD az_result az_json_reader_init(
  *
  * @return AZ_OK if the token was read successfully.<br>
  *         AZ_ERROR_EOF when the end of the JSON document is reached.<br>
- *         AZ_ERROR_UNEXPECTED_CHAR when an invalid character is detected.
+ *         AZ_ERROR_UNEXPECTED_CHAR when an invalid character is detected.<br>
+ *         AZ_ERROR_JSON_READER_NEED_MORE_DATA when the reader is initialized with
+ *         #az_json_reader_chunked_init() and reaches the end of the last appended buffer.<br>
+ *         AZ_ERROR_INSUFFICIENT_SPAN_SIZE when a token cut by the end of a buffer doesn't fit in
+ *         the token buffer of a chunked reader.
  */
 AZ_NODISCARD az_result az_json_reader_next_token(az_json_reader* json_reader);
 
@@ -553,9 +653,177 @@ AZ_NODISCARD az_result az_json_reader_next_token(az_json_reader* json_reader);
  * @remarks If the current token kind is a property name, the reader first moves to the property
  * value. Then, if the token kind is start of an object or array, the reader moves to the matching
  * end object or array. For all other token kinds, the reader doesn't move and returns #AZ_OK.
+ *
+ * @remarks When it returns #AZ_ERROR_JSON_READER_NEED_MORE_DATA, the reader stays within the
+ * children, at the token read last: the caller reads the rest of them with
+ * #az_json_reader_next_token(), counting the objects and arrays they begin and end.
  */
 AZ_NODISCARD az_result az_json_reader_skip_children(az_json_reader* json_reader);
 
+/**
+ * @brief Finds the values at JSON Pointer (RFC 6901) paths, such as
+ * `/desired/thermostat1/targetTemperature`, in a single pass, skipping the children of the values
+ * that are on none of the paths.
+ *
+ * @param json_reader A pointer to an #az_json_reader instance, at the value the paths start from:
+ * the root of the JSON payload if no token is read yet, or the current value or property value.
+ * @param[in] json_pointers The paths. Each of them is empty, for the value itself, or has a `/`
+ * before each property name or array index on the way to the value. In property names, `~0` stands
+ * for `~` and `~1` for `/`. Array indexes are decimal, from `0`, without leading zeros.
+ * @param[in] json_pointers_count The number of paths.
+ * @param[out] out_values The values at the paths, in the same order: the first token of an object
+ * or array. A token of kind #AZ_JSON_TOKEN_NONE for a path that isn't found.
+ *
+ * @return An #az_result value indicating the result of the operation:
+ *         - #AZ_OK if all the paths are found
+ *         - #AZ_ERROR_ITEM_NOT_FOUND if some paths aren't found, the values of the others are set
+ *         - the failure of #az_json_reader_next_token() for an invalid JSON payload
+ *
+ * @remarks Once all the paths are found, the reader stops at the value found last, without reading
+ * the rest of the JSON. Otherwise, it stops at the end of the value the paths start from.
+ *
+ * @remarks A chunked reader (#az_json_reader_chunked_init) isn't supported: the slices of the
+ * values could point in a buffer read before the last one.
+ */
+AZ_NODISCARD az_result az_json_reader_find_paths(
+    az_json_reader* json_reader,
+    az_span const json_pointers[],
+    int32_t json_pointers_count,
+    az_json_token out_values[]);
+
+/**
+ * @brief Finds the value at a JSON Pointer (RFC 6901) path, as #az_json_reader_find_paths() does.
+ *
+ * @param json_reader A pointer to an #az_json_reader instance, at the value the path starts from.
+ * @param[in] json_pointer The path, such as `/desired/$version`.
+ * @param[out] out_value The value at the path.
+ *
+ * @return #AZ_OK if the path is found, #AZ_ERROR_ITEM_NOT_FOUND if it isn't, or the failure of
+ * #az_json_reader_next_token() for an invalid JSON payload.
+ */
+AZ_NODISCARD AZ_INLINE az_result az_json_reader_find_path(
+    az_json_reader* json_reader,
+    az_span json_pointer,
+    az_json_token* out_value)
+{
+  return az_json_reader_find_paths(json_reader, &json_pointer, 1, out_value);
+}
+
+/************************************ JSON INDEX ******************/
+
+/**
+ * @brief A token of an #az_json_index.
+ */
+typedef struct
+{
+  int32_t offset; // Of the token slice in the JSON buffer.
+  int32_t size; // Of the token slice.
+  int32_t last; // The position of the last token of its children, see az_json_index_skip_children.
+  uint8_t kind; // An az_json_token_kind.
+  bool string_has_escaped_chars;
+} _az_json_index_entry;
+
+/**
+ * @brief The size of a buffer to pass to #az_json_index_init, so that the index holds up to
+ * \p max_tokens tokens.
+ */
+#define AZ_JSON_INDEX_BUFFER_SIZE(max_tokens) \
+  ((max_tokens) * sizeof(_az_json_index_entry) + sizeof(int32_t))
+
+/**
+ * @brief The tokens of a JSON payload, read once, to look them up as many times as needed without
+ * reading the JSON again.
+ *
+ * @details The tokens are identified by their position, from `0` for the first one to
+ * #az_json_index_get_token_count() - 1. Each of them knows where its children end, so that moving
+ * past an object or an array doesn't read the tokens within it.
+ */
+typedef struct
+{
+  struct
+  {
+    az_span json_buffer;
+    _az_json_index_entry const* entries;
+    int32_t count;
+  } _internal;
+} az_json_index;
+
+/**
+ * @brief Reads all the tokens of a JSON payload into an #az_json_index, kept in a caller buffer.
+ *
+ * @param[out] out_index A pointer to the #az_json_index instance to initialize.
+ * @param[in] json_buffer An #az_span over the JSON text to read. The tokens of the index point in
+ * it, it must stay valid as long as the index is used.
+ * @param[in] buffer The buffer holding the tokens. Use #AZ_JSON_INDEX_BUFFER_SIZE to get its size
+ * for a number of tokens.
+ * @param[in] options __[nullable]__ A reference to an #az_json_reader_options structure which
+ * defines how the JSON is read. If `NULL` is passed, the default options are used.
+ *
+ * @return An #az_result value indicating the result of the operation:
+ *         - #AZ_OK if the whole JSON payload is read successfully
+ *         - #AZ_ERROR_INSUFFICIENT_SPAN_SIZE if \p buffer can't hold all the tokens
+ *         - the failure of #az_json_reader_next_token() for an invalid JSON payload
+ */
+AZ_NODISCARD az_result az_json_index_init(
+    az_json_index* out_index,
+    az_span json_buffer,
+    az_span buffer,
+    az_json_reader_options const* options);
+
+/**
+ * @brief Gets the number of tokens of an #az_json_index.
+ *
+ * @param[in] index A pointer to an #az_json_index instance.
+ *
+ * @return The number of tokens in the JSON payload.
+ */
+AZ_NODISCARD AZ_INLINE int32_t az_json_index_get_token_count(az_json_index const* index)
+{
+  return index->_internal.count;
+}
+
+/**
+ * @brief Gets a token of an #az_json_index.
+ *
+ * @param[in] index A pointer to an #az_json_index instance.
+ * @param[in] position The position of the token, less than #az_json_index_get_token_count().
+ *
+ * @return The token, as #az_json_reader_next_token() read it.
+ */
+AZ_NODISCARD az_json_token az_json_index_get_token(az_json_index const* index, int32_t position);
+
+/**
+ * @brief Gets the position of the last token of the children of a token of an #az_json_index,
+ * without going through them.
+ *
+ * @param[in] index A pointer to an #az_json_index instance.
+ * @param[in] position The position of the token, less than #az_json_index_get_token_count().
+ *
+ * @return The position #az_json_reader_skip_children() moves a reader to: the end of the object or
+ * array of a begin object or array, the last token of the value of a property name, and
+ * \p position itself for other tokens. The next token, if any, follows it.
+ */
+AZ_NODISCARD int32_t az_json_index_skip_children(az_json_index const* index, int32_t position);
+
+/**
+ * @brief Finds the value of a property of an object of an #az_json_index, going over the values of
+ * the other properties without going through their children.
+ *
+ * @param[in] index A pointer to an #az_json_index instance.
+ * @param[in] object_position The position of the begin object token of the object.
+ * @param[in] name The name of the property, as unescaped text (see #az_json_token_is_text_equal).
+ * @param[out] out_value_position The position of the first token of the value of the property.
+ *
+ * @return An #az_result value indicating the result of the operation:
+ *         - #AZ_OK if the property is found
+ *         - #AZ_ERROR_ITEM_NOT_FOUND if the object has no property with that name
+ */
+AZ_NODISCARD az_result az_json_index_find_property(
+    az_json_index const* index,
+    int32_t object_position,
+    az_span name,
+    int32_t* out_value_position);
+
 #include <azure/core/_az_cfg_suffix.h>
 
 #endif // _az_JSON_H
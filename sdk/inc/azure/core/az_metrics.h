@@ -0,0 +1,160 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file az_metrics.h
+ *
+ * @brief This header defines the types and functions your application uses to measure where the
+ * time of the HTTP requests sent by the Azure SDK client libraries goes.
+ *
+ * @note You MUST NOT use any symbols (macros, functions, structures, enums, etc.)
+ * prefixed with an underscore ('_') directly in your application code. These symbols
+ * are part of Azure SDK's internal implementation; we do not document these symbols
+ * and they are subject to change in future versions of the SDK which would break your code.
+ */
+
+#ifndef _az_METRICS_H
+#define _az_METRICS_H
+
+#include <azure/core/az_result.h>
+#include <azure/core/_az_spinlock.h>
+
+#include <stdint.h>
+
+#include <azure/core/_az_cfg_prefix.h>
+
+enum
+{
+  /// Maximum number of policies of a pipeline whose elapsed time is measured, the length of the
+  /// longest pipeline of the SDK clients. The policies past it aren't measured on their own, their
+  /// time is only counted in the elapsed time of the policies before them.
+  AZ_METRICS_MAX_POLICIES = 11,
+
+  /// Number of buckets of an #az_metrics_histogram, the last one counts the longer latencies.
+  AZ_METRICS_HISTOGRAM_BUCKETS = 16,
+};
+
+/**
+ * @brief The metrics of one HTTP request, given to the #az_metrics_fn callback once the pipeline
+ * sending it returns.
+ *
+ * @details The transport adapter fills the timings of the last attempt, the ones it doesn't measure
+ * are `0`. They are measured from the start of the attempt, the same way as libcurl does: e.g. the
+ * time to first byte includes the DNS, connect and TLS times. The bytes are counted over all the
+ * attempts, headers included.
+ */
+typedef struct
+{
+  az_result result; ///< The result the pipeline returned.
+  int32_t retry_count; ///< Number of retries sent by the retry policy.
+  int64_t total_msec; ///< Time the pipeline took, retries and delays included.
+
+  /// Time spent in each policy of the pipeline, and in the ones after it, in the order of the
+  /// pipeline, retries included. The time spent in policy `i` itself is
+  /// `policy_elapsed_usec[i] - policy_elapsed_usec[i + 1]`. Most policies take a few microseconds.
+  int64_t policy_elapsed_usec[AZ_METRICS_MAX_POLICIES];
+
+  int64_t dns_usec; ///< Time the name resolution of the host took.
+  int64_t connect_usec; ///< Time until the TCP connection was established.
+  int64_t tls_usec; ///< Time until the TLS handshake completed, `0` without TLS.
+  int64_t time_to_first_byte_usec; ///< Time until the first byte of the response was received.
+  int64_t transfer_usec; ///< Time the last attempt took.
+  int64_t bytes_sent; ///< Bytes of the requests sent.
+  int64_t bytes_received; ///< Bytes of the responses received.
+} az_http_metrics;
+
+/**
+ * @brief The metrics of a request being sent, and the policies of the pipeline sending it.
+ */
+typedef struct
+{
+  struct
+  {
+    az_http_metrics metrics;
+    void const* policies; // _az_http_policy const*, the first policy of the pipeline.
+  } _internal;
+} _az_http_metrics_state;
+
+/**
+ * @brief Defines the signature of the callback function that receives the metrics of each HTTP
+ * request.
+ *
+ * @param metrics The metrics of the request, only valid during the call.
+ */
+typedef void (*az_metrics_fn)(az_http_metrics const* metrics);
+
+/**
+ * @brief Latencies aggregated across requests, in fixed buckets.
+ *
+ * @details Bucket `i` counts the latencies up to #az_metrics_histogram_get_bucket bound, and above
+ * the bound of bucket `i - 1`. The bounds go from 1 millisecond to about 16 seconds, doubling
+ * from one bucket to the next, and the last bucket counts the longer latencies. Initialize it with
+ * #az_metrics_histogram_init. It is thread-safe.
+ */
+typedef struct
+{
+  struct
+  {
+    _az_spinlock lock;
+    int64_t counts[AZ_METRICS_HISTOGRAM_BUCKETS];
+  } _internal;
+} az_metrics_histogram;
+
+/**
+ * @brief Initializes an #az_metrics_histogram, with all its buckets empty.
+ *
+ * @param[out] out_histogram The histogram to initialize.
+ */
+void az_metrics_histogram_init(az_metrics_histogram* out_histogram);
+
+/**
+ * @brief Gets one bucket of a histogram.
+ *
+ * @param[in] histogram The histogram.
+ * @param[in] index Index of the bucket, lower than #AZ_METRICS_HISTOGRAM_BUCKETS.
+ * @param[out] out_upper_bound_msec The largest latency counted by the bucket, `INT64_MAX` for the
+ * last one.
+ * @param[out] out_count Number of latencies counted by the bucket.
+ */
+void az_metrics_histogram_get_bucket(
+    az_metrics_histogram* histogram,
+    int32_t index,
+    int64_t* out_upper_bound_msec,
+    int64_t* out_count);
+
+/**
+ * @brief Sets the function invoked with the metrics of each HTTP request sent synchronously.
+ *
+ * @param metrics_callback __[nullable]__ The function to invoke, `NULL` not to measure the requests
+ * unless a histogram is set.
+ */
+#ifndef AZ_NO_METRICS
+void az_metrics_set_callback(az_metrics_fn metrics_callback);
+#else
+AZ_INLINE void az_metrics_set_callback(az_metrics_fn metrics_callback) { (void)metrics_callback; }
+#endif // AZ_NO_METRICS
+
+/**
+ * @brief Sets the histograms the latencies of the HTTP requests sent synchronously are added to.
+ *
+ * @param total __[nullable]__ Histogram of the time the pipelines took, `NULL` for none.
+ * @param time_to_first_byte __[nullable]__ Histogram of the time to first byte of the last attempt
+ * of the requests, `NULL` for none.
+ */
+#ifndef AZ_NO_METRICS
+void az_metrics_set_histograms(
+    az_metrics_histogram* total,
+    az_metrics_histogram* time_to_first_byte);
+#else
+AZ_INLINE void az_metrics_set_histograms(
+    az_metrics_histogram* total,
+    az_metrics_histogram* time_to_first_byte)
+{
+  (void)total;
+  (void)time_to_first_byte;
+}
+#endif // AZ_NO_METRICS
+
+#include <azure/core/_az_cfg_suffix.h>
+
+#endif // _az_METRICS_H
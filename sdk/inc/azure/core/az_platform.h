@@ -20,6 +20,15 @@
  */
 AZ_NODISCARD int64_t az_platform_clock_msec();
 
+/**
+ * @brief Gets the platform clock in microseconds, to measure durations shorter than a millisecond.
+ * @remark As for #az_platform_clock_msec, the moment of time where clock starts is undefined. The
+ * platforms without a finer clock return the milliseconds of #az_platform_clock_msec, in
+ * microseconds.
+ * @return Platform clock in microseconds.
+ */
+AZ_NODISCARD int64_t az_platform_clock_usec();
+
 /**
  * @brief Tells the platform to sleep for a given number of milliseconds.
  * @param milliseconds Number of milliseconds to sleep.
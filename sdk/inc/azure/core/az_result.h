@@ -113,6 +113,14 @@ typedef enum
   AZ_ERROR_JSON_NESTING_OVERFLOW
   = _az_RESULT_MAKE_ERROR(_az_FACILITY_JSON, 2), ///< The JSON depth is too large.
   AZ_ERROR_JSON_READER_DONE = _az_RESULT_MAKE_ERROR(_az_FACILITY_JSON, 3),
+  AZ_ERROR_JSON_READER_NEED_MORE_DATA = _az_RESULT_MAKE_ERROR(
+      _az_FACILITY_JSON,
+      4), ///< The JSON buffers read so far end before the next token, append the next one.
+
+  // HTTP: Success results
+  AZ_HTTP_REQUEST_PENDING = _az_RESULT_MAKE_SUCCESS(
+      _az_FACILITY_HTTP,
+      1), ///< The request was sent asynchronously, its result is delivered on completion.
 
   // HTTP error codes
   AZ_ERROR_HTTP_INVALID_STATE = _az_RESULT_MAKE_ERROR(_az_FACILITY_HTTP, 1),
@@ -127,6 +135,18 @@ typedef enum
 
   AZ_ERROR_HTTP_CORRUPT_RESPONSE_HEADER = _az_RESULT_MAKE_ERROR(_az_FACILITY_HTTP, 7),
 
+  AZ_ERROR_HTTP_CIRCUIT_OPEN = _az_RESULT_MAKE_ERROR(
+      _az_FACILITY_HTTP,
+      8), ///< The request wasn't sent, the host failed too many times in a row recently.
+
+  AZ_ERROR_HTTP_ATTEMPT_TIMEOUT = _az_RESULT_MAKE_ERROR(
+      _az_FACILITY_HTTP,
+      9), ///< An attempt to send the request took longer than the per-try timeout.
+
+  AZ_ERROR_HTTP_BULKHEAD_FULL = _az_RESULT_MAKE_ERROR(
+      _az_FACILITY_HTTP,
+      10), ///< The request wasn't sent, too many requests to the host are in flight or waiting.
+
   // IoT error codes
   AZ_ERROR_IOT_TOPIC_NO_MATCH = _az_RESULT_MAKE_ERROR(_az_FACILITY_IOT, 1),
 } az_result;
@@ -23,7 +23,7 @@ typedef struct
 {
   struct
   {
-    _az_http_policy policies[10];
+    _az_http_policy policies[11];
   } _internal;
 } _az_http_pipeline;
 
@@ -91,7 +91,10 @@ AZ_NODISCARD az_http_policy_retry_options _az_http_policy_retry_options_default(
 // Client ->
 //  ===HttpPipelinePolicies===
 //    UniqueRequestID
+//    SingleFlight
+//    Bulkhead
 //    Retry
+//    Hedging
 //    Authentication
 //    Logging
 //    Buffer Response
@@ -125,6 +128,36 @@ AZ_NODISCARD az_result az_http_pipeline_policy_retry(
     az_http_request* ref_request,
     az_http_response* ref_response);
 
+AZ_NODISCARD az_result az_http_pipeline_policy_cache(
+    _az_http_policy* ref_policies,
+    void* ref_options,
+    az_http_request* ref_request,
+    az_http_response* ref_response);
+
+AZ_NODISCARD az_result az_http_pipeline_policy_single_flight(
+    _az_http_policy* ref_policies,
+    void* ref_options,
+    az_http_request* ref_request,
+    az_http_response* ref_response);
+
+AZ_NODISCARD az_result az_http_pipeline_policy_bulkhead(
+    _az_http_policy* ref_policies,
+    void* ref_options,
+    az_http_request* ref_request,
+    az_http_response* ref_response);
+
+AZ_NODISCARD az_result az_http_pipeline_policy_compression(
+    _az_http_policy* ref_policies,
+    void* ref_options,
+    az_http_request* ref_request,
+    az_http_response* ref_response);
+
+AZ_NODISCARD az_result az_http_pipeline_policy_hedging(
+    _az_http_policy* ref_policies,
+    void* ref_options,
+    az_http_request* ref_request,
+    az_http_response* ref_response);
+
 AZ_NODISCARD az_result az_http_pipeline_policy_credential(
     _az_http_policy* ref_policies,
     void* ref_options,
@@ -145,6 +178,17 @@ AZ_NODISCARD az_result az_http_pipeline_policy_transport(
     az_http_request* ref_request,
     az_http_response* ref_response);
 
+#ifndef AZ_NO_METRICS
+/**
+ * @brief Calls the first of \p ref_policies, adding the time it takes to the metrics of
+ * \p ref_request.
+ */
+AZ_NODISCARD az_result _az_http_pipeline_nextpolicy_measured(
+    _az_http_policy* ref_policies,
+    az_http_request* ref_request,
+    az_http_response* ref_response);
+#endif // AZ_NO_METRICS
+
 AZ_NODISCARD AZ_INLINE az_result _az_http_pipeline_nextpolicy(
     _az_http_policy* ref_policies,
     az_http_request* ref_request,
@@ -157,6 +201,13 @@ AZ_NODISCARD AZ_INLINE az_result _az_http_pipeline_nextpolicy(
     return AZ_ERROR_HTTP_PIPELINE_INVALID_POLICY;
   }
 
+#ifndef AZ_NO_METRICS
+  if (ref_request->_internal.metrics != NULL)
+  {
+    return _az_http_pipeline_nextpolicy_measured(ref_policies, ref_request, ref_response);
+  }
+#endif // AZ_NO_METRICS
+
   return ref_policies[0]._internal.process(
       &(ref_policies[1]), ref_policies[0]._internal.options, ref_request, ref_response);
 }
@@ -240,6 +291,140 @@ az_http_request_set_query_parameter(az_http_request* ref_request, az_span name,
 AZ_NODISCARD az_result
 az_http_request_append_header(az_http_request* ref_request, az_span key, az_span value);
 
+/**
+ * @brief Sets the body of the request to be read from a body source, instead of the #az_span
+ * passed to #az_http_request_init.
+ *
+ * @param ref_request HTTP request to set the body of.
+ * @param source The body source. It is copied, but what it reads from must stay valid while the
+ * request is in flight.
+ *
+ * @return
+ *   - *`AZ_OK`* success.
+ */
+AZ_NODISCARD az_result
+az_http_request_set_body_source(az_http_request* ref_request, az_http_body_source const* source);
+
+/**
+ * @brief Initializes the state of a request sent through an asynchronous HTTP transport adapter.
+ *
+ * @param[out] out_state The state to initialize. Its `_internal.context` is a child of \p parent
+ * that binds the requests sent with it to \p out_state.
+ * @param[in] parent The parent context, `NULL` means #az_context_application.
+ * @param[in] buffer Buffer where the url and the headers of the request are copied while the
+ * request is in flight.
+ *
+ * @return #AZ_OK.
+ */
+AZ_NODISCARD az_result
+_az_http_async_state_init(_az_http_async_state* out_state, az_context const* parent, az_span buffer);
+
+/**
+ * @brief Creates a child of \p parent on which HTTP requests are sent synchronously, even when
+ * \p parent is bound to an asynchronous request (e.g. to get a token while sending it).
+ */
+AZ_NODISCARD az_context _az_http_context_create_synchronous(az_context const* parent);
+
+/**
+ * @brief Gets the asynchronous state \p request is bound to through its context.
+ *
+ * @return The state, or `NULL` if \p request is to be sent synchronously.
+ */
+AZ_NODISCARD _az_http_async_state* _az_http_request_get_async_state(az_http_request const* request);
+
+/**
+ * @brief Gets how long the transport adapter can take to send \p request and receive its response,
+ * from \p now_msec: the time left before the context of \p request expires, capped by the per-try
+ * timeout set by the retry policy.
+ *
+ * @param[out] out_timeout_msec The timeout, `0` if there is none.
+ *
+ * @return #AZ_OK, or #AZ_ERROR_CANCELED if the context has expired.
+ */
+AZ_NODISCARD az_result _az_http_request_get_timeout(
+    az_http_request const* request,
+    int64_t now_msec,
+    int64_t* out_timeout_msec);
+
+/**
+ * @brief Gets the result of an attempt that the transport adapter aborted at \p now_msec, once the
+ * timeout given by #_az_http_request_get_timeout elapsed.
+ *
+ * @return #AZ_ERROR_CANCELED if the context of \p request has expired, or
+ * #AZ_ERROR_HTTP_ATTEMPT_TIMEOUT, which the retry policy retries.
+ */
+AZ_NODISCARD az_result
+_az_http_request_get_timeout_result(az_http_request const* request, int64_t now_msec);
+
+/**
+ * @brief Gets the metrics of \p request that the policies and the transport adapter fill, `NULL`
+ * if they aren't measured.
+ */
+AZ_NODISCARD AZ_INLINE az_http_metrics* _az_http_request_get_metrics(az_http_request const* request)
+{
+#ifndef AZ_NO_METRICS
+  return request->_internal.metrics == NULL ? NULL : &request->_internal.metrics->_internal.metrics;
+#else
+  (void)request;
+  return NULL;
+#endif // AZ_NO_METRICS
+}
+
+/**
+ * @brief Gets the host (and port) of the url of \p request, which the policies keeping a state per
+ * host key it by.
+ */
+AZ_NODISCARD az_span _az_http_request_get_host(az_http_request const* request);
+
+/**
+ * @brief Gets the part of the state buffer that the copy of \p request doesn't use, which the
+ * transport adapter can use for its own data while \p request is in flight.
+ *
+ * @return The unused end of the buffer, empty if the buffer can't hold the copy of \p request.
+ */
+AZ_NODISCARD az_span
+_az_http_async_state_get_scratch(_az_http_async_state const* state, az_http_request const* request);
+
+/**
+ * @brief Called by a policy that got #AZ_HTTP_REQUEST_PENDING from the next policies. Copies
+ * \p request into \p ref_state and records that \p process has to be called again with
+ * \p ref_policies and \p ref_options once the response is received.
+ *
+ * @return #AZ_HTTP_REQUEST_PENDING, or #AZ_ERROR_INSUFFICIENT_SPAN_SIZE if the state buffer can't
+ * hold the request.
+ */
+AZ_NODISCARD az_result _az_http_async_state_suspend(
+    _az_http_async_state* ref_state,
+    _az_http_policy* ref_policies,
+    _az_http_policy_process_fn process,
+    void* ref_options,
+    az_http_request const* request);
+
+/**
+ * @brief Called by the asynchronous transport adapter when it is reached while a policy is being
+ * resumed. Takes the result of the request that was sent.
+ *
+ * @return `true` if there was a result to take, `false` if the request has to be sent.
+ */
+AZ_NODISCARD bool _az_http_async_state_take_result(
+    _az_http_async_state* ref_state,
+    az_result* out_result);
+
+/**
+ * @brief Called by the asynchronous transport adapter once the response of a request has been
+ * written into \p ref_response. Resumes the suspended policy, if any.
+ *
+ * @param[in] ref_state The state of the request.
+ * @param[in] result The result of sending the request.
+ * @param[in] ref_response The response of the request.
+ *
+ * @return The final result of the request, or #AZ_HTTP_REQUEST_PENDING if it was sent again.
+ */
+AZ_NODISCARD az_result _az_http_async_state_complete(
+    _az_http_async_state* ref_state,
+    az_result result,
+    az_http_response* ref_response);
+
 #include <azure/core/_az_cfg_suffix.h>
 
 #endif // _az_HTTP_INTERNAL_H
@@ -0,0 +1,33 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#ifndef _az_METRICS_INTERNAL_H
+#define _az_METRICS_INTERNAL_H
+
+#include <azure/core/az_metrics.h>
+
+#include <stdbool.h>
+
+#include <azure/core/_az_cfg_prefix.h>
+
+// Requests are only measured when a callback or a histogram is set.
+
+#ifndef AZ_NO_METRICS
+
+bool _az_metrics_should_write();
+void _az_metrics_write(az_http_metrics const* metrics);
+
+#define _az_METRICS_SHOULD_WRITE() _az_metrics_should_write()
+#define _az_METRICS_WRITE(metrics) _az_metrics_write(metrics)
+
+#else
+
+#define _az_METRICS_SHOULD_WRITE() false
+
+#define _az_METRICS_WRITE(metrics)
+
+#endif // AZ_NO_METRICS
+
+#include <azure/core/_az_cfg_suffix.h>
+
+#endif // _az_METRICS_INTERNAL_H
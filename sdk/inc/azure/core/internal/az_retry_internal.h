@@ -20,6 +20,33 @@ AZ_NODISCARD AZ_INLINE int32_t _az_retry_calc_delay(
                                                         : exponential_retry_after;
 }
 
+/*
+ * Decorrelated jitter: the delay is a random value between retry_delay_msec and three times the
+ * previous delay, capped at max_retry_delay_msec. random is a uniformly distributed value, used
+ * modulo the size of that range. previous_delay_msec is 0 before the first retry.
+ */
+AZ_NODISCARD AZ_INLINE int32_t _az_retry_calc_decorrelated_delay(
+    int32_t previous_delay_msec,
+    int32_t retry_delay_msec,
+    int32_t max_retry_delay_msec,
+    uint32_t random)
+{
+  int64_t upper = (int64_t)(previous_delay_msec > retry_delay_msec ? previous_delay_msec
+                                                                   : retry_delay_msec)
+      * 3;
+  if (upper > max_retry_delay_msec)
+  {
+    upper = max_retry_delay_msec;
+  }
+
+  if (upper <= retry_delay_msec)
+  {
+    return upper > 0 ? (int32_t)upper : 0;
+  }
+
+  return retry_delay_msec + (int32_t)(random % (uint32_t)(upper - retry_delay_msec + 1));
+}
+
 #include <azure/core/_az_cfg_suffix.h>
 
 #endif // _az_RETRY_INTERNAL_H
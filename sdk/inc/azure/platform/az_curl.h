@@ -0,0 +1,288 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file az_curl.h
+ *
+ * @brief This header defines the functions your application uses to configure the libcurl HTTP
+ * transport adapter (`az_curl`).
+ *
+ * @note You MUST NOT use any symbols (macros, functions, structures, enums, etc.)
+ * prefixed with an underscore ('_') directly in your application code. These symbols
+ * are part of Azure SDK's internal implementation; we do not document these symbols
+ * and they are subject to change in future versions of the SDK which would break your code.
+ */
+
+#ifndef _az_CURL_H
+#define _az_CURL_H
+
+#include <azure/core/az_context.h>
+#include <azure/core/az_http.h>
+#include <azure/core/az_http_transport.h>
+#include <azure/core/az_result.h>
+#include <azure/core/az_span.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <azure/core/_az_cfg_prefix.h>
+
+/**
+ * @brief The HTTP version the libcurl HTTP transport adapter uses.
+ */
+typedef enum
+{
+  AZ_HTTP_CLIENT_CURL_HTTP_VERSION_1_1 = 0, ///< HTTP/1.1 (default).
+
+  /// HTTP/2 over TLS, negotiated with ALPN. Falls back to HTTP/1.1 if the server doesn't support
+  /// it, and for `http://` urls. Concurrent requests sent through an #az_http_client_curl_async
+  /// driver to the same host are multiplexed over a single connection.
+  AZ_HTTP_CLIENT_CURL_HTTP_VERSION_2 = 1,
+
+  /// HTTP/2 without negotiation, including for `http://` urls (h2c). Only use it for servers known
+  /// to support HTTP/2, e.g. local test servers.
+  AZ_HTTP_CLIENT_CURL_HTTP_VERSION_2_PRIOR_KNOWLEDGE = 2,
+} az_http_client_curl_http_version;
+
+/**
+ * @brief Allows you to customize the libcurl HTTP transport adapter.
+ *
+ * @details The adapter keeps a small pool of libcurl handles, one per host, so that consecutive
+ * requests to the same host reuse an already established TCP and TLS connection. Use
+ * #az_http_client_curl_options_default to get an initialized instance of this struct.
+ */
+typedef struct
+{
+  /// Time in milliseconds an idle pooled connection is kept alive before it is closed.
+  int32_t max_idle_connection_msec;
+
+  /// Maximum lifetime in milliseconds of a pooled connection, idle or not. Once reached, the
+  /// connection is closed after its current request completes. `0` means no limit.
+  int32_t max_connection_age_msec;
+
+  /// The HTTP version to use.
+  az_http_client_curl_http_version http_version;
+
+  /// Asks for gzip or deflate compressed responses (`Accept-Encoding: gzip, deflate`), which
+  /// libcurl inflates before they are written to the #az_http_response buffer. The buffer must fit
+  /// the inflated body. The `Content-Encoding` and `Content-Length` headers of the response are
+  /// the ones sent by the server.
+  bool decompress_responses;
+} az_http_client_curl_options;
+
+/**
+ * @brief Gets the default libcurl HTTP transport adapter options.
+ *
+ * @details Call this to obtain an initialized #az_http_client_curl_options structure that can be
+ * modified and passed to #az_http_client_curl_set_options().
+ *
+ * @return The default #az_http_client_curl_options.
+ */
+AZ_NODISCARD az_http_client_curl_options az_http_client_curl_options_default();
+
+/**
+ * @brief Sets the options used by the libcurl HTTP transport adapter.
+ *
+ * @remarks Calling this function is optional, the adapter uses
+ * #az_http_client_curl_options_default otherwise. It is not thread-safe, call it before sending
+ * any HTTP request.
+ *
+ * @param[in] options __[nullable]__ A reference to an #az_http_client_curl_options structure. If
+ * `NULL` is passed, the default options are used.
+ *
+ * @return An #az_result value indicating the result of the operation:
+ *         - #AZ_OK if successful
+ *         - #AZ_ERROR_ARG if any of the \p options values is negative or unknown
+ *         - #AZ_ERROR_NOT_SUPPORTED if HTTP/2 is requested but libcurl was built without it
+ *         - #AZ_ERROR_NOT_SUPPORTED if \p options ask for compressed responses but libcurl was
+ *           built without zlib
+ */
+AZ_NODISCARD az_result az_http_client_curl_set_options(az_http_client_curl_options const* options);
+
+/**
+ * @brief Closes all the pooled connections and releases the libcurl handles owned by the
+ * adapter.
+ *
+ * @remarks Call this function once there are no HTTP requests in flight, and before calling
+ * `curl_global_cleanup()`. The adapter can still be used afterwards, it will create new
+ * connections as needed.
+ */
+void az_http_client_curl_cleanup();
+
+/**
+ * @brief Drives many HTTP requests concurrently from a single thread, using the libcurl multi
+ * interface.
+ *
+ * @details Bind a request to the driver by sending it with the context of an
+ * #az_http_client_curl_async_operation (see #az_http_client_curl_async_operation_get_context). The
+ * SDK function sending the request (e.g. `az_storage_blobs_blob_upload()`) returns
+ * #AZ_HTTP_REQUEST_PENDING right away, and the request goes through the same policies as a
+ * synchronous one (including retries) while #az_http_client_curl_async_perform is called. Requests
+ * sent by the same driver share its connections.
+ *
+ * A driver is not thread-safe: use it, and send the requests bound to it, from a single thread.
+ */
+typedef struct az_http_client_curl_async az_http_client_curl_async;
+
+/**
+ * @brief The state of one HTTP request sent through an #az_http_client_curl_async driver.
+ */
+typedef struct az_http_client_curl_async_operation az_http_client_curl_async_operation;
+
+/**
+ * @brief Called by #az_http_client_curl_async_perform when an operation is complete.
+ *
+ * @param[in] operation The operation that completed. It can be initialized and used again.
+ * @param[in] result The result that the SDK function sending the request would have returned if
+ * it had been sent synchronously. If it is #AZ_OK, the response has been written to the
+ * #az_http_response passed to that function.
+ * @param[in] user_context The user context passed to #az_http_client_curl_async_operation_init.
+ */
+typedef void (*az_http_client_curl_async_callback)(
+    az_http_client_curl_async_operation* operation,
+    az_result result,
+    void* user_context);
+
+/**
+ * @brief The body of a request being uploaded, read by libcurl as it sends it.
+ */
+typedef struct
+{
+  struct
+  {
+    az_http_body_source source;
+    int64_t offset; // Position of the next byte to send.
+    az_result read_result; // The error that aborted the upload, set by the read callback.
+  } _internal;
+} _az_http_client_curl_upload;
+
+/**
+ * @brief The header list of a request being sent.
+ */
+typedef struct
+{
+  struct
+  {
+    void* list; // struct curl_slist*
+    bool is_allocated; // By libcurl, rather than laid out in a scratch buffer.
+  } _internal;
+} _az_http_client_curl_headers;
+
+struct az_http_client_curl_async
+{
+  struct
+  {
+    void* multi;
+    az_http_client_curl_async_operation* operations;
+    int32_t operations_count;
+  } _internal;
+};
+
+struct az_http_client_curl_async_operation
+{
+  struct
+  {
+    _az_http_async_state state; // Must be the first member.
+    az_http_client_curl_async* async;
+    az_http_client_curl_async_callback callback;
+    void* user_context;
+    az_http_response* response;
+    void* curl;
+    _az_http_client_curl_headers headers;
+    _az_http_client_curl_upload upload;
+    az_http_client_curl_async_operation* next;
+    bool is_in_flight;
+    bool is_transferring;
+  } _internal;
+};
+
+/**
+ * @brief Initializes an #az_http_client_curl_async driver.
+ *
+ * @param[out] out_async The driver to initialize.
+ *
+ * @return An #az_result value indicating the result of the operation:
+ *         - #AZ_OK if successful
+ *         - #AZ_ERROR_HTTP_PLATFORM if libcurl couldn't create a multi handle
+ */
+AZ_NODISCARD az_result az_http_client_curl_async_init(az_http_client_curl_async* out_async);
+
+/**
+ * @brief Cancels the operations still in flight, calling their callback with #AZ_ERROR_CANCELED,
+ * and releases the resources of the driver.
+ *
+ * @param[in] ref_async The driver to clean up.
+ */
+void az_http_client_curl_async_cleanup(az_http_client_curl_async* ref_async);
+
+/**
+ * @brief Initializes an operation, to send one request through \p async.
+ *
+ * @remarks The operation, the \p buffer, the request body and the #az_http_response passed to the
+ * SDK function must stay valid, and must not be moved, until \p callback is called.
+ *
+ * @param[out] out_operation The operation to initialize.
+ * @param[in] async The driver the request is sent through.
+ * @param[in] parent __[nullable]__ The parent of the operation context, it can be used to cancel
+ * the request or to set its deadline. `NULL` means #az_context_application.
+ * @param[in] buffer Buffer where the url and headers of the request are kept while it is in
+ * flight, so that retries can be sent after the SDK function returned. It needs to hold the url,
+ * the headers and the header table of the request (e.g. #AZ_HTTP_REQUEST_URL_BUFFER_SIZE plus 1KB).
+ * The url and the header list given to libcurl are laid out in the rest of it, they are allocated
+ * if they don't fit.
+ * @param[in] callback The function called when the operation is complete.
+ * @param[in] user_context __[nullable]__ A value passed to \p callback.
+ *
+ * @return #AZ_OK.
+ */
+AZ_NODISCARD az_result az_http_client_curl_async_operation_init(
+    az_http_client_curl_async_operation* out_operation,
+    az_http_client_curl_async* async,
+    az_context const* parent,
+    az_span buffer,
+    az_http_client_curl_async_callback callback,
+    void* user_context);
+
+/**
+ * @brief Gets the context to pass to the SDK function that sends the request of \p operation.
+ *
+ * @param[in] operation The operation.
+ *
+ * @return The context that binds the request to \p operation.
+ */
+AZ_NODISCARD az_context* az_http_client_curl_async_operation_get_context(
+    az_http_client_curl_async_operation* operation);
+
+/**
+ * @brief Runs the transfers of the operations in flight, calling the callback of the ones that
+ * complete.
+ *
+ * @details Waits up to \p timeout_msec for network activity, or for a retry to be due. Call it in
+ * a loop until \p out_operations_count is `0`. New requests can be sent, including from a callback,
+ * between calls.
+ *
+ * @param[in] ref_async The driver.
+ * @param[in] timeout_msec Maximum time to wait for activity, `0` not to wait.
+ * @param[out] out_operations_count The number of operations still in flight.
+ *
+ * @return An #az_result value indicating the result of the operation:
+ *         - #AZ_OK if successful, the result of each request is given to its callback
+ *         - #AZ_ERROR_HTTP_PLATFORM if libcurl failed to run the transfers
+ */
+AZ_NODISCARD az_result az_http_client_curl_async_perform(
+    az_http_client_curl_async* ref_async,
+    int32_t timeout_msec,
+    int32_t* out_operations_count);
+
+#ifdef _az_MOCK_ENABLED
+/**
+ * @brief Gets the number of heap allocations the adapter made since the process started. The url
+ * and the headers of a request are laid out in a scratch buffer, they are only allocated when they
+ * don't fit in it. The allocations made by libcurl itself are not counted. Only built for tests.
+ */
+AZ_NODISCARD int64_t _az_http_client_curl_get_allocation_count();
+#endif // _az_MOCK_ENABLED
+
+#include <azure/core/_az_cfg_suffix.h>
+
+#endif // _az_CURL_H
@@ -40,6 +40,11 @@ static az_span const AZ_STORAGE_API_VERSION = AZ_SPAN_LITERAL_FROM_STR("2019-02-
 typedef struct
 {
   az_http_policy_retry_options retry_options; /**< Optional values used to override the default retry policy options **/
+  az_http_policy_hedging* hedging; /**< __[nullable]__ Hedging of the reads (e.g. #az_storage_blobs_blob_download), `NULL` (default) not to hedge them **/
+  az_http_policy_cache* cache; /**< __[nullable]__ Cache of the downloaded blobs, revalidated with conditional requests, `NULL` (default) not to cache them **/
+  az_http_policy_single_flight* single_flight; /**< __[nullable]__ Coalescing of identical concurrent reads, `NULL` (default) not to coalesce them **/
+  az_http_policy_bulkhead* bulkhead; /**< __[nullable]__ Bound on the requests in flight to each host, `NULL` (default) not to bound them **/
+  az_http_policy_compression* compression; /**< __[nullable]__ Gzip compression of the uploaded blobs, stored with `Content-Encoding: gzip`, `NULL` (default) not to compress them **/
   struct
   {
     _az_http_policy_apiversion_options api_version;
@@ -142,6 +147,79 @@ AZ_NODISCARD az_result az_storage_blobs_blob_upload(
     az_storage_blobs_blob_upload_options* options,
     az_http_response* response);
 
+/**
+ * @brief Uploads content that is read as it is sent to blob storage, e.g. a file larger than the
+ * available memory.
+ *
+ * @param client A storage blobs client structure.
+ * @param context Supports cancelling long running operations.
+ * @param content_source The blob content to upload. It is read again from its start if the upload
+ * is retried.
+ * @param options __[nullable]__ A reference to an #az_storage_blobs_blob_upload_options
+ * structure which defines custom behavior for uploading the blob. If `NULL` is passed, the client
+ * will use the default options (i.e. #az_storage_blobs_blob_upload_options_default()).
+ * @param response A pre-allocated buffer where to write HTTP response into.
+ *
+ * @return An #az_result value indicating the result of the operation:
+ *         - #AZ_OK if successful
+ */
+AZ_NODISCARD az_result az_storage_blobs_blob_upload_from_source(
+    az_storage_blobs_blob_client* client,
+    az_context* context,
+    az_http_body_source const* content_source,
+    az_storage_blobs_blob_upload_options* options,
+    az_http_response* response);
+
+/**
+ * @brief Azure Storage Blobs Blob download options.
+ * @remark Reserved for future use
+ */
+typedef struct
+{
+  struct
+  {
+    az_span unused;
+  } _internal;
+} az_storage_blobs_blob_download_options;
+
+/**
+ * @brief Gets the default blob download options
+ *
+ * @details Call this to obtain an initialized #az_storage_blobs_blob_download_options structure
+ *
+ * @remark Use this, for instance, when only caring about setting one option by calling this method
+ * and then overriding that specific option.
+ *
+ */
+AZ_NODISCARD AZ_INLINE az_storage_blobs_blob_download_options
+az_storage_blobs_blob_download_options_default()
+{
+  return (az_storage_blobs_blob_download_options){ ._internal = { .unused = AZ_SPAN_NULL } };
+}
+
+/**
+ * @brief Downloads the contents of a blob.
+ *
+ * @details The blob content is the body of \p response. To download a blob larger than the
+ * \p response buffer, set a body callback with #az_http_response_set_body_callback, which receives
+ * the content as it is downloaded.
+ *
+ * @param client A storage blobs client structure.
+ * @param context Supports cancelling long running operations.
+ * @param options __[nullable]__ A reference to an #az_storage_blobs_blob_download_options
+ * structure which defines custom behavior for downloading the blob. If `NULL` is passed, the client
+ * will use the default options (i.e. #az_storage_blobs_blob_download_options_default()).
+ * @param response A pre-allocated buffer where to write HTTP response into.
+ *
+ * @return An #az_result value indicating the result of the operation:
+ *         - #AZ_OK if successful
+ */
+AZ_NODISCARD az_result az_storage_blobs_blob_download(
+    az_storage_blobs_blob_client* client,
+    az_context* context,
+    az_storage_blobs_blob_download_options* options,
+    az_http_response* response);
+
 #include <azure/core/_az_cfg_suffix.h>
 
 #endif // _az_STORAGE_BLOBS_H
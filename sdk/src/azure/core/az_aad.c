@@ -82,43 +82,16 @@ AZ_NODISCARD static az_result _az_parse_json_payload(
   az_json_reader jr;
   AZ_RETURN_IF_FAILED(az_json_reader_init(&jr, body, NULL));
 
-  AZ_RETURN_IF_FAILED(az_json_reader_next_token(&jr));
-  if (jr.token.kind != AZ_JSON_TOKEN_BEGIN_OBJECT)
-  {
-    return AZ_ERROR_UNEXPECTED_CHAR;
-  }
-
-  bool found_expires_in = false;
-  bool found_access_token = false;
-
-  AZ_RETURN_IF_FAILED(az_json_reader_next_token(&jr));
-
-  while (jr.token.kind != AZ_JSON_TOKEN_END_OBJECT)
-  {
-    if (az_json_token_is_text_equal(&jr.token, AZ_SPAN_FROM_STR("expires_in")))
-    {
-      AZ_RETURN_IF_FAILED(az_json_reader_next_token(&jr));
-      AZ_RETURN_IF_FAILED(az_json_token_get_int64(&jr.token, expires_in_seconds));
-      found_expires_in = true;
-    }
-    else if (az_json_token_is_text_equal(&jr.token, AZ_SPAN_FROM_STR("access_token")))
-    {
-      AZ_RETURN_IF_FAILED(az_json_reader_next_token(&jr));
-      *json_access_token = jr.token;
-      found_access_token = true;
-    }
-    else
-    {
-      // ignore other tokens
-      AZ_RETURN_IF_FAILED(az_json_reader_skip_children(&jr));
-    }
-    AZ_RETURN_IF_FAILED(az_json_reader_next_token(&jr));
-  }
+  az_span const paths[] = {
+    AZ_SPAN_LITERAL_FROM_STR("/expires_in"),
+    AZ_SPAN_LITERAL_FROM_STR("/access_token"),
+  };
+  az_json_token values[sizeof(paths) / sizeof(paths[0])];
+  AZ_RETURN_IF_FAILED(
+      az_json_reader_find_paths(&jr, paths, sizeof(paths) / sizeof(paths[0]), values));
 
-  if (!found_expires_in || !found_access_token)
-  {
-    return AZ_ERROR_ITEM_NOT_FOUND;
-  }
+  AZ_RETURN_IF_FAILED(az_json_token_get_int64(&values[0], expires_in_seconds));
+  *json_access_token = values[1];
 
   return AZ_OK;
 }
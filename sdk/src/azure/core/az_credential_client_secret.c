@@ -66,8 +66,11 @@ static AZ_NODISCARD az_result _az_credential_client_secret_apply_policy(
 
   if (_az_token_expired(&token))
   {
-    AZ_RETURN_IF_FAILED(_az_credential_client_secret_request_token(
-        credential, ref_request->_internal.context, &token));
+    // The token is needed before the request can be sent, so get it synchronously even when the
+    // request itself is sent asynchronously.
+    az_context token_context = _az_http_context_create_synchronous(ref_request->_internal.context);
+    AZ_RETURN_IF_FAILED(
+        _az_credential_client_secret_request_token(credential, &token_context, &token));
 
     AZ_RETURN_IF_FAILED(
         _az_credential_token_set_token(&credential->_internal.token_credential, &token));
@@ -0,0 +1,708 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "az_deflate_private.h"
+#include <azure/core/internal/az_precondition_internal.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <azure/core/_az_cfg.h>
+
+enum
+{
+  _az_DEFLATE_HASH_BITS = 12,
+  _az_DEFLATE_MIN_MATCH = 3,
+  _az_DEFLATE_MAX_MATCH = 258,
+  _az_DEFLATE_WINDOW_SIZE = 32768,
+  _az_DEFLATE_END_OF_BLOCK = 256,
+};
+
+// CRC-32 of each byte value.
+static uint32_t const _az_crc32_table[256] = {
+  0x00000000, 0x77073096, 0xEE0E612C, 0x990951BA, 0x076DC419, 0x706AF48F, 0xE963A535, 0x9E6495A3,
+  0x0EDB8832, 0x79DCB8A4, 0xE0D5E91E, 0x97D2D988, 0x09B64C2B, 0x7EB17CBD, 0xE7B82D07, 0x90BF1D91,
+  0x1DB71064, 0x6AB020F2, 0xF3B97148, 0x84BE41DE, 0x1ADAD47D, 0x6DDDE4EB, 0xF4D4B551, 0x83D385C7,
+  0x136C9856, 0x646BA8C0, 0xFD62F97A, 0x8A65C9EC, 0x14015C4F, 0x63066CD9, 0xFA0F3D63, 0x8D080DF5,
+  0x3B6E20C8, 0x4C69105E, 0xD56041E4, 0xA2677172, 0x3C03E4D1, 0x4B04D447, 0xD20D85FD, 0xA50AB56B,
+  0x35B5A8FA, 0x42B2986C, 0xDBBBC9D6, 0xACBCF940, 0x32D86CE3, 0x45DF5C75, 0xDCD60DCF, 0xABD13D59,
+  0x26D930AC, 0x51DE003A, 0xC8D75180, 0xBFD06116, 0x21B4F4B5, 0x56B3C423, 0xCFBA9599, 0xB8BDA50F,
+  0x2802B89E, 0x5F058808, 0xC60CD9B2, 0xB10BE924, 0x2F6F7C87, 0x58684C11, 0xC1611DAB, 0xB6662D3D,
+  0x76DC4190, 0x01DB7106, 0x98D220BC, 0xEFD5102A, 0x71B18589, 0x06B6B51F, 0x9FBFE4A5, 0xE8B8D433,
+  0x7807C9A2, 0x0F00F934, 0x9609A88E, 0xE10E9818, 0x7F6A0DBB, 0x086D3D2D, 0x91646C97, 0xE6635C01,
+  0x6B6B51F4, 0x1C6C6162, 0x856530D8, 0xF262004E, 0x6C0695ED, 0x1B01A57B, 0x8208F4C1, 0xF50FC457,
+  0x65B0D9C6, 0x12B7E950, 0x8BBEB8EA, 0xFCB9887C, 0x62DD1DDF, 0x15DA2D49, 0x8CD37CF3, 0xFBD44C65,
+  0x4DB26158, 0x3AB551CE, 0xA3BC0074, 0xD4BB30E2, 0x4ADFA541, 0x3DD895D7, 0xA4D1C46D, 0xD3D6F4FB,
+  0x4369E96A, 0x346ED9FC, 0xAD678846, 0xDA60B8D0, 0x44042D73, 0x33031DE5, 0xAA0A4C5F, 0xDD0D7CC9,
+  0x5005713C, 0x270241AA, 0xBE0B1010, 0xC90C2086, 0x5768B525, 0x206F85B3, 0xB966D409, 0xCE61E49F,
+  0x5EDEF90E, 0x29D9C998, 0xB0D09822, 0xC7D7A8B4, 0x59B33D17, 0x2EB40D81, 0xB7BD5C3B, 0xC0BA6CAD,
+  0xEDB88320, 0x9ABFB3B6, 0x03B6E20C, 0x74B1D29A, 0xEAD54739, 0x9DD277AF, 0x04DB2615, 0x73DC1683,
+  0xE3630B12, 0x94643B84, 0x0D6D6A3E, 0x7A6A5AA8, 0xE40ECF0B, 0x9309FF9D, 0x0A00AE27, 0x7D079EB1,
+  0xF00F9344, 0x8708A3D2, 0x1E01F268, 0x6906C2FE, 0xF762575D, 0x806567CB, 0x196C3671, 0x6E6B06E7,
+  0xFED41B76, 0x89D32BE0, 0x10DA7A5A, 0x67DD4ACC, 0xF9B9DF6F, 0x8EBEEFF9, 0x17B7BE43, 0x60B08ED5,
+  0xD6D6A3E8, 0xA1D1937E, 0x38D8C2C4, 0x4FDFF252, 0xD1BB67F1, 0xA6BC5767, 0x3FB506DD, 0x48B2364B,
+  0xD80D2BDA, 0xAF0A1B4C, 0x36034AF6, 0x41047A60, 0xDF60EFC3, 0xA867DF55, 0x316E8EEF, 0x4669BE79,
+  0xCB61B38C, 0xBC66831A, 0x256FD2A0, 0x5268E236, 0xCC0C7795, 0xBB0B4703, 0x220216B9, 0x5505262F,
+  0xC5BA3BBE, 0xB2BD0B28, 0x2BB45A92, 0x5CB36A04, 0xC2D7FFA7, 0xB5D0CF31, 0x2CD99E8B, 0x5BDEAE1D,
+  0x9B64C2B0, 0xEC63F226, 0x756AA39C, 0x026D930A, 0x9C0906A9, 0xEB0E363F, 0x72076785, 0x05005713,
+  0x95BF4A82, 0xE2B87A14, 0x7BB12BAE, 0x0CB61B38, 0x92D28E9B, 0xE5D5BE0D, 0x7CDCEFB7, 0x0BDBDF21,
+  0x86D3D2D4, 0xF1D4E242, 0x68DDB3F8, 0x1FDA836E, 0x81BE16CD, 0xF6B9265B, 0x6FB077E1, 0x18B74777,
+  0x88085AE6, 0xFF0F6A70, 0x66063BCA, 0x11010B5C, 0x8F659EFF, 0xF862AE69, 0x616BFFD3, 0x166CCF45,
+  0xA00AE278, 0xD70DD2EE, 0x4E048354, 0x3903B3C2, 0xA7672661, 0xD06016F7, 0x4969474D, 0x3E6E77DB,
+  0xAED16A4A, 0xD9D65ADC, 0x40DF0B66, 0x37D83BF0, 0xA9BCAE53, 0xDEBB9EC5, 0x47B2CF7F, 0x30B5FFE9,
+  0xBDBDF21C, 0xCABAC28A, 0x53B39330, 0x24B4A3A6, 0xBAD03605, 0xCDD70693, 0x54DE5729, 0x23D967BF,
+  0xB3667A2E, 0xC4614AB8, 0x5D681B02, 0x2A6F2B94, 0xB40BBE37, 0xC30C8EA1, 0x5A05DF1B, 0x2D02EF8D,
+};
+
+AZ_NODISCARD uint32_t _az_crc32(uint32_t crc, az_span data)
+{
+  uint8_t const* const ptr = az_span_ptr(data);
+  int32_t const size = az_span_size(data);
+
+  crc = ~crc;
+  for (int32_t i = 0; i < size; ++i)
+  {
+    crc = (crc >> 8) ^ _az_crc32_table[(crc ^ ptr[i]) & 0xFF];
+  }
+
+  return ~crc;
+}
+
+// Writes the bits of the deflate stream, least significant first, to the destination.
+typedef struct
+{
+  uint8_t* ptr;
+  int32_t size;
+  int32_t written;
+  uint64_t bits;
+  int32_t bits_count;
+  bool is_overflowed;
+} _az_deflate_writer;
+
+static void _az_deflate_write_bits(_az_deflate_writer* ref_writer, uint32_t bits, int32_t count)
+{
+  ref_writer->bits |= (uint64_t)bits << ref_writer->bits_count;
+  ref_writer->bits_count += count;
+
+  if (ref_writer->bits_count >= 32)
+  {
+    if (ref_writer->written + 4 > ref_writer->size)
+    {
+      ref_writer->is_overflowed = true;
+      ref_writer->bits_count = 0;
+      return;
+    }
+
+    for (int32_t i = 0; i < 4; ++i)
+    {
+      ref_writer->ptr[ref_writer->written++] = (uint8_t)(ref_writer->bits >> (8 * i));
+    }
+    ref_writer->bits >>= 32;
+    ref_writer->bits_count -= 32;
+  }
+}
+
+// Writes the last bits, padded to a byte.
+static void _az_deflate_flush_bits(_az_deflate_writer* ref_writer)
+{
+  while (ref_writer->bits_count > 0 && !ref_writer->is_overflowed)
+  {
+    if (ref_writer->written == ref_writer->size)
+    {
+      ref_writer->is_overflowed = true;
+      return;
+    }
+
+    ref_writer->ptr[ref_writer->written++] = (uint8_t)ref_writer->bits;
+    ref_writer->bits >>= 8;
+    ref_writer->bits_count -= 8;
+  }
+  ref_writer->bits_count = 0;
+}
+
+// Huffman codes are written most significant bit first.
+static uint32_t _az_deflate_reverse_bits(uint32_t code, int32_t count)
+{
+  uint32_t reversed = 0;
+  for (int32_t i = 0; i < count; ++i)
+  {
+    reversed = (reversed << 1) | ((code >> i) & 1);
+  }
+
+  return reversed;
+}
+
+// Gets the index of the highest bit set of value, which isn't 0.
+static int32_t _az_deflate_log2(uint32_t value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+  return 31 - __builtin_clz(value);
+#else
+  int32_t log = 0;
+  while (value >>= 1)
+  {
+    ++log;
+  }
+
+  return log;
+#endif
+}
+
+// The symbols of a block: literals and lengths, distances, and the lengths of their codes in the
+// header of a block with dynamic codes.
+enum
+{
+  _az_DEFLATE_LENGTHS_COUNT = 286,
+  _az_DEFLATE_FIXED_LENGTHS_COUNT = 288, // The fixed code has 2 more, that are never used.
+  _az_DEFLATE_DISTANCES_COUNT = 30,
+  _az_DEFLATE_CODE_LENGTHS_COUNT = 19,
+  _az_DEFLATE_MAX_CODE_SIZE = 15,
+  _az_DEFLATE_MAX_CODE_LENGTH_CODE_SIZE = 7,
+};
+
+// The order the lengths of the code length codes are written in (RFC 1951, 3.2.7).
+static uint8_t const _az_deflate_code_length_order[_az_DEFLATE_CODE_LENGTHS_COUNT]
+    = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+
+// The codes of a block, bit-reversed and shifted left by 4, with their size in the low 4 bits. The
+// tokens of the block are counted, to choose its codes, or written with them.
+typedef struct
+{
+  _az_deflate_writer* writer; // NULL while the tokens are counted.
+  uint32_t literal_counts[_az_DEFLATE_LENGTHS_COUNT];
+  uint32_t distance_counts[_az_DEFLATE_DISTANCES_COUNT];
+  uint32_t literal_codes[_az_DEFLATE_FIXED_LENGTHS_COUNT];
+  uint32_t distance_codes[_az_DEFLATE_DISTANCES_COUNT];
+} _az_deflate_block;
+
+static void _az_deflate_write_code(_az_deflate_writer* ref_writer, uint32_t code)
+{
+  _az_deflate_write_bits(ref_writer, code >> 4, (int32_t)(code & 0x0F));
+}
+
+static void _az_deflate_emit_literal(_az_deflate_block* ref_block, int32_t symbol)
+{
+  if (ref_block->writer == NULL)
+  {
+    ++ref_block->literal_counts[symbol];
+  }
+  else
+  {
+    _az_deflate_write_code(ref_block->writer, ref_block->literal_codes[symbol]);
+  }
+}
+
+// Emits a match of length bytes, distance bytes back.
+static void _az_deflate_emit_match(_az_deflate_block* ref_block, int32_t length, int32_t distance)
+{
+  // Lengths 3 to 10 have a symbol each, then each 4 symbols double the range they cover.
+  uint32_t const length_value = (uint32_t)(length - _az_DEFLATE_MIN_MATCH);
+  int32_t length_symbol = 285;
+  int32_t length_extra_count = 0;
+  uint32_t length_extra = 0;
+  if (length_value < 8)
+  {
+    length_symbol = 257 + (int32_t)length_value;
+  }
+  else if (length != _az_DEFLATE_MAX_MATCH)
+  {
+    length_extra_count = _az_deflate_log2(length_value) - 2;
+    uint32_t const high_bits = (length_value >> length_extra_count) & 3;
+    length_symbol = 261 + 4 * length_extra_count + (int32_t)high_bits;
+    length_extra = length_value - ((4 | high_bits) << length_extra_count);
+  }
+
+  // Distances 1 to 4 have a symbol each, then each 2 symbols double the range they cover.
+  uint32_t const distance_value = (uint32_t)(distance - 1);
+  int32_t distance_symbol = (int32_t)distance_value;
+  int32_t distance_extra_count = 0;
+  uint32_t distance_extra = 0;
+  if (distance_value >= 4)
+  {
+    distance_extra_count = _az_deflate_log2(distance_value) - 1;
+    uint32_t const high_bit = (distance_value >> distance_extra_count) & 1;
+    distance_symbol = 2 * distance_extra_count + 2 + (int32_t)high_bit;
+    distance_extra = distance_value - ((2 | high_bit) << distance_extra_count);
+  }
+
+  if (ref_block->writer == NULL)
+  {
+    ++ref_block->literal_counts[length_symbol];
+    ++ref_block->distance_counts[distance_symbol];
+    return;
+  }
+
+  _az_deflate_write_code(ref_block->writer, ref_block->literal_codes[length_symbol]);
+  _az_deflate_write_bits(ref_block->writer, length_extra, length_extra_count);
+  _az_deflate_write_code(ref_block->writer, ref_block->distance_codes[distance_symbol]);
+  _az_deflate_write_bits(ref_block->writer, distance_extra, distance_extra_count);
+}
+
+static uint32_t _az_deflate_hash(uint8_t const* ptr)
+{
+  uint32_t const sequence = (uint32_t)ptr[0] | ((uint32_t)ptr[1] << 8) | ((uint32_t)ptr[2] << 16);
+  return (sequence * 2654435761U) >> (32 - _az_DEFLATE_HASH_BITS);
+}
+
+// Gets how many bytes at ptr and at match are the same, up to max_length.
+static int32_t
+_az_deflate_match_length(uint8_t const* ptr, uint8_t const* match, int32_t max_length)
+{
+  int32_t length = 0;
+
+  // Compare 8 bytes at a time, then find the first different one.
+  while (length + 8 <= max_length)
+  {
+    uint64_t a = 0;
+    uint64_t b = 0;
+    memcpy(&a, ptr + length, sizeof(a));
+    memcpy(&b, match + length, sizeof(b));
+    if (a != b)
+    {
+      break;
+    }
+    length += 8;
+  }
+
+  while (length < max_length && ptr[length] == match[length])
+  {
+    ++length;
+  }
+
+  return length;
+}
+
+// Emits source as literals and matches (LZ77). The matches found are the same each time.
+static void _az_deflate_emit_tokens(
+    _az_deflate_encoder* ref_encoder,
+    _az_deflate_block* ref_block,
+    az_span source)
+{
+  uint8_t const* const ptr = az_span_ptr(source);
+  int32_t const size = az_span_size(source);
+  int32_t* const head = ref_encoder->_internal.head;
+
+  for (int32_t i = 0; i < _az_DEFLATE_HASH_SIZE; ++i)
+  {
+    head[i] = -1;
+  }
+
+  int32_t position = 0;
+  while (position + _az_DEFLATE_MIN_MATCH <= size
+         && (ref_block->writer == NULL || !ref_block->writer->is_overflowed))
+  {
+    uint32_t const hash = _az_deflate_hash(ptr + position);
+    int32_t const candidate = head[hash];
+    head[hash] = position;
+
+    int32_t length = 0;
+    if (candidate >= 0 && position - candidate <= _az_DEFLATE_WINDOW_SIZE)
+    {
+      int32_t const max_length = size - position < _az_DEFLATE_MAX_MATCH ? size - position
+                                                                         : _az_DEFLATE_MAX_MATCH;
+      length = _az_deflate_match_length(ptr + position, ptr + candidate, max_length);
+    }
+
+    if (length < _az_DEFLATE_MIN_MATCH)
+    {
+      _az_deflate_emit_literal(ref_block, ptr[position]);
+      ++position;
+      continue;
+    }
+
+    _az_deflate_emit_match(ref_block, length, position - candidate);
+
+    // Remember the sequences inside the match, for the next matches.
+    int32_t const end = position + length;
+    for (++position; position < end && position + _az_DEFLATE_MIN_MATCH <= size; ++position)
+    {
+      head[_az_deflate_hash(ptr + position)] = position;
+    }
+    position = end;
+  }
+
+  for (; position < size; ++position)
+  {
+    _az_deflate_emit_literal(ref_block, ptr[position]);
+  }
+
+  _az_deflate_emit_literal(ref_block, _az_DEFLATE_END_OF_BLOCK);
+}
+
+// Sets the sizes of the Huffman codes of count symbols, up to max_size bits, from how often they
+// are used. Unused symbols have no code. There are always two codes at least, some decoders reject
+// a code with a single symbol.
+static void _az_deflate_build_code_sizes(
+    uint32_t const* counts,
+    int32_t count,
+    int32_t max_size,
+    uint8_t* out_sizes)
+{
+  uint32_t weights[_az_DEFLATE_LENGTHS_COUNT];
+  int32_t symbols[_az_DEFLATE_LENGTHS_COUNT];
+  int32_t used = 0;
+  for (int32_t i = 0; i < count; ++i)
+  {
+    out_sizes[i] = 0;
+    weights[i] = counts[i];
+    used += counts[i] > 0 ? 1 : 0;
+  }
+  for (int32_t i = 0; i < count && used < 2; ++i)
+  {
+    if (weights[i] == 0)
+    {
+      weights[i] = 1;
+      ++used;
+    }
+  }
+
+  used = 0;
+  for (int32_t i = 0; i < count; ++i)
+  {
+    if (weights[i] > 0)
+    {
+      symbols[used++] = i;
+    }
+  }
+
+  while (true)
+  {
+    // Sort the symbols by weight (insertion sort, the symbols are usually almost sorted).
+    for (int32_t i = 1; i < used; ++i)
+    {
+      int32_t const symbol = symbols[i];
+      int32_t j = i;
+      for (; j > 0 && weights[symbols[j - 1]] > weights[symbol]; --j)
+      {
+        symbols[j] = symbols[j - 1];
+      }
+      symbols[j] = symbol;
+    }
+
+    // Merge the two lightest nodes until one is left, the leaves and the nodes created are both
+    // in increasing weight order.
+    uint32_t node_weights[_az_DEFLATE_LENGTHS_COUNT];
+    int32_t node_parents[_az_DEFLATE_LENGTHS_COUNT];
+    int32_t leaf_parents[_az_DEFLATE_LENGTHS_COUNT];
+    int32_t leaf = 0;
+    int32_t node = 0;
+    for (int32_t created = 0; created < used - 1; ++created)
+    {
+      uint32_t weight = 0;
+      for (int32_t child = 0; child < 2; ++child)
+      {
+        if (leaf < used && (node == created || weights[symbols[leaf]] <= node_weights[node]))
+        {
+          weight += weights[symbols[leaf]];
+          leaf_parents[leaf++] = created;
+        }
+        else
+        {
+          weight += node_weights[node];
+          node_parents[node++] = created;
+        }
+      }
+      node_weights[created] = weight;
+    }
+
+    // The depth of each node, from the root (the last one created).
+    int32_t depths[_az_DEFLATE_LENGTHS_COUNT];
+    depths[used - 2] = 0;
+    for (int32_t i = used - 3; i >= 0; --i)
+    {
+      depths[i] = depths[node_parents[i]] + 1;
+    }
+
+    int32_t max_depth = 0;
+    for (int32_t i = 0; i < used; ++i)
+    {
+      int32_t const depth = depths[leaf_parents[i]] + 1;
+      out_sizes[symbols[i]] = (uint8_t)depth;
+      max_depth = depth > max_depth ? depth : max_depth;
+    }
+
+    if (max_depth <= max_size)
+    {
+      return;
+    }
+
+    // Flatten the weights until the codes are short enough.
+    for (int32_t i = 0; i < used; ++i)
+    {
+      weights[symbols[i]] = (weights[symbols[i]] >> 1) | 1;
+    }
+  }
+}
+
+// Sets the canonical Huffman codes of count symbols from their sizes (RFC 1951, 3.2.2).
+static void _az_deflate_build_codes(uint8_t const* sizes, int32_t count, uint32_t* out_codes)
+{
+  int32_t sizes_count[_az_DEFLATE_MAX_CODE_SIZE + 1] = { 0 };
+  for (int32_t i = 0; i < count; ++i)
+  {
+    ++sizes_count[sizes[i]];
+  }
+  sizes_count[0] = 0;
+
+  uint32_t next_codes[_az_DEFLATE_MAX_CODE_SIZE + 1] = { 0 };
+  uint32_t code = 0;
+  for (int32_t size = 1; size <= _az_DEFLATE_MAX_CODE_SIZE; ++size)
+  {
+    code = (code + (uint32_t)sizes_count[size - 1]) << 1;
+    next_codes[size] = code;
+  }
+
+  for (int32_t i = 0; i < count; ++i)
+  {
+    int32_t const size = sizes[i];
+    out_codes[i] = size == 0
+        ? 0
+        : (_az_deflate_reverse_bits(next_codes[size]++, size) << 4) | (uint32_t)size;
+  }
+}
+
+// The fixed codes (RFC 1951, 3.2.6).
+static void
+_az_deflate_build_fixed_code_sizes(uint8_t* out_literal_sizes, uint8_t* out_distance_sizes)
+{
+  for (int32_t symbol = 0; symbol < _az_DEFLATE_FIXED_LENGTHS_COUNT; ++symbol)
+  {
+    out_literal_sizes[symbol] = symbol < 144 ? 8 : symbol < 256 ? 9 : symbol < 280 ? 7 : 8;
+  }
+  for (int32_t symbol = 0; symbol < _az_DEFLATE_DISTANCES_COUNT; ++symbol)
+  {
+    out_distance_sizes[symbol] = 5;
+  }
+}
+
+static uint32_t _az_deflate_get_cost(uint32_t const* counts, uint8_t const* sizes, int32_t count)
+{
+  uint32_t cost = 0;
+  for (int32_t i = 0; i < count; ++i)
+  {
+    cost += counts[i] * sizes[i];
+  }
+
+  return cost;
+}
+
+// The sizes of the literal and distance codes, run-length encoded with the code length symbols
+// (RFC 1951, 3.2.7): each one has its extra bits value in the bits above the low 5 bits.
+typedef struct
+{
+  uint32_t tokens[_az_DEFLATE_LENGTHS_COUNT + _az_DEFLATE_DISTANCES_COUNT];
+  int32_t tokens_count;
+  uint32_t counts[_az_DEFLATE_CODE_LENGTHS_COUNT];
+} _az_deflate_code_lengths;
+
+static void _az_deflate_encode_code_sizes(
+    uint8_t const* sizes,
+    int32_t count,
+    _az_deflate_code_lengths* out_code_lengths)
+{
+  out_code_lengths->tokens_count = 0;
+  for (int32_t i = 0; i < _az_DEFLATE_CODE_LENGTHS_COUNT; ++i)
+  {
+    out_code_lengths->counts[i] = 0;
+  }
+
+  for (int32_t i = 0; i < count;)
+  {
+    int32_t run = 1;
+    while (i + run < count && sizes[i + run] == sizes[i])
+    {
+      ++run;
+    }
+
+    uint32_t token = sizes[i];
+    int32_t used = 1;
+    if (sizes[i] == 0 && run >= 11)
+    {
+      used = run < 138 ? run : 138;
+      token = 18 | ((uint32_t)(used - 11) << 5);
+    }
+    else if (sizes[i] == 0 && run >= 3)
+    {
+      used = run;
+      token = 17 | ((uint32_t)(used - 3) << 5);
+    }
+    else if (i > 0 && sizes[i] == sizes[i - 1] && run >= 3)
+    {
+      used = run < 6 ? run : 6;
+      token = 16 | ((uint32_t)(used - 3) << 5);
+    }
+
+    out_code_lengths->tokens[out_code_lengths->tokens_count++] = token;
+    ++out_code_lengths->counts[token & 0x1F];
+    i += used;
+  }
+}
+
+static void _az_deflate_write_dynamic_header(
+    _az_deflate_writer* ref_writer,
+    int32_t literals_count,
+    int32_t distances_count,
+    _az_deflate_code_lengths const* code_lengths,
+    uint8_t const* code_length_sizes,
+    int32_t code_length_sizes_count)
+{
+  uint32_t code_length_codes[_az_DEFLATE_CODE_LENGTHS_COUNT];
+  _az_deflate_build_codes(code_length_sizes, _az_DEFLATE_CODE_LENGTHS_COUNT, code_length_codes);
+
+  _az_deflate_write_bits(ref_writer, (uint32_t)(literals_count - 257), 5);
+  _az_deflate_write_bits(ref_writer, (uint32_t)(distances_count - 1), 5);
+  _az_deflate_write_bits(ref_writer, (uint32_t)(code_length_sizes_count - 4), 4);
+  for (int32_t i = 0; i < code_length_sizes_count; ++i)
+  {
+    _az_deflate_write_bits(ref_writer, code_length_sizes[_az_deflate_code_length_order[i]], 3);
+  }
+
+  static uint8_t const extra_counts[3] = { 2, 3, 7 };
+  for (int32_t i = 0; i < code_lengths->tokens_count; ++i)
+  {
+    uint32_t const symbol = code_lengths->tokens[i] & 0x1F;
+    _az_deflate_write_code(ref_writer, code_length_codes[symbol]);
+    if (symbol >= 16)
+    {
+      _az_deflate_write_bits(ref_writer, code_lengths->tokens[i] >> 5, extra_counts[symbol - 16]);
+    }
+  }
+}
+
+// Writes source as a single final block, with the fixed codes or with codes built for it,
+// whichever is smaller.
+static void _az_deflate_write_block(
+    _az_deflate_encoder* ref_encoder,
+    _az_deflate_writer* ref_writer,
+    az_span source)
+{
+  _az_deflate_block block = { 0 };
+  _az_deflate_emit_tokens(ref_encoder, &block, source);
+
+  uint8_t sizes[_az_DEFLATE_LENGTHS_COUNT + _az_DEFLATE_DISTANCES_COUNT];
+  uint8_t fixed_sizes[_az_DEFLATE_FIXED_LENGTHS_COUNT + _az_DEFLATE_DISTANCES_COUNT];
+  _az_deflate_build_code_sizes(
+      block.literal_counts, _az_DEFLATE_LENGTHS_COUNT, _az_DEFLATE_MAX_CODE_SIZE, sizes);
+  _az_deflate_build_fixed_code_sizes(fixed_sizes, fixed_sizes + _az_DEFLATE_FIXED_LENGTHS_COUNT);
+
+  // Trailing unused symbols aren't described in the header.
+  int32_t literals_count = _az_DEFLATE_LENGTHS_COUNT;
+  while (sizes[literals_count - 1] == 0)
+  {
+    --literals_count;
+  }
+  _az_deflate_build_code_sizes(
+      block.distance_counts,
+      _az_DEFLATE_DISTANCES_COUNT,
+      _az_DEFLATE_MAX_CODE_SIZE,
+      sizes + literals_count);
+  int32_t distances_count = _az_DEFLATE_DISTANCES_COUNT;
+  while (sizes[literals_count + distances_count - 1] == 0)
+  {
+    --distances_count;
+  }
+
+  // The code sizes of both codes are a single sequence in the header.
+  _az_deflate_code_lengths code_lengths;
+  _az_deflate_encode_code_sizes(sizes, literals_count + distances_count, &code_lengths);
+  uint8_t code_length_sizes[_az_DEFLATE_CODE_LENGTHS_COUNT];
+  _az_deflate_build_code_sizes(
+      code_lengths.counts,
+      _az_DEFLATE_CODE_LENGTHS_COUNT,
+      _az_DEFLATE_MAX_CODE_LENGTH_CODE_SIZE,
+      code_length_sizes);
+  int32_t code_length_sizes_count = _az_DEFLATE_CODE_LENGTHS_COUNT;
+  while (code_length_sizes_count > 4
+         && code_length_sizes[_az_deflate_code_length_order[code_length_sizes_count - 1]] == 0)
+  {
+    --code_length_sizes_count;
+  }
+
+  uint32_t const dynamic_cost = 14 + 3 * (uint32_t)code_length_sizes_count
+      + _az_deflate_get_cost(
+          code_lengths.counts, code_length_sizes, _az_DEFLATE_CODE_LENGTHS_COUNT)
+      + _az_deflate_get_cost(block.literal_counts, sizes, literals_count)
+      + _az_deflate_get_cost(block.distance_counts, sizes + literals_count, distances_count);
+  uint32_t const fixed_cost
+      = _az_deflate_get_cost(block.literal_counts, fixed_sizes, _az_DEFLATE_LENGTHS_COUNT)
+      + _az_deflate_get_cost(
+            block.distance_counts,
+            fixed_sizes + _az_DEFLATE_FIXED_LENGTHS_COUNT,
+            _az_DEFLATE_DISTANCES_COUNT);
+
+  if (dynamic_cost < fixed_cost)
+  {
+    _az_deflate_write_bits(ref_writer, 1 | (2 << 1), 3);
+    _az_deflate_write_dynamic_header(
+        ref_writer,
+        literals_count,
+        distances_count,
+        &code_lengths,
+        code_length_sizes,
+        code_length_sizes_count);
+    _az_deflate_build_codes(sizes, literals_count, block.literal_codes);
+    _az_deflate_build_codes(sizes + literals_count, distances_count, block.distance_codes);
+  }
+  else
+  {
+    _az_deflate_write_bits(ref_writer, 1 | (1 << 1), 3);
+    _az_deflate_build_codes(fixed_sizes, _az_DEFLATE_FIXED_LENGTHS_COUNT, block.literal_codes);
+    _az_deflate_build_codes(
+        fixed_sizes + _az_DEFLATE_FIXED_LENGTHS_COUNT,
+        _az_DEFLATE_DISTANCES_COUNT,
+        block.distance_codes);
+  }
+
+  // The same tokens again, written with the codes chosen.
+  block.writer = ref_writer;
+  _az_deflate_emit_tokens(ref_encoder, &block, source);
+  _az_deflate_flush_bits(ref_writer);
+}
+
+AZ_NODISCARD az_result _az_gzip_compress(
+    _az_deflate_encoder* ref_encoder,
+    az_span source,
+    az_span destination,
+    az_span* out_compressed)
+{
+  _az_PRECONDITION_NOT_NULL(ref_encoder);
+  _az_PRECONDITION_VALID_SPAN(source, 0, true);
+  _az_PRECONDITION_NOT_NULL(out_compressed);
+
+  int32_t const destination_size = az_span_size(destination);
+  if (destination_size < _az_GZIP_HEADER_SIZE + _az_GZIP_TRAILER_SIZE)
+  {
+    return AZ_ERROR_INSUFFICIENT_SPAN_SIZE;
+  }
+
+  // No file name nor modification time, from an unknown operating system.
+  static uint8_t const header[_az_GZIP_HEADER_SIZE] = { 0x1F, 0x8B, 8, 0, 0, 0, 0, 0, 0, 0xFF };
+  uint8_t* const ptr = az_span_ptr(destination);
+  memcpy(ptr, header, sizeof(header));
+
+  _az_deflate_writer writer = {
+    .ptr = ptr + _az_GZIP_HEADER_SIZE,
+    .size = destination_size - _az_GZIP_HEADER_SIZE - _az_GZIP_TRAILER_SIZE,
+    .written = 0,
+    .bits = 0,
+    .bits_count = 0,
+    .is_overflowed = false,
+  };
+  _az_deflate_write_block(ref_encoder, &writer, source);
+  if (writer.is_overflowed)
+  {
+    return AZ_ERROR_INSUFFICIENT_SPAN_SIZE;
+  }
+
+  uint32_t const trailer[2] = { _az_crc32(0, source), (uint32_t)az_span_size(source) };
+  uint8_t* const trailer_ptr = writer.ptr + writer.written;
+  for (int32_t i = 0; i < _az_GZIP_TRAILER_SIZE; ++i)
+  {
+    trailer_ptr[i] = (uint8_t)(trailer[i / 4] >> (8 * (i % 4)));
+  }
+
+  *out_compressed = az_span_slice(
+      destination, 0, _az_GZIP_HEADER_SIZE + writer.written + _az_GZIP_TRAILER_SIZE);
+  return AZ_OK;
+}
@@ -0,0 +1,50 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#ifndef _az_DEFLATE_PRIVATE_H
+#define _az_DEFLATE_PRIVATE_H
+
+#include <azure/core/_az_deflate.h>
+#include <azure/core/az_result.h>
+#include <azure/core/az_span.h>
+
+#include <stdint.h>
+
+#include <azure/core/_az_cfg_prefix.h>
+
+enum
+{
+  _az_GZIP_HEADER_SIZE = 10,
+  _az_GZIP_TRAILER_SIZE = 8,
+};
+
+/**
+ * @brief Updates the CRC-32 (ISO 3309, as in gzip and zlib) \p crc, `0` initially, with \p data.
+ */
+AZ_NODISCARD uint32_t _az_crc32(uint32_t crc, az_span data);
+
+/**
+ * @brief Compresses \p source to the gzip format (RFC 1952) in \p destination.
+ *
+ * @details The deflate stream (RFC 1951) is a single block, whose LZ77 matches are found with a
+ * hash table of the last position of each sequence of 3 bytes. The matches are found twice: to
+ * count the symbols and build Huffman codes for them, then to write them with those codes or
+ * with the fixed codes, whichever is smaller.
+ *
+ * @param[in,out] ref_encoder The hash table used for the compression, its content doesn't matter.
+ * @param[in] source The data to compress.
+ * @param[out] destination The buffer to write the gzip data to.
+ * @param[out] out_compressed The gzip data, the start of \p destination.
+ *
+ * @return #AZ_OK, or #AZ_ERROR_INSUFFICIENT_SPAN_SIZE when it doesn't fit in \p destination. The
+ * compression stops as soon as it overflows.
+ */
+AZ_NODISCARD az_result _az_gzip_compress(
+    _az_deflate_encoder* ref_encoder,
+    az_span source,
+    az_span destination,
+    az_span* out_compressed);
+
+#include <azure/core/_az_cfg_suffix.h>
+
+#endif // _az_DEFLATE_PRIVATE_H
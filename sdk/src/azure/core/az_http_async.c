@@ -0,0 +1,215 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "az_http_private.h"
+
+#include <azure/core/az_context.h>
+#include <azure/core/az_http.h>
+#include <azure/core/az_http_transport.h>
+#include <azure/core/az_precondition.h>
+#include <azure/core/internal/az_http_internal.h>
+#include <azure/core/internal/az_precondition_internal.h>
+
+#include <stdint.h>
+
+#include <azure/core/_az_cfg.h>
+
+// The address of this variable is the az_context key that binds a request to its
+// _az_http_async_state.
+static uint8_t const _az_http_async_state_key = 0;
+
+AZ_NODISCARD az_result
+_az_http_async_state_init(_az_http_async_state* out_state, az_context const* parent, az_span buffer)
+{
+  _az_PRECONDITION_NOT_NULL(out_state);
+  _az_PRECONDITION_VALID_SPAN(buffer, 0, true);
+
+  *out_state = (_az_http_async_state){
+    ._internal = {
+      .context = { 0 },
+      .request = { 0 },
+      .buffer = buffer,
+      .resume_policy = { 0 },
+      .resume_next_policies = NULL,
+      .not_before_msec = 0,
+      .attempt = 0,
+      .retry_delay_msec = 0,
+      .completed_result = AZ_OK,
+      .is_completed = false,
+    },
+  };
+
+  out_state->_internal.context
+      = az_context_create_with_value(parent, &_az_http_async_state_key, out_state);
+
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_context _az_http_context_create_synchronous(az_context const* parent)
+{
+  return az_context_create_with_value(parent, &_az_http_async_state_key, NULL);
+}
+
+AZ_NODISCARD _az_http_async_state* _az_http_request_get_async_state(az_http_request const* request)
+{
+  _az_PRECONDITION_NOT_NULL(request);
+
+  void const* value = NULL;
+  if (request->_internal.context == NULL
+      || az_failed(
+          az_context_get_value(request->_internal.context, &_az_http_async_state_key, &value)))
+  {
+    return NULL;
+  }
+
+  // The state was bound by _az_http_async_state_init(), which got it as a mutable pointer.
+  return (_az_http_async_state*)(uintptr_t)value;
+}
+
+// The headers of the copy are read through an az_pair pointer, so align them as a pointer.
+AZ_NODISCARD AZ_INLINE int32_t _az_http_async_state_get_padding(az_span buffer)
+{
+  int32_t const misalignment = (int32_t)((uintptr_t)az_span_ptr(buffer) % sizeof(void*));
+  return misalignment == 0 ? 0 : (int32_t)sizeof(void*) - misalignment;
+}
+
+AZ_NODISCARD az_span
+_az_http_async_state_get_scratch(_az_http_async_state const* state, az_http_request const* request)
+{
+  _az_PRECONDITION_NOT_NULL(state);
+  _az_PRECONDITION_NOT_NULL(request);
+
+  // Same layout as _az_http_async_state_copy_request().
+  az_span const buffer = state->_internal.buffer;
+  int32_t const headers_count
+      = request->_internal.retry_headers_start_byte_offset / (int32_t)sizeof(az_pair);
+  int32_t copy_size = _az_http_async_state_get_padding(buffer)
+      + request->_internal.max_headers * (int32_t)sizeof(az_pair) + request->_internal.url_length;
+  for (int32_t i = 0; i < headers_count; ++i)
+  {
+    az_pair const header = ((az_pair*)az_span_ptr(request->_internal.headers))[i];
+    copy_size += az_span_size(header.key) + az_span_size(header.value);
+  }
+
+  return copy_size < az_span_size(buffer) ? az_span_slice_to_end(buffer, copy_size) : AZ_SPAN_NULL;
+}
+
+/**
+ * @brief Copies \p request into \p ref_state, including the bytes of its url and of the headers
+ * that were added before the retry policy, so that the request can be replayed after the caller's
+ * buffers are gone.
+ */
+static AZ_NODISCARD az_result
+_az_http_async_state_copy_request(_az_http_async_state* ref_state, az_http_request const* request)
+{
+  az_span buffer = ref_state->_internal.buffer;
+  int32_t const headers_count
+      = request->_internal.retry_headers_start_byte_offset / (int32_t)sizeof(az_pair);
+  int32_t const pairs_size = request->_internal.max_headers * (int32_t)sizeof(az_pair);
+
+  int32_t const padding = _az_http_async_state_get_padding(buffer);
+  AZ_RETURN_IF_NOT_ENOUGH_SIZE(buffer, padding + pairs_size + request->_internal.url_length);
+  buffer = az_span_slice_to_end(buffer, padding);
+
+  az_span const headers = az_span_slice(buffer, 0, pairs_size);
+  buffer = az_span_slice_to_end(buffer, pairs_size);
+
+  az_span const url = az_span_slice(request->_internal.url, 0, request->_internal.url_length);
+  az_span const url_copy = az_span_slice(buffer, 0, request->_internal.url_length);
+  buffer = az_span_copy(buffer, url);
+
+  az_pair* const pairs = (az_pair*)az_span_ptr(headers);
+  for (int32_t i = 0; i < headers_count; ++i)
+  {
+    az_pair const header = ((az_pair*)az_span_ptr(request->_internal.headers))[i];
+    int32_t const key_size = az_span_size(header.key);
+    int32_t const value_size = az_span_size(header.value);
+    AZ_RETURN_IF_NOT_ENOUGH_SIZE(buffer, key_size + value_size);
+
+    pairs[i].key = az_span_slice(buffer, 0, key_size);
+    buffer = az_span_copy(buffer, header.key);
+    pairs[i].value = az_span_slice(buffer, 0, value_size);
+    buffer = az_span_copy(buffer, header.value);
+  }
+
+  ref_state->_internal.request = *request;
+  ref_state->_internal.request._internal.url = url_copy;
+  ref_state->_internal.request._internal.headers = headers;
+  ref_state->_internal.request._internal.headers_length = headers_count;
+
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result _az_http_async_state_suspend(
+    _az_http_async_state* ref_state,
+    _az_http_policy* ref_policies,
+    _az_http_policy_process_fn process,
+    void* ref_options,
+    az_http_request const* request)
+{
+  _az_PRECONDITION_NOT_NULL(ref_state);
+  _az_PRECONDITION_NOT_NULL(ref_policies);
+  _az_PRECONDITION_NOT_NULL(process);
+  _az_PRECONDITION_NOT_NULL(request);
+
+  // When resumed, the policy gets the copy of the request, which doesn't need to be copied again.
+  if (request != &ref_state->_internal.request)
+  {
+    AZ_RETURN_IF_FAILED(_az_http_async_state_copy_request(ref_state, request));
+  }
+
+  ref_state->_internal.resume_policy._internal.process = process;
+  ref_state->_internal.resume_policy._internal.options = ref_options;
+  ref_state->_internal.resume_next_policies = ref_policies;
+
+  return AZ_HTTP_REQUEST_PENDING;
+}
+
+AZ_NODISCARD bool _az_http_async_state_take_result(
+    _az_http_async_state* ref_state,
+    az_result* out_result)
+{
+  _az_PRECONDITION_NOT_NULL(ref_state);
+  _az_PRECONDITION_NOT_NULL(out_result);
+
+  if (!ref_state->_internal.is_completed)
+  {
+    return false;
+  }
+
+  ref_state->_internal.is_completed = false;
+  *out_result = ref_state->_internal.completed_result;
+  return true;
+}
+
+AZ_NODISCARD az_result _az_http_async_state_complete(
+    _az_http_async_state* ref_state,
+    az_result result,
+    az_http_response* ref_response)
+{
+  _az_PRECONDITION_NOT_NULL(ref_state);
+  _az_PRECONDITION_NOT_NULL(ref_response);
+
+  _az_http_policy const resume_policy = ref_state->_internal.resume_policy;
+  if (resume_policy._internal.process == NULL)
+  {
+    // No policy is waiting for the response, it goes straight to the caller.
+    return result;
+  }
+
+  ref_state->_internal.completed_result = result;
+  ref_state->_internal.is_completed = true;
+  ref_state->_internal.resume_policy._internal.process = NULL;
+
+  result = resume_policy._internal.process(
+      ref_state->_internal.resume_next_policies,
+      resume_policy._internal.options,
+      &ref_state->_internal.request,
+      ref_response);
+
+  // The transport normally takes the response back while the policies run. If it wasn't reached
+  // (e.g. a policy failed before it), don't keep the stale response around.
+  ref_state->_internal.is_completed = false;
+
+  return result;
+}
@@ -2,11 +2,65 @@
 // SPDX-License-Identifier: MIT
 
 #include <azure/core/az_http.h>
+#include <azure/core/az_metrics.h>
+#include <azure/core/az_platform.h>
+#include <azure/core/internal/az_config_internal.h>
 #include <azure/core/internal/az_http_internal.h>
+#include <azure/core/internal/az_metrics_internal.h>
 #include <azure/core/internal/az_precondition_internal.h>
 
+#include <stddef.h>
+
 #include <azure/core/_az_cfg.h>
 
+#ifndef AZ_NO_METRICS
+AZ_NODISCARD az_result _az_http_pipeline_nextpolicy_measured(
+    _az_http_policy* ref_policies,
+    az_http_request* ref_request,
+    az_http_response* ref_response)
+{
+  _az_http_metrics_state* const state = ref_request->_internal.metrics;
+  ptrdiff_t const index = ref_policies - (_az_http_policy const*)state->_internal.policies;
+
+  int64_t const start = az_platform_clock_usec();
+  az_result const result = ref_policies[0]._internal.process(
+      &(ref_policies[1]), ref_policies[0]._internal.options, ref_request, ref_response);
+
+  if (index >= 0 && index < AZ_METRICS_MAX_POLICIES)
+  {
+    state->_internal.metrics.policy_elapsed_usec[index] += az_platform_clock_usec() - start;
+  }
+
+  return result;
+}
+
+// Processes the request with its metrics measured, and reports them once the pipeline returns.
+static AZ_NODISCARD az_result _az_http_pipeline_process_measured(
+    _az_http_pipeline* ref_pipeline,
+    az_http_request* ref_request,
+    az_http_response* ref_response)
+{
+  _az_http_metrics_state state = {
+    ._internal = {
+      .metrics = { 0 },
+      .policies = ref_pipeline->_internal.policies,
+    },
+  };
+  ref_request->_internal.metrics = &state;
+
+  az_result const result = _az_http_pipeline_nextpolicy(
+      ref_pipeline->_internal.policies, ref_request, ref_response);
+
+  ref_request->_internal.metrics = NULL;
+  state._internal.metrics.result = result;
+  state._internal.metrics.total_msec
+      = state._internal.metrics.policy_elapsed_usec[0] / _az_TIME_MICROSECONDS_PER_MILLISECOND;
+  _az_METRICS_WRITE(&state._internal.metrics);
+
+  return result;
+}
+#endif // AZ_NO_METRICS
+
 AZ_NODISCARD az_result az_http_pipeline_process(
     _az_http_pipeline* ref_pipeline,
     az_http_request* ref_request,
@@ -16,6 +70,15 @@ AZ_NODISCARD az_result az_http_pipeline_process(
   _az_PRECONDITION_NOT_NULL(ref_response);
   _az_PRECONDITION_NOT_NULL(ref_pipeline);
 
+#ifndef AZ_NO_METRICS
+  // Asynchronous requests return before they are sent, their metrics aren't measured.
+  if (_az_METRICS_SHOULD_WRITE() && ref_request->_internal.metrics == NULL
+      && _az_http_request_get_async_state(ref_request) == NULL)
+  {
+    return _az_http_pipeline_process_measured(ref_pipeline, ref_request, ref_response);
+  }
+#endif // AZ_NO_METRICS
+
   return ref_pipeline->_internal.policies[0]._internal.process(
       &(ref_pipeline->_internal.policies[1]),
       ref_pipeline->_internal.policies[0]._internal.options,
@@ -0,0 +1,193 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "az_span_private.h"
+#include <azure/core/az_context.h>
+#include <azure/core/az_http.h>
+#include <azure/core/az_http_transport.h>
+#include <azure/core/az_platform.h>
+#include <azure/core/internal/az_http_internal.h>
+#include <azure/core/internal/az_precondition_internal.h>
+#include <azure/core/internal/az_spinlock_internal.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <azure/core/_az_cfg.h>
+
+enum
+{
+  _az_HTTP_POLICY_BULKHEAD_POLL_MSEC = 1, // How often queued requests check for a free slot.
+};
+
+void az_http_policy_bulkhead_init(
+    az_http_policy_bulkhead* out_bulkhead,
+    int32_t max_in_flight,
+    int32_t max_queued)
+{
+  _az_PRECONDITION_NOT_NULL(out_bulkhead);
+  _az_PRECONDITION_RANGE(1, max_in_flight, INT32_MAX);
+  _az_PRECONDITION_RANGE(0, max_queued, INT32_MAX);
+
+  *out_bulkhead = (az_http_policy_bulkhead){
+    ._internal = {
+      .lock = { 0 },
+      .max_in_flight = max_in_flight,
+      .max_queued = max_queued,
+      .hosts = { { 0 } },
+    },
+  };
+}
+
+// FNV-1a, never 0 so that 0 can mark unused hosts.
+static uint32_t _az_http_policy_bulkhead_hash(az_span span)
+{
+  uint32_t const hash = _az_span_fnv1a_32(span);
+  return hash != 0 ? hash : 1;
+}
+
+// Gets the slot of the host, assigning it one if it has none yet. Returns NULL if all the slots
+// are taken by other hosts. The hosts are compared byte for byte, the hash only skips the slots of
+// most other hosts. The lock of the bulkhead must be held.
+static _az_http_policy_bulkhead_host* _az_http_policy_bulkhead_get_host(
+    az_http_policy_bulkhead* ref_bulkhead,
+    az_span host_name,
+    uint32_t host_hash)
+{
+  _az_http_policy_bulkhead_host* unused_host = NULL;
+  for (int32_t i = 0; i < _az_HTTP_POLICY_BULKHEAD_HOSTS; ++i)
+  {
+    _az_http_policy_bulkhead_host* const host = &ref_bulkhead->_internal.hosts[i];
+    if (host->host_hash == host_hash
+        && az_span_is_content_equal(az_span_create(host->host, host->host_size), host_name))
+    {
+      return host;
+    }
+
+    if (host->host_hash == 0 && unused_host == NULL)
+    {
+      unused_host = host;
+    }
+  }
+
+  if (unused_host != NULL)
+  {
+    unused_host->host_hash = host_hash;
+    unused_host->host_size = az_span_size(host_name);
+    az_span_copy(AZ_SPAN_FROM_BUFFER(unused_host->host), host_name);
+  }
+
+  return unused_host;
+}
+
+// Frees the slot of the host once no request to it is left. The lock of the bulkhead must be held.
+static void _az_http_policy_bulkhead_release_host(_az_http_policy_bulkhead_host* ref_host)
+{
+  if (ref_host->in_flight == 0 && ref_host->queued == 0)
+  {
+    ref_host->host_hash = 0;
+  }
+}
+
+// Waits for one of the requests in flight to the host to complete, and takes its place.
+static AZ_NODISCARD az_result _az_http_policy_bulkhead_wait(
+    az_http_policy_bulkhead* ref_bulkhead,
+    _az_http_policy_bulkhead_host* ref_host,
+    az_context const* context)
+{
+  bool const has_deadline
+      = context != NULL && az_context_get_expiration(context) != _az_CONTEXT_MAX_EXPIRATION;
+
+  while (true)
+  {
+    az_platform_sleep_msec(_az_HTTP_POLICY_BULKHEAD_POLL_MSEC);
+
+    bool const has_expired
+        = has_deadline && az_context_has_expired(context, az_platform_clock_msec());
+
+    az_result result = AZ_CONTINUE;
+    _az_spinlock_enter_writer(&ref_bulkhead->_internal.lock);
+    if (ref_host->in_flight < ref_bulkhead->_internal.max_in_flight)
+    {
+      --ref_host->queued;
+      ++ref_host->in_flight;
+      result = AZ_OK;
+    }
+    else if (has_expired)
+    {
+      --ref_host->queued;
+      result = AZ_ERROR_CANCELED;
+    }
+    _az_spinlock_exit_writer(&ref_bulkhead->_internal.lock);
+
+    if (result != AZ_CONTINUE)
+    {
+      return result;
+    }
+  }
+}
+
+AZ_NODISCARD az_result az_http_pipeline_policy_bulkhead(
+    _az_http_policy* ref_policies,
+    void* ref_options,
+    az_http_request* ref_request,
+    az_http_response* ref_response)
+{
+  az_http_policy_bulkhead* const bulkhead = (az_http_policy_bulkhead*)ref_options;
+
+  // The policy isn't called again once an asynchronous request completes, to release its slot.
+  az_span const host_name = _az_http_request_get_host(ref_request);
+  if (bulkhead == NULL || _az_http_request_get_async_state(ref_request) != NULL
+      || az_span_size(host_name) > _az_HTTP_POLICY_HOST_MAX_SIZE)
+  {
+    return _az_http_pipeline_nextpolicy(ref_policies, ref_request, ref_response);
+  }
+
+  uint32_t const host_hash = _az_http_policy_bulkhead_hash(host_name);
+
+  // A host gets a slot only if a request to it can be sent, there is no need to release it here.
+  bool is_sent = false;
+  bool is_queued = false;
+  _az_spinlock_enter_writer(&bulkhead->_internal.lock);
+  _az_http_policy_bulkhead_host* const host
+      = _az_http_policy_bulkhead_get_host(bulkhead, host_name, host_hash);
+  if (host != NULL && host->in_flight < bulkhead->_internal.max_in_flight)
+  {
+    ++host->in_flight;
+    is_sent = true;
+  }
+  else if (host != NULL && host->queued < bulkhead->_internal.max_queued)
+  {
+    ++host->queued;
+    is_queued = true;
+  }
+  _az_spinlock_exit_writer(&bulkhead->_internal.lock);
+
+  if (!is_sent && !is_queued)
+  {
+    // Too many requests to the host, or too many hosts with requests in flight.
+    return AZ_ERROR_HTTP_BULKHEAD_FULL;
+  }
+
+  if (is_queued)
+  {
+    az_result const wait_result
+        = _az_http_policy_bulkhead_wait(bulkhead, host, ref_request->_internal.context);
+    if (az_failed(wait_result))
+    {
+      _az_spinlock_enter_writer(&bulkhead->_internal.lock);
+      _az_http_policy_bulkhead_release_host(host);
+      _az_spinlock_exit_writer(&bulkhead->_internal.lock);
+      return wait_result;
+    }
+  }
+
+  az_result const result = _az_http_pipeline_nextpolicy(ref_policies, ref_request, ref_response);
+
+  _az_spinlock_enter_writer(&bulkhead->_internal.lock);
+  --host->in_flight;
+  _az_http_policy_bulkhead_release_host(host);
+  _az_spinlock_exit_writer(&bulkhead->_internal.lock);
+
+  return result;
+}
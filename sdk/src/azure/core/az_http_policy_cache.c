@@ -0,0 +1,332 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "az_http_private.h"
+#include "az_span_private.h"
+#include <azure/core/az_http.h>
+#include <azure/core/az_http_transport.h>
+#include <azure/core/internal/az_http_internal.h>
+#include <azure/core/internal/az_precondition_internal.h>
+#include <azure/core/internal/az_spinlock_internal.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <azure/core/_az_cfg.h>
+
+enum
+{
+  // Size of the stack buffers the validators of a cached response are copied to. Responses with
+  // larger validators aren't cached.
+  _az_HTTP_POLICY_CACHE_VALIDATOR_SIZE = 128,
+};
+
+static az_span const _az_http_policy_cache_etag = AZ_SPAN_LITERAL_FROM_STR("ETag");
+static az_span const _az_http_policy_cache_last_modified
+    = AZ_SPAN_LITERAL_FROM_STR("Last-Modified");
+static az_span const _az_http_policy_cache_if_none_match
+    = AZ_SPAN_LITERAL_FROM_STR("If-None-Match");
+static az_span const _az_http_policy_cache_if_modified_since
+    = AZ_SPAN_LITERAL_FROM_STR("If-Modified-Since");
+
+void az_http_policy_cache_init(az_http_policy_cache* out_cache, az_span buffer)
+{
+  _az_PRECONDITION_NOT_NULL(out_cache);
+  _az_PRECONDITION_VALID_SPAN(buffer, _az_HTTP_POLICY_CACHE_ENTRIES, false);
+
+  *out_cache = (az_http_policy_cache){
+    ._internal = {
+      .lock = { 0 },
+      .buffer = buffer,
+      .entry_size = az_span_size(buffer) / _az_HTTP_POLICY_CACHE_ENTRIES,
+      .clock = 0,
+      .entries = { { 0 } },
+    },
+  };
+}
+
+// Requests for part of a blob, or that are already conditional, are sent as they are.
+static bool _az_http_policy_cache_is_cacheable(az_http_request const* request)
+{
+  if (!az_span_is_content_equal(request->_internal.method, az_http_method_get())
+      || _az_http_request_get_async_state(request) != NULL)
+  {
+    return false;
+  }
+
+  for (int32_t i = 0; i < az_http_request_headers_count(request); ++i)
+  {
+    az_pair header = { 0 };
+    if (az_failed(az_http_request_get_header(request, i, &header))
+        || az_span_is_content_equal_ignoring_case(header.key, AZ_SPAN_FROM_STR("Range"))
+        || az_span_is_content_equal_ignoring_case(header.key, AZ_SPAN_FROM_STR("x-ms-range"))
+        || (az_span_size(header.key) > 3
+            && az_span_is_content_equal_ignoring_case(
+                az_span_slice(header.key, 0, 3), AZ_SPAN_FROM_STR("If-"))))
+    {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+// Gets the entry of url, NULL if it isn't cached. The lock must be held.
+static _az_http_policy_cache_entry* _az_http_policy_cache_find(
+    az_http_policy_cache* ref_cache,
+    uint64_t url_hash,
+    az_span url)
+{
+  for (int32_t i = 0; i < _az_HTTP_POLICY_CACHE_ENTRIES; ++i)
+  {
+    _az_http_policy_cache_entry* const entry = &ref_cache->_internal.entries[i];
+    if (entry->is_used && entry->url_hash == url_hash && az_span_is_content_equal(entry->url, url))
+    {
+      return entry;
+    }
+  }
+
+  return NULL;
+}
+
+// Copies a validator of an entry to buffer, returns false if it has none.
+static bool _az_http_policy_cache_copy_validator(
+    az_span validator,
+    az_span buffer,
+    az_span* out_validator)
+{
+  if (az_span_size(validator) == 0)
+  {
+    return false;
+  }
+
+  az_span_copy(buffer, validator);
+  *out_validator = az_span_slice(buffer, 0, az_span_size(validator));
+  return true;
+}
+
+// Gets the value of a validator header of response as an offset and a size in its content, which
+// are the same in the copy of the content cached. Returns false if it's too large to be sent back.
+static bool _az_http_policy_cache_get_validator(
+    az_http_response* ref_response,
+    az_span content,
+    az_span name,
+    int32_t* out_offset,
+    int32_t* out_size)
+{
+  az_span value = AZ_SPAN_NULL;
+  *out_offset = 0;
+  *out_size = 0;
+  if (az_failed(az_http_response_get_header(ref_response, name, &value)))
+  {
+    return true;
+  }
+
+  if (az_span_size(value) > _az_HTTP_POLICY_CACHE_VALIDATOR_SIZE)
+  {
+    return false;
+  }
+
+  *out_offset = (int32_t)(az_span_ptr(value) - az_span_ptr(content));
+  *out_size = az_span_size(value);
+  return true;
+}
+
+// Caches the response to url when it has validators and fits in an entry, or evicts the stale
+// response to url otherwise.
+static void _az_http_policy_cache_store(
+    az_http_policy_cache* ref_cache,
+    uint64_t url_hash,
+    az_span url,
+    az_http_response* ref_response)
+{
+  az_http_response_status_line status_line = { 0 };
+  // The raw response, as the transport adapter appended it to the response buffer.
+  az_span const content
+      = az_span_slice(ref_response->_internal.http_response, 0, ref_response->_internal.written);
+  int32_t etag_offset = 0;
+  int32_t etag_size = 0;
+  int32_t last_modified_offset = 0;
+  int32_t last_modified_size = 0;
+
+  bool const is_cacheable
+      = az_succeeded(az_http_response_get_status_line(ref_response, &status_line))
+      && status_line.status_code == AZ_HTTP_STATUS_CODE_OK
+      && ref_response->_internal.body.callback == NULL
+      && az_span_size(url) + az_span_size(content) <= ref_cache->_internal.entry_size
+      && _az_http_policy_cache_get_validator(
+          ref_response, content, _az_http_policy_cache_etag, &etag_offset, &etag_size)
+      && _az_http_policy_cache_get_validator(
+          ref_response,
+          content,
+          _az_http_policy_cache_last_modified,
+          &last_modified_offset,
+          &last_modified_size)
+      && (etag_size > 0 || last_modified_size > 0);
+
+  _az_spinlock_enter_writer(&ref_cache->_internal.lock);
+
+  _az_http_policy_cache_entry* entry = _az_http_policy_cache_find(ref_cache, url_hash, url);
+  if (!is_cacheable)
+  {
+    if (entry != NULL)
+    {
+      entry->is_used = false;
+    }
+    _az_spinlock_exit_writer(&ref_cache->_internal.lock);
+    return;
+  }
+
+  // Replace the response to url, or the least recently used one.
+  for (int32_t i = 0; entry == NULL && i < _az_HTTP_POLICY_CACHE_ENTRIES; ++i)
+  {
+    if (!ref_cache->_internal.entries[i].is_used)
+    {
+      entry = &ref_cache->_internal.entries[i];
+    }
+  }
+  if (entry == NULL)
+  {
+    entry = &ref_cache->_internal.entries[0];
+    for (int32_t i = 1; i < _az_HTTP_POLICY_CACHE_ENTRIES; ++i)
+    {
+      if (ref_cache->_internal.entries[i].last_used < entry->last_used)
+      {
+        entry = &ref_cache->_internal.entries[i];
+      }
+    }
+  }
+
+  int32_t const index = (int32_t)(entry - ref_cache->_internal.entries);
+  az_span const slot = az_span_slice(
+      ref_cache->_internal.buffer,
+      index * ref_cache->_internal.entry_size,
+      (index + 1) * ref_cache->_internal.entry_size);
+  az_span const response = az_span_slice(az_span_copy(slot, url), 0, az_span_size(content));
+  az_span_copy(response, content);
+
+  *entry = (_az_http_policy_cache_entry){
+    .url_hash = url_hash,
+    .url = az_span_slice(slot, 0, az_span_size(url)),
+    .response = response,
+    .etag = az_span_slice(response, etag_offset, etag_offset + etag_size),
+    .last_modified
+    = az_span_slice(response, last_modified_offset, last_modified_offset + last_modified_size),
+    .last_used = ++ref_cache->_internal.clock,
+    .is_used = true,
+  };
+
+  _az_spinlock_exit_writer(&ref_cache->_internal.lock);
+}
+
+// Replaces the 304 response with the cached response to url, if it is still the one the request
+// was made conditional on. Returns false if it was evicted or replaced since then.
+static bool _az_http_policy_cache_load(
+    az_http_policy_cache* ref_cache,
+    uint64_t url_hash,
+    az_span url,
+    az_span etag,
+    az_span last_modified,
+    az_http_response* ref_response,
+    az_result* out_result)
+{
+  bool is_loaded = false;
+
+  _az_spinlock_enter_writer(&ref_cache->_internal.lock);
+  _az_http_policy_cache_entry* const entry = _az_http_policy_cache_find(ref_cache, url_hash, url);
+  if (entry != NULL && az_span_is_content_equal(entry->etag, etag)
+      && az_span_is_content_equal(entry->last_modified, last_modified))
+  {
+    entry->last_used = ++ref_cache->_internal.clock;
+
+    _az_http_response_reset(ref_response);
+    *out_result = az_http_response_append(ref_response, entry->response);
+    is_loaded = true;
+  }
+  _az_spinlock_exit_writer(&ref_cache->_internal.lock);
+
+  return is_loaded;
+}
+
+AZ_NODISCARD az_result az_http_pipeline_policy_cache(
+    _az_http_policy* ref_policies,
+    void* ref_options,
+    az_http_request* ref_request,
+    az_http_response* ref_response)
+{
+  az_http_policy_cache* const cache = (az_http_policy_cache*)ref_options;
+
+  if (cache == NULL || ref_response->_internal.body.callback != NULL
+      || !_az_http_policy_cache_is_cacheable(ref_request))
+  {
+    return _az_http_pipeline_nextpolicy(ref_policies, ref_request, ref_response);
+  }
+
+  az_span const url
+      = az_span_slice(ref_request->_internal.url, 0, ref_request->_internal.url_length);
+  // Hashed to skip comparing the urls of most of the entries.
+  uint64_t const url_hash = _az_span_fnv1a_64(url);
+
+  // The validators of the cached response are copied, the entry can be replaced while the request
+  // is in flight.
+  uint8_t etag_buffer[_az_HTTP_POLICY_CACHE_VALIDATOR_SIZE];
+  uint8_t last_modified_buffer[_az_HTTP_POLICY_CACHE_VALIDATOR_SIZE];
+  az_span etag = AZ_SPAN_NULL;
+  az_span last_modified = AZ_SPAN_NULL;
+  bool is_conditional = false;
+
+  _az_spinlock_enter_reader(&cache->_internal.lock);
+  _az_http_policy_cache_entry const* const entry
+      = _az_http_policy_cache_find(cache, url_hash, url);
+  if (entry != NULL)
+  {
+    bool const has_etag = _az_http_policy_cache_copy_validator(
+        entry->etag, AZ_SPAN_FROM_BUFFER(etag_buffer), &etag);
+    bool const has_last_modified = _az_http_policy_cache_copy_validator(
+        entry->last_modified, AZ_SPAN_FROM_BUFFER(last_modified_buffer), &last_modified);
+    is_conditional = has_etag || has_last_modified;
+  }
+  _az_spinlock_exit_reader(&cache->_internal.lock);
+
+  int32_t const headers_length = ref_request->_internal.headers_length;
+  az_result result = AZ_OK;
+  if (az_span_size(etag) > 0)
+  {
+    result = az_http_request_append_header(ref_request, _az_http_policy_cache_if_none_match, etag);
+  }
+  if (az_succeeded(result) && az_span_size(last_modified) > 0)
+  {
+    result = az_http_request_append_header(
+        ref_request, _az_http_policy_cache_if_modified_since, last_modified);
+  }
+
+  if (az_succeeded(result))
+  {
+    result = _az_http_pipeline_nextpolicy(ref_policies, ref_request, ref_response);
+  }
+
+  // The conditional headers point to the stack, they are removed before returning.
+  ref_request->_internal.headers_length = headers_length;
+  if (az_failed(result))
+  {
+    return result;
+  }
+
+  az_http_response_status_line status_line = { 0 };
+  if (is_conditional && az_succeeded(az_http_response_get_status_line(ref_response, &status_line))
+      && status_line.status_code == AZ_HTTP_STATUS_CODE_NOT_MODIFIED)
+  {
+    if (_az_http_policy_cache_load(
+            cache, url_hash, url, etag, last_modified, ref_response, &result))
+    {
+      return result;
+    }
+
+    // The cached response was evicted while the request was in flight, get the whole response.
+    _az_http_response_reset(ref_response);
+    AZ_RETURN_IF_FAILED(_az_http_pipeline_nextpolicy(ref_policies, ref_request, ref_response));
+  }
+
+  _az_http_policy_cache_store(cache, url_hash, url, ref_response);
+  return AZ_OK;
+}
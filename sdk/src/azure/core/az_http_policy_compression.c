@@ -0,0 +1,169 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "az_deflate_private.h"
+#include <azure/core/az_http.h>
+#include <azure/core/az_http_transport.h>
+#include <azure/core/internal/az_config_internal.h>
+#include <azure/core/internal/az_http_internal.h>
+#include <azure/core/internal/az_precondition_internal.h>
+#include <azure/core/internal/az_span_internal.h>
+#include <azure/core/internal/az_spinlock_internal.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <azure/core/_az_cfg.h>
+
+static az_span const _az_http_policy_compression_content_encoding
+    = AZ_SPAN_LITERAL_FROM_STR("Content-Encoding");
+static az_span const _az_http_policy_compression_content_length
+    = AZ_SPAN_LITERAL_FROM_STR("Content-Length");
+
+void az_http_policy_compression_init(
+    az_http_policy_compression* out_compression,
+    az_span buffer,
+    int32_t min_size)
+{
+  _az_PRECONDITION_NOT_NULL(out_compression);
+  _az_PRECONDITION_VALID_SPAN(buffer, 0, true);
+  _az_PRECONDITION_RANGE(0, min_size, INT32_MAX);
+
+  *out_compression = (az_http_policy_compression){
+    ._internal = {
+      .lock = { 0 },
+      .is_busy = false,
+      .buffer = buffer,
+      .min_size = min_size,
+      .encoder = { 0 },
+    },
+  };
+}
+
+// Gets the index of the Content-Length header of request, -1 if it has none. Returns false if the
+// body is already encoded.
+static bool _az_http_policy_compression_find_headers(
+    az_http_request const* request,
+    int32_t* out_content_length_index)
+{
+  *out_content_length_index = -1;
+  for (int32_t i = 0; i < az_http_request_headers_count(request); ++i)
+  {
+    az_pair header = { 0 };
+    if (az_failed(az_http_request_get_header(request, i, &header))
+        || az_span_is_content_equal_ignoring_case(
+            header.key, _az_http_policy_compression_content_encoding))
+    {
+      return false;
+    }
+
+    if (az_span_is_content_equal_ignoring_case(
+            header.key, _az_http_policy_compression_content_length))
+    {
+      *out_content_length_index = i;
+    }
+  }
+
+  return true;
+}
+
+// Compresses the body of the request to the buffer, which the request uses until it is released.
+// Returns false if the body is sent as is.
+static bool _az_http_policy_compression_compress(
+    az_http_policy_compression* ref_compression,
+    az_span body,
+    az_span* out_compressed)
+{
+  _az_spinlock_enter_writer(&ref_compression->_internal.lock);
+  bool const is_busy = ref_compression->_internal.is_busy;
+  ref_compression->_internal.is_busy = true;
+  _az_spinlock_exit_writer(&ref_compression->_internal.lock);
+
+  if (is_busy)
+  {
+    return false;
+  }
+
+  // The compressed body is only sent when it is smaller.
+  az_span buffer = ref_compression->_internal.buffer;
+  if (az_span_size(buffer) >= az_span_size(body))
+  {
+    buffer = az_span_slice(buffer, 0, az_span_size(body) - 1);
+  }
+
+  if (az_succeeded(_az_gzip_compress(
+          &ref_compression->_internal.encoder, body, buffer, out_compressed)))
+  {
+    return true;
+  }
+
+  _az_spinlock_enter_writer(&ref_compression->_internal.lock);
+  ref_compression->_internal.is_busy = false;
+  _az_spinlock_exit_writer(&ref_compression->_internal.lock);
+  return false;
+}
+
+AZ_NODISCARD az_result az_http_pipeline_policy_compression(
+    _az_http_policy* ref_policies,
+    void* ref_options,
+    az_http_request* ref_request,
+    az_http_response* ref_response)
+{
+  az_http_policy_compression* const compression = (az_http_policy_compression*)ref_options;
+  az_span const body = ref_request->_internal.body;
+  int32_t content_length_index = -1;
+  az_span compressed = AZ_SPAN_NULL;
+
+  if (compression == NULL || az_span_size(body) == 0
+      || az_span_size(body) < compression->_internal.min_size
+      || ref_request->_internal.body_source._internal.read != NULL
+      || _az_http_request_get_async_state(ref_request) != NULL
+      || !_az_http_policy_compression_find_headers(ref_request, &content_length_index)
+      || !_az_http_policy_compression_compress(compression, body, &compressed))
+  {
+    return _az_http_pipeline_nextpolicy(ref_policies, ref_request, ref_response);
+  }
+
+  // The headers are restored once the request is sent, the size of the compressed body is on the
+  // stack.
+  az_pair* const headers = (az_pair*)az_span_ptr(ref_request->_internal.headers);
+  int32_t const headers_length = ref_request->_internal.headers_length;
+  az_span const content_length
+      = content_length_index >= 0 ? headers[content_length_index].value : AZ_SPAN_NULL;
+  uint8_t content_length_buffer[_az_INT64_AS_STR_BUFFER_SIZE];
+
+  az_result result = az_http_request_append_header(
+      ref_request, _az_http_policy_compression_content_encoding, AZ_SPAN_FROM_STR("gzip"));
+  if (az_succeeded(result) && content_length_index >= 0)
+  {
+    az_span remainder = AZ_SPAN_NULL;
+    result = az_span_i32toa(
+        AZ_SPAN_FROM_BUFFER(content_length_buffer), az_span_size(compressed), &remainder);
+    if (az_succeeded(result))
+    {
+      headers[content_length_index].value = az_span_slice(
+          AZ_SPAN_FROM_BUFFER(content_length_buffer),
+          0,
+          _az_span_diff(remainder, AZ_SPAN_FROM_BUFFER(content_length_buffer)));
+    }
+  }
+
+  if (az_succeeded(result))
+  {
+    ref_request->_internal.body = compressed;
+    result = _az_http_pipeline_nextpolicy(ref_policies, ref_request, ref_response);
+  }
+
+  ref_request->_internal.body = body;
+  ref_request->_internal.headers_length = headers_length;
+  if (content_length_index >= 0)
+  {
+    headers[content_length_index].value = content_length;
+  }
+
+  _az_spinlock_enter_writer(&compression->_internal.lock);
+  compression->_internal.is_busy = false;
+  _az_spinlock_exit_writer(&compression->_internal.lock);
+
+  return result;
+}
@@ -0,0 +1,128 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include <azure/core/az_http.h>
+#include <azure/core/az_http_transport.h>
+#include <azure/core/internal/az_http_internal.h>
+#include <azure/core/internal/az_precondition_internal.h>
+#include <azure/core/internal/az_spinlock_internal.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <azure/core/_az_cfg.h>
+
+enum
+{
+  _az_HTTP_POLICY_HEDGING_MIN_SAMPLES = 16, // Latencies needed before any request is hedged.
+};
+
+void az_http_policy_hedging_init(
+    az_http_policy_hedging* out_hedging,
+    int32_t percentile,
+    int32_t min_delay_msec)
+{
+  _az_PRECONDITION_NOT_NULL(out_hedging);
+  _az_PRECONDITION_RANGE(1, percentile, 99);
+  _az_PRECONDITION_RANGE(0, min_delay_msec, INT32_MAX);
+
+  *out_hedging = (az_http_policy_hedging){
+    ._internal = {
+      .lock = { 0 },
+      .percentile = percentile,
+      .min_delay_msec = min_delay_msec,
+      .latencies_msec = { 0 },
+      .latencies_count = 0,
+      .next_latency = 0,
+    },
+  };
+}
+
+// Gets the delay after which a request is hedged, 0 if there aren't enough latencies yet.
+static int32_t _az_http_policy_hedging_get_delay(az_http_policy_hedging* ref_hedging)
+{
+  int32_t latencies[_az_HTTP_POLICY_HEDGING_SAMPLES];
+
+  _az_spinlock_enter_reader(&ref_hedging->_internal.lock);
+  int32_t const count = ref_hedging->_internal.latencies_count;
+  for (int32_t i = 0; i < count; ++i)
+  {
+    latencies[i] = ref_hedging->_internal.latencies_msec[i];
+  }
+  _az_spinlock_exit_reader(&ref_hedging->_internal.lock);
+
+  if (count < _az_HTTP_POLICY_HEDGING_MIN_SAMPLES)
+  {
+    return 0;
+  }
+
+  // Insertion sort, there are only a few dozen latencies.
+  for (int32_t i = 1; i < count; ++i)
+  {
+    int32_t const latency = latencies[i];
+    int32_t j = i;
+    for (; j > 0 && latencies[j - 1] > latency; --j)
+    {
+      latencies[j] = latencies[j - 1];
+    }
+    latencies[j] = latency;
+  }
+
+  // Nearest-rank percentile.
+  int32_t const rank = (count * ref_hedging->_internal.percentile + 99) / 100;
+  int32_t const delay_msec = latencies[rank - 1] > ref_hedging->_internal.min_delay_msec
+      ? latencies[rank - 1]
+      : ref_hedging->_internal.min_delay_msec;
+
+  return delay_msec > 0 ? delay_msec : 1;
+}
+
+static void _az_http_policy_hedging_add_latency(
+    az_http_policy_hedging* ref_hedging,
+    int64_t latency_msec)
+{
+  _az_spinlock_enter_writer(&ref_hedging->_internal.lock);
+  ref_hedging->_internal.latencies_msec[ref_hedging->_internal.next_latency]
+      = latency_msec < INT32_MAX ? (int32_t)latency_msec : INT32_MAX;
+  ref_hedging->_internal.next_latency
+      = (ref_hedging->_internal.next_latency + 1) % _az_HTTP_POLICY_HEDGING_SAMPLES;
+  if (ref_hedging->_internal.latencies_count < _az_HTTP_POLICY_HEDGING_SAMPLES)
+  {
+    ++ref_hedging->_internal.latencies_count;
+  }
+  _az_spinlock_exit_writer(&ref_hedging->_internal.lock);
+}
+
+AZ_NODISCARD az_result az_http_pipeline_policy_hedging(
+    _az_http_policy* ref_policies,
+    void* ref_options,
+    az_http_request* ref_request,
+    az_http_response* ref_response)
+{
+  az_http_policy_hedging* const hedging = (az_http_policy_hedging*)ref_options;
+
+  // Asynchronous requests don't hold a thread while they wait, they aren't hedged.
+  if (hedging == NULL || _az_http_request_get_async_state(ref_request) != NULL
+      || !(az_span_is_content_equal(ref_request->_internal.method, az_http_method_get())
+           || az_span_is_content_equal(ref_request->_internal.method, az_http_method_head())))
+  {
+    return _az_http_pipeline_nextpolicy(ref_policies, ref_request, ref_response);
+  }
+
+  // The hedge is sent when the response hasn't started after the delay, so the latencies kept are
+  // the times to first byte the transport measures, rather than the time the whole request took.
+  int64_t time_to_first_byte_msec = -1;
+  ref_request->_internal.hedge_delay_msec = _az_http_policy_hedging_get_delay(hedging);
+  ref_request->_internal.time_to_first_byte_msec = &time_to_first_byte_msec;
+
+  az_result const result = _az_http_pipeline_nextpolicy(ref_policies, ref_request, ref_response);
+
+  ref_request->_internal.hedge_delay_msec = 0;
+  ref_request->_internal.time_to_first_byte_msec = NULL;
+  if (az_succeeded(result) && time_to_first_byte_msec >= 0)
+  {
+    _az_http_policy_hedging_add_latency(hedging, time_to_first_byte_msec);
+  }
+
+  return result;
+}
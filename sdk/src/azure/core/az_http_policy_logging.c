@@ -232,7 +232,11 @@ AZ_NODISCARD az_result az_http_pipeline_policy_logging(
 {
   (void)ref_options;
 
-  if (_az_LOG_SHOULD_WRITE(AZ_LOG_HTTP_REQUEST))
+  // When an asynchronous request is resumed, the request was already logged when it was sent.
+  _az_http_async_state const* const async_state = _az_http_request_get_async_state(ref_request);
+  bool const is_resuming = async_state != NULL && async_state->_internal.is_completed;
+
+  if (!is_resuming && _az_LOG_SHOULD_WRITE(AZ_LOG_HTTP_REQUEST))
   {
     _az_http_policy_logging_log_http_request(ref_request);
   }
@@ -247,7 +251,11 @@ AZ_NODISCARD az_result az_http_pipeline_policy_logging(
   az_result const result = _az_http_pipeline_nextpolicy(ref_policies, ref_request, ref_response);
   int64_t const end = az_platform_clock_msec();
 
-  _az_http_policy_logging_log_http_response(ref_response, end - start, ref_request);
+  // There is no response yet, it gets logged once the request is resumed.
+  if (result != AZ_HTTP_REQUEST_PENDING)
+  {
+    _az_http_policy_logging_log_http_response(ref_response, end - start, ref_request);
+  }
 
   return result;
 }
@@ -2,13 +2,16 @@
 // SPDX-License-Identifier: MIT
 
 #include "az_http_private.h"
+#include "az_span_private.h"
 #include <azure/core/az_config.h>
 #include <azure/core/az_platform.h>
 #include <azure/core/internal/az_config_internal.h>
 #include <azure/core/internal/az_http_internal.h>
 #include <azure/core/internal/az_log_internal.h>
+#include <azure/core/internal/az_precondition_internal.h>
 #include <azure/core/internal/az_retry_internal.h>
 #include <azure/core/internal/az_span_internal.h>
+#include <azure/core/internal/az_spinlock_internal.h>
 
 #include <stdbool.h>
 #include <stddef.h>
@@ -34,9 +37,345 @@ AZ_NODISCARD az_http_policy_retry_options _az_http_policy_retry_options_default(
     .max_retry_delay_msec
     = 2 * _az_TIME_SECONDS_PER_MINUTE * _az_TIME_MILLISECONDS_PER_SECOND, // 2 minutes
     .status_codes = _default_status_codes,
+    .try_timeout_msec = 0,
+    .budget = NULL,
+    .circuit_breaker = NULL,
+    .rate_limiter = NULL,
   };
 }
 
+enum
+{
+  _az_HTTP_POLICY_RETRY_BUDGET_RETRY_COST = 10, // Tenths of a token spent by a retry.
+};
+
+void az_http_policy_retry_budget_init(az_http_policy_retry_budget* out_budget, int32_t max_tokens)
+{
+  _az_PRECONDITION_NOT_NULL(out_budget);
+  _az_PRECONDITION_RANGE(1, max_tokens, INT32_MAX / _az_HTTP_POLICY_RETRY_BUDGET_RETRY_COST);
+
+  int32_t const tokens = max_tokens * _az_HTTP_POLICY_RETRY_BUDGET_RETRY_COST;
+  *out_budget = (az_http_policy_retry_budget){
+    ._internal = {
+      .lock = { 0 },
+      .tokens = tokens,
+      .max_tokens = tokens,
+    },
+  };
+}
+
+// Takes the cost of a retry from the budget, returns false if it is empty.
+static bool _az_http_policy_retry_budget_spend(az_http_policy_retry_budget* ref_budget)
+{
+  _az_spinlock_enter_writer(&ref_budget->_internal.lock);
+  bool const can_retry = ref_budget->_internal.tokens >= _az_HTTP_POLICY_RETRY_BUDGET_RETRY_COST;
+  if (can_retry)
+  {
+    ref_budget->_internal.tokens -= _az_HTTP_POLICY_RETRY_BUDGET_RETRY_COST;
+  }
+  _az_spinlock_exit_writer(&ref_budget->_internal.lock);
+
+  return can_retry;
+}
+
+static void _az_http_policy_retry_budget_earn(az_http_policy_retry_budget* ref_budget)
+{
+  _az_spinlock_enter_writer(&ref_budget->_internal.lock);
+  if (ref_budget->_internal.tokens < ref_budget->_internal.max_tokens)
+  {
+    ++ref_budget->_internal.tokens;
+  }
+  _az_spinlock_exit_writer(&ref_budget->_internal.lock);
+}
+
+void az_http_policy_retry_circuit_breaker_init(
+    az_http_policy_retry_circuit_breaker* out_circuit_breaker,
+    int32_t failure_threshold,
+    int32_t open_msec)
+{
+  _az_PRECONDITION_NOT_NULL(out_circuit_breaker);
+  _az_PRECONDITION_RANGE(1, failure_threshold, INT32_MAX);
+  _az_PRECONDITION_RANGE(1, open_msec, INT32_MAX);
+
+  *out_circuit_breaker = (az_http_policy_retry_circuit_breaker){
+    ._internal = {
+      .lock = { 0 },
+      .failure_threshold = failure_threshold,
+      .open_msec = open_msec,
+      .circuits = { { 0 } },
+    },
+  };
+}
+
+// FNV-1a, never 0 so that 0 can mark unused circuits.
+static uint32_t _az_http_policy_retry_hash(az_span span)
+{
+  uint32_t const hash = _az_span_fnv1a_32(span);
+  return hash != 0 ? hash : 1;
+}
+
+// Gets the circuit of the host (and port) of the request url, assigning it a slot if it has none
+// yet. Returns NULL if all the slots are taken by other hosts, or if the host is too long to be
+// kept. The hosts are compared byte for byte, the hash only picks the first slot to look at. The
+// lock of the circuit breaker must be held.
+static _az_http_policy_retry_circuit* _az_http_policy_retry_get_circuit(
+    az_http_policy_retry_circuit_breaker* ref_circuit_breaker,
+    az_span host,
+    uint32_t host_hash)
+{
+  if (az_span_size(host) > _az_HTTP_POLICY_HOST_MAX_SIZE)
+  {
+    return NULL;
+  }
+
+  _az_http_policy_retry_circuit* const circuits = ref_circuit_breaker->_internal.circuits;
+  for (int32_t i = 0; i < _az_HTTP_POLICY_RETRY_CIRCUIT_BREAKER_HOSTS; ++i)
+  {
+    _az_http_policy_retry_circuit* const circuit
+        = &circuits[(host_hash + (uint32_t)i) % _az_HTTP_POLICY_RETRY_CIRCUIT_BREAKER_HOSTS];
+
+    if (circuit->host_hash == host_hash
+        && az_span_is_content_equal(az_span_create(circuit->host, circuit->host_size), host))
+    {
+      return circuit;
+    }
+
+    if (circuit->host_hash == 0)
+    {
+      circuit->host_hash = host_hash;
+      circuit->host_size = az_span_size(host);
+      az_span_copy(AZ_SPAN_FROM_BUFFER(circuit->host), host);
+      return circuit;
+    }
+  }
+
+  return NULL;
+}
+
+// Returns false if the circuit of the host is open. Once the open duration has elapsed, lets one
+// request through as a probe, and keeps the circuit open for the others: if the probe never
+// reports back, another one goes through after the open duration.
+static bool _az_http_policy_retry_circuit_allows(
+    az_http_policy_retry_circuit_breaker* ref_circuit_breaker,
+    az_span host,
+    uint32_t host_hash)
+{
+  bool allows = true;
+  _az_spinlock_enter_writer(&ref_circuit_breaker->_internal.lock);
+  _az_http_policy_retry_circuit* const circuit
+      = _az_http_policy_retry_get_circuit(ref_circuit_breaker, host, host_hash);
+
+  if (circuit != NULL && circuit->open_until_msec != 0)
+  {
+    int64_t const now_msec = az_platform_clock_msec();
+    allows = now_msec >= circuit->open_until_msec;
+    if (allows)
+    {
+      circuit->open_until_msec = now_msec + ref_circuit_breaker->_internal.open_msec;
+    }
+  }
+  _az_spinlock_exit_writer(&ref_circuit_breaker->_internal.lock);
+
+  return allows;
+}
+
+// Records the outcome of an attempt, returns true if the circuit of the host is open.
+static bool _az_http_policy_retry_circuit_record(
+    az_http_policy_retry_circuit_breaker* ref_circuit_breaker,
+    az_span host,
+    uint32_t host_hash,
+    bool has_failed)
+{
+  bool is_open = false;
+  _az_spinlock_enter_writer(&ref_circuit_breaker->_internal.lock);
+  _az_http_policy_retry_circuit* const circuit
+      = _az_http_policy_retry_get_circuit(ref_circuit_breaker, host, host_hash);
+
+  if (circuit != NULL)
+  {
+    if (!has_failed)
+    {
+      circuit->failures = 0;
+      circuit->open_until_msec = 0;
+    }
+    else
+    {
+      if (circuit->failures < INT32_MAX)
+      {
+        ++circuit->failures;
+      }
+
+      if (circuit->failures >= ref_circuit_breaker->_internal.failure_threshold)
+      {
+        circuit->open_until_msec
+            = az_platform_clock_msec() + ref_circuit_breaker->_internal.open_msec;
+        is_open = true;
+      }
+    }
+  }
+  _az_spinlock_exit_writer(&ref_circuit_breaker->_internal.lock);
+
+  return is_open;
+}
+
+enum
+{
+  _az_HTTP_POLICY_RATE_LIMITER_MIN_RATE = 100, // A request every 10 seconds.
+  _az_HTTP_POLICY_RATE_LIMITER_MAX_RATE = 1000 * 1000 * 1000,
+  _az_HTTP_POLICY_RATE_LIMITER_WINDOW_MSEC = 1000,
+};
+
+void az_http_policy_rate_limiter_init(az_http_policy_rate_limiter* out_rate_limiter)
+{
+  _az_PRECONDITION_NOT_NULL(out_rate_limiter);
+
+  *out_rate_limiter = (az_http_policy_rate_limiter){
+    ._internal = {
+      .lock = { 0 },
+      .rate = 0,
+      .next_send_usec = 0,
+      .blocked_until_msec = 0,
+      .last_decrease_msec = 0,
+      .window_start_msec = 0,
+      .window_sends = 0,
+      .window_rate = 0,
+    },
+  };
+}
+
+// Takes the next turn to send a request, not before earliest_msec. Returns the time the request
+// can be sent at.
+static int64_t _az_http_policy_rate_limiter_acquire(
+    az_http_policy_rate_limiter* ref_rate_limiter,
+    int64_t now_msec,
+    int64_t earliest_msec)
+{
+  _az_spinlock_enter_writer(&ref_rate_limiter->_internal.lock);
+
+  // Measure the rate requests are sent at, to know where to start from when one is throttled.
+  int64_t const window_msec = now_msec - ref_rate_limiter->_internal.window_start_msec;
+  if (window_msec >= _az_HTTP_POLICY_RATE_LIMITER_WINDOW_MSEC)
+  {
+    ref_rate_limiter->_internal.window_rate
+        = ref_rate_limiter->_internal.window_sends * 1000LL * 1000 / window_msec;
+    ref_rate_limiter->_internal.window_start_msec = now_msec;
+    ref_rate_limiter->_internal.window_sends = 0;
+  }
+  ++ref_rate_limiter->_internal.window_sends;
+
+  int64_t send_msec = earliest_msec > ref_rate_limiter->_internal.blocked_until_msec
+      ? earliest_msec
+      : ref_rate_limiter->_internal.blocked_until_msec;
+
+  int64_t const rate = ref_rate_limiter->_internal.rate;
+  if (rate > 0)
+  {
+    int64_t send_usec = send_msec * 1000;
+    if (ref_rate_limiter->_internal.next_send_usec > send_usec)
+    {
+      send_usec = ref_rate_limiter->_internal.next_send_usec;
+    }
+    ref_rate_limiter->_internal.next_send_usec = send_usec + 1000LL * 1000 * 1000 / rate;
+    send_msec = (send_usec + 999) / 1000;
+  }
+
+  _az_spinlock_exit_writer(&ref_rate_limiter->_internal.lock);
+
+  return send_msec;
+}
+
+// Adapts the rate to the response of an attempt.
+static void _az_http_policy_rate_limiter_record(
+    az_http_policy_rate_limiter* ref_rate_limiter,
+    int64_t now_msec,
+    bool is_throttled,
+    int32_t retry_after_msec)
+{
+  _az_spinlock_enter_writer(&ref_rate_limiter->_internal.lock);
+
+  int64_t const rate = ref_rate_limiter->_internal.rate;
+  if (!is_throttled)
+  {
+    // Additive increase: rate requests take about a second to be sent, so the rate goes up by
+    // about one request per second every second.
+    if (rate > 0 && rate < _az_HTTP_POLICY_RATE_LIMITER_MAX_RATE)
+    {
+      ref_rate_limiter->_internal.rate = rate + (1000LL * 1000 + rate - 1) / rate;
+    }
+  }
+  else
+  {
+    if (retry_after_msec >= 0
+        && now_msec + retry_after_msec > ref_rate_limiter->_internal.blocked_until_msec)
+    {
+      ref_rate_limiter->_internal.blocked_until_msec = now_msec + retry_after_msec;
+    }
+
+    // Multiplicative decrease, from the rate requests were actually sent at. The requests that
+    // were in flight when the rate was decreased get throttled too, it only decreases once per
+    // window.
+    if (rate == 0
+        || now_msec - ref_rate_limiter->_internal.last_decrease_msec
+            >= _az_HTTP_POLICY_RATE_LIMITER_WINDOW_MSEC)
+    {
+      int64_t const window_msec = now_msec - ref_rate_limiter->_internal.window_start_msec;
+      int64_t sent_rate = ref_rate_limiter->_internal.window_sends * 1000LL * 1000
+          / (window_msec > _az_HTTP_POLICY_RATE_LIMITER_WINDOW_MSEC
+                 ? window_msec
+                 : _az_HTTP_POLICY_RATE_LIMITER_WINDOW_MSEC);
+      if (ref_rate_limiter->_internal.window_rate > sent_rate)
+      {
+        sent_rate = ref_rate_limiter->_internal.window_rate;
+      }
+      if (rate > 0 && rate < sent_rate)
+      {
+        sent_rate = rate;
+      }
+
+      int64_t const decreased_rate = sent_rate * 7 / 10;
+      ref_rate_limiter->_internal.rate = decreased_rate > _az_HTTP_POLICY_RATE_LIMITER_MIN_RATE
+          ? decreased_rate
+          : _az_HTTP_POLICY_RATE_LIMITER_MIN_RATE;
+      ref_rate_limiter->_internal.last_decrease_msec = now_msec;
+    }
+  }
+
+  _az_spinlock_exit_writer(&ref_rate_limiter->_internal.lock);
+}
+
+static _az_spinlock _az_http_policy_retry_random_lock = { 0 };
+static uint64_t _az_http_policy_retry_random_state = 0;
+
+// SplitMix64, seeded with an address on the stack, which differs between processes that randomize
+// their address space. Devices that don't are told apart by the entropy mixed in, the hash of the
+// request id the service gave to the failed response.
+static uint32_t _az_http_policy_retry_random(uint32_t entropy)
+{
+  uint8_t stack_marker = 0;
+
+  _az_spinlock_enter_writer(&_az_http_policy_retry_random_lock);
+  if (_az_http_policy_retry_random_state == 0)
+  {
+    _az_http_policy_retry_random_state = (uint64_t)(uintptr_t)&stack_marker;
+  }
+  _az_http_policy_retry_random_state += 0x9E3779B97F4A7C15ULL + entropy;
+  uint64_t z = _az_http_policy_retry_random_state;
+  _az_spinlock_exit_writer(&_az_http_policy_retry_random_lock);
+
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+  return (uint32_t)((z ^ (z >> 31)) >> 32);
+}
+
+static uint32_t _az_http_policy_retry_get_entropy(az_http_response* ref_response)
+{
+  az_span request_id = AZ_SPAN_NULL;
+  return az_succeeded(az_http_response_get_header(
+             ref_response, AZ_SPAN_FROM_STR("x-ms-request-id"), &request_id))
+      ? _az_http_policy_retry_hash(request_id)
+      : 0;
+}
+
 // TODO: Add unit tests
 AZ_INLINE az_result _az_http_policy_retry_append_http_retry_msg(
     int32_t attempt,
@@ -85,67 +424,80 @@ AZ_INLINE AZ_NODISCARD int32_t _az_uint32_span_to_int32(az_span span)
   return -1;
 }
 
-AZ_INLINE AZ_NODISCARD az_result _az_http_policy_retry_get_retry_after(
-    az_http_response* ref_response,
-    az_http_status_code const* status_codes,
-    bool* should_retry,
-    int32_t* retry_after_msec)
+// Gets the delay the response asks for before a retry, -1 if it doesn't say.
+static AZ_NODISCARD int32_t _az_http_policy_retry_get_retry_after(az_http_response* ref_response)
 {
-  az_http_response_status_line status_line = { 0 };
-  AZ_RETURN_IF_FAILED(az_http_response_get_status_line(ref_response, &status_line));
-  az_http_status_code const response_code = status_line.status_code;
-
-  for (; *status_codes != AZ_HTTP_STATUS_CODE_END_OF_LIST; ++status_codes)
+  // These are single lookups when the response has a header index.
+  az_span value = AZ_SPAN_NULL;
+  if (az_succeeded(
+          az_http_response_get_header(ref_response, AZ_SPAN_FROM_STR("retry-after-ms"), &value))
+      || az_succeeded(az_http_response_get_header(
+          ref_response, AZ_SPAN_FROM_STR("x-ms-retry-after-ms"), &value)))
   {
-    if (*status_codes != response_code)
+    // The value is in milliseconds.
+    int32_t const msec = _az_uint32_span_to_int32(value);
+    if (msec >= 0) // int32_t max == ~24 days
     {
-      continue;
+      return msec;
     }
+  }
 
-    // Try to get the value of retry-after header, if there's one.
-    *should_retry = true;
+  if (az_succeeded(
+          az_http_response_get_header(ref_response, AZ_SPAN_FROM_STR("Retry-After"), &value)))
+  {
+    // The value is either seconds or date.
+    int32_t const seconds = _az_uint32_span_to_int32(value);
+    if (seconds >= 0) // int32_t max == ~68 years
+    {
+      return (seconds <= (INT32_MAX / _az_TIME_MILLISECONDS_PER_SECOND))
+          ? seconds * _az_TIME_MILLISECONDS_PER_SECOND
+          : INT32_MAX;
+    }
 
-    az_pair header = { 0 };
-    while (az_http_response_get_next_header(ref_response, &header) == AZ_OK)
+    // An HTTP-date. Devices may not have a calendar clock, the delay is counted from the Date the
+    // response was sent at.
+    int64_t retry_after_sec = 0;
+    int64_t date_sec = 0;
+    az_span date = AZ_SPAN_NULL;
+    if (az_succeeded(_az_http_parse_date(value, &retry_after_sec))
+        && az_succeeded(
+            az_http_response_get_header(ref_response, AZ_SPAN_FROM_STR("Date"), &date))
+        && az_succeeded(_az_http_parse_date(date, &date_sec)))
     {
-      if (az_span_is_content_equal_ignoring_case(header.key, AZ_SPAN_FROM_STR("retry-after-ms"))
-          || az_span_is_content_equal_ignoring_case(
-              header.key, AZ_SPAN_FROM_STR("x-ms-retry-after-ms")))
-      {
-        // The value is in milliseconds.
-        int32_t const msec = _az_uint32_span_to_int32(header.value);
-        if (msec >= 0) // int32_t max == ~24 days
-        {
-          *retry_after_msec = msec;
-          return AZ_OK;
-        }
-      }
-      else if (az_span_is_content_equal_ignoring_case(header.key, AZ_SPAN_FROM_STR("Retry-After")))
-      {
-        // The value is either seconds or date.
-        int32_t const seconds = _az_uint32_span_to_int32(header.value);
-        if (seconds >= 0) // int32_t max == ~68 years
-        {
-          *retry_after_msec = (seconds <= (INT32_MAX / _az_TIME_MILLISECONDS_PER_SECOND))
-              ? seconds * _az_TIME_MILLISECONDS_PER_SECOND
-              : INT32_MAX;
+      int64_t const delay_sec = retry_after_sec - date_sec;
+      return delay_sec <= 0
+          ? 0
+          : (delay_sec <= (INT32_MAX / _az_TIME_MILLISECONDS_PER_SECOND)
+                 ? (int32_t)delay_sec * _az_TIME_MILLISECONDS_PER_SECOND
+                 : INT32_MAX);
+    }
+  }
 
-          return AZ_OK;
-        }
+  return -1;
+}
 
-        // TODO: Other possible value is HTTP Date. For that, we'll need to parse date, get
-        // current date, subtract one from another, get seconds. And the device should have a
-        // sense of calendar clock.
-      }
+AZ_NODISCARD AZ_INLINE bool _az_http_policy_retry_is_retriable(
+    az_http_status_code const* status_codes,
+    az_http_status_code status_code)
+{
+  for (; *status_codes != AZ_HTTP_STATUS_CODE_END_OF_LIST; ++status_codes)
+  {
+    if (*status_codes == status_code)
+    {
+      return true;
     }
-
-    *retry_after_msec = -1;
-    return AZ_OK;
   }
 
-  *should_retry = false;
-  *retry_after_msec = -1;
-  return AZ_OK;
+  return false;
+}
+
+// Whether an attempt that failed with result failed because of its host: the transport couldn't
+// reach it, or it didn't answer in time. The errors on the side of the client (e.g. a response
+// overflowing its buffer, or a credential failing to get a token) say nothing about its health.
+AZ_NODISCARD AZ_INLINE bool _az_http_policy_retry_is_host_failure(az_result result)
+{
+  return result == AZ_ERROR_HTTP_PLATFORM || result == AZ_ERROR_HTTP_RESPONSE_COULDNT_RESOLVE_HOST
+      || result == AZ_ERROR_HTTP_ATTEMPT_TIMEOUT;
 }
 
 AZ_NODISCARD az_result az_http_pipeline_policy_retry(
@@ -160,35 +512,139 @@ AZ_NODISCARD az_result az_http_pipeline_policy_retry(
   int32_t const max_retries = retry_options->max_retries;
   int32_t const retry_delay_msec = retry_options->retry_delay_msec;
   int32_t const max_retry_delay_msec = retry_options->max_retry_delay_msec;
+  int32_t const try_timeout_msec = retry_options->try_timeout_msec;
   az_http_status_code const* const status_codes = retry_options->status_codes;
+  az_http_policy_retry_budget* const budget = retry_options->budget;
+  az_http_policy_retry_circuit_breaker* const circuit_breaker = retry_options->circuit_breaker;
+  az_http_policy_rate_limiter* const rate_limiter = retry_options->rate_limiter;
+
+  // When the request is sent asynchronously, this policy gets called again, with the response and
+  // the attempt it was waiting for, once the response has been received.
+  _az_http_async_state* const async_state = _az_http_request_get_async_state(ref_request);
+  bool is_resuming = async_state != NULL && async_state->_internal.attempt > 0;
+
+  // The circuits are kept per host (and port) of the request url.
+  az_span const host
+      = circuit_breaker != NULL ? _az_http_request_get_host(ref_request) : AZ_SPAN_NULL;
+  uint32_t const host_hash = circuit_breaker != NULL ? _az_http_policy_retry_hash(host) : 0;
+
+  if (!is_resuming)
+  {
+    if (circuit_breaker != NULL
+        && !_az_http_policy_retry_circuit_allows(circuit_breaker, host, host_hash))
+    {
+      return AZ_ERROR_HTTP_CIRCUIT_OPEN;
+    }
 
-  AZ_RETURN_IF_FAILED(_az_http_request_mark_retry_headers_start(ref_request));
+    AZ_RETURN_IF_FAILED(_az_http_request_mark_retry_headers_start(ref_request));
+  }
 
   az_context* const context = ref_request->_internal.context;
 
   bool const should_log = _az_LOG_SHOULD_WRITE(AZ_LOG_HTTP_RETRY);
+  bool const needs_status = budget != NULL || circuit_breaker != NULL || rate_limiter != NULL;
   az_result result = AZ_OK;
-  int32_t attempt = 1;
+  int32_t attempt = is_resuming ? async_state->_internal.attempt : 1;
+  int32_t delay_msec = is_resuming ? async_state->_internal.retry_delay_msec : 0;
   while (true)
   {
-    AZ_RETURN_IF_FAILED(az_http_response_init(ref_response, ref_response->_internal.http_response));
+    if (!is_resuming)
+    {
+      _az_http_response_reset(ref_response);
+
+      if (rate_limiter != NULL)
+      {
+        // Wait for the turn of this attempt. An asynchronous retry is already held by the
+        // transport until its delay has elapsed.
+        int64_t const now_msec = az_platform_clock_msec();
+        int64_t const earliest_msec
+            = async_state != NULL && async_state->_internal.not_before_msec > now_msec
+            ? async_state->_internal.not_before_msec
+            : now_msec;
+        int64_t const send_msec
+            = _az_http_policy_rate_limiter_acquire(rate_limiter, now_msec, earliest_msec);
+
+        if (async_state != NULL)
+        {
+          async_state->_internal.not_before_msec = send_msec;
+        }
+        else if (send_msec > now_msec)
+        {
+          az_platform_sleep_msec((int32_t)(send_msec - now_msec));
+        }
+      }
+    }
+    is_resuming = false;
     AZ_RETURN_IF_FAILED(_az_http_request_remove_retry_headers(ref_request));
 
+    if (async_state != NULL)
+    {
+      async_state->_internal.attempt = attempt;
+      async_state->_internal.retry_delay_msec = delay_msec;
+    }
+
+    ref_request->_internal.try_timeout_msec = try_timeout_msec;
     result = _az_http_pipeline_nextpolicy(ref_policies, ref_request, ref_response);
 
-    // Even HTTP 429, or 502 are expected to be AZ_OK, so the failed result is not retriable.
-    if (attempt > max_retries || az_failed(result))
+    if (result == AZ_HTTP_REQUEST_PENDING)
     {
-      return result;
+      return _az_http_async_state_suspend(
+          async_state, ref_policies, az_http_pipeline_policy_retry, ref_options, ref_request);
     }
 
     int32_t retry_after_msec = -1;
-    bool should_retry = false;
+    bool should_retry = result == AZ_ERROR_HTTP_ATTEMPT_TIMEOUT;
     az_http_response response_copy = *ref_response;
-    AZ_RETURN_IF_FAILED(_az_http_policy_retry_get_retry_after(
-        &response_copy, status_codes, &should_retry, &retry_after_msec));
+    if (az_succeeded(result) && (attempt <= max_retries || needs_status))
+    {
+      az_http_response_status_line status_line = { 0 };
+      AZ_RETURN_IF_FAILED(az_http_response_get_status_line(&response_copy, &status_line));
+      should_retry = _az_http_policy_retry_is_retriable(status_codes, status_line.status_code);
 
-    if (!should_retry)
+      bool const is_throttled = status_line.status_code == AZ_HTTP_STATUS_CODE_TOO_MANY_REQUESTS
+          || status_line.status_code == AZ_HTTP_STATUS_CODE_SERVICE_UNAVAILABLE;
+      if (should_retry || (rate_limiter != NULL && is_throttled))
+      {
+        retry_after_msec = _az_http_policy_retry_get_retry_after(&response_copy);
+      }
+
+      if (rate_limiter != NULL)
+      {
+        _az_http_policy_rate_limiter_record(
+            rate_limiter, az_platform_clock_msec(), is_throttled, retry_after_msec);
+      }
+    }
+
+    // A response with a retriable status code counts as a failure of the host, one that failed on
+    // the side of the client, or a canceled request, isn't counted.
+    if (circuit_breaker != NULL
+        && (az_succeeded(result) || _az_http_policy_retry_is_host_failure(result))
+        && _az_http_policy_retry_circuit_record(
+            circuit_breaker, host, host_hash, az_failed(result) || should_retry))
+    {
+      return result;
+    }
+
+    // The body callback can't take back the bytes it already received, a retry would stream the
+    // body to it again from its start.
+    if (ref_response->_internal.body.has_streamed_bytes)
+    {
+      should_retry = false;
+    }
+
+    if (budget != NULL && az_succeeded(result) && !should_retry)
+    {
+      _az_http_policy_retry_budget_earn(budget);
+    }
+
+    // Even HTTP 429, or 502 are expected to be AZ_OK, so the failed result is not retriable, unless
+    // the attempt timed out.
+    if (attempt > max_retries || !should_retry)
+    {
+      return result;
+    }
+
+    if (budget != NULL && !_az_http_policy_retry_budget_spend(budget))
     {
       return result;
     }
@@ -197,7 +653,30 @@ AZ_NODISCARD az_result az_http_pipeline_policy_retry(
 
     if (retry_after_msec < 0)
     { // there wasn't any kind of "retry-after" response header
-      retry_after_msec = _az_retry_calc_delay(attempt, retry_delay_msec, max_retry_delay_msec);
+      delay_msec = _az_retry_calc_decorrelated_delay(
+          delay_msec,
+          retry_delay_msec,
+          max_retry_delay_msec,
+          _az_http_policy_retry_random(
+              az_succeeded(result) ? _az_http_policy_retry_get_entropy(&response_copy) : 0));
+      retry_after_msec = delay_msec;
+    }
+
+    // Don't wait for a retry that would be sent after the deadline of the request, return the last
+    // response instead.
+    if (context != NULL && az_context_get_expiration(context) != _az_CONTEXT_MAX_EXPIRATION)
+    {
+      int64_t const now_msec = az_platform_clock_msec();
+      int64_t const expiration_msec = az_context_get_expiration(context);
+      if (now_msec >= expiration_msec)
+      {
+        return AZ_ERROR_CANCELED;
+      }
+
+      if (now_msec + retry_after_msec >= expiration_msec)
+      {
+        return result;
+      }
     }
 
     if (should_log)
@@ -205,12 +684,26 @@ AZ_NODISCARD az_result az_http_pipeline_policy_retry(
       _az_http_policy_retry_log(attempt, retry_after_msec);
     }
 
-    az_platform_sleep_msec(retry_after_msec);
+    if (async_state != NULL)
+    {
+      // Don't block the thread driving the asynchronous requests, the transport delays the send.
+      async_state->_internal.not_before_msec = az_platform_clock_msec() + retry_after_msec;
+    }
+    else
+    {
+      az_platform_sleep_msec(retry_after_msec);
+    }
 
     if (context != NULL && az_context_has_expired(context, az_platform_clock_msec()))
     {
       return AZ_ERROR_CANCELED;
     }
+
+    az_http_metrics* const metrics = _az_http_request_get_metrics(ref_request);
+    if (metrics != NULL)
+    {
+      ++metrics->retry_count;
+    }
   }
 
   return result;
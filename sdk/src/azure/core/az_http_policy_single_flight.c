@@ -0,0 +1,262 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "az_http_private.h"
+#include "az_span_private.h"
+#include <azure/core/az_context.h>
+#include <azure/core/az_http.h>
+#include <azure/core/az_http_transport.h>
+#include <azure/core/az_platform.h>
+#include <azure/core/internal/az_http_internal.h>
+#include <azure/core/internal/az_precondition_internal.h>
+#include <azure/core/internal/az_spinlock_internal.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <azure/core/_az_cfg.h>
+
+enum
+{
+  // Size of the stack buffer the key of a request is laid out in. Requests with a larger key aren't
+  // coalesced.
+  _az_HTTP_POLICY_SINGLE_FLIGHT_KEY_SIZE = AZ_HTTP_REQUEST_URL_BUFFER_SIZE + 1024,
+
+  _az_HTTP_POLICY_SINGLE_FLIGHT_POLL_MSEC = 1, // How often followers check for the response.
+};
+
+// Headers whose value differs between otherwise identical requests.
+static az_span const _az_http_policy_single_flight_ignored_headers[] = {
+  AZ_SPAN_LITERAL_FROM_STR("x-ms-client-request-id"),
+};
+
+void az_http_policy_single_flight_init(az_http_policy_single_flight* out_single_flight)
+{
+  _az_PRECONDITION_NOT_NULL(out_single_flight);
+
+  *out_single_flight = (az_http_policy_single_flight){ 0 };
+}
+
+static bool _az_http_policy_single_flight_is_ignored(az_span header_name)
+{
+  for (size_t i = 0; i < sizeof(_az_http_policy_single_flight_ignored_headers)
+           / sizeof(_az_http_policy_single_flight_ignored_headers[0]);
+       ++i)
+  {
+    if (az_span_is_content_equal_ignoring_case(
+            header_name, _az_http_policy_single_flight_ignored_headers[i]))
+    {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+// Lays out the url and the headers of request in buffer. Returns false if they don't fit.
+static bool _az_http_policy_single_flight_get_key(
+    az_http_request const* request,
+    az_span buffer,
+    az_span* out_key)
+{
+  az_span const url = az_span_slice(request->_internal.url, 0, request->_internal.url_length);
+  if (az_span_size(buffer) < az_span_size(url) + 1)
+  {
+    return false;
+  }
+  az_span remainder = az_span_copy(buffer, url);
+  remainder = az_span_copy_u8(remainder, '\n');
+
+  for (int32_t i = 0; i < az_http_request_headers_count(request); ++i)
+  {
+    az_pair header = { 0 };
+    if (az_failed(az_http_request_get_header(request, i, &header)))
+    {
+      return false;
+    }
+
+    if (_az_http_policy_single_flight_is_ignored(header.key))
+    {
+      continue;
+    }
+
+    if (az_span_size(remainder) < az_span_size(header.key) + az_span_size(header.value) + 2)
+    {
+      return false;
+    }
+    remainder = az_span_copy(remainder, header.key);
+    remainder = az_span_copy_u8(remainder, ':');
+    remainder = az_span_copy(remainder, header.value);
+    remainder = az_span_copy_u8(remainder, '\n');
+  }
+
+  *out_key = az_span_slice(buffer, 0, az_span_size(buffer) - az_span_size(remainder));
+  return true;
+}
+
+// Sends the request, then lets the followers copy the response before returning it.
+static AZ_NODISCARD az_result _az_http_policy_single_flight_lead(
+    _az_http_policy* ref_policies,
+    az_http_policy_single_flight* ref_single_flight,
+    _az_http_policy_single_flight_call* ref_call,
+    az_http_request* ref_request,
+    az_http_response* ref_response)
+{
+  az_result const result = _az_http_pipeline_nextpolicy(ref_policies, ref_request, ref_response);
+
+  _az_spinlock_enter_writer(&ref_single_flight->_internal.lock);
+  ref_call->result = result;
+  ref_call->response = ref_response;
+  ref_call->is_done = true;
+  _az_spinlock_exit_writer(&ref_single_flight->_internal.lock);
+
+  // The response must stay valid until the followers are done copying it. Requests can join the
+  // call until it is released, with the lock held, once no follower is left.
+  bool is_released = false;
+  while (!is_released)
+  {
+    _az_spinlock_enter_writer(&ref_single_flight->_internal.lock);
+    if (ref_call->followers == 0)
+    {
+      ref_call->is_used = false;
+      is_released = true;
+    }
+    _az_spinlock_exit_writer(&ref_single_flight->_internal.lock);
+
+    if (!is_released)
+    {
+      az_platform_sleep_msec(_az_HTTP_POLICY_SINGLE_FLIGHT_POLL_MSEC);
+    }
+  }
+
+  return result;
+}
+
+// Waits for the leader and copies its response, or sends the request if the leader failed.
+static AZ_NODISCARD az_result _az_http_policy_single_flight_follow(
+    _az_http_policy* ref_policies,
+    az_http_policy_single_flight* ref_single_flight,
+    _az_http_policy_single_flight_call* ref_call,
+    az_http_request* ref_request,
+    az_http_response* ref_response)
+{
+  az_context const* const context = ref_request->_internal.context;
+  bool const has_deadline
+      = context != NULL && az_context_get_expiration(context) != _az_CONTEXT_MAX_EXPIRATION;
+
+  bool is_done = false;
+  while (true)
+  {
+    _az_spinlock_enter_reader(&ref_single_flight->_internal.lock);
+    is_done = ref_call->is_done;
+    _az_spinlock_exit_reader(&ref_single_flight->_internal.lock);
+
+    if (is_done || (has_deadline && az_context_has_expired(context, az_platform_clock_msec())))
+    {
+      break;
+    }
+
+    az_platform_sleep_msec(_az_HTTP_POLICY_SINGLE_FLIGHT_POLL_MSEC);
+  }
+
+  // The result and the response of the leader don't change once the call is done.
+  bool is_copied = false;
+  if (is_done && az_succeeded(ref_call->result))
+  {
+    // The transport adapter appended the response to the buffer of the leader.
+    az_http_response const* const response = ref_call->response;
+    az_span const content
+        = az_span_slice(response->_internal.http_response, 0, response->_internal.written);
+
+    _az_http_response_reset(ref_response);
+    is_copied = az_succeeded(az_http_response_append(ref_response, content));
+  }
+
+  _az_spinlock_enter_writer(&ref_single_flight->_internal.lock);
+  --ref_call->followers;
+  _az_spinlock_exit_writer(&ref_single_flight->_internal.lock);
+
+  if (!is_done)
+  {
+    return AZ_ERROR_CANCELED;
+  }
+
+  if (is_copied)
+  {
+    return AZ_OK;
+  }
+
+  _az_http_response_reset(ref_response);
+  return _az_http_pipeline_nextpolicy(ref_policies, ref_request, ref_response);
+}
+
+AZ_NODISCARD az_result az_http_pipeline_policy_single_flight(
+    _az_http_policy* ref_policies,
+    void* ref_options,
+    az_http_request* ref_request,
+    az_http_response* ref_response)
+{
+  az_http_policy_single_flight* const single_flight = (az_http_policy_single_flight*)ref_options;
+
+  // The key is laid out on the stack of the leader, where followers compare theirs with it.
+  uint8_t key_buffer[_az_HTTP_POLICY_SINGLE_FLIGHT_KEY_SIZE];
+  az_span key = AZ_SPAN_NULL;
+  if (single_flight == NULL || _az_http_request_get_async_state(ref_request) != NULL
+      || ref_response->_internal.body.callback != NULL
+      || !az_span_is_content_equal(ref_request->_internal.method, az_http_method_get())
+      || !_az_http_policy_single_flight_get_key(
+          ref_request, AZ_SPAN_FROM_BUFFER(key_buffer), &key))
+  {
+    return _az_http_pipeline_nextpolicy(ref_policies, ref_request, ref_response);
+  }
+
+  // Hashed to skip comparing the keys of most of the calls in flight.
+  uint64_t const key_hash = _az_span_fnv1a_64(key);
+
+  // Join the identical request in flight, if any, or lead a new call.
+  _az_http_policy_single_flight_call* call = NULL;
+  _az_http_policy_single_flight_call* unused_call = NULL;
+  _az_spinlock_enter_writer(&single_flight->_internal.lock);
+  for (int32_t i = 0; i < _az_HTTP_POLICY_SINGLE_FLIGHT_CALLS; ++i)
+  {
+    _az_http_policy_single_flight_call* const candidate = &single_flight->_internal.calls[i];
+    if (!candidate->is_used)
+    {
+      unused_call = unused_call == NULL ? candidate : unused_call;
+    }
+    else if (candidate->key_hash == key_hash && az_span_is_content_equal(candidate->key, key))
+    {
+      call = candidate;
+      ++call->followers;
+      break;
+    }
+  }
+
+  bool const is_leader = call == NULL && unused_call != NULL;
+  if (is_leader)
+  {
+    call = unused_call;
+    *call = (_az_http_policy_single_flight_call){
+      .key_hash = key_hash,
+      .key = key,
+      .response = NULL,
+      .result = AZ_OK,
+      .followers = 0,
+      .is_used = true,
+      .is_done = false,
+    };
+  }
+  _az_spinlock_exit_writer(&single_flight->_internal.lock);
+
+  if (call == NULL)
+  {
+    // Too many distinct requests in flight, this one isn't coalesced.
+    return _az_http_pipeline_nextpolicy(ref_policies, ref_request, ref_response);
+  }
+
+  return is_leader
+      ? _az_http_policy_single_flight_lead(
+          ref_policies, single_flight, call, ref_request, ref_response)
+      : _az_http_policy_single_flight_follow(
+          ref_policies, single_flight, call, ref_request, ref_response);
+}
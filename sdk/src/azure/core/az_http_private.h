@@ -47,6 +47,19 @@ AZ_NODISCARD AZ_INLINE az_result _az_http_request_remove_retry_headers(az_http_r
  */
 void _az_http_response_reset(az_http_response* ref_response);
 
+/**
+ * @brief Parses an HTTP-date in the IMF-fixdate format (e.g. `Sun, 06 Nov 1994 08:49:37 GMT`), the
+ * one servers send in the `Date` and `Retry-After` headers.
+ *
+ * @param[in] value The header value.
+ * @param[out] out_unix_sec The number of seconds between 1970-01-01T00:00:00Z and the date.
+ *
+ * @return
+ *   - *`AZ_OK`* success.
+ *   - *`AZ_ERROR_UNEXPECTED_CHAR`* \p value is not an IMF-fixdate.
+ */
+AZ_NODISCARD az_result _az_http_parse_date(az_span value, int64_t* out_unix_sec);
+
 #include <azure/core/_az_cfg_suffix.h>
 
 #endif // _az_HTTP_PRIVATE_H
@@ -12,6 +12,8 @@
 #include <azure/core/internal/az_precondition_internal.h>
 
 #include <assert.h>
+#include <stdint.h>
+#include <string.h>
 
 #include <azure/core/_az_cfg.h>
 
@@ -55,6 +57,11 @@ AZ_NODISCARD az_result az_http_request_init(
                                = az_span_size(headers_buffer) / (int32_t)sizeof(az_pair),
                                .retry_headers_start_byte_offset = 0,
                                .body = body,
+                               .body_source = { 0 },
+                               .hedge_delay_msec = 0,
+                               .time_to_first_byte_msec = NULL,
+                               .try_timeout_msec = 0,
+                               .metrics = NULL,
                            } };
 
   return AZ_OK;
@@ -328,7 +335,181 @@ AZ_NODISCARD az_result az_http_request_get_body(az_http_request const* request,
   return AZ_OK;
 }
 
+AZ_NODISCARD az_result
+az_http_request_set_body_source(az_http_request* ref_request, az_http_body_source const* source)
+{
+  _az_PRECONDITION_NOT_NULL(ref_request);
+  _az_PRECONDITION_NOT_NULL(source);
+  _az_PRECONDITION_NOT_NULL(source->_internal.read);
+
+  ref_request->_internal.body_source = *source;
+  ref_request->_internal.body = AZ_SPAN_NULL;
+
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result
+az_http_request_get_body_source(az_http_request const* request, az_http_body_source* out_source)
+{
+  _az_PRECONDITION_NOT_NULL(request);
+  _az_PRECONDITION_NOT_NULL(out_source);
+
+  if (request->_internal.body_source._internal.read != NULL)
+  {
+    *out_source = request->_internal.body_source;
+    return AZ_OK;
+  }
+
+  return az_http_body_source_init_from_buffer(
+      out_source,
+      az_span_ptr(request->_internal.body),
+      az_span_size(request->_internal.body));
+}
+
+AZ_NODISCARD az_result az_http_body_source_init(
+    az_http_body_source* out_source,
+    int64_t length,
+    az_http_body_source_read_fn read,
+    void* user_context)
+{
+  _az_PRECONDITION_NOT_NULL(out_source);
+  _az_PRECONDITION_NOT_NULL(read);
+  _az_PRECONDITION(length >= 0);
+
+  *out_source = (az_http_body_source){
+    ._internal = {
+      .read = read,
+      .user_context = user_context,
+      .length = length,
+    },
+  };
+
+  return AZ_OK;
+}
+
+static AZ_NODISCARD az_result _az_http_body_source_read_from_buffer(
+    void* user_context,
+    int64_t offset,
+    az_span destination,
+    int32_t* out_size)
+{
+  uint8_t const* const buffer = (uint8_t const*)user_context;
+  int32_t const size = az_span_size(destination);
+
+  memcpy(az_span_ptr(destination), buffer + offset, (size_t)size);
+  *out_size = size;
+
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result az_http_body_source_init_from_buffer(
+    az_http_body_source* out_source,
+    void const* buffer,
+    int64_t length)
+{
+  _az_PRECONDITION_NOT_NULL(out_source);
+  _az_PRECONDITION(length == 0 || buffer != NULL);
+
+  // The buffer is only read, it is kept as the mutable user context of the read function.
+  return az_http_body_source_init(
+      out_source, length, _az_http_body_source_read_from_buffer, (void*)(uintptr_t)buffer);
+}
+
+AZ_NODISCARD az_result az_http_body_source_read(
+    az_http_body_source const* source,
+    int64_t offset,
+    az_span destination,
+    int32_t* out_size)
+{
+  _az_PRECONDITION_NOT_NULL(source);
+  _az_PRECONDITION_NOT_NULL(out_size);
+  _az_PRECONDITION(offset >= 0 && offset <= source->_internal.length);
+
+  int64_t const remaining = source->_internal.length - offset;
+  if (remaining < az_span_size(destination))
+  {
+    destination = az_span_slice(destination, 0, (int32_t)remaining);
+  }
+
+  *out_size = 0;
+  if (az_span_size(destination) == 0)
+  {
+    return AZ_OK;
+  }
+
+  int32_t size = 0;
+  AZ_RETURN_IF_FAILED(
+      source->_internal.read(source->_internal.user_context, offset, destination, &size));
+
+  if (size <= 0 || size > az_span_size(destination))
+  {
+    return AZ_ERROR_EOF;
+  }
+
+  *out_size = size;
+  return AZ_OK;
+}
+
 AZ_NODISCARD int32_t az_http_request_headers_count(az_http_request const* request)
 {
   return request->_internal.headers_length;
 }
+
+AZ_NODISCARD az_result _az_http_request_get_timeout(
+    az_http_request const* request,
+    int64_t now_msec,
+    int64_t* out_timeout_msec)
+{
+  _az_PRECONDITION_NOT_NULL(request);
+  _az_PRECONDITION_NOT_NULL(out_timeout_msec);
+
+  int64_t deadline_msec = request->_internal.context != NULL
+      ? az_context_get_expiration(request->_internal.context)
+      : _az_CONTEXT_MAX_EXPIRATION;
+  if (deadline_msec <= now_msec)
+  {
+    return AZ_ERROR_CANCELED;
+  }
+
+  int32_t const try_timeout_msec = request->_internal.try_timeout_msec;
+  if (try_timeout_msec > 0 && deadline_msec - now_msec > try_timeout_msec)
+  {
+    deadline_msec = now_msec + try_timeout_msec;
+  }
+
+  *out_timeout_msec = deadline_msec == _az_CONTEXT_MAX_EXPIRATION ? 0 : deadline_msec - now_msec;
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result
+_az_http_request_get_timeout_result(az_http_request const* request, int64_t now_msec)
+{
+  _az_PRECONDITION_NOT_NULL(request);
+
+  return request->_internal.context != NULL
+          && az_context_get_expiration(request->_internal.context) <= now_msec
+      ? AZ_ERROR_CANCELED
+      : AZ_ERROR_HTTP_ATTEMPT_TIMEOUT;
+}
+
+AZ_NODISCARD az_span _az_http_request_get_host(az_http_request const* request)
+{
+  _az_PRECONDITION_NOT_NULL(request);
+
+  az_span url = az_span_slice(request->_internal.url, 0, request->_internal.url_length);
+
+  int32_t const scheme_end = az_span_find(url, AZ_SPAN_FROM_STR("://"));
+  if (scheme_end >= 0)
+  {
+    url = az_span_slice_to_end(url, scheme_end + 3);
+  }
+
+  int32_t host_size = 0;
+  uint8_t const* const ptr = az_span_ptr(url);
+  while (host_size < az_span_size(url) && ptr[host_size] != '/' && ptr[host_size] != '?')
+  {
+    ++host_size;
+  }
+
+  return az_span_slice(url, 0, host_size);
+}
@@ -9,33 +9,13 @@
 #include <azure/core/az_precondition.h>
 #include <azure/core/internal/az_precondition_internal.h>
 
+#include <stdint.h>
+
 #include <azure/core/_az_cfg.h>
 #include <ctype.h>
 
 // HTTP Response utility functions
 
-AZ_NODISCARD AZ_INLINE az_result _az_is_char(az_span slice, uint8_t c)
-{
-  return az_span_ptr(slice)[0] == c ? AZ_OK : AZ_CONTINUE;
-}
-
-static AZ_NODISCARD az_result _az_valid_header_name_to_colon(az_span slice)
-{
-  az_result is_colon_result = _az_is_char(slice, ':');
-  if (is_colon_result == AZ_OK)
-  {
-    return is_colon_result;
-  }
-
-  if (!az_http_valid_token[az_span_ptr(slice)[0]])
-  {
-    return AZ_ERROR_HTTP_CORRUPT_RESPONSE_HEADER;
-  }
-
-  return is_colon_result;
-}
-static AZ_NODISCARD az_result _az_is_new_line(az_span slice) { return _az_is_char(slice, '\n'); }
-
 static AZ_NODISCARD bool _az_is_http_whitespace(uint8_t c)
 {
   switch (c)
@@ -49,11 +29,6 @@ static AZ_NODISCARD bool _az_is_http_whitespace(uint8_t c)
   }
 }
 
-static AZ_NODISCARD az_result _az_slice_is_not_http_whitespace(az_span slice)
-{
-  return _az_is_http_whitespace(az_span_ptr(slice)[0]) == true ? AZ_CONTINUE : AZ_OK;
-}
-
 /* PRIVATE Function. parse next  */
 static AZ_NODISCARD az_result _az_get_digit(az_span* ref_span, uint8_t* save_here)
 {
@@ -82,6 +57,7 @@ _az_get_http_status_line(az_span* ref_span, az_http_response_status_line* out_st
 
   // HTTP-version = HTTP-name "/" DIGIT "." DIGIT
   // https://tools.ietf.org/html/rfc7230#section-2.6
+  // HTTP/2 responses are reported by transports with the major version only ("HTTP/2").
   az_span const start = AZ_SPAN_FROM_STR("HTTP/");
   az_span const dot = AZ_SPAN_FROM_STR(".");
   az_span const space = AZ_SPAN_FROM_STR(" ");
@@ -89,8 +65,15 @@ _az_get_http_status_line(az_span* ref_span, az_http_response_status_line* out_st
   // parse and move reader if success
   AZ_RETURN_IF_FAILED(_az_is_expected_span(ref_span, start));
   AZ_RETURN_IF_FAILED(_az_get_digit(ref_span, &out_status_line->major_version));
-  AZ_RETURN_IF_FAILED(_az_is_expected_span(ref_span, dot));
-  AZ_RETURN_IF_FAILED(_az_get_digit(ref_span, &out_status_line->minor_version));
+  if (az_span_size(*ref_span) > 0 && az_span_ptr(*ref_span)[0] == '.')
+  {
+    AZ_RETURN_IF_FAILED(_az_is_expected_span(ref_span, dot));
+    AZ_RETURN_IF_FAILED(_az_get_digit(ref_span, &out_status_line->minor_version));
+  }
+  else
+  {
+    out_status_line->minor_version = 0;
+  }
 
   // SP = " "
   AZ_RETURN_IF_FAILED(_az_is_expected_span(ref_span, space));
@@ -104,21 +87,27 @@ _az_get_http_status_line(az_span* ref_span, az_http_response_status_line* out_st
     *ref_span = az_span_slice_to_end(*ref_span, 3);
   }
 
-  // SP
-  AZ_RETURN_IF_FAILED(_az_is_expected_span(ref_span, space));
+  // SP, which HTTP/2 transports may leave out when there is no reason-phrase
+  if (az_span_size(*ref_span) > 0 && az_span_ptr(*ref_span)[0] == ' ')
+  {
+    AZ_RETURN_IF_FAILED(_az_is_expected_span(ref_span, space));
+  }
   // get a pointer to read response until end of reason-phrase is found
   // reason-phrase = *(HTAB / SP / VCHAR / obs-text)
   // HTAB = "\t"
   // VCHAR or obs-text is %x21-FF,
-  int32_t offset = 0;
-  AZ_RETURN_IF_FAILED(_az_span_scan_until(*ref_span, _az_is_new_line, &offset));
+  int32_t const offset = _az_span_find_delimiter_or_control(*ref_span, '\r');
+  if (offset < 0)
+  {
+    return AZ_ERROR_ITEM_NOT_FOUND;
+  }
 
-  // save reason-phrase in status line now that we got the offset. Remove 1 last chars(\r)
-  out_status_line->reason_phrase = az_span_slice(*ref_span, 0, offset - 1);
+  // save reason-phrase in status line now that we got the offset.
+  out_status_line->reason_phrase = az_span_slice(*ref_span, 0, offset);
   // move position of reader after reason-phrase (parsed done)
-  *ref_span = az_span_slice_to_end(*ref_span, offset + 1);
+  *ref_span = az_span_slice_to_end(*ref_span, offset);
   // CR LF
-  // AZ_RETURN_IF_FAILED(_az_is_expected_span(response, AZ_SPAN_FROM_STR("\r\n")));
+  AZ_RETURN_IF_FAILED(_az_is_expected_span(ref_span, AZ_SPAN_FROM_STR("\r\n")));
 
   return AZ_OK;
 }
@@ -179,15 +168,30 @@ az_http_response_get_next_header(az_http_response* ref_response, az_pair* out_he
   // header-field   = field-name ":" OWS field-value OWS
   // field-name     = token
   {
-    int32_t field_name_length = 0;
     // https://tools.ietf.org/html/rfc7230#section-3.2.6
     // token = 1*tchar
     // tchar = "!" / "#" / "$" / "%" / "&" / "'" / "*" / "+" / "-" / "." / "^" /
     //         "_" / "`" / "|" / "~" / DIGIT / ALPHA;
     // any VCHAR,
     //    except delimiters
-    AZ_RETURN_IF_FAILED(
-        _az_span_scan_until(*reader, _az_valid_header_name_to_colon, &field_name_length));
+    int32_t const colon_offset = _az_span_find_delimiter_or_control(*reader, ':');
+    int32_t const field_name_length = colon_offset < 0 ? az_span_size(*reader) : colon_offset;
+    uint8_t const* const field_name = az_span_ptr(*reader);
+    for (int32_t i = 0; i < field_name_length; ++i)
+    {
+      if (!az_http_valid_token[field_name[i]])
+      {
+        return AZ_ERROR_HTTP_CORRUPT_RESPONSE_HEADER;
+      }
+    }
+    if (colon_offset < 0)
+    {
+      return AZ_ERROR_ITEM_NOT_FOUND;
+    }
+    if (field_name[colon_offset] != ':')
+    {
+      return AZ_ERROR_HTTP_CORRUPT_RESPONSE_HEADER;
+    }
 
     // form a header name. Reader is currently at char ':'
     out_header->key = az_span_slice(*reader, 0, field_name_length);
@@ -200,7 +204,14 @@ az_http_response_get_next_header(az_http_response* ref_response, az_pair* out_he
 
     // OWS -> remove the optional whitespace characters before header value
     int32_t ows_len = 0;
-    AZ_RETURN_IF_FAILED(_az_span_scan_until(*reader, _az_slice_is_not_http_whitespace, &ows_len));
+    while (ows_len < az_span_size(*reader) && _az_is_http_whitespace(az_span_ptr(*reader)[ows_len]))
+    {
+      ++ows_len;
+    }
+    if (ows_len == az_span_size(*reader))
+    {
+      return AZ_ERROR_ITEM_NOT_FOUND;
+    }
     *reader = az_span_slice_to_end(*reader, ows_len);
   }
   // field-value    = *( field-content / obs-fold )
@@ -213,37 +224,239 @@ az_http_response_get_next_header(az_http_response* ref_response, az_pair* out_he
   //
   // Note: obs-fold is not implemented.
   {
-    int32_t offset = 0;
-    int32_t offset_value_end = offset;
-    while (true)
+    // The value ends at '\r', any other control character but HTAB is unexpected.
+    int32_t const offset = _az_span_find_delimiter_or_control(*reader, '\r');
+    if (offset < 0)
     {
-      uint8_t c = az_span_ptr(*reader)[offset];
-      offset += 1;
-      if (c == '\r')
-      {
-        break; // break as soon as end of value char is found
-      }
-      if (_az_is_http_whitespace(c))
+      return AZ_ERROR_ITEM_NOT_FOUND;
+    }
+    if (az_span_ptr(*reader)[offset] != '\r')
+    {
+      return AZ_ERROR_UNEXPECTED_CHAR;
+    }
+
+    // Remove whitespace characters from value https://github.com/Azure/azure-sdk-for-c/issues/604
+    out_header->value = _az_span_trim_whitespace_from_end(az_span_slice(*reader, 0, offset));
+    // moving reader after \r
+    *reader = az_span_slice_to_end(*reader, offset + 1);
+  }
+
+  AZ_RETURN_IF_FAILED(_az_is_expected_span(reader, AZ_SPAN_FROM_STR("\n")));
+
+  return AZ_OK;
+}
+
+// Lowercases ASCII letters, the header names being tokens, other characters are kept distinct.
+AZ_NODISCARD AZ_INLINE uint8_t _az_http_response_header_name_tolower(uint8_t c)
+{
+  return (c >= 'A' && c <= 'Z') ? (uint8_t)(c | 0x20) : c;
+}
+
+// FNV-1a hash of the lowercase header name.
+static AZ_NODISCARD uint32_t _az_http_response_header_name_hash(az_span name)
+{
+  uint32_t hash = _az_FNV1A_32_OFFSET_BASIS;
+  uint8_t const* const ptr = az_span_ptr(name);
+  for (int32_t i = 0; i < az_span_size(name); ++i)
+  {
+    hash = _az_fnv1a_32_add(hash, _az_http_response_header_name_tolower(ptr[i]));
+  }
+
+  return hash;
+}
+
+/**
+ * @brief Builds the header index of \p ref_response, if it has one and it wasn't built yet.
+ *
+ * @return `true` if the index holds all the headers of the response, and where its body starts.
+ */
+static AZ_NODISCARD bool _az_http_response_build_header_index(az_http_response* ref_response)
+{
+  if (ref_response->_internal.header_index.is_built)
+  {
+    return ref_response->_internal.header_index.is_complete;
+  }
+
+  if (ref_response->_internal.header_index.max_entries == 0)
+  {
+    return false;
+  }
+
+  // Parse the headers with the response parser, without changing where its user is at.
+  az_span const parser_remaining = ref_response->_internal.parser.remaining;
+  _az_http_response_kind const parser_next_kind = ref_response->_internal.parser.next_kind;
+
+  _az_http_response_header_entry* const entries = ref_response->_internal.header_index.entries;
+  uint16_t* const slots = ref_response->_internal.header_index.slots;
+  int32_t const slots_mask = ref_response->_internal.header_index.slots_count - 1;
+  uint8_t const* const base = az_span_ptr(ref_response->_internal.http_response);
+
+  for (int32_t i = 0; i <= slots_mask; ++i)
+  {
+    slots[i] = 0;
+  }
+
+  int32_t count = 0;
+  bool is_complete = false;
+  az_http_response_status_line status_line = { 0 };
+  if (az_succeeded(az_http_response_get_status_line(ref_response, &status_line)))
+  {
+    az_pair header = { 0 };
+    az_result result = AZ_OK;
+    while (count < ref_response->_internal.header_index.max_entries
+           && az_succeeded(result = az_http_response_get_next_header(ref_response, &header)))
+    {
+      uint32_t const hash = _az_http_response_header_name_hash(header.key);
+      entries[count] = (_az_http_response_header_entry){
+        .name_hash = hash,
+        .name_offset = (int32_t)(az_span_ptr(header.key) - base),
+        .name_length = az_span_size(header.key),
+        .value_offset = (int32_t)(az_span_ptr(header.value) - base),
+        .value_length = az_span_size(header.value),
+      };
+
+      // Linear probing. The table is at least twice as large as the entries, so it never fills.
+      int32_t slot = (int32_t)(hash & (uint32_t)slots_mask);
+      while (slots[slot] != 0)
       {
-        continue; // whitespace or tab is accepted. It can be any number after value (OWS)
+        slot = (slot + 1) & slots_mask;
       }
-      if (c <= ' ')
+      slots[slot] = (uint16_t)(count + 1);
+      ++count;
+    }
+
+    if (result == AZ_OK)
+    {
+      // The index is full, it is only complete if there are no more headers.
+      result = az_http_response_get_next_header(ref_response, &header);
+    }
+
+    if (result == AZ_ERROR_ITEM_NOT_FOUND)
+    {
+      is_complete = true;
+      ref_response->_internal.header_index.body_offset
+          = (int32_t)(az_span_ptr(ref_response->_internal.parser.remaining) - base);
+    }
+  }
+
+  ref_response->_internal.parser.remaining = parser_remaining;
+  ref_response->_internal.parser.next_kind = parser_next_kind;
+  ref_response->_internal.header_index.entries_count = count;
+  ref_response->_internal.header_index.is_complete = is_complete;
+  ref_response->_internal.header_index.is_built = true;
+
+  return is_complete;
+}
+
+AZ_NODISCARD az_result
+az_http_response_set_header_index(az_http_response* ref_response, az_span buffer)
+{
+  _az_PRECONDITION_NOT_NULL(ref_response);
+
+  // The widest members of the entries are 32-bit integers, which sets their alignment. The slots
+  // that follow them are 16-bit.
+  az_span const aligned_buffer = _az_span_align(buffer, (int32_t)sizeof(int32_t));
+  int32_t const size = az_span_size(aligned_buffer);
+
+  // Find how many entries fit along with a hash table of at least twice as many slots.
+  int32_t max_entries = size > 0 ? size / (int32_t)sizeof(_az_http_response_header_entry) : 0;
+  max_entries = max_entries > UINT16_MAX ? UINT16_MAX : max_entries;
+  int32_t slots_count = 0;
+  while (max_entries > 0)
+  {
+    slots_count = 1;
+    while (slots_count < 2 * max_entries)
+    {
+      slots_count *= 2;
+    }
+
+    if (max_entries * (int32_t)sizeof(_az_http_response_header_entry)
+            + slots_count * (int32_t)sizeof(uint16_t)
+        <= size)
+    {
+      break;
+    }
+    --max_entries;
+  }
+
+  _az_http_response_header_entry* entries = NULL;
+  uint16_t* slots = NULL;
+  if (max_entries > 0)
+  {
+    entries = (_az_http_response_header_entry*)(void*)az_span_ptr(aligned_buffer);
+    slots = (uint16_t*)(void*)(entries + max_entries);
+  }
+  else
+  {
+    slots_count = 0;
+  }
+
+  ref_response->_internal.header_index.buffer = buffer;
+  ref_response->_internal.header_index.entries = entries;
+  ref_response->_internal.header_index.slots = slots;
+  ref_response->_internal.header_index.entries_count = 0;
+  ref_response->_internal.header_index.max_entries = max_entries;
+  ref_response->_internal.header_index.slots_count = slots_count;
+  ref_response->_internal.header_index.body_offset = 0;
+  ref_response->_internal.header_index.is_built = false;
+  ref_response->_internal.header_index.is_complete = false;
+
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result
+az_http_response_get_header(az_http_response* ref_response, az_span name, az_span* out_value)
+{
+  _az_PRECONDITION_NOT_NULL(ref_response);
+  _az_PRECONDITION_NOT_NULL(out_value);
+
+  if (_az_http_response_build_header_index(ref_response))
+  {
+    _az_http_response_header_entry const* const entries
+        = ref_response->_internal.header_index.entries;
+    uint16_t const* const slots = ref_response->_internal.header_index.slots;
+    int32_t const slots_mask = ref_response->_internal.header_index.slots_count - 1;
+    uint8_t* const base = az_span_ptr(ref_response->_internal.http_response);
+
+    uint32_t const hash = _az_http_response_header_name_hash(name);
+    for (int32_t slot = (int32_t)(hash & (uint32_t)slots_mask); slots[slot] != 0;
+         slot = (slot + 1) & slots_mask)
+    {
+      _az_http_response_header_entry const* const entry = &entries[slots[slot] - 1];
+      if (entry->name_hash == hash
+          && az_span_is_content_equal_ignoring_case(
+              az_span_create(base + entry->name_offset, entry->name_length), name))
       {
-        return AZ_ERROR_UNEXPECTED_CHAR;
+        *out_value = az_span_create(base + entry->value_offset, entry->value_length);
+        return AZ_OK;
       }
-      offset_value_end = offset; // increasing index only for valid chars,
     }
-    out_header->value = az_span_slice(*reader, 0, offset_value_end);
-    // moving reader. It is currently after \r was found
-    *reader = az_span_slice_to_end(*reader, offset);
 
-    // Remove whitespace characters from value https://github.com/Azure/azure-sdk-for-c/issues/604
-    out_header->value = _az_span_trim_whitespace_from_end(out_header->value);
+    return AZ_ERROR_ITEM_NOT_FOUND;
   }
 
-  AZ_RETURN_IF_FAILED(_az_is_expected_span(reader, AZ_SPAN_FROM_STR("\n")));
+  // Without an index, parse the headers, without changing where the user of the parser is at.
+  az_span const parser_remaining = ref_response->_internal.parser.remaining;
+  _az_http_response_kind const parser_next_kind = ref_response->_internal.parser.next_kind;
 
-  return AZ_OK;
+  az_http_response_status_line status_line = { 0 };
+  az_result result = az_http_response_get_status_line(ref_response, &status_line);
+  if (az_succeeded(result))
+  {
+    az_pair header = { 0 };
+    while (az_succeeded(result = az_http_response_get_next_header(ref_response, &header)))
+    {
+      if (az_span_is_content_equal_ignoring_case(header.key, name))
+      {
+        *out_value = header.value;
+        break;
+      }
+    }
+  }
+
+  ref_response->_internal.parser.remaining = parser_remaining;
+  ref_response->_internal.parser.next_kind = parser_next_kind;
+  return result;
 }
 
 AZ_NODISCARD az_result az_http_response_get_body(az_http_response* ref_response, az_span* out_body)
@@ -251,6 +464,14 @@ AZ_NODISCARD az_result az_http_response_get_body(az_http_response* ref_response,
   _az_PRECONDITION_NOT_NULL(ref_response);
   _az_PRECONDITION_NOT_NULL(out_body);
 
+  // The header index knows where the body starts.
+  if (_az_http_response_build_header_index(ref_response))
+  {
+    ref_response->_internal.parser.remaining = az_span_slice_to_end(
+        ref_response->_internal.http_response, ref_response->_internal.header_index.body_offset);
+    ref_response->_internal.parser.next_kind = _az_HTTP_RESPONSE_KIND_BODY;
+  }
+
   // Make sure get body works no matter where is the current parsing. Allow users to call get body
   // directly and ignore headers and status line
   _az_http_response_kind current_parsing_section = ref_response->_internal.parser.next_kind;
@@ -276,20 +497,126 @@ AZ_NODISCARD az_result az_http_response_get_body(az_http_response* ref_response,
     }
   }
 
-  // take all the remaining content from reader as body
-  *out_body = az_span_slice_to_end(ref_response->_internal.parser.remaining, 0);
+  // take all the remaining content from reader as body, unless it went to the body callback
+  *out_body = ref_response->_internal.body.is_body_streamed
+      ? az_span_slice(ref_response->_internal.parser.remaining, 0, 0)
+      : az_span_slice_to_end(ref_response->_internal.parser.remaining, 0);
 
   ref_response->_internal.parser.next_kind = _az_HTTP_RESPONSE_KIND_EOF;
   return AZ_OK;
 }
 
+AZ_NODISCARD az_result az_http_response_set_body_callback(
+    az_http_response* ref_response,
+    az_http_response_body_callback callback,
+    void* user_context)
+{
+  _az_PRECONDITION_NOT_NULL(ref_response);
+
+  ref_response->_internal.body.callback = callback;
+  ref_response->_internal.body.user_context = user_context;
+
+  return AZ_OK;
+}
+
 void _az_http_response_reset(az_http_response* ref_response)
 {
+  az_http_response_body_callback const callback = ref_response->_internal.body.callback;
+  void* const user_context = ref_response->_internal.body.user_context;
+  _az_http_response_header_index const header_index = ref_response->_internal.header_index;
+
   // never fails, discard the result
   // init will set written to 0 and will use the same az_span. Internal parser's state is also
   // reset
   az_result result = az_http_response_init(ref_response, ref_response->_internal.http_response);
   (void)result;
+
+  // The body callback and the header index are set by the user, and are kept for the next attempt.
+  ref_response->_internal.body.callback = callback;
+  ref_response->_internal.body.user_context = user_context;
+  ref_response->_internal.header_index = header_index;
+  ref_response->_internal.header_index.is_built = false;
+}
+
+// Parses count digits at the start of value.
+static AZ_NODISCARD bool _az_http_parse_date_digits(az_span value, int32_t count, int32_t* out)
+{
+  int32_t result = 0;
+  for (int32_t i = 0; i < count; ++i)
+  {
+    uint8_t const c = az_span_ptr(value)[i];
+    if (c < '0' || c > '9')
+    {
+      return false;
+    }
+    result = result * 10 + (c - '0');
+  }
+
+  *out = result;
+  return true;
+}
+
+// Finds value in a list of 3-letter names, returns its index or -1.
+static AZ_NODISCARD int32_t _az_http_parse_date_name(az_span value, az_span names)
+{
+  for (int32_t i = 0; i < az_span_size(names) / 3; ++i)
+  {
+    if (az_span_is_content_equal(value, az_span_slice(names, i * 3, i * 3 + 3)))
+    {
+      return i;
+    }
+  }
+
+  return -1;
+}
+
+AZ_NODISCARD az_result _az_http_parse_date(az_span value, int64_t* out_unix_sec)
+{
+  _az_PRECONDITION_NOT_NULL(out_unix_sec);
+
+  // "Sun, 06 Nov 1994 08:49:37 GMT"
+  if (az_span_size(value) != (int32_t)sizeof("Www, DD Mmm YYYY HH:MM:SS GMT") - 1
+      || _az_http_parse_date_name(
+             az_span_slice(value, 0, 3), AZ_SPAN_FROM_STR("MonTueWedThuFriSatSun"))
+          < 0
+      || !az_span_is_content_equal(az_span_slice(value, 3, 5), AZ_SPAN_FROM_STR(", "))
+      || !az_span_is_content_equal(az_span_slice(value, 25, 29), AZ_SPAN_FROM_STR(" GMT")))
+  {
+    return AZ_ERROR_UNEXPECTED_CHAR;
+  }
+
+  uint8_t const* const ptr = az_span_ptr(value);
+  int32_t const month = _az_http_parse_date_name(
+      az_span_slice(value, 8, 11), AZ_SPAN_FROM_STR("JanFebMarAprMayJunJulAugSepOctNovDec"));
+
+  int32_t day = 0;
+  int32_t year = 0;
+  int32_t hour = 0;
+  int32_t minute = 0;
+  int32_t second = 0;
+  if (month < 0 || ptr[7] != ' ' || ptr[11] != ' ' || ptr[16] != ' ' || ptr[19] != ':'
+      || ptr[22] != ':' || !_az_http_parse_date_digits(az_span_slice_to_end(value, 5), 2, &day)
+      || !_az_http_parse_date_digits(az_span_slice_to_end(value, 12), 4, &year)
+      || !_az_http_parse_date_digits(az_span_slice_to_end(value, 17), 2, &hour)
+      || !_az_http_parse_date_digits(az_span_slice_to_end(value, 20), 2, &minute)
+      || !_az_http_parse_date_digits(az_span_slice_to_end(value, 23), 2, &second) || day < 1
+      || day > 31 || hour > 23 || minute > 59 || second > 60)
+  {
+    return AZ_ERROR_UNEXPECTED_CHAR;
+  }
+
+  // Days since 1970-01-01 of the civil date (month is 0 for January), counting years from March so
+  // that the leap day is the last day of the year.
+  int32_t const y = month < 2 ? year - 1 : year;
+  int32_t const era = y / 400;
+  int32_t const year_of_era = y - era * 400;
+  int32_t const day_of_year = (153 * (month < 2 ? month + 10 : month - 2) + 2) / 5 + day - 1;
+  int32_t const day_of_era
+      = year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year;
+  int64_t const days_since_epoch = (int64_t)era * 146097 + day_of_era - 719468;
+
+  *out_unix_sec = days_since_epoch * 86400 + hour * 3600 + minute * 60 + second;
+  return AZ_OK;
 }
 
 // internal function to get az_http_response remainder
@@ -298,10 +625,9 @@ static az_span _az_http_response_get_remaining(az_http_response const* response)
   return az_span_slice_to_end(response->_internal.http_response, response->_internal.written);
 }
 
-AZ_NODISCARD az_result az_http_response_append(az_http_response* ref_response, az_span source)
+static AZ_NODISCARD az_result
+_az_http_response_write(az_http_response* ref_response, az_span source)
 {
-  _az_PRECONDITION_NOT_NULL(ref_response);
-
   az_span remaining = _az_http_response_get_remaining(ref_response);
   int32_t write_size = az_span_size(source);
   AZ_RETURN_IF_NOT_ENOUGH_SIZE(remaining, write_size);
@@ -311,3 +637,106 @@ AZ_NODISCARD az_result az_http_response_append(az_http_response* ref_response, a
 
   return AZ_OK;
 }
+
+/**
+ * @brief Gets the number of bytes of \p source that belong to the status line and headers, up to
+ * and including the empty line ending them, or -1 if they don't end within \p source.
+ */
+static AZ_NODISCARD int32_t
+_az_http_response_find_headers_end(az_http_response* ref_response, az_span source)
+{
+  int32_t matched = ref_response->_internal.body.headers_end_matched;
+  uint8_t const* const ptr = az_span_ptr(source);
+  int32_t const size = az_span_size(source);
+
+  for (int32_t i = 0; i < size; ++i)
+  {
+    // Look for "\r\n\r\n": even positions are '\r', odd positions are '\n'.
+    uint8_t const expected = matched % 2 == 0 ? '\r' : '\n';
+    if (ptr[i] == expected)
+    {
+      ++matched;
+    }
+    else
+    {
+      matched = ptr[i] == '\r' ? 1 : 0;
+    }
+
+    if (matched == 4)
+    {
+      ref_response->_internal.body.headers_end_matched = 0;
+      return i + 1;
+    }
+  }
+
+  ref_response->_internal.body.headers_end_matched = matched;
+  return -1;
+}
+
+/**
+ * @brief Called once the headers of a response are in the buffer, decides where its body goes.
+ */
+static void _az_http_response_on_headers_complete(az_http_response* ref_response)
+{
+  az_http_response_status_line status_line = { 0 };
+  az_result const result = az_http_response_get_status_line(ref_response, &status_line);
+  ref_response->_internal.parser.next_kind = _az_HTTP_RESPONSE_KIND_STATUS_LINE;
+
+  if (az_succeeded(result) && status_line.status_code >= 100 && status_line.status_code < 200)
+  {
+    // An interim response (e.g. 100 Continue) has no body, the final response follows it.
+    ref_response->_internal.written = 0;
+    return;
+  }
+
+  ref_response->_internal.body.is_headers_complete = true;
+  ref_response->_internal.body.is_body_streamed
+      = az_succeeded(result) && status_line.status_code >= 200 && status_line.status_code < 300;
+}
+
+AZ_NODISCARD az_result az_http_response_append(az_http_response* ref_response, az_span source)
+{
+  _az_PRECONDITION_NOT_NULL(ref_response);
+
+  if (ref_response->_internal.body.callback == NULL)
+  {
+    return _az_http_response_write(ref_response, source);
+  }
+
+  // Write the status line and headers to the buffer, there may be several sets of them when
+  // there are interim responses.
+  while (!ref_response->_internal.body.is_headers_complete)
+  {
+    int32_t const headers_end = _az_http_response_find_headers_end(ref_response, source);
+    if (headers_end < 0)
+    {
+      return _az_http_response_write(ref_response, source);
+    }
+
+    AZ_RETURN_IF_FAILED(
+        _az_http_response_write(ref_response, az_span_slice(source, 0, headers_end)));
+    source = az_span_slice_to_end(source, headers_end);
+    _az_http_response_on_headers_complete(ref_response);
+  }
+
+  if (!ref_response->_internal.body.is_body_streamed)
+  {
+    return _az_http_response_write(ref_response, source);
+  }
+
+  if (az_span_size(source) == 0)
+  {
+    return AZ_OK;
+  }
+
+  ref_response->_internal.body.has_streamed_bytes = true;
+  az_result const result = ref_response->_internal.body.callback(
+      source, ref_response->_internal.body.user_context);
+  if (az_failed(result))
+  {
+    // Kept so that the transport adapter can report it, instead of its own write error.
+    ref_response->_internal.body.callback_result = result;
+  }
+
+  return result;
+}
@@ -0,0 +1,151 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "az_json_private.h"
+#include "az_span_private.h"
+#include <azure/core/az_json.h>
+#include <azure/core/az_precondition.h>
+#include <azure/core/az_result.h>
+#include <azure/core/az_span.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <azure/core/_az_cfg.h>
+
+AZ_NODISCARD az_result az_json_index_init(
+    az_json_index* out_index,
+    az_span json_buffer,
+    az_span buffer,
+    az_json_reader_options const* options)
+{
+  _az_PRECONDITION_NOT_NULL(out_index);
+  _az_PRECONDITION_VALID_SPAN(json_buffer, 1, false);
+
+  *out_index = (az_json_index){
+    ._internal = {
+      .json_buffer = json_buffer,
+      .entries = NULL,
+      .count = 0,
+    },
+  };
+
+  // The widest members of the entries are int32_t, which sets their alignment.
+  az_span const aligned_buffer = _az_span_align(buffer, (int32_t)sizeof(int32_t));
+  int32_t const max_entries
+      = az_span_size(aligned_buffer) / (int32_t)sizeof(_az_json_index_entry);
+  _az_json_index_entry* const entries
+      = max_entries > 0 ? (_az_json_index_entry*)(void*)az_span_ptr(aligned_buffer) : NULL;
+
+  az_json_reader reader = { 0 };
+  AZ_RETURN_IF_FAILED(az_json_reader_init(&reader, json_buffer, options));
+
+  // The positions of the begin object and array tokens whose end isn't read yet.
+  int32_t open_containers[_az_MAX_JSON_STACK_SIZE];
+  int32_t depth = 0;
+
+  int32_t count = 0;
+  az_result result = AZ_OK;
+  while (az_succeeded(result = az_json_reader_next_token(&reader)))
+  {
+    if (count >= max_entries)
+    {
+      return AZ_ERROR_INSUFFICIENT_SPAN_SIZE;
+    }
+
+    az_json_token_kind const kind = reader.token.kind;
+    entries[count] = (_az_json_index_entry){
+      .offset = (int32_t)(az_span_ptr(reader.token.slice) - az_span_ptr(json_buffer)),
+      .size = az_span_size(reader.token.slice),
+      .last = count,
+      .kind = (uint8_t)kind,
+      .string_has_escaped_chars = reader.token._internal.string_has_escaped_chars,
+    };
+
+    // The reader validates the nesting, its depth is at most the size of the stack.
+    int32_t value_start = count;
+    if (kind == AZ_JSON_TOKEN_BEGIN_OBJECT || kind == AZ_JSON_TOKEN_BEGIN_ARRAY)
+    {
+      open_containers[depth++] = count;
+      value_start = -1;
+    }
+    else if (kind == AZ_JSON_TOKEN_END_OBJECT || kind == AZ_JSON_TOKEN_END_ARRAY)
+    {
+      value_start = open_containers[--depth];
+      entries[value_start].last = count;
+    }
+    else if (kind == AZ_JSON_TOKEN_PROPERTY_NAME)
+    {
+      value_start = -1;
+    }
+
+    // The children of a property name are its value, which ends here.
+    if (value_start > 0 && entries[value_start - 1].kind == AZ_JSON_TOKEN_PROPERTY_NAME)
+    {
+      entries[value_start - 1].last = count;
+    }
+
+    count++;
+  }
+
+  if (result != AZ_ERROR_JSON_READER_DONE)
+  {
+    return result;
+  }
+
+  out_index->_internal.entries = entries;
+  out_index->_internal.count = count;
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_json_token az_json_index_get_token(az_json_index const* index, int32_t position)
+{
+  _az_PRECONDITION_NOT_NULL(index);
+  _az_PRECONDITION_RANGE(0, position, index->_internal.count - 1);
+
+  _az_json_index_entry const* const entry = &index->_internal.entries[position];
+  return (az_json_token){
+    .kind = (az_json_token_kind)entry->kind,
+    .slice = az_span_slice(
+        index->_internal.json_buffer, entry->offset, entry->offset + entry->size),
+    ._internal = {
+      .string_has_escaped_chars = entry->string_has_escaped_chars,
+    },
+  };
+}
+
+AZ_NODISCARD int32_t az_json_index_skip_children(az_json_index const* index, int32_t position)
+{
+  _az_PRECONDITION_NOT_NULL(index);
+  _az_PRECONDITION_RANGE(0, position, index->_internal.count - 1);
+
+  return index->_internal.entries[position].last;
+}
+
+AZ_NODISCARD az_result az_json_index_find_property(
+    az_json_index const* index,
+    int32_t object_position,
+    az_span name,
+    int32_t* out_value_position)
+{
+  _az_PRECONDITION_NOT_NULL(index);
+  _az_PRECONDITION_RANGE(0, object_position, index->_internal.count - 1);
+  _az_PRECONDITION(
+      index->_internal.entries[object_position].kind == AZ_JSON_TOKEN_BEGIN_OBJECT);
+  _az_PRECONDITION_NOT_NULL(out_value_position);
+
+  // The property names follow each other, after the last token of the value of the previous one.
+  int32_t const end = index->_internal.entries[object_position].last;
+  for (int32_t position = object_position + 1; position < end;
+       position = index->_internal.entries[position].last + 1)
+  {
+    az_json_token const property_name = az_json_index_get_token(index, position);
+    if (az_json_token_is_text_equal(&property_name, name))
+    {
+      *out_value_position = position + 1;
+      return AZ_OK;
+    }
+  }
+
+  return AZ_ERROR_ITEM_NOT_FOUND;
+}
@@ -0,0 +1,249 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "az_json_private.h"
+#include <azure/core/az_json.h>
+#include <azure/core/az_precondition.h>
+#include <azure/core/az_result.h>
+#include <azure/core/az_span.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <azure/core/_az_cfg.h>
+
+// Gets the size of the first segments of a JSON pointer, with their `/`, or -1 if it has fewer.
+AZ_NODISCARD static int32_t _az_json_pointer_get_prefix_size(
+    az_span json_pointer,
+    int32_t segment_count)
+{
+  uint8_t const* const pointer_ptr = az_span_ptr(json_pointer);
+  int32_t const pointer_size = az_span_size(json_pointer);
+
+  int32_t prefix_size = 0;
+  for (int32_t i = 0; i < segment_count; ++i)
+  {
+    if (prefix_size >= pointer_size || pointer_ptr[prefix_size] != '/')
+    {
+      return -1;
+    }
+
+    do
+    {
+      prefix_size++;
+    } while (prefix_size < pointer_size && pointer_ptr[prefix_size] != '/');
+  }
+
+  return prefix_size;
+}
+
+// Checks whether a segment of a JSON pointer is a property name, unescaping both.
+AZ_NODISCARD static bool _az_json_pointer_segment_is_name(
+    az_span segment,
+    az_json_token const* property_name)
+{
+  // Unescaping only makes the segment shorter, it is longer than the name when it matches with
+  // escape sequences.
+  if (!property_name->_internal.string_has_escaped_chars)
+  {
+    if (az_span_size(segment) <= az_span_size(property_name->slice))
+    {
+      return az_span_is_content_equal(segment, property_name->slice)
+          && az_span_find(segment, AZ_SPAN_FROM_STR("~")) == -1;
+    }
+
+    if (az_span_find(segment, AZ_SPAN_FROM_STR("~")) == -1)
+    {
+      return false;
+    }
+  }
+
+  uint8_t const* const segment_ptr = az_span_ptr(segment);
+  int32_t const segment_size = az_span_size(segment);
+  uint8_t const* const name_ptr = az_span_ptr(property_name->slice);
+  int32_t const name_size = az_span_size(property_name->slice);
+
+  int32_t segment_index = 0;
+  int32_t name_index = 0;
+  while (segment_index < segment_size && name_index < name_size)
+  {
+    uint8_t segment_byte = segment_ptr[segment_index++];
+    if (segment_byte == '~')
+    {
+      if (segment_index >= segment_size
+          || (segment_ptr[segment_index] != '0' && segment_ptr[segment_index] != '1'))
+      {
+        return false;
+      }
+      segment_byte = segment_ptr[segment_index++] == '0' ? '~' : '/';
+    }
+
+    // The reader validated the escape sequences, a byte follows each backslash.
+    uint8_t name_byte = name_ptr[name_index++];
+    if (name_byte == '\\')
+    {
+      name_byte = name_ptr[name_index++];
+
+      // As in az_json_token_is_text_equal(), \uXXXX isn't supported.
+      if (name_byte == 'u')
+      {
+        return false;
+      }
+      name_byte = _az_json_unescape_single_byte(name_byte);
+    }
+
+    if (segment_byte != name_byte)
+    {
+      return false;
+    }
+  }
+
+  return segment_index == segment_size && name_index == name_size;
+}
+
+// Checks whether a segment of a JSON pointer is the index of an item of an array.
+AZ_NODISCARD static bool _az_json_pointer_segment_is_index(az_span segment, int32_t item_index)
+{
+  // Indexes have no leading zeros, so the segment is the only way to write the item index.
+  uint8_t index_buffer[_az_MAX_SIZE_FOR_INT32];
+  az_span remainder = AZ_SPAN_NULL;
+  if (az_failed(az_span_i32toa(AZ_SPAN_FROM_BUFFER(index_buffer), item_index, &remainder)))
+  {
+    return false;
+  }
+
+  int32_t const index_size = (int32_t)sizeof(index_buffer) - az_span_size(remainder);
+  return az_span_is_content_equal(segment, az_span_create(index_buffer, index_size));
+}
+
+AZ_NODISCARD az_result az_json_reader_find_paths(
+    az_json_reader* json_reader,
+    az_span const json_pointers[],
+    int32_t json_pointers_count,
+    az_json_token out_values[])
+{
+  _az_PRECONDITION_NOT_NULL(json_reader);
+  _az_PRECONDITION(!json_reader->_internal.chunked.is_chunked);
+  _az_PRECONDITION(json_pointers_count > 0);
+  _az_PRECONDITION_NOT_NULL(json_pointers);
+  _az_PRECONDITION_NOT_NULL(out_values);
+
+  if (json_reader->token.kind == AZ_JSON_TOKEN_NONE
+      || json_reader->token.kind == AZ_JSON_TOKEN_PROPERTY_NAME)
+  {
+    AZ_RETURN_IF_FAILED(az_json_reader_next_token(json_reader));
+  }
+
+  _az_PRECONDITION(
+      json_reader->token.kind != AZ_JSON_TOKEN_END_OBJECT
+      && json_reader->token.kind != AZ_JSON_TOKEN_END_ARRAY);
+
+  // The values found are never of kind AZ_JSON_TOKEN_NONE, which marks the paths left to find.
+  int32_t paths_left = json_pointers_count;
+  for (int32_t i = 0; i < json_pointers_count; ++i)
+  {
+    out_values[i] = _az_JSON_TOKEN_DEFAULT;
+    if (az_span_size(json_pointers[i]) == 0)
+    {
+      out_values[i] = json_reader->token;
+      paths_left--;
+    }
+  }
+
+  // The index of the next item of each array entered, or -1 for an object, by depth.
+  int32_t item_indexes[_az_MAX_JSON_STACK_SIZE];
+  int32_t depth = 0;
+  if (paths_left > 0
+      && (json_reader->token.kind == AZ_JSON_TOKEN_BEGIN_OBJECT
+          || json_reader->token.kind == AZ_JSON_TOKEN_BEGIN_ARRAY))
+  {
+    item_indexes[0] = json_reader->token.kind == AZ_JSON_TOKEN_BEGIN_ARRAY ? 0 : -1;
+    depth = 1;
+  }
+
+  // Only the values on a path are entered, so the path to the current one is made of the first
+  // segments of a pointer: the one followed last. The paths going through the current object or
+  // array start with the same parent_size bytes.
+  int32_t followed_pointer = 0;
+  int32_t parent_depth = 1;
+  int32_t parent_size = 0;
+  while (paths_left > 0 && depth > 0)
+  {
+    AZ_RETURN_IF_FAILED(az_json_reader_next_token(json_reader));
+    if (json_reader->token.kind == AZ_JSON_TOKEN_END_OBJECT
+        || json_reader->token.kind == AZ_JSON_TOKEN_END_ARRAY)
+    {
+      depth--;
+      continue;
+    }
+
+    az_json_token const property_name = json_reader->token;
+    int32_t const item_index = item_indexes[depth - 1];
+    if (item_index < 0)
+    {
+      AZ_RETURN_IF_FAILED(az_json_reader_next_token(json_reader));
+    }
+    else
+    {
+      item_indexes[depth - 1]++;
+    }
+
+    if (parent_depth != depth)
+    {
+      parent_depth = depth;
+      parent_size = _az_json_pointer_get_prefix_size(json_pointers[followed_pointer], depth - 1);
+    }
+    az_span const parent_path = az_span_slice(json_pointers[followed_pointer], 0, parent_size);
+
+    az_json_token_kind const kind = json_reader->token.kind;
+    bool is_followed = false;
+    for (int32_t i = 0; i < json_pointers_count; ++i)
+    {
+      az_span const pointer = json_pointers[i];
+      uint8_t const* const pointer_ptr = az_span_ptr(pointer);
+      int32_t const pointer_size = az_span_size(pointer);
+      if (out_values[i].kind != AZ_JSON_TOKEN_NONE || pointer_size <= parent_size
+          || pointer_ptr[parent_size] != '/'
+          || !az_span_is_content_equal(az_span_slice(pointer, 0, parent_size), parent_path))
+      {
+        continue;
+      }
+
+      int32_t segment_end = parent_size + 1;
+      while (segment_end < pointer_size && pointer_ptr[segment_end] != '/')
+      {
+        segment_end++;
+      }
+
+      az_span const segment = az_span_slice(pointer, parent_size + 1, segment_end);
+      if (!(item_index < 0 ? _az_json_pointer_segment_is_name(segment, &property_name)
+                           : _az_json_pointer_segment_is_index(segment, item_index)))
+      {
+        continue;
+      }
+
+      if (segment_end == pointer_size)
+      {
+        out_values[i] = json_reader->token;
+        paths_left--;
+      }
+      else if (kind == AZ_JSON_TOKEN_BEGIN_OBJECT || kind == AZ_JSON_TOKEN_BEGIN_ARRAY)
+      {
+        followed_pointer = i;
+        is_followed = true;
+      }
+    }
+
+    if (is_followed)
+    {
+      item_indexes[depth] = kind == AZ_JSON_TOKEN_BEGIN_ARRAY ? 0 : -1;
+      depth++;
+    }
+    else if (paths_left > 0)
+    {
+      AZ_RETURN_IF_FAILED(az_json_reader_skip_children(json_reader));
+    }
+  }
+
+  return paths_left == 0 ? AZ_OK : AZ_ERROR_ITEM_NOT_FOUND;
+}
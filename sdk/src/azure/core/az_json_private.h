@@ -108,6 +108,33 @@ AZ_NODISCARD AZ_INLINE _az_json_stack_item _az_json_stack_peek(_az_json_bit_stac
                                                         : _az_JSON_STACK_ARRAY;
 }
 
+AZ_NODISCARD AZ_INLINE uint8_t _az_json_unescape_single_byte(uint8_t ch)
+{
+  switch (ch)
+  {
+    case 'b':
+      return '\b';
+    case 'f':
+      return '\f';
+    case 'n':
+      return '\n';
+    case 'r':
+      return '\r';
+    case 't':
+      return '\t';
+    case '\\':
+    case '"':
+    case '/':
+    default:
+    {
+      // We are assuming the JSON token string has already been validated before this and we won't
+      // have unexpected bytes folowing the back slash (for example \q). Therefore, just return the
+      // same character back for such cases.
+      return ch;
+    }
+  }
+}
+
 #include <azure/core/_az_cfg_suffix.h>
 
 #endif // _az_SPAN_PRIVATE_H
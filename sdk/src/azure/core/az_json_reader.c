@@ -2,11 +2,13 @@
 // SPDX-License-Identifier: MIT
 
 #include "az_json_private.h"
+#include "az_simd_private.h"
 #include "az_span_private.h"
 
 #include <azure/core/az_precondition.h>
 
 #include <ctype.h>
+#include <string.h>
 
 #include <azure/core/_az_cfg.h>
 
@@ -32,11 +34,123 @@ AZ_NODISCARD az_result az_json_reader_init(
       .is_complex_json = false,
       .bit_stack = { 0 },
       .options = options == NULL ? az_json_reader_options_default() : *options,
+      .index = {
+        .start = 0,
+        .size = 0,
+        .whitespace = 0,
+        .string_ends = 0,
+      },
+      .chunked = {
+        .is_chunked = false,
+        .is_last_buffer = true,
+        .needs_buffer = false,
+        .token_buffer = AZ_SPAN_NULL,
+        .token_size = 0,
+        .next_buffer = AZ_SPAN_NULL,
+        .next_buffer_copied = 0,
+      },
+    },
+  };
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result az_json_reader_chunked_init(
+    az_json_reader* json_reader,
+    az_span first_json_buffer,
+    az_span token_buffer,
+    az_json_reader_options const* options)
+{
+  _az_PRECONDITION_NOT_NULL(json_reader);
+  _az_PRECONDITION_VALID_SPAN(first_json_buffer, 0, true);
+  _az_PRECONDITION_VALID_SPAN(token_buffer, 1, false);
+
+  *json_reader = (az_json_reader){
+    .token = (az_json_token){
+      .kind = AZ_JSON_TOKEN_NONE,
+      .slice = AZ_SPAN_NULL,
+      ._internal = {
+        .string_has_escaped_chars = false,
+      },
+    },
+    ._internal = {
+      .json_buffer = first_json_buffer,
+      .bytes_consumed = 0,
+      .is_complex_json = false,
+      .bit_stack = { 0 },
+      .options = options == NULL ? az_json_reader_options_default() : *options,
+      .index = {
+        .start = 0,
+        .size = 0,
+        .whitespace = 0,
+        .string_ends = 0,
+      },
+      .chunked = {
+        .is_chunked = true,
+        .is_last_buffer = false,
+        .needs_buffer = false,
+        .token_buffer = token_buffer,
+        .token_size = 0,
+        .next_buffer = AZ_SPAN_NULL,
+        .next_buffer_copied = 0,
+      },
     },
   };
   return AZ_OK;
 }
 
+// Makes the reader read json_buffer from its start, with no block of it indexed yet.
+static void _az_json_reader_set_buffer(az_json_reader* json_reader, az_span json_buffer)
+{
+  json_reader->_internal.json_buffer = json_buffer;
+  json_reader->_internal.bytes_consumed = 0;
+  json_reader->_internal.index.size = 0;
+}
+
+AZ_NODISCARD az_result
+az_json_reader_chunked_append(az_json_reader* json_reader, az_span next_json_buffer)
+{
+  _az_PRECONDITION_NOT_NULL(json_reader);
+  _az_PRECONDITION(json_reader->_internal.chunked.is_chunked);
+  _az_PRECONDITION_VALID_SPAN(next_json_buffer, 0, true);
+
+  if (!json_reader->_internal.chunked.needs_buffer || json_reader->_internal.chunked.is_last_buffer)
+  {
+    return AZ_ERROR_JSON_INVALID_STATE;
+  }
+  json_reader->_internal.chunked.needs_buffer = false;
+
+  int32_t const token_size = json_reader->_internal.chunked.token_size;
+  if (token_size == 0)
+  {
+    _az_json_reader_set_buffer(json_reader, next_json_buffer);
+    return AZ_OK;
+  }
+
+  // The cut token is read from the token buffer, followed by as much of the next buffer as it fits.
+  az_span const token_buffer = json_reader->_internal.chunked.token_buffer;
+  int32_t copied = az_span_size(token_buffer) - token_size;
+  if (copied > az_span_size(next_json_buffer))
+  {
+    copied = az_span_size(next_json_buffer);
+  }
+
+  az_span_copy(
+      az_span_slice_to_end(token_buffer, token_size), az_span_slice(next_json_buffer, 0, copied));
+  json_reader->_internal.chunked.next_buffer = next_json_buffer;
+  json_reader->_internal.chunked.next_buffer_copied = copied;
+  _az_json_reader_set_buffer(json_reader, az_span_slice(token_buffer, 0, token_size + copied));
+  return AZ_OK;
+}
+
+void az_json_reader_chunked_end(az_json_reader* json_reader)
+{
+  _az_PRECONDITION_NOT_NULL(json_reader);
+  _az_PRECONDITION(json_reader->_internal.chunked.is_chunked);
+
+  json_reader->_internal.chunked.is_last_buffer = true;
+  json_reader->_internal.chunked.needs_buffer = false;
+}
+
 AZ_NODISCARD static az_span _get_remaining_json(az_json_reader* json_reader)
 {
   _az_PRECONDITION_NOT_NULL(json_reader);
@@ -56,15 +170,233 @@ static void _az_json_reader_update_state(
   json_reader->_internal.bytes_consumed += consumed;
 }
 
+enum
+{
+  _az_JSON_INDEX_BLOCK_SIZE = 64, // Number of bytes classified at once, one bit each in a mask.
+};
+
+AZ_NODISCARD AZ_INLINE bool _az_json_is_whitespace(uint8_t byte)
+{
+  return byte == ' ' || byte == '\t' || byte == '\n' || byte == '\r';
+}
+
+AZ_NODISCARD AZ_INLINE bool _az_json_is_string_end(uint8_t byte)
+{
+  return byte == '"' || byte == '\\' || byte < 0x20;
+}
+
+#if defined(_az_SIMD_SSE2) || defined(_az_SIMD_NEON)
+#if defined(_az_SIMD_NEON)
+// Gets a mask of 64 bits, one per byte of the four comparison results, which NEON has no
+// instruction for: each byte keeps its bit, and pairwise additions gather them.
+AZ_NODISCARD AZ_INLINE uint64_t
+_az_json_neon_movemask(uint8x16_t m0, uint8x16_t m1, uint8x16_t m2, uint8x16_t m3)
+{
+  static uint8_t const bits[16] = { 1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128 };
+  uint8x16_t const weights = vld1q_u8(bits);
+  m0 = vandq_u8(m0, weights);
+  m1 = vandq_u8(m1, weights);
+  m2 = vandq_u8(m2, weights);
+  m3 = vandq_u8(m3, weights);
+  uint8x8_t const sum01 = vpadd_u8(
+      vpadd_u8(vget_low_u8(m0), vget_high_u8(m0)), vpadd_u8(vget_low_u8(m1), vget_high_u8(m1)));
+  uint8x8_t const sum23 = vpadd_u8(
+      vpadd_u8(vget_low_u8(m2), vget_high_u8(m2)), vpadd_u8(vget_low_u8(m3), vget_high_u8(m3)));
+  return vget_lane_u64(vreinterpret_u64_u8(vpadd_u8(sum01, sum23)), 0);
+}
+#endif // _az_SIMD_NEON
+
+/**
+ * @brief Classifies the bytes of the block of the JSON buffer that starts at \p start.
+ */
+static void _az_json_reader_index_block(az_json_reader* json_reader, int32_t start)
+{
+  az_span const json_buffer = json_reader->_internal.json_buffer;
+  int32_t const remaining = az_span_size(json_buffer) - start;
+  int32_t const size
+      = remaining < _az_JSON_INDEX_BLOCK_SIZE ? remaining : _az_JSON_INDEX_BLOCK_SIZE;
+  uint8_t const* block = az_span_ptr(json_buffer) + start;
+
+  // The end of the buffer is copied to a full block. The padding is neither whitespace nor the end
+  // of a string, which the lookups find as the end of the block.
+  uint8_t padded_block[_az_JSON_INDEX_BLOCK_SIZE];
+  if (size < _az_JSON_INDEX_BLOCK_SIZE)
+  {
+    memset(padded_block, 'a', sizeof(padded_block));
+    memcpy(padded_block, block, (size_t)size);
+    block = padded_block;
+  }
+
+  uint64_t whitespace = 0;
+  uint64_t string_ends = 0;
+  bool const validate_utf8 = json_reader->_internal.options.validate_utf8;
+
+  // A byte is a control character when it is unchanged by an unsigned min with 0x1F. When UTF-8
+  // is validated, the bytes above 0x7F also end the runs of ASCII characters of strings: their high
+  // bit is what the movemask instructions read.
+#if defined(_az_SIMD_AVX2)
+  {
+    __m256i const control_max = _mm256_set1_epi8(0x1F);
+    __m256i const non_ascii = _mm256_set1_epi8(validate_utf8 ? (char)0x80 : 0);
+    for (int32_t i = 0; i < _az_JSON_INDEX_BLOCK_SIZE; i += 32)
+    {
+      __m256i const bytes = _mm256_loadu_si256((__m256i const*)(block + i));
+      __m256i const is_whitespace = _mm256_or_si256(
+          _mm256_or_si256(
+              _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8(' ')),
+              _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8('\t'))),
+          _mm256_or_si256(
+              _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8('\n')),
+              _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8('\r'))));
+      __m256i const is_string_end = _mm256_or_si256(
+          _mm256_or_si256(
+              _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8('"')),
+              _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8('\\'))),
+          _mm256_or_si256(
+              _mm256_cmpeq_epi8(_mm256_min_epu8(bytes, control_max), bytes),
+              _mm256_and_si256(bytes, non_ascii)));
+      whitespace |= (uint64_t)(uint32_t)_mm256_movemask_epi8(is_whitespace) << i;
+      string_ends |= (uint64_t)(uint32_t)_mm256_movemask_epi8(is_string_end) << i;
+    }
+  }
+#elif defined(_az_SIMD_SSE2)
+  {
+    __m128i const control_max = _mm_set1_epi8(0x1F);
+    __m128i const non_ascii = _mm_set1_epi8(validate_utf8 ? (char)0x80 : 0);
+    for (int32_t i = 0; i < _az_JSON_INDEX_BLOCK_SIZE; i += 16)
+    {
+      __m128i const bytes = _mm_loadu_si128((__m128i const*)(block + i));
+      __m128i const is_whitespace = _mm_or_si128(
+          _mm_or_si128(
+              _mm_cmpeq_epi8(bytes, _mm_set1_epi8(' ')),
+              _mm_cmpeq_epi8(bytes, _mm_set1_epi8('\t'))),
+          _mm_or_si128(
+              _mm_cmpeq_epi8(bytes, _mm_set1_epi8('\n')),
+              _mm_cmpeq_epi8(bytes, _mm_set1_epi8('\r'))));
+      __m128i const is_string_end = _mm_or_si128(
+          _mm_or_si128(
+              _mm_cmpeq_epi8(bytes, _mm_set1_epi8('"')),
+              _mm_cmpeq_epi8(bytes, _mm_set1_epi8('\\'))),
+          _mm_or_si128(
+              _mm_cmpeq_epi8(_mm_min_epu8(bytes, control_max), bytes),
+              _mm_and_si128(bytes, non_ascii)));
+      whitespace |= (uint64_t)(uint32_t)_mm_movemask_epi8(is_whitespace) << i;
+      string_ends |= (uint64_t)(uint32_t)_mm_movemask_epi8(is_string_end) << i;
+    }
+  }
+#elif defined(_az_SIMD_NEON)
+  {
+    uint8x16_t const non_ascii = vdupq_n_u8(validate_utf8 ? 0xFF : 0);
+    uint8x16_t is_whitespace[4];
+    uint8x16_t is_string_end[4];
+    for (int32_t i = 0; i < 4; ++i)
+    {
+      uint8x16_t const bytes = vld1q_u8(block + i * 16);
+      is_whitespace[i] = vorrq_u8(
+          vorrq_u8(vceqq_u8(bytes, vdupq_n_u8(' ')), vceqq_u8(bytes, vdupq_n_u8('\t'))),
+          vorrq_u8(vceqq_u8(bytes, vdupq_n_u8('\n')), vceqq_u8(bytes, vdupq_n_u8('\r'))));
+      is_string_end[i] = vorrq_u8(
+          vorrq_u8(vceqq_u8(bytes, vdupq_n_u8('"')), vceqq_u8(bytes, vdupq_n_u8('\\'))),
+          vorrq_u8(
+              vcleq_u8(bytes, vdupq_n_u8(0x1F)),
+              vandq_u8(vcgeq_u8(bytes, vdupq_n_u8(0x80)), non_ascii)));
+    }
+    whitespace = _az_json_neon_movemask(
+        is_whitespace[0], is_whitespace[1], is_whitespace[2], is_whitespace[3]);
+    string_ends = _az_json_neon_movemask(
+        is_string_end[0], is_string_end[1], is_string_end[2], is_string_end[3]);
+  }
+#endif // _az_SIMD_AVX2
+
+  json_reader->_internal.index.start = start;
+  json_reader->_internal.index.size = size;
+  json_reader->_internal.index.whitespace = whitespace;
+  json_reader->_internal.index.string_ends = string_ends;
+}
+
+/**
+ * @brief Finds the first byte of the JSON buffer, from \p position, that is not whitespace or, if
+ * \p find_string_end is `true`, that is `"`, `\`, a control character or, when UTF-8 is validated,
+ * above 0x7F.
+ *
+ * @return The offset of the byte in the JSON buffer, or the size of the buffer if there is none.
+ */
+AZ_NODISCARD static int32_t
+_az_json_reader_find_next(az_json_reader* json_reader, int32_t position, bool find_string_end)
+{
+  int32_t const buffer_size = az_span_size(json_reader->_internal.json_buffer);
+  while (position < buffer_size)
+  {
+    if (position < json_reader->_internal.index.start
+        || position >= json_reader->_internal.index.start + json_reader->_internal.index.size)
+    {
+      _az_json_reader_index_block(json_reader, position);
+    }
+
+    int32_t const start = json_reader->_internal.index.start;
+    int32_t const end = start + json_reader->_internal.index.size;
+    uint64_t const mask
+        = (find_string_end ? json_reader->_internal.index.string_ends
+                           : ~json_reader->_internal.index.whitespace)
+        >> (position - start);
+    if (mask != 0)
+    {
+      int32_t const found = position + _az_simd_lowest_bit_index(mask);
+      if (found < end)
+      {
+        return found;
+      }
+    }
+
+    position = end;
+  }
+
+  return buffer_size;
+}
+#else
+// Without SIMD instructions, the bytes are read one at a time: indexing a block would read each of
+// them as many times, and most of the whitespace and strings are shorter than a block.
+AZ_NODISCARD static int32_t
+_az_json_reader_find_next(az_json_reader* json_reader, int32_t position, bool find_string_end)
+{
+  uint8_t const* const json = az_span_ptr(json_reader->_internal.json_buffer);
+  int32_t const buffer_size = az_span_size(json_reader->_internal.json_buffer);
+  if (find_string_end)
+  {
+    uint8_t const last_ascii = json_reader->_internal.options.validate_utf8 ? 0x7F : 0xFF;
+    while (position < buffer_size && !_az_json_is_string_end(json[position])
+           && json[position] <= last_ascii)
+    {
+      position++;
+    }
+  }
+  else
+  {
+    while (position < buffer_size && _az_json_is_whitespace(json[position]))
+    {
+      position++;
+    }
+  }
+
+  return position;
+}
+#endif // _az_SIMD_SSE2 || _az_SIMD_NEON
+
 AZ_NODISCARD static az_span _az_json_reader_skip_whitespace(az_json_reader* json_reader)
 {
-  az_span remaining = _get_remaining_json(json_reader);
-  az_span json = _az_span_trim_whitespace_from_start(remaining);
+  az_span const json_buffer = json_reader->_internal.json_buffer;
+  int32_t const position = json_reader->_internal.bytes_consumed;
 
-  // Find out how many whitespace characters were trimmed.
-  json_reader->_internal.bytes_consumed += az_span_size(remaining) - az_span_size(json);
+  // Tokens are mostly separated by no whitespace, or a single one: the index is only looked up
+  // after it.
+  if (position < az_span_size(json_buffer)
+      && _az_json_is_whitespace(az_span_ptr(json_buffer)[position]))
+  {
+    json_reader->_internal.bytes_consumed
+        = _az_json_reader_find_next(json_reader, position + 1, false);
+  }
 
-  return json;
+  return _get_remaining_json(json_reader);
 }
 
 AZ_NODISCARD static az_result _az_json_reader_process_container_end(
@@ -138,77 +470,163 @@ AZ_NODISCARD static bool _az_validate_hex_digits(uint8_t* token_ptr, int32_t ind
   return true;
 }
 
+/**
+ * @brief Gets the size of the UTF-8 sequence (RFC 3629) that starts with the byte above 0x7F at
+ * \p bytes, of which \p size bytes are in the JSON buffer.
+ *
+ * @return The size of the sequence, `0` if it is invalid, or `-1` if it is valid up to the end of
+ * the JSON buffer.
+ */
+AZ_NODISCARD static int32_t _az_json_utf8_sequence_size(uint8_t const* bytes, int32_t size)
+{
+  uint8_t const lead = bytes[0];
+  int32_t sequence_size = 0;
+
+  // The range of the second byte excludes overlong encodings, surrogates (U+D800 to U+DFFF) and
+  // code points above U+10FFFF.
+  uint8_t min = 0x80;
+  uint8_t max = 0xBF;
+  if (lead >= 0xC2 && lead <= 0xDF)
+  {
+    sequence_size = 2;
+  }
+  else if (lead >= 0xE0 && lead <= 0xEF)
+  {
+    sequence_size = 3;
+    min = lead == 0xE0 ? 0xA0 : min;
+    max = lead == 0xED ? 0x9F : max;
+  }
+  else if (lead >= 0xF0 && lead <= 0xF4)
+  {
+    sequence_size = 4;
+    min = lead == 0xF0 ? 0x90 : min;
+    max = lead == 0xF4 ? 0x8F : max;
+  }
+  else
+  {
+    return 0;
+  }
+
+  for (int32_t i = 1; i < sequence_size; ++i)
+  {
+    if (i >= size)
+    {
+      return -1;
+    }
+
+    if (bytes[i] < min || bytes[i] > max)
+    {
+      return 0;
+    }
+
+    min = 0x80;
+    max = 0xBF;
+  }
+
+  return sequence_size;
+}
+
 AZ_NODISCARD static az_result _az_json_reader_process_string(az_json_reader* json_reader)
 {
   // Move past the first '"' character
   json_reader->_internal.bytes_consumed++;
 
+  int32_t const start = json_reader->_internal.bytes_consumed;
   az_span token = _get_remaining_json(json_reader);
   uint8_t* const token_ptr = az_span_ptr(token);
   int32_t const remaining_size = az_span_size(token);
 
+  // Like any string the payload ends in, one that ends right after its opening quote isn't
+  // terminated.
+  if (remaining_size < 1)
+  {
+    return AZ_ERROR_EOF;
+  }
+
   int32_t string_length = 0;
-  uint8_t next_byte = token_ptr[0];
 
   // Clear the state of any previous string token.
   json_reader->token._internal.string_has_escaped_chars = false;
 
   while (true)
   {
+    // The bytes up to the next '"', '\', control character, or non-ASCII byte when UTF-8 is
+    // validated, are part of the string.
+    string_length = _az_json_reader_find_next(json_reader, start + string_length, true) - start;
+    if (string_length >= remaining_size)
+    {
+      return AZ_ERROR_EOF;
+    }
+
+    uint8_t next_byte = token_ptr[string_length];
     if (next_byte == '"')
     {
       break;
     }
-    else if (next_byte == '\\')
-    {
-      json_reader->token._internal.string_has_escaped_chars = true;
-      string_length++;
-      if (string_length >= remaining_size)
-      {
-        return AZ_ERROR_EOF;
-      }
-      next_byte = token_ptr[string_length];
 
-      if (next_byte == 'u')
+    // Characters outside of ASCII mostly follow each other, they are validated until the next
+    // ASCII character.
+    if (next_byte > 0x7F)
+    {
+      do
       {
-        string_length++;
-        // Expecting 4 hex digits to follow the escaped 'u'
-        if (string_length > remaining_size - 4)
+        int32_t const sequence_size = _az_json_utf8_sequence_size(
+            token_ptr + string_length, remaining_size - string_length);
+        if (sequence_size < 0)
         {
           return AZ_ERROR_EOF;
         }
-
-        if (!_az_validate_hex_digits(token_ptr, string_length))
+        if (sequence_size == 0)
         {
           return AZ_ERROR_UNEXPECTED_CHAR;
         }
 
-        // Skip past the 4 hex digits, the loop accounts for incrementing by 1 more.
-        string_length += 3;
+        string_length += sequence_size;
+      } while (string_length < remaining_size && token_ptr[string_length] > 0x7F);
+      continue;
+    }
+
+    // Control characters are invalid within a JSON string and should be correctly escaped.
+    if (next_byte != '\\')
+    {
+      return AZ_ERROR_UNEXPECTED_CHAR;
+    }
+
+    json_reader->token._internal.string_has_escaped_chars = true;
+    string_length++;
+    if (string_length >= remaining_size)
+    {
+      return AZ_ERROR_EOF;
+    }
+    next_byte = token_ptr[string_length];
+
+    if (next_byte == 'u')
+    {
+      string_length++;
+      // Expecting 4 hex digits to follow the escaped 'u'
+      if (string_length > remaining_size - 4)
+      {
+        return AZ_ERROR_EOF;
       }
-      else
+
+      if (!_az_validate_hex_digits(token_ptr, string_length))
       {
-        if (!_az_is_valid_escaped_character(next_byte))
-        {
-          return AZ_ERROR_UNEXPECTED_CHAR;
-        }
+        return AZ_ERROR_UNEXPECTED_CHAR;
       }
+
+      // Skip past the 4 hex digits, the last one is skipped below.
+      string_length += 3;
     }
     else
     {
-      // Control characters are invalid within a JSON string and should be correctly escaped.
-      if (next_byte < 0x20)
+      if (!_az_is_valid_escaped_character(next_byte))
       {
         return AZ_ERROR_UNEXPECTED_CHAR;
       }
     }
 
+    // Move past the escaped character.
     string_length++;
-    if (string_length >= remaining_size)
-    {
-      return AZ_ERROR_EOF;
-    }
-    next_byte = token_ptr[string_length];
   }
 
   // Add 1 to number of bytes consumed to account for the last '"' character.
@@ -247,18 +665,18 @@ AZ_NODISCARD static az_result _az_json_reader_process_property_name(az_json_read
 // Used to search for possible valid end of a number character, when we have complex JSON payloads
 // (i.e. not a single JSON value).
 // Whitespace characters, comma, or a container end character indicate the end of a JSON number.
-static const az_span json_delimiters = AZ_SPAN_LITERAL_FROM_STR(",}] \n\r\t");
+AZ_NODISCARD AZ_INLINE bool _az_json_is_number_delimiter(uint8_t byte)
+{
+  return byte == ',' || byte == '}' || byte == ']' || _az_json_is_whitespace(byte);
+}
 
 AZ_NODISCARD static bool _az_finished_consuming_json_number(
     uint8_t next_byte,
     az_span expected_next_bytes,
     az_result* result)
 {
-  az_span next_byte_span = az_span_create(&next_byte, 1);
-
   // Checking if we are done processing a JSON number
-  int32_t index = az_span_find(json_delimiters, next_byte_span);
-  if (index != -1)
+  if (_az_json_is_number_delimiter(next_byte))
   {
     *result = AZ_OK;
     return true;
@@ -268,8 +686,8 @@ AZ_NODISCARD static bool _az_finished_consuming_json_number(
   // indicate scientific notation. For example "01" or "123f" is invalid.
   // The next character after "[-][digits].[digits]" must be 'e'/'E' if we haven't reached the end
   // of the number yet. For example, "1.1f" or "1.1-" are invalid.
-  index = az_span_find(expected_next_bytes, next_byte_span);
-  if (index == -1)
+  if (memchr(az_span_ptr(expected_next_bytes), next_byte, (size_t)az_span_size(expected_next_bytes))
+      == NULL)
   {
     *result = AZ_ERROR_UNEXPECTED_CHAR;
     return true;
@@ -305,7 +723,8 @@ AZ_NODISCARD static az_result _az_json_reader_update_number_state_if_single_valu
     az_span token_slice,
     int32_t consumed_count)
 {
-  if (json_reader->_internal.is_complex_json)
+  // A single number may also continue in the next buffer.
+  if (json_reader->_internal.is_complex_json || !json_reader->_internal.chunked.is_last_buffer)
   {
     return AZ_ERROR_EOF;
   }
@@ -479,8 +898,7 @@ AZ_NODISCARD static az_result _az_json_reader_process_number(az_json_reader* jso
 
   // Checking if we are done processing a JSON number
   next_byte = next_byte_ptr[consumed_count];
-  int32_t index = az_span_find(json_delimiters, az_span_create(&next_byte, 1));
-  if (index == -1)
+  if (!_az_json_is_number_delimiter(next_byte))
   {
     return AZ_ERROR_UNEXPECTED_CHAR;
   }
@@ -627,15 +1045,17 @@ AZ_NODISCARD static az_result _az_json_reader_process_next_byte(
   }
 }
 
-AZ_NODISCARD az_result az_json_reader_next_token(az_json_reader* json_reader)
+AZ_NODISCARD static az_result _az_json_reader_read_token(az_json_reader* json_reader)
 {
-  _az_PRECONDITION_NOT_NULL(json_reader);
-
   az_span json = _az_json_reader_skip_whitespace(json_reader);
 
-  if (az_span_size(json) < 1 && json_reader->token.kind != AZ_JSON_TOKEN_NONE)
+  if (az_span_size(json) < 1)
   {
-    return AZ_ERROR_JSON_READER_DONE;
+    // An empty JSON payload is invalid, and more of it may follow the end of a buffer.
+    return json_reader->token.kind == AZ_JSON_TOKEN_NONE
+            || !json_reader->_internal.chunked.is_last_buffer
+        ? AZ_ERROR_EOF
+        : AZ_ERROR_JSON_READER_DONE;
   }
 
   uint8_t const first_byte = az_span_ptr(json)[0];
@@ -643,14 +1063,7 @@ AZ_NODISCARD az_result az_json_reader_next_token(az_json_reader* json_reader)
   switch (json_reader->token.kind)
   {
     case AZ_JSON_TOKEN_NONE:
-    {
-      // An empty JSON payload is invalid.
-      if (az_span_size(json) < 1)
-      {
-        return AZ_ERROR_EOF;
-      }
       return _az_json_reader_read_first_token(json_reader, json, first_byte);
-    }
     case AZ_JSON_TOKEN_BEGIN_OBJECT:
     {
       if (first_byte == '}')
@@ -694,6 +1107,85 @@ AZ_NODISCARD az_result az_json_reader_next_token(az_json_reader* json_reader)
   }
 }
 
+/**
+ * @brief Reads the next token of a chunked reader. A token cut by the end of the buffer is read
+ * again from its start, in the same state, once the next buffer is appended to it.
+ */
+AZ_NODISCARD static az_result _az_json_reader_read_chunked_token(az_json_reader* json_reader)
+{
+  // The reader is in the same state after the whitespace before the token, which the next buffer
+  // doesn't need to continue.
+  az_span const cut_token = _az_json_reader_skip_whitespace(json_reader);
+  int32_t const token_start = json_reader->_internal.bytes_consumed;
+  az_json_token const token = json_reader->token;
+  _az_json_bit_stack const bit_stack = json_reader->_internal.bit_stack;
+  bool const is_complex_json = json_reader->_internal.is_complex_json;
+
+  az_result const result = _az_json_reader_read_token(json_reader);
+  int32_t const token_size = json_reader->_internal.chunked.token_size;
+  az_span const next_buffer = json_reader->_internal.chunked.next_buffer;
+
+  if (az_succeeded(result) && token_size > 0)
+  {
+    // The cut token ends in the next buffer, which is read from there.
+    _az_PRECONDITION(json_reader->_internal.bytes_consumed >= token_size);
+    int32_t const consumed = json_reader->_internal.bytes_consumed - token_size;
+    json_reader->_internal.chunked.token_size = 0;
+    json_reader->_internal.chunked.next_buffer = AZ_SPAN_NULL;
+    json_reader->_internal.chunked.next_buffer_copied = 0;
+    _az_json_reader_set_buffer(json_reader, next_buffer);
+    json_reader->_internal.bytes_consumed = consumed;
+    return result;
+  }
+
+  if (result != AZ_ERROR_EOF)
+  {
+    return result;
+  }
+
+  json_reader->token = token;
+  json_reader->_internal.bit_stack = bit_stack;
+  json_reader->_internal.is_complex_json = is_complex_json;
+  json_reader->_internal.bytes_consumed = token_start;
+
+  // The token continues past the part of the next buffer that fits in the token buffer.
+  if (token_size > 0
+      && json_reader->_internal.chunked.next_buffer_copied < az_span_size(next_buffer))
+  {
+    return AZ_ERROR_INSUFFICIENT_SPAN_SIZE;
+  }
+
+  if (json_reader->_internal.chunked.is_last_buffer)
+  {
+    return AZ_ERROR_EOF;
+  }
+
+  // The cut token is moved to the start of the token buffer, which it may already be in, and the
+  // reader reads it there until the next buffer is appended.
+  az_span const token_buffer = json_reader->_internal.chunked.token_buffer;
+  if (az_span_size(cut_token) > az_span_size(token_buffer))
+  {
+    return AZ_ERROR_INSUFFICIENT_SPAN_SIZE;
+  }
+
+  az_span_copy(token_buffer, cut_token);
+  json_reader->_internal.chunked.token_size = az_span_size(cut_token);
+  json_reader->_internal.chunked.next_buffer = AZ_SPAN_NULL;
+  json_reader->_internal.chunked.next_buffer_copied = 0;
+  json_reader->_internal.chunked.needs_buffer = true;
+  _az_json_reader_set_buffer(json_reader, az_span_slice(token_buffer, 0, az_span_size(cut_token)));
+  return AZ_ERROR_JSON_READER_NEED_MORE_DATA;
+}
+
+AZ_NODISCARD az_result az_json_reader_next_token(az_json_reader* json_reader)
+{
+  _az_PRECONDITION_NOT_NULL(json_reader);
+
+  return json_reader->_internal.chunked.is_chunked
+      ? _az_json_reader_read_chunked_token(json_reader)
+      : _az_json_reader_read_token(json_reader);
+}
+
 AZ_NODISCARD az_result az_json_reader_skip_children(az_json_reader* json_reader)
 {
   _az_PRECONDITION_NOT_NULL(json_reader);
@@ -7,33 +7,6 @@
 
 #include <azure/core/_az_cfg.h>
 
-AZ_NODISCARD static uint8_t _az_json_unescape_single_byte(uint8_t ch)
-{
-  switch (ch)
-  {
-    case 'b':
-      return '\b';
-    case 'f':
-      return '\f';
-    case 'n':
-      return '\n';
-    case 'r':
-      return '\r';
-    case 't':
-      return '\t';
-    case '\\':
-    case '"':
-    case '/':
-    default:
-    {
-      // We are assuming the JSON token string has already been validated before this and we won't
-      // have unexpected bytes folowing the back slash (for example \q). Therefore, just return the
-      // same character back for such cases.
-      return ch;
-    }
-  }
-}
-
 AZ_NODISCARD bool az_json_token_is_text_equal(
     az_json_token const* json_token,
     az_span expected_text)
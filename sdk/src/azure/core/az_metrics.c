@@ -0,0 +1,105 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include <azure/core/az_metrics.h>
+#include <azure/core/internal/az_metrics_internal.h>
+#include <azure/core/internal/az_precondition_internal.h>
+#include <azure/core/internal/az_spinlock_internal.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <azure/core/_az_cfg.h>
+
+void az_metrics_histogram_init(az_metrics_histogram* out_histogram)
+{
+  _az_PRECONDITION_NOT_NULL(out_histogram);
+
+  *out_histogram = (az_metrics_histogram){ 0 };
+}
+
+void az_metrics_histogram_get_bucket(
+    az_metrics_histogram* histogram,
+    int32_t index,
+    int64_t* out_upper_bound_msec,
+    int64_t* out_count)
+{
+  _az_PRECONDITION_NOT_NULL(histogram);
+  _az_PRECONDITION_RANGE(0, index, AZ_METRICS_HISTOGRAM_BUCKETS - 1);
+  _az_PRECONDITION_NOT_NULL(out_upper_bound_msec);
+  _az_PRECONDITION_NOT_NULL(out_count);
+
+  *out_upper_bound_msec
+      = index < AZ_METRICS_HISTOGRAM_BUCKETS - 1 ? (int64_t)1 << index : INT64_MAX;
+
+  _az_spinlock_enter_reader(&histogram->_internal.lock);
+  *out_count = histogram->_internal.counts[index];
+  _az_spinlock_exit_reader(&histogram->_internal.lock);
+}
+
+#ifndef AZ_NO_METRICS
+
+static az_metrics_fn volatile _az_metrics_callback = NULL;
+static az_metrics_histogram* volatile _az_metrics_total_histogram = NULL;
+static az_metrics_histogram* volatile _az_metrics_time_to_first_byte_histogram = NULL;
+
+void az_metrics_set_callback(az_metrics_fn metrics_callback)
+{
+  _az_metrics_callback = metrics_callback;
+}
+
+void az_metrics_set_histograms(
+    az_metrics_histogram* total,
+    az_metrics_histogram* time_to_first_byte)
+{
+  _az_metrics_total_histogram = total;
+  _az_metrics_time_to_first_byte_histogram = time_to_first_byte;
+}
+
+static void _az_metrics_histogram_add(az_metrics_histogram* ref_histogram, int64_t latency_msec)
+{
+  // The first bucket whose upper bound, 2^index milliseconds, isn't lower than the latency.
+  int32_t index = 0;
+  while (index < AZ_METRICS_HISTOGRAM_BUCKETS - 1 && ((int64_t)1 << index) < latency_msec)
+  {
+    ++index;
+  }
+
+  _az_spinlock_enter_writer(&ref_histogram->_internal.lock);
+  ++ref_histogram->_internal.counts[index];
+  _az_spinlock_exit_writer(&ref_histogram->_internal.lock);
+}
+
+bool _az_metrics_should_write()
+{
+  return _az_metrics_callback != NULL || _az_metrics_total_histogram != NULL
+      || _az_metrics_time_to_first_byte_histogram != NULL;
+}
+
+void _az_metrics_write(az_http_metrics const* metrics)
+{
+  // Copy the volatile fields to local variables so that they don't change within this function
+  az_metrics_fn const callback = _az_metrics_callback;
+  az_metrics_histogram* const total_histogram = _az_metrics_total_histogram;
+  az_metrics_histogram* const time_to_first_byte_histogram
+      = _az_metrics_time_to_first_byte_histogram;
+
+  if (total_histogram != NULL)
+  {
+    _az_metrics_histogram_add(total_histogram, metrics->total_msec);
+  }
+
+  // Requests that didn't reach the transport, or failed before a response, have no first byte.
+  if (time_to_first_byte_histogram != NULL && metrics->time_to_first_byte_usec > 0)
+  {
+    _az_metrics_histogram_add(
+        time_to_first_byte_histogram, (metrics->time_to_first_byte_usec + 999) / 1000);
+  }
+
+  if (callback != NULL)
+  {
+    callback(metrics);
+  }
+}
+
+#endif // AZ_NO_METRICS
@@ -0,0 +1,77 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file az_simd_private.h
+ *
+ * @brief Selects the SIMD instruction set the SDK's byte scanners are compiled for.
+ *
+ * @details The instruction set is chosen at compile time from what the compiler targets: AVX2 when
+ * enabled (e.g. `-mavx2`), otherwise SSE2 on x86 and x64, NEON on ARM. Every scanner has a scalar
+ * implementation, used on other targets or when `AZ_NO_SIMD` is defined.
+ */
+
+#ifndef _az_SIMD_PRIVATE_H
+#define _az_SIMD_PRIVATE_H
+
+#include <stdint.h>
+
+#if !defined(AZ_NO_SIMD)
+#if defined(__AVX2__)
+#define _az_SIMD_AVX2
+#define _az_SIMD_SSE2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define _az_SIMD_SSE2
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#define _az_SIMD_NEON
+#endif
+#endif // AZ_NO_SIMD
+
+#if defined(_az_SIMD_SSE2)
+#include <immintrin.h>
+#elif defined(_az_SIMD_NEON)
+#include <arm_neon.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#include <azure/core/_az_cfg_prefix.h>
+
+// Name of the instruction set the scanners use, for diagnostics and benchmarks.
+#if defined(_az_SIMD_AVX2)
+#define _az_SIMD_NAME "AVX2"
+#elif defined(_az_SIMD_SSE2)
+#define _az_SIMD_NAME "SSE2"
+#elif defined(_az_SIMD_NEON)
+#define _az_SIMD_NAME "NEON"
+#else
+#define _az_SIMD_NAME "scalar"
+#endif
+
+/**
+ * @brief Returns the index of the lowest bit set in \p mask, which must not be `0`.
+ */
+AZ_INLINE int32_t _az_simd_lowest_bit_index(uint64_t mask)
+{
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+  unsigned long index = 0;
+  (void)_BitScanForward64(&index, mask);
+  return (int32_t)index;
+#elif defined(__GNUC__) || defined(__clang__)
+  return (int32_t)__builtin_ctzll(mask);
+#else
+  int32_t index = 0;
+  while ((mask & 1) == 0)
+  {
+    mask >>= 1;
+    ++index;
+  }
+  return index;
+#endif
+}
+
+#include <azure/core/_az_cfg_suffix.h>
+
+#endif // _az_SIMD_PRIVATE_H
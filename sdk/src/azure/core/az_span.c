@@ -2,6 +2,7 @@
 // SPDX-License-Identifier: MIT
 
 #include "az_hex_private.h"
+#include "az_simd_private.h"
 #include "az_span_private.h"
 #include <azure/core/az_precondition.h>
 #include <azure/core/az_span.h>
@@ -898,6 +899,94 @@ _az_span_scan_until(az_span span, _az_predicate predicate, int32_t* out_index)
   return AZ_ERROR_ITEM_NOT_FOUND;
 }
 
+AZ_NODISCARD AZ_INLINE bool _az_is_delimiter_or_control(uint8_t c, uint8_t delimiter)
+{
+  return c == delimiter || (c < ' ' && c != '\t');
+}
+
+AZ_NODISCARD int32_t _az_span_find_delimiter_or_control(az_span span, uint8_t delimiter)
+{
+  _az_PRECONDITION_VALID_SPAN(span, 0, true);
+
+  uint8_t* const ptr = az_span_ptr(span);
+  int32_t const size = az_span_size(span);
+  int32_t index = 0;
+
+  // Each block of bytes is compared at once: a byte is a control character when it is unchanged by
+  // an unsigned min with 0x1F.
+#if defined(_az_SIMD_AVX2)
+  {
+    __m256i const control_max = _mm256_set1_epi8(0x1F);
+    __m256i const tab = _mm256_set1_epi8('\t');
+    __m256i const delimiters = _mm256_set1_epi8((char)delimiter);
+    for (; index + 32 <= size; index += 32)
+    {
+      __m256i const bytes = _mm256_loadu_si256((__m256i const*)(ptr + index));
+      __m256i const is_control = _mm256_cmpeq_epi8(_mm256_min_epu8(bytes, control_max), bytes);
+      __m256i const is_match = _mm256_or_si256(
+          _mm256_andnot_si256(_mm256_cmpeq_epi8(bytes, tab), is_control),
+          _mm256_cmpeq_epi8(bytes, delimiters));
+      uint32_t const mask = (uint32_t)_mm256_movemask_epi8(is_match);
+      if (mask != 0)
+      {
+        return index + _az_simd_lowest_bit_index(mask);
+      }
+    }
+  }
+#endif // _az_SIMD_AVX2
+
+#if defined(_az_SIMD_SSE2)
+  {
+    __m128i const control_max = _mm_set1_epi8(0x1F);
+    __m128i const tab = _mm_set1_epi8('\t');
+    __m128i const delimiters = _mm_set1_epi8((char)delimiter);
+    for (; index + 16 <= size; index += 16)
+    {
+      __m128i const bytes = _mm_loadu_si128((__m128i const*)(ptr + index));
+      __m128i const is_control = _mm_cmpeq_epi8(_mm_min_epu8(bytes, control_max), bytes);
+      __m128i const is_match = _mm_or_si128(
+          _mm_andnot_si128(_mm_cmpeq_epi8(bytes, tab), is_control),
+          _mm_cmpeq_epi8(bytes, delimiters));
+      uint32_t const mask = (uint32_t)_mm_movemask_epi8(is_match);
+      if (mask != 0)
+      {
+        return index + _az_simd_lowest_bit_index(mask);
+      }
+    }
+  }
+#elif defined(_az_SIMD_NEON)
+  {
+    uint8x16_t const control_max = vdupq_n_u8(0x1F);
+    uint8x16_t const tab = vdupq_n_u8('\t');
+    uint8x16_t const delimiters = vdupq_n_u8(delimiter);
+    for (; index + 16 <= size; index += 16)
+    {
+      uint8x16_t const bytes = vld1q_u8(ptr + index);
+      uint8x16_t const is_match = vorrq_u8(
+          vbicq_u8(vcleq_u8(bytes, control_max), vceqq_u8(bytes, tab)),
+          vceqq_u8(bytes, delimiters));
+      // NEON has no movemask: narrowing each 16-bit lane by 4 bits leaves one nibble per byte.
+      uint64_t const mask = vget_lane_u64(
+          vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(is_match), 4)), 0);
+      if (mask != 0)
+      {
+        return index + _az_simd_lowest_bit_index(mask) / 4;
+      }
+    }
+  }
+#endif // _az_SIMD_SSE2
+
+  for (; index < size; ++index)
+  {
+    if (_az_is_delimiter_or_control(ptr[index], delimiter))
+    {
+      return index;
+    }
+  }
+
+  return -1;
+}
+
 AZ_NODISCARD az_span _az_span_trim_whitespace(az_span source)
 {
   // Trim from end after trim from start
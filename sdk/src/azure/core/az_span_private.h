@@ -74,6 +74,17 @@ _az_span_scan_until(az_span span, _az_predicate predicate, int32_t* out_index);
 
 AZ_NODISCARD az_result _az_is_expected_span(az_span* ref_span, az_span expected);
 
+/**
+ * @brief Finds the first byte of \p span that is either \p delimiter, or a control character
+ * (`0x00` to `0x1F`) other than a horizontal tab.
+ *
+ * @details This is how the end of an HTTP header name (`:`), of a header value or of the status
+ * line (`\r`) is found. The scan uses SIMD instructions when available (see az_simd_private.h).
+ *
+ * @return The index of the byte, or `-1` if there is none.
+ */
+AZ_NODISCARD int32_t _az_span_find_delimiter_or_control(az_span span, uint8_t delimiter);
+
 /**
  * @brief Removes all leading and trailing whitespace characters from the \p span. Function will
  * create a new #az_span pointing to the first non-whitespace (` `, \\n, \\r, \\t) character found
@@ -134,6 +145,64 @@ AZ_NODISCARD az_span _az_span_trim_whitespace_from_start(az_span source);
  */
 AZ_NODISCARD az_span _az_span_trim_whitespace_from_end(az_span source);
 
+/**
+ * @brief Skips the first bytes of \p source, so that it starts at an address multiple of
+ * \p alignment, the alignment of the values laid out in it.
+ *
+ * @return The aligned rest of \p source, empty when \p source is too short to be aligned.
+ */
+AZ_NODISCARD AZ_INLINE az_span _az_span_align(az_span source, int32_t alignment)
+{
+  int32_t const misalignment = (int32_t)((uintptr_t)az_span_ptr(source) % (uintptr_t)alignment);
+  int32_t const padding = misalignment == 0 ? 0 : alignment - misalignment;
+  return padding <= az_span_size(source) ? az_span_slice_to_end(source, padding) : AZ_SPAN_NULL;
+}
+
+/**
+ * @brief The initial value of a 32-bit FNV-1a hash, see #_az_fnv1a_32_add.
+ */
+#define _az_FNV1A_32_OFFSET_BASIS 2166136261U
+
+/**
+ * @brief Adds a byte to a 32-bit FNV-1a hash, #_az_FNV1A_32_OFFSET_BASIS for the first byte.
+ */
+AZ_NODISCARD AZ_INLINE uint32_t _az_fnv1a_32_add(uint32_t hash, uint8_t byte)
+{
+  return (hash ^ byte) * 16777619U;
+}
+
+/**
+ * @brief The 32-bit FNV-1a hash of the bytes of \p source. It tells most spans apart without
+ * comparing them, but isn't meant to resist collisions made on purpose.
+ */
+AZ_NODISCARD AZ_INLINE uint32_t _az_span_fnv1a_32(az_span source)
+{
+  uint32_t hash = _az_FNV1A_32_OFFSET_BASIS;
+  uint8_t const* const ptr = az_span_ptr(source);
+  for (int32_t i = 0; i < az_span_size(source); ++i)
+  {
+    hash = _az_fnv1a_32_add(hash, ptr[i]);
+  }
+
+  return hash;
+}
+
+/**
+ * @brief The 64-bit FNV-1a hash of the bytes of \p source, for tables whose keys are too many or
+ * too long for #_az_span_fnv1a_32 to keep collisions rare.
+ */
+AZ_NODISCARD AZ_INLINE uint64_t _az_span_fnv1a_64(az_span source)
+{
+  uint64_t hash = 14695981039346656037ULL;
+  uint8_t const* const ptr = az_span_ptr(source);
+  for (int32_t i = 0; i < az_span_size(source); ++i)
+  {
+    hash = (hash ^ ptr[i]) * 1099511628211ULL;
+  }
+
+  return hash;
+}
+
 #include <azure/core/_az_cfg_suffix.h>
 
 #endif // _az_SPAN_PRIVATE_H
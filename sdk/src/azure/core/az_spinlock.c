@@ -34,12 +34,12 @@ void _az_spinlock_enter_writer(_az_spinlock* lock)
     }
 
     // Otherwise, if no writer is waiting, try to set that a writer is waiting
-    // If we fail, we'll spin around and try again
+    // Whether or not that succeeds, spin around and try again to acquire the lock
     if ((state & _az_SPINLOCK_WRITER_WAITING_BIT) == 0
         && az_platform_atomic_compare_exchange(
             &lock->_internal.state, state, state | _az_SPINLOCK_WRITER_WAITING_BIT))
     {
-      return;
+      continue;
     }
   }
 }
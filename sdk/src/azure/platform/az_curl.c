@@ -3,19 +3,34 @@
 
 #include <azure/core/az_http.h>
 #include <azure/core/az_http_transport.h>
+#include <azure/core/az_platform.h>
 #include <azure/core/az_span.h>
+#include <azure/core/internal/az_config_internal.h>
+#include <azure/core/internal/az_http_internal.h>
 #include <azure/core/internal/az_span_internal.h>
+#include <azure/core/internal/az_spinlock_internal.h>
+#include <azure/platform/az_curl.h>
 
+#include <stdbool.h>
+#include <stdint.h>
 #include <stdlib.h>
 
 #include <curl/curl.h>
 
 #include <azure/core/_az_cfg.h>
 
+#ifdef _az_MOCK_ENABLED
+static void _az_http_client_curl_count_allocation();
+#else
+// The allocations are only counted in the builds of the tests.
+#define _az_http_client_curl_count_allocation()
+#endif // _az_MOCK_ENABLED
+
 static AZ_NODISCARD az_result _az_span_malloc(int32_t size, az_span* out)
 {
   _az_PRECONDITION_NOT_NULL(out);
 
+  _az_http_client_curl_count_allocation();
   uint8_t* const p = (uint8_t*)malloc((size_t)size);
   if (p == NULL)
   {
@@ -57,25 +72,635 @@ static AZ_NODISCARD az_result _az_http_client_curl_code_to_result(CURLcode code)
   }
 }
 
+/**
+ * Converts the CURLcode of a finished transfer to az_result. A write error raised by the body
+ * callback of \p response is reported with the result of that callback.
+ */
+static AZ_NODISCARD az_result
+_az_http_client_curl_transfer_code_to_result(CURLcode code, az_http_response const* response)
+{
+  if (code == CURLE_WRITE_ERROR && az_failed(response->_internal.body.callback_result))
+  {
+    return response->_internal.body.callback_result;
+  }
+
+  return _az_http_client_curl_code_to_result(code);
+}
+
+/**
+ * Converts the CURLcode of a finished attempt to send \p request to az_result. An attempt aborted
+ * once its timeout elapsed is reported as canceled if the context of \p request has expired.
+ * An upload aborted by the read callback fails with the error of the body source instead.
+ */
+static AZ_NODISCARD az_result _az_http_client_curl_attempt_code_to_result(
+    CURLcode code,
+    az_http_request const* request,
+    az_http_response const* response,
+    _az_http_client_curl_upload const* upload)
+{
+  if (code == CURLE_ABORTED_BY_CALLBACK && az_failed(upload->_internal.read_result))
+  {
+    return upload->_internal.read_result;
+  }
+
+  // Otherwise, the progress callback aborted the transfer when the context expired.
+  if (code == CURLE_OPERATION_TIMEDOUT || code == CURLE_ABORTED_BY_CALLBACK)
+  {
+    return _az_http_request_get_timeout_result(request, az_platform_clock_msec());
+  }
+
+  return _az_http_client_curl_transfer_code_to_result(code, response);
+}
+
 // returning AZ error on CURL Error
 #define AZ_RETURN_IF_CURL_FAILED(exp) AZ_RETURN_IF_FAILED(_az_http_client_curl_code_to_result(exp))
 
-AZ_NODISCARD AZ_INLINE az_result _az_http_client_curl_init(CURL** out)
+#if LIBCURL_VERSION_NUM >= 0x072000 // 7.32.0
+/**
+ * @brief Aborts a transfer whose context expires while it is in flight, e.g. because
+ * az_context_cancel() was called on another thread.
+ */
+static int _az_http_client_curl_check_context(
+    void* clientp,
+    curl_off_t dltotal,
+    curl_off_t dlnow,
+    curl_off_t ultotal,
+    curl_off_t ulnow)
+{
+  (void)dltotal;
+  (void)dlnow;
+  (void)ultotal;
+  (void)ulnow;
+
+  return az_context_has_expired((az_context const*)clientp, az_platform_clock_msec()) ? 1 : 0;
+}
+#endif
+
+/**
+ * @brief Bounds the transfer of \p request by the time left before its context expires, and by
+ * its per-try timeout.
+ */
+static AZ_NODISCARD az_result
+_az_http_client_curl_setup_timeout(CURL* ref_curl, az_http_request const* request)
+{
+  int64_t timeout_msec = 0;
+  AZ_RETURN_IF_FAILED(
+      _az_http_request_get_timeout(request, az_platform_clock_msec(), &timeout_msec));
+
+  // 0 lets the transfer take as long as it needs, and the connection as long as libcurl allows.
+  long const curl_timeout_msec = (long)(timeout_msec < INT32_MAX ? timeout_msec : INT32_MAX);
+  AZ_RETURN_IF_CURL_FAILED(curl_easy_setopt(ref_curl, CURLOPT_TIMEOUT_MS, curl_timeout_msec));
+  AZ_RETURN_IF_CURL_FAILED(
+      curl_easy_setopt(ref_curl, CURLOPT_CONNECTTIMEOUT_MS, curl_timeout_msec));
+
+#if LIBCURL_VERSION_NUM >= 0x072000 // 7.32.0
+  az_context const* const context = request->_internal.context;
+  if (context != NULL)
+  {
+    AZ_RETURN_IF_CURL_FAILED(
+        curl_easy_setopt(ref_curl, CURLOPT_XFERINFOFUNCTION, _az_http_client_curl_check_context));
+    AZ_RETURN_IF_CURL_FAILED(
+        curl_easy_setopt(ref_curl, CURLOPT_XFERINFODATA, (void*)(uintptr_t)context));
+  }
+  AZ_RETURN_IF_CURL_FAILED(
+      curl_easy_setopt(ref_curl, CURLOPT_NOPROGRESS, context != NULL ? 0L : 1L));
+#endif
+
+  return AZ_OK;
+}
+
+/**
+ * @brief Sets the timings libcurl measured for the last transfer of \p request in its metrics,
+ * and adds the bytes it sent and received, if they are measured.
+ */
+static void _az_http_client_curl_record_metrics(CURL* ref_curl, az_http_request const* request)
+{
+  az_http_metrics* const metrics = _az_http_request_get_metrics(request);
+  if (metrics == NULL)
+  {
+    return;
+  }
+
+  // The info that libcurl can't give is left at 0.
+  double namelookup_sec = 0;
+  double connect_sec = 0;
+  double appconnect_sec = 0;
+  double starttransfer_sec = 0;
+  double total_sec = 0;
+#if LIBCURL_VERSION_NUM >= 0x073700 // 7.55.0
+  curl_off_t upload_size = 0;
+  curl_off_t download_size = 0;
+#else
+  double upload_size = 0;
+  double download_size = 0;
+#endif
+  long request_size = 0;
+  long header_size = 0;
+  (void)curl_easy_getinfo(ref_curl, CURLINFO_NAMELOOKUP_TIME, &namelookup_sec);
+  (void)curl_easy_getinfo(ref_curl, CURLINFO_CONNECT_TIME, &connect_sec);
+  (void)curl_easy_getinfo(ref_curl, CURLINFO_APPCONNECT_TIME, &appconnect_sec);
+  (void)curl_easy_getinfo(ref_curl, CURLINFO_STARTTRANSFER_TIME, &starttransfer_sec);
+  (void)curl_easy_getinfo(ref_curl, CURLINFO_TOTAL_TIME, &total_sec);
+#if LIBCURL_VERSION_NUM >= 0x073700 // 7.55.0
+  (void)curl_easy_getinfo(ref_curl, CURLINFO_SIZE_UPLOAD_T, &upload_size);
+  (void)curl_easy_getinfo(ref_curl, CURLINFO_SIZE_DOWNLOAD_T, &download_size);
+#else
+  (void)curl_easy_getinfo(ref_curl, CURLINFO_SIZE_UPLOAD, &upload_size);
+  (void)curl_easy_getinfo(ref_curl, CURLINFO_SIZE_DOWNLOAD, &download_size);
+#endif
+  (void)curl_easy_getinfo(ref_curl, CURLINFO_REQUEST_SIZE, &request_size);
+  (void)curl_easy_getinfo(ref_curl, CURLINFO_HEADER_SIZE, &header_size);
+
+  metrics->dns_usec = (int64_t)(namelookup_sec * 1000000);
+  metrics->connect_usec = (int64_t)(connect_sec * 1000000);
+  metrics->tls_usec = (int64_t)(appconnect_sec * 1000000);
+  metrics->time_to_first_byte_usec = (int64_t)(starttransfer_sec * 1000000);
+  metrics->transfer_usec = (int64_t)(total_sec * 1000000);
+  metrics->bytes_sent += (int64_t)request_size + (int64_t)upload_size;
+  metrics->bytes_received += (int64_t)header_size + (int64_t)download_size;
+}
+
+/**
+ * @brief Reports the time to first byte of the last transfer of \p request, if the hedging policy
+ * asks for it. The transfer started \p start_offset_msec after the request was sent.
+ */
+static void _az_http_client_curl_record_time_to_first_byte(
+    CURL* ref_curl,
+    az_http_request const* request,
+    int64_t start_offset_msec)
+{
+  int64_t* const time_to_first_byte_msec = request->_internal.time_to_first_byte_msec;
+  if (time_to_first_byte_msec == NULL)
+  {
+    return;
+  }
+
+  double starttransfer_sec = 0;
+  if (curl_easy_getinfo(ref_curl, CURLINFO_STARTTRANSFER_TIME, &starttransfer_sec) == CURLE_OK)
+  {
+    *time_to_first_byte_msec = start_offset_msec + (int64_t)(starttransfer_sec * 1000);
+  }
+}
+
+enum
 {
-  *out = curl_easy_init();
+  _az_CURL_POOL_SIZE = 16, // Max number of handles (and thus hosts) kept alive at the same time.
+  _az_CURL_POOL_HOST_BUFFER_SIZE = 128, // Max size of "scheme://host:port" for a pooled handle.
+  _az_CURL_DEFAULT_MAX_IDLE_CONNECTION_MSEC = 60 * 1000,
+  _az_CURL_DEFAULT_MAX_CONNECTION_AGE_MSEC = 5 * 60 * 1000,
+
+  // Size of the stack buffer the url and the header list of a synchronous request are laid out in.
+  _az_CURL_SCRATCH_BUFFER_SIZE = AZ_HTTP_REQUEST_URL_BUFFER_SIZE + 2 * 1024,
+
+  _az_CURL_HEDGING_POOL_SIZE = 4, // Max number of hedged requests kept ready to run concurrently.
+};
+
+/**
+ * @brief A libcurl handle kept alive between requests, together with the host it is connected to.
+ * libcurl keeps the connection cache inside the easy handle, so reusing the handle for the same
+ * host reuses the TCP connection and the TLS session.
+ */
+typedef struct
+{
+  CURL* handle;
+  int64_t created_msec;
+  int64_t last_used_msec;
+  int32_t host_length;
+  bool in_use;
+  uint8_t host[_az_CURL_POOL_HOST_BUFFER_SIZE];
+} _az_http_client_curl_pooled_handle;
+
+static az_http_client_curl_options _az_http_client_curl_pool_options = {
+  .max_idle_connection_msec = _az_CURL_DEFAULT_MAX_IDLE_CONNECTION_MSEC,
+  .max_connection_age_msec = _az_CURL_DEFAULT_MAX_CONNECTION_AGE_MSEC,
+  .http_version = AZ_HTTP_CLIENT_CURL_HTTP_VERSION_1_1,
+  .decompress_responses = false,
+};
+
+static _az_spinlock _az_http_client_curl_pool_lock = { 0 };
+static _az_http_client_curl_pooled_handle _az_http_client_curl_pool[_az_CURL_POOL_SIZE] = { 0 };
+
+/**
+ * @brief A libcurl multi handle running the two transfers of a hedged request, with their easy
+ * handles. Once an easy handle is added to a multi handle, its connections are kept in the cache of
+ * the multi handle, which is kept alive between hedged requests so that they reuse them.
+ */
+typedef struct
+{
+  CURLM* multi;
+  CURL* handles[2];
+  bool in_use;
+} _az_http_client_curl_hedging_slot;
+
+static _az_http_client_curl_hedging_slot
+    _az_http_client_curl_hedging_pool[_az_CURL_HEDGING_POOL_SIZE]
+    = { 0 };
+
+#ifdef _az_MOCK_ENABLED
+// Heap allocations made by the adapter, when the url or the headers of a request don't fit in its
+// scratch buffer. The allocations made by libcurl itself are not counted.
+static int64_t _az_http_client_curl_allocation_count = 0;
+
+static void _az_http_client_curl_count_allocation()
+{
+  _az_spinlock_enter_writer(&_az_http_client_curl_pool_lock);
+  ++_az_http_client_curl_allocation_count;
+  _az_spinlock_exit_writer(&_az_http_client_curl_pool_lock);
+}
+
+AZ_NODISCARD int64_t _az_http_client_curl_get_allocation_count()
+{
+  _az_spinlock_enter_reader(&_az_http_client_curl_pool_lock);
+  int64_t const count = _az_http_client_curl_allocation_count;
+  _az_spinlock_exit_reader(&_az_http_client_curl_pool_lock);
+
+  return count;
+}
+#endif // _az_MOCK_ENABLED
+
+AZ_NODISCARD az_http_client_curl_options az_http_client_curl_options_default()
+{
+  return (az_http_client_curl_options){
+    .max_idle_connection_msec = _az_CURL_DEFAULT_MAX_IDLE_CONNECTION_MSEC,
+    .max_connection_age_msec = _az_CURL_DEFAULT_MAX_CONNECTION_AGE_MSEC,
+    .http_version = AZ_HTTP_CLIENT_CURL_HTTP_VERSION_1_1,
+    .decompress_responses = false,
+  };
+}
+
+AZ_NODISCARD az_result az_http_client_curl_set_options(az_http_client_curl_options const* options)
+{
+  az_http_client_curl_options const new_options
+      = options == NULL ? az_http_client_curl_options_default() : *options;
+
+  if (new_options.max_idle_connection_msec < 0 || new_options.max_connection_age_msec < 0)
+  {
+    return AZ_ERROR_ARG;
+  }
+
+  switch (new_options.http_version)
+  {
+    case AZ_HTTP_CLIENT_CURL_HTTP_VERSION_1_1:
+      break;
+
+    case AZ_HTTP_CLIENT_CURL_HTTP_VERSION_2:
+    case AZ_HTTP_CLIENT_CURL_HTTP_VERSION_2_PRIOR_KNOWLEDGE:
+#if LIBCURL_VERSION_NUM >= 0x073100 // 7.49.0
+      if ((curl_version_info(CURLVERSION_NOW)->features & CURL_VERSION_HTTP2) == 0)
+      {
+        return AZ_ERROR_NOT_SUPPORTED;
+      }
+      break;
+#else
+      return AZ_ERROR_NOT_SUPPORTED;
+#endif
+
+    default:
+      return AZ_ERROR_ARG;
+  }
+
+  if (new_options.decompress_responses
+      && (curl_version_info(CURLVERSION_NOW)->features & CURL_VERSION_LIBZ) == 0)
+  {
+    return AZ_ERROR_NOT_SUPPORTED;
+  }
+
+  _az_spinlock_enter_writer(&_az_http_client_curl_pool_lock);
+  _az_http_client_curl_pool_options = new_options;
+  _az_spinlock_exit_writer(&_az_http_client_curl_pool_lock);
+
   return AZ_OK;
 }
 
-AZ_NODISCARD AZ_INLINE az_result _az_http_client_curl_done(CURL** pp)
+static void _az_http_client_curl_hedging_slot_cleanup(_az_http_client_curl_hedging_slot* ref_slot)
+{
+  for (int32_t i = 0; i < 2; ++i)
+  {
+    if (ref_slot->handles[i] != NULL)
+    {
+      curl_easy_cleanup(ref_slot->handles[i]);
+    }
+  }
+
+  if (ref_slot->multi != NULL)
+  {
+    curl_multi_cleanup(ref_slot->multi);
+  }
+
+  *ref_slot = (_az_http_client_curl_hedging_slot){ 0 };
+}
+
+void az_http_client_curl_cleanup()
+{
+  CURL* stale[_az_CURL_POOL_SIZE] = { 0 };
+
+  _az_spinlock_enter_writer(&_az_http_client_curl_pool_lock);
+  for (int32_t i = 0; i < _az_CURL_POOL_SIZE; ++i)
+  {
+    _az_http_client_curl_pooled_handle* const entry = &_az_http_client_curl_pool[i];
+    if (!entry->in_use)
+    {
+      stale[i] = entry->handle;
+      entry->handle = NULL;
+      entry->host_length = 0;
+    }
+  }
+
+  _az_http_client_curl_hedging_slot stale_hedging[_az_CURL_HEDGING_POOL_SIZE] = { 0 };
+  for (int32_t i = 0; i < _az_CURL_HEDGING_POOL_SIZE; ++i)
+  {
+    _az_http_client_curl_hedging_slot* const slot = &_az_http_client_curl_hedging_pool[i];
+    if (!slot->in_use)
+    {
+      stale_hedging[i] = *slot;
+      *slot = (_az_http_client_curl_hedging_slot){ 0 };
+    }
+  }
+  _az_spinlock_exit_writer(&_az_http_client_curl_pool_lock);
+
+  // Closing a connection may block (e.g. TLS shutdown), so it is done outside of the lock.
+  for (int32_t i = 0; i < _az_CURL_POOL_SIZE; ++i)
+  {
+    if (stale[i] != NULL)
+    {
+      curl_easy_cleanup(stale[i]);
+    }
+  }
+
+  for (int32_t i = 0; i < _az_CURL_HEDGING_POOL_SIZE; ++i)
+  {
+    _az_http_client_curl_hedging_slot_cleanup(&stale_hedging[i]);
+  }
+}
+
+/**
+ * @brief Gets the "scheme://host[:port]" part of a url, which is the key used to pool handles.
+ */
+static AZ_NODISCARD az_span _az_http_client_curl_get_pool_key(az_span url)
+{
+  int32_t const url_size = az_span_size(url);
+  uint8_t const* const url_ptr = az_span_ptr(url);
+
+  int32_t authority_start = az_span_find(url, AZ_SPAN_FROM_STR("://"));
+  authority_start = authority_start < 0 ? 0 : authority_start + 3;
+
+  int32_t authority_end = authority_start;
+  while (authority_end < url_size && url_ptr[authority_end] != '/' && url_ptr[authority_end] != '?')
+  {
+    ++authority_end;
+  }
+
+  return az_span_slice(url, 0, authority_end);
+}
+
+AZ_NODISCARD AZ_INLINE bool _az_http_client_curl_pooled_handle_is_expired(
+    _az_http_client_curl_pooled_handle const* entry,
+    az_http_client_curl_options const* options,
+    int64_t now_msec)
+{
+  return (now_msec - entry->last_used_msec) >= options->max_idle_connection_msec
+      || (options->max_connection_age_msec > 0
+          && (now_msec - entry->created_msec) >= options->max_connection_age_msec);
+}
+
+/**
+ * @brief Gets a copy of the options set with az_http_client_curl_set_options().
+ */
+static AZ_NODISCARD az_http_client_curl_options _az_http_client_curl_get_options()
+{
+  _az_spinlock_enter_reader(&_az_http_client_curl_pool_lock);
+  az_http_client_curl_options const options = _az_http_client_curl_pool_options;
+  _az_spinlock_exit_reader(&_az_http_client_curl_pool_lock);
+
+  return options;
+}
+
+/**
+ * @brief Sets the options on \p ref_curl for the HTTP version to use, to keep the connection
+ * alive between requests, and to ask for compressed responses.
+ */
+static AZ_NODISCARD az_result _az_http_client_curl_setup_connection(
+    CURL* ref_curl,
+    az_http_client_curl_options const* options)
 {
-  _az_PRECONDITION_NOT_NULL(pp);
-  _az_PRECONDITION_NOT_NULL(*pp);
+  _az_PRECONDITION_NOT_NULL(ref_curl);
+
+#if LIBCURL_VERSION_NUM >= 0x073100 // 7.49.0
+  long http_version = CURL_HTTP_VERSION_1_1;
+  switch (options->http_version)
+  {
+    case AZ_HTTP_CLIENT_CURL_HTTP_VERSION_2:
+      http_version = CURL_HTTP_VERSION_2TLS;
+      break;
+
+    case AZ_HTTP_CLIENT_CURL_HTTP_VERSION_2_PRIOR_KNOWLEDGE:
+      http_version = CURL_HTTP_VERSION_2_PRIOR_KNOWLEDGE;
+      break;
+
+    default:
+      break;
+  }
+  AZ_RETURN_IF_CURL_FAILED(curl_easy_setopt(ref_curl, CURLOPT_HTTP_VERSION, http_version));
+#endif
+
+#if LIBCURL_VERSION_NUM >= 0x071900 // 7.25.0
+  AZ_RETURN_IF_CURL_FAILED(curl_easy_setopt(ref_curl, CURLOPT_TCP_KEEPALIVE, 1L));
+#endif
+
+  if (options->decompress_responses)
+  {
+    // libcurl inflates the body before it reaches the write callback, so the size of the response
+    // buffer is checked against the inflated body, and overflows as any other response would.
+#if LIBCURL_VERSION_NUM >= 0x071506 // 7.21.6
+    AZ_RETURN_IF_CURL_FAILED(curl_easy_setopt(ref_curl, CURLOPT_ACCEPT_ENCODING, "gzip, deflate"));
+#else
+    AZ_RETURN_IF_CURL_FAILED(curl_easy_setopt(ref_curl, CURLOPT_ENCODING, "gzip, deflate"));
+#endif
+  }
+
+#if LIBCURL_VERSION_NUM >= 0x074100 // 7.65.0
+  {
+    // libcurl rounds down to seconds, make sure an idle limit under a second still closes.
+    long const max_idle_sec
+        = (long)(options->max_idle_connection_msec / _az_TIME_MILLISECONDS_PER_SECOND);
+    AZ_RETURN_IF_CURL_FAILED(
+        curl_easy_setopt(ref_curl, CURLOPT_MAXAGE_CONN, max_idle_sec > 0 ? max_idle_sec : 1L));
+  }
+#endif
+
+#if LIBCURL_VERSION_NUM >= 0x075000 // 7.80.0
+  if (options->max_connection_age_msec > 0)
+  {
+    long const max_age_sec
+        = (long)(options->max_connection_age_msec / _az_TIME_MILLISECONDS_PER_SECOND);
+    AZ_RETURN_IF_CURL_FAILED(
+        curl_easy_setopt(ref_curl, CURLOPT_MAXLIFETIME_CONN, max_age_sec > 0 ? max_age_sec : 1L));
+  }
+#endif
 
-  curl_easy_cleanup(*pp);
-  *pp = NULL;
   return AZ_OK;
 }
 
+/**
+ * @brief Gives \p curl back to the pool so the next request to the same host can reuse its
+ * connection. Temporary handles, and handles used by a request that failed at the transport level,
+ * are closed.
+ */
+static void _az_http_client_curl_release(
+    _az_http_client_curl_pooled_handle* entry,
+    CURL* curl,
+    az_result send_result)
+{
+  if (entry == NULL)
+  {
+    curl_easy_cleanup(curl);
+    return;
+  }
+
+  bool const keep = az_succeeded(send_result);
+
+  _az_spinlock_enter_writer(&_az_http_client_curl_pool_lock);
+  entry->handle = keep ? curl : NULL;
+  entry->host_length = keep ? entry->host_length : 0;
+  entry->last_used_msec = az_platform_clock_msec();
+  entry->in_use = false;
+  _az_spinlock_exit_writer(&_az_http_client_curl_pool_lock);
+
+  if (!keep)
+  {
+    curl_easy_cleanup(curl);
+  }
+}
+
+/**
+ * @brief Gets a curl handle for sending a request to \p url. An idle handle already connected to
+ * the same host is reused when available. When the host can't be pooled or all the pooled handles
+ * are busy, a temporary handle is created and \p out_entry is set to `NULL`.
+ */
+static AZ_NODISCARD az_result _az_http_client_curl_acquire(
+    az_span url,
+    _az_http_client_curl_pooled_handle** out_entry,
+    CURL** out_curl)
+{
+  _az_PRECONDITION_NOT_NULL(out_entry);
+  _az_PRECONDITION_NOT_NULL(out_curl);
+
+  az_span const key = _az_http_client_curl_get_pool_key(url);
+  int32_t const key_size = az_span_size(key);
+  int64_t const now_msec = az_platform_clock_msec();
+
+  CURL* stale[_az_CURL_POOL_SIZE] = { 0 };
+  _az_http_client_curl_pooled_handle* entry = NULL;
+  CURL* curl = NULL;
+
+  _az_spinlock_enter_writer(&_az_http_client_curl_pool_lock);
+  az_http_client_curl_options const options = _az_http_client_curl_pool_options;
+
+  if (key_size <= _az_CURL_POOL_HOST_BUFFER_SIZE)
+  {
+    _az_http_client_curl_pooled_handle* empty = NULL;
+    _az_http_client_curl_pooled_handle* least_recently_used = NULL;
+
+    for (int32_t i = 0; i < _az_CURL_POOL_SIZE; ++i)
+    {
+      _az_http_client_curl_pooled_handle* const current = &_az_http_client_curl_pool[i];
+      if (current->in_use)
+      {
+        continue;
+      }
+
+      if (current->handle != NULL
+          && _az_http_client_curl_pooled_handle_is_expired(current, &options, now_msec))
+      {
+        stale[i] = current->handle;
+        current->handle = NULL;
+        current->host_length = 0;
+      }
+
+      if (current->handle == NULL)
+      {
+        empty = empty == NULL ? current : empty;
+      }
+      else if (
+          entry == NULL && current->host_length == key_size
+          && az_span_is_content_equal(az_span_create(current->host, current->host_length), key))
+      {
+        entry = current;
+      }
+      else if (
+          least_recently_used == NULL
+          || current->last_used_msec < least_recently_used->last_used_msec)
+      {
+        least_recently_used = current;
+      }
+    }
+
+    if (entry == NULL)
+    {
+      entry = empty != NULL ? empty : least_recently_used;
+      if (entry != NULL)
+      {
+        // Connected to another host (or never connected), start from a new handle.
+        stale[entry - _az_http_client_curl_pool] = entry->handle;
+        entry->handle = NULL;
+        az_span_copy(AZ_SPAN_FROM_BUFFER(entry->host), key);
+        entry->host_length = key_size;
+        entry->created_msec = now_msec;
+      }
+    }
+
+    if (entry != NULL)
+    {
+      entry->in_use = true;
+      entry->last_used_msec = now_msec;
+      curl = entry->handle;
+    }
+  }
+
+  _az_spinlock_exit_writer(&_az_http_client_curl_pool_lock);
+
+  // Closing a connection may block (e.g. TLS shutdown), so it is done outside of the lock.
+  for (int32_t i = 0; i < _az_CURL_POOL_SIZE; ++i)
+  {
+    if (stale[i] != NULL)
+    {
+      curl_easy_cleanup(stale[i]);
+    }
+  }
+
+  if (curl != NULL)
+  {
+    // Clears the options of the previous request, but keeps the live connections and caches.
+    curl_easy_reset(curl);
+  }
+  else
+  {
+    curl = curl_easy_init();
+    if (curl == NULL)
+    {
+      if (entry != NULL)
+      {
+        _az_spinlock_enter_writer(&_az_http_client_curl_pool_lock);
+        entry->in_use = false;
+        entry->host_length = 0;
+        _az_spinlock_exit_writer(&_az_http_client_curl_pool_lock);
+      }
+      return AZ_ERROR_HTTP_PLATFORM;
+    }
+  }
+
+  *out_entry = entry;
+  *out_curl = curl;
+
+  az_result const result = _az_http_client_curl_setup_connection(curl, &options);
+  if (az_failed(result))
+  {
+    _az_http_client_curl_release(entry, curl, result);
+  }
+
+  return result;
+}
+
 /**
  * @brief writes a header key and value to a buffer as a 0-terminated string and using a separator
  * span in between. Returns error as soon as any of the write operations fails
@@ -107,11 +732,13 @@ _az_http_client_curl_slist_append(struct curl_slist** ref_list, char const* str)
   _az_PRECONDITION_NOT_NULL(ref_list);
   _az_PRECONDITION_NOT_NULL(str);
 
+  _az_http_client_curl_count_allocation();
   struct curl_slist* const new_list = curl_slist_append(*ref_list, str);
   if (new_list == NULL)
   {
     // free any previous allocates custom headers
     curl_slist_free_all(*ref_list);
+    *ref_list = NULL;
     return AZ_ERROR_HTTP_PLATFORM;
   }
 
@@ -161,46 +788,8 @@ static AZ_NODISCARD az_result _az_http_client_curl_add_header_to_curl_list(
 }
 
 /**
- * @brief Adds special header "Expect:" for libcurl to avoid sending only headers to server and wait
- * for a 100 Continue response before sending a PUT method
- *
- * see: https://github.com/curl/curl/blob/master/docs/FAQ#L1033
- * libcurl makes all POST and PUT requests (except for POST requests with a
- * very tiny request body) use the "Expect: 100-continue" header. This header
- * allows the server to deny the operation early so that libcurl can bail out
- * before having to send any data. This is useful in authentication
- * cases and others.
- *
- * However, many servers don't implement the Expect: stuff properly and if the
- * server doesn't respond (positively) within 1 second libcurl will continue
- * and send off the data anyway.
- *
- * You can disable libcurl's use of the Expect: header the same way you disable
- * any header, using -H / CURLOPT_HTTPHEADER, or by forcing it to use HTTP 1.0.
- *
- * This function is meant to be called after all headers from original request was called. It will
- * append another header and set headers for a ref_curl session
- *
- * @param ref_curl reference to an easy curl session
- * @param ref_list list of headers as curl list
- *
- * @return az_result
- */
-static AZ_NODISCARD az_result
-_az_http_client_curl_add_expect_header(CURL* ref_curl, struct curl_slist** ref_list)
-{
-  _az_PRECONDITION_NOT_NULL(ref_curl);
-  _az_PRECONDITION_NOT_NULL(ref_list);
-
-  // Append header to current custom headers list
-  AZ_RETURN_IF_FAILED(_az_http_client_curl_slist_append(ref_list, "Expect:"));
-  // Update the reference to curl custom list (in case it gets moved in memory due to appending)
-  AZ_RETURN_IF_CURL_FAILED(curl_easy_setopt(ref_curl, CURLOPT_HTTPHEADER, *ref_list));
-  return AZ_OK;
-}
-
-/**
- * @brief loop all the headers from a HTTP request and set each header into easy curl
+ * @brief loop all the headers from a HTTP request and append each header to a list allocated by
+ * libcurl
  *
  * @param request an http builder request reference
  * @param ref_headers list of headers in curl specific list
@@ -223,28 +812,99 @@ _az_http_client_curl_build_headers(az_http_request const* request, struct curl_s
 }
 
 /**
- * @brief writes a url request adds a zero to make it a c-string. Return error if any of the write
- * operations fails.
+ * @brief Lays out the headers of \p request as a curl list in \p ref_scratch, the nodes first and
+ * then the "key:value" strings. libcurl only reads the list, which must stay valid until the
+ * transfer is done.
  *
- * @param writable_buffer a pre-allocated buffer to write http request
- * @param url_from_request a url that is not zero terminated
- * @return az_result
+ * @return `false`, leaving \p ref_scratch untouched, if the list doesn't fit in it.
  */
-static AZ_NODISCARD az_result
-_az_http_client_curl_append_url(az_span writable_buffer, az_span url_from_request)
+static AZ_NODISCARD bool _az_http_client_curl_layout_headers(
+    az_http_request const* request,
+    int32_t nodes_count,
+    az_span* ref_scratch,
+    struct curl_slist** out_list)
 {
-  int32_t length;
-  AZ_RETURN_IF_FAILED(_az_span_url_encode(writable_buffer, url_from_request, &length));
-  az_span remainder = az_span_slice_to_end(writable_buffer, length);
-  az_span_copy_u8(remainder, 0);
+  int32_t const headers_count = az_http_request_headers_count(request);
+  az_pair const* const headers = (az_pair const*)az_span_ptr(request->_internal.headers);
+
+  // The nodes are read through a pointer, so align them as a pointer.
+  int32_t const misalignment = (int32_t)((uintptr_t)az_span_ptr(*ref_scratch) % sizeof(void*));
+  int32_t const padding = misalignment == 0 ? 0 : (int32_t)sizeof(void*) - misalignment;
+  int64_t required_size = padding + (int64_t)nodes_count * (int64_t)sizeof(struct curl_slist);
+  for (int32_t i = 0; i < headers_count; ++i)
+  {
+    required_size += az_span_size(headers[i].key) + az_span_size(headers[i].value) + 2;
+  }
+  if (required_size > az_span_size(*ref_scratch))
+  {
+    return false;
+  }
 
-  return AZ_OK;
+  az_span scratch = az_span_slice_to_end(*ref_scratch, padding);
+  struct curl_slist* const nodes = (struct curl_slist*)az_span_ptr(scratch);
+  scratch = az_span_slice_to_end(scratch, nodes_count * (int32_t)sizeof(struct curl_slist));
+
+  for (int32_t i = 0; i < nodes_count; ++i)
+  {
+    if (i < headers_count)
+    {
+      nodes[i].data = (char*)az_span_ptr(scratch);
+      scratch = az_span_copy(scratch, headers[i].key);
+      scratch = az_span_copy_u8(scratch, ':');
+      scratch = az_span_copy(scratch, headers[i].value);
+      scratch = az_span_copy_u8(scratch, 0);
+    }
+    else
+    {
+      nodes[i].data = (char*)(uintptr_t)"Expect:";
+    }
+    nodes[i].next = i + 1 < nodes_count ? &nodes[i + 1] : NULL;
+  }
+
+  *ref_scratch = scratch;
+  *out_list = nodes;
+  return true;
 }
 
 /**
- * @brief This is the function that curl will use to write response into a user provider span
- * Function receives the size of the response and must return this same number, otherwise it is
- * consider that function failed
+ * @brief Frees the header list of a request once its transfer is done, if it was allocated by
+ * libcurl.
+ */
+static void _az_http_client_curl_headers_free(_az_http_client_curl_headers* ref_headers)
+{
+  if (ref_headers->_internal.is_allocated)
+  {
+    curl_slist_free_all((struct curl_slist*)ref_headers->_internal.list);
+  }
+
+  ref_headers->_internal.list = NULL;
+  ref_headers->_internal.is_allocated = false;
+}
+
+/**
+ * @brief writes a url request adds a zero to make it a c-string. Return error if any of the write
+ * operations fails.
+ *
+ * @param writable_buffer a pre-allocated buffer to write http request
+ * @param url_from_request a url that is not zero terminated
+ * @return az_result
+ */
+static AZ_NODISCARD az_result
+_az_http_client_curl_append_url(az_span writable_buffer, az_span url_from_request)
+{
+  // The url is already encoded by the request builder. Encoding it as a whole would also escape
+  // the scheme and path separators.
+  AZ_RETURN_IF_NOT_ENOUGH_SIZE(writable_buffer, az_span_size(url_from_request) + 1);
+  az_span remainder = az_span_copy(writable_buffer, url_from_request);
+  az_span_copy_u8(remainder, 0);
+
+  return AZ_OK;
+}
+
+/**
+ * @brief This is the function that curl will use to write response into a user provider span
+ * Function receives the size of the response and must return this same number, otherwise it is
+ * consider that function failed
  *
  * @param contents response data from Curl response
  * @param size size of the curl response data
@@ -276,175 +936,244 @@ static size_t _az_http_client_curl_write_to_span(
 }
 
 /**
- * handles GET request
+ * handles DELETE request
  */
-static AZ_NODISCARD az_result _az_http_client_curl_send_get_request(CURL* ref_curl)
+static AZ_NODISCARD az_result _az_http_client_curl_setup_delete_request(CURL* ref_curl)
 {
   _az_PRECONDITION_NOT_NULL(ref_curl);
 
-  // send
-  AZ_RETURN_IF_CURL_FAILED(curl_easy_perform(ref_curl));
+  AZ_RETURN_IF_CURL_FAILED(curl_easy_setopt(ref_curl, CURLOPT_CUSTOMREQUEST, "DELETE"));
 
   return AZ_OK;
 }
 
 /**
- * handles DELETE request
+ * @brief UPLOAD requests are done via callbacks.  The callback is passed in a buffer address which
+ * is filled with the next part of the request body. The callback will occur until the callback
+ * returns 0 (no more data). The callback will return CURL_READFUNC_ABORT should an error occur.
+ * This in turn terminates the request.
+ *
+ * @param dst Destination address buffer
+ * @param size Size of an item
+ * @param nmemb Number of items to copy
+ * @param userdata Source data to upload
+ *                 Passed as the pointer to an _az_http_client_curl_upload
+ * @return size_t
  */
-static AZ_NODISCARD az_result _az_http_client_curl_send_delete_request(CURL* ref_curl)
+static size_t _az_http_client_curl_upload_read_callback(
+    char* dst,
+    size_t size,
+    size_t nmemb,
+    void* userdata)
 {
-  _az_PRECONDITION_NOT_NULL(ref_curl);
+  _az_http_client_curl_upload* upload = (_az_http_client_curl_upload*)userdata;
 
-  AZ_RETURN_IF_FAILED(_az_http_client_curl_code_to_result(
-      curl_easy_setopt(ref_curl, CURLOPT_CUSTOMREQUEST, "DELETE")));
+  // Calculate the size of the *dst buffer
+  size_t const dst_buffer_size = nmemb * size;
+
+  // Terminate the upload if the destination buffer is too small
+  if (dst_buffer_size < 1)
+  {
+    upload->_internal.read_result = AZ_ERROR_INSUFFICIENT_SPAN_SIZE;
+    return CURL_READFUNC_ABORT;
+  }
 
-  AZ_RETURN_IF_FAILED(_az_http_client_curl_code_to_result(curl_easy_perform(ref_curl)));
+  az_span const destination = az_span_create(
+      (uint8_t*)dst, dst_buffer_size > INT32_MAX ? INT32_MAX : (int32_t)dst_buffer_size);
 
-  return AZ_OK;
+  int32_t size_of_copy = 0;
+  upload->_internal.read_result = az_http_body_source_read(
+      &upload->_internal.source, upload->_internal.offset, destination, &size_of_copy);
+  if (az_failed(upload->_internal.read_result))
+  {
+    return CURL_READFUNC_ABORT;
+  }
+
+  // 0 once the whole body was read, which ends the upload.
+  upload->_internal.offset += size_of_copy;
+  return (size_t)size_of_copy;
 }
 
 /**
- * handles POST request. It handles seting up a body for request
+ * @brief Called by curl when it needs to send the body again from an earlier position, e.g. when
+ * it retries the request on a new connection. Only absolute positions are requested.
  */
-static AZ_NODISCARD az_result
-_az_http_client_curl_send_post_request(CURL* ref_curl, az_http_request const* request)
+static int _az_http_client_curl_upload_seek_callback(void* userdata, curl_off_t offset, int origin)
 {
-  _az_PRECONDITION_NOT_NULL(ref_curl);
-  _az_PRECONDITION_NOT_NULL(request);
-
-  // Method
-  az_span request_body = { 0 };
-  AZ_RETURN_IF_FAILED(az_http_request_get_body(request, &request_body));
-  az_span body = { 0 };
-  int32_t const required_length = az_span_size(request_body) + az_span_size(AZ_SPAN_FROM_STR("\0"));
-
-  AZ_RETURN_IF_FAILED(_az_span_malloc(required_length, &body));
-
-  char* b = (char*)az_span_ptr(body);
-  az_span_to_str(b, required_length, request_body);
+  _az_http_client_curl_upload* upload = (_az_http_client_curl_upload*)userdata;
 
-  az_result res_code
-      = _az_http_client_curl_code_to_result(curl_easy_setopt(ref_curl, CURLOPT_POSTFIELDS, b));
-  if (az_succeeded(res_code))
+  if (origin != SEEK_SET || offset < 0
+      || offset > az_http_body_source_get_length(&upload->_internal.source))
   {
-    res_code = _az_http_client_curl_code_to_result(curl_easy_perform(ref_curl));
+    return CURL_SEEKFUNC_CANTSEEK;
   }
 
-  _az_span_free(&body);
-  AZ_RETURN_IF_FAILED(res_code);
-
-  return AZ_OK;
+  upload->_internal.offset = (int64_t)offset;
+  return CURL_SEEKFUNC_OK;
 }
 
 /**
- * @brief UPLOAD requests are done via callbacks.  The callback is passed in a buffer address which
- * is filled with the userdata content. The callback will occur until the callback returns 0 (no
- * more data). The callback will return CURL_READFUNC_ABORT should an error occur.  This in turn
- * terminates the POST request.
+ * @brief Sets up \p ref_curl to read the body of \p request with the upload callbacks.
  *
- * @param dst Destination address buffer
- * @param size Size of an item
- * @param nmemb Number of items to copy
- * @param userdata Source data to upload
- *                 Passed as the pointer to an az_span
- * @return int
+ * @param ref_upload the state of the upload, read by the callbacks. It must stay valid until the
+ * transfer is done.
  */
-static int32_t _az_http_client_curl_upload_read_callback(
-    void* dst,
-    size_t size,
-    size_t nmemb,
-    void* userdata)
+static AZ_NODISCARD az_result _az_http_client_curl_setup_upload_body(
+    CURL* ref_curl,
+    az_http_request const* request,
+    _az_http_client_curl_upload* ref_upload)
 {
+  // Each attempt sends the body from its start.
+  AZ_RETURN_IF_FAILED(az_http_request_get_body_source(request, &ref_upload->_internal.source));
+  ref_upload->_internal.offset = 0;
 
-  az_span* upload_content = (az_span*)userdata;
+  AZ_RETURN_IF_CURL_FAILED(
+      curl_easy_setopt(ref_curl, CURLOPT_READFUNCTION, _az_http_client_curl_upload_read_callback));
 
-  // Calculate the size of the *dst buffer
-  int32_t dst_buffer_size = (int32_t)(nmemb * size);
+  // Setup the request to pass the upload state into the read callback
+  AZ_RETURN_IF_CURL_FAILED(curl_easy_setopt(ref_curl, CURLOPT_READDATA, (void*)ref_upload));
 
-  // Terminate the upload if the destination buffer is too small
-  if (dst_buffer_size < 1)
-    return CURL_READFUNC_ABORT;
+  AZ_RETURN_IF_CURL_FAILED(
+      curl_easy_setopt(ref_curl, CURLOPT_SEEKFUNCTION, _az_http_client_curl_upload_seek_callback));
+  AZ_RETURN_IF_CURL_FAILED(curl_easy_setopt(ref_curl, CURLOPT_SEEKDATA, (void*)ref_upload));
+
+  return AZ_OK;
+}
 
-  int32_t userdata_length = az_span_size(*upload_content);
+/**
+ * handles POST request. It handles seting up a body for request
+ */
+static AZ_NODISCARD az_result _az_http_client_curl_setup_post_request(
+    CURL* ref_curl,
+    az_http_request const* request,
+    _az_http_client_curl_upload* ref_upload)
+{
+  _az_PRECONDITION_NOT_NULL(ref_curl);
+  _az_PRECONDITION_NOT_NULL(request);
+  _az_PRECONDITION_NOT_NULL(ref_upload);
 
-  // Return if nothing to copy
-  if (userdata_length < 1)
-    return CURLE_OK; // Success, all bytes copied
+  az_span request_body = { 0 };
+  AZ_RETURN_IF_FAILED(az_http_request_get_body(request, &request_body));
 
-  // Calculate how many bytes can we copy from customer data (upload_content)
-  // Curl provides dst buffer with a max size of dest_buffer_size, if customer data size is less
-  // than the max, we can copy all customer data directly and have it uploaded at once.
-  // If not, we can only copy the max dst size from customer data and wait for another upload to
-  // copy a next chunk of data
-  int32_t size_of_copy = (userdata_length < dst_buffer_size) ? userdata_length : dst_buffer_size;
+  if (az_span_size(request_body) == 0)
+  {
+    az_http_body_source source = { 0 };
+    AZ_RETURN_IF_FAILED(az_http_request_get_body_source(request, &source));
+    if (az_http_body_source_get_length(&source) > 0)
+    {
+      // The body is read from a body source as it is sent.
+      AZ_RETURN_IF_CURL_FAILED(curl_easy_setopt(ref_curl, CURLOPT_POST, 1L));
+      AZ_RETURN_IF_CURL_FAILED(curl_easy_setopt(
+          ref_curl,
+          CURLOPT_POSTFIELDSIZE_LARGE,
+          (curl_off_t)az_http_body_source_get_length(&source)));
+      return _az_http_client_curl_setup_upload_body(ref_curl, request, ref_upload);
+    }
+  }
 
-  memcpy(dst, az_span_ptr(*upload_content), (size_t)size_of_copy);
+  // The body outlives the transfer, so libcurl can send it from the request without a copy. Its
+  // size is set first so it doesn't need to be 0-terminated.
+  AZ_RETURN_IF_CURL_FAILED(curl_easy_setopt(
+      ref_curl, CURLOPT_POSTFIELDSIZE_LARGE, (curl_off_t)az_span_size(request_body)));
 
-  // Update the userdata span. If we already copied all content, slice will set upload_content with
-  // 0 length
-  *upload_content = az_span_slice_to_end(*upload_content, size_of_copy);
+  char const* const body
+      = az_span_size(request_body) > 0 ? (char const*)az_span_ptr(request_body) : "";
+  AZ_RETURN_IF_CURL_FAILED(curl_easy_setopt(ref_curl, CURLOPT_POSTFIELDS, body));
 
-  return size_of_copy;
+  return AZ_OK;
 }
 
 /**
- * Perform an UPLOAD or PUT request.
+ * Set up an UPLOAD or PUT request.
  * As of CURL 7.12.1 CURLOPT_PUT is deprecated.  PUT requests should be made using CURLOPT_UPLOAD
+ *
+ * @param ref_upload the state of the upload, read by the read callback. It must stay valid until
+ * the transfer is done.
  */
-static AZ_NODISCARD az_result
-_az_http_client_curl_send_upload_request(CURL* ref_curl, az_http_request const* request)
+static AZ_NODISCARD az_result _az_http_client_curl_setup_upload_request(
+    CURL* ref_curl,
+    az_http_request const* request,
+    _az_http_client_curl_upload* ref_upload)
 {
   _az_PRECONDITION_NOT_NULL(ref_curl);
   _az_PRECONDITION_NOT_NULL(request);
-
-  az_span body = { 0 };
-  AZ_RETURN_IF_FAILED(az_http_request_get_body(request, &body));
+  _az_PRECONDITION_NOT_NULL(ref_upload);
 
   AZ_RETURN_IF_CURL_FAILED(curl_easy_setopt(ref_curl, CURLOPT_UPLOAD, 1L));
-  AZ_RETURN_IF_CURL_FAILED(
-      curl_easy_setopt(ref_curl, CURLOPT_READFUNCTION, _az_http_client_curl_upload_read_callback));
-
-  // Setup the request to pass body into the read callback
-  // The read callback receives the address of body
-  AZ_RETURN_IF_CURL_FAILED(curl_easy_setopt(ref_curl, CURLOPT_READDATA, &body));
+  AZ_RETURN_IF_FAILED(_az_http_client_curl_setup_upload_body(ref_curl, request, ref_upload));
 
   // Set the size of the upload
-  AZ_RETURN_IF_CURL_FAILED(
-      curl_easy_setopt(ref_curl, CURLOPT_INFILESIZE, (curl_off_t)az_span_size(body)));
-
-  // Do the curl work
-  // curl_easy_perform does not return until the CURLOPT_READFUNCTION callbacks complete.
-  AZ_RETURN_IF_CURL_FAILED(curl_easy_perform(ref_curl));
+  AZ_RETURN_IF_CURL_FAILED(curl_easy_setopt(
+      ref_curl,
+      CURLOPT_INFILESIZE_LARGE,
+      (curl_off_t)az_http_body_source_get_length(&ref_upload->_internal.source)));
 
   return AZ_OK;
 }
 
 /**
- * @brief finds out if there are headers in the request and add them to curl header list
+ * @brief Sets the headers of \p request on \p ref_curl. The header list is laid out in
+ * \p ref_scratch when it fits, otherwise it is allocated by libcurl.
+ *
+ * The special header "Expect:" can be added for libcurl to avoid sending only headers to server and
+ * wait for a 100 Continue response before sending a PUT or POST body.
+ *
+ * see: https://github.com/curl/curl/blob/master/docs/FAQ#L1033
+ * libcurl makes all POST and PUT requests (except for POST requests with a
+ * very tiny request body) use the "Expect: 100-continue" header. This header
+ * allows the server to deny the operation early so that libcurl can bail out
+ * before having to send any data. This is useful in authentication
+ * cases and others.
+ *
+ * However, many servers don't implement the Expect: stuff properly and if the
+ * server doesn't respond (positively) within 1 second libcurl will continue
+ * and send off the data anyway.
+ *
+ * You can disable libcurl's use of the Expect: header the same way you disable
+ * any header, using -H / CURLOPT_HTTPHEADER, or by forcing it to use HTTP 1.0.
  *
  * @param ref_curl curl specific structure to send a request
- * @param ref_list curl headers list
  * @param request an http request
+ * @param add_expect whether to add the "Expect:" header
+ * @param ref_scratch buffer the list is laid out in. It is advanced past the list.
+ * @param ref_headers the header list. It must be freed once the transfer is done, even on failure.
  * @return az_result
  */
 static AZ_NODISCARD az_result _az_http_client_curl_setup_headers(
     CURL* ref_curl,
-    struct curl_slist** ref_list,
-    az_http_request const* request)
+    az_http_request const* request,
+    bool add_expect,
+    az_span* ref_scratch,
+    _az_http_client_curl_headers* ref_headers)
 {
   _az_PRECONDITION_NOT_NULL(ref_curl);
   _az_PRECONDITION_NOT_NULL(request);
+  _az_PRECONDITION_NOT_NULL(ref_scratch);
+  _az_PRECONDITION_NOT_NULL(ref_headers);
 
-  if (az_http_request_headers_count(request) == 0)
+  int32_t const nodes_count = az_http_request_headers_count(request) + (add_expect ? 1 : 0);
+  if (nodes_count == 0)
   {
     // no headers, no need to set it up
     return AZ_OK;
   }
 
-  // build headers into a slist as curl is expecting
-  AZ_RETURN_IF_FAILED(_az_http_client_curl_build_headers(request, ref_list));
+  struct curl_slist* list = NULL;
+  if (!_az_http_client_curl_layout_headers(request, nodes_count, ref_scratch, &list))
+  {
+    ref_headers->_internal.is_allocated = true;
+    az_result result = _az_http_client_curl_build_headers(request, &list);
+    if (az_succeeded(result) && add_expect)
+    {
+      result = _az_http_client_curl_slist_append(&list, "Expect:");
+    }
+    ref_headers->_internal.list = list;
+    AZ_RETURN_IF_FAILED(result);
+  }
+  ref_headers->_internal.list = list;
+
   // set all headers from slist
-  AZ_RETURN_IF_CURL_FAILED(curl_easy_setopt(ref_curl, CURLOPT_HTTPHEADER, *ref_list));
+  AZ_RETURN_IF_CURL_FAILED(curl_easy_setopt(ref_curl, CURLOPT_HTTPHEADER, list));
 
   return AZ_OK;
 }
@@ -457,7 +1186,7 @@ static AZ_NODISCARD az_result _az_http_client_curl_setup_headers(
  * @return az_result
  */
 static AZ_NODISCARD az_result
-_az_http_client_curl_setup_url(CURL* ref_curl, az_http_request const* request)
+_az_http_client_curl_setup_url(CURL* ref_curl, az_http_request const* request, az_span scratch)
 {
   _az_PRECONDITION_NOT_NULL(ref_curl);
   _az_PRECONDITION_NOT_NULL(request);
@@ -465,13 +1194,15 @@ _az_http_client_curl_setup_url(CURL* ref_curl, az_http_request const* request)
   az_span request_url = { 0 };
   // get request_url. It will have the size of what it has written in it only
   AZ_RETURN_IF_FAILED(az_http_request_get_url(request, &request_url));
-  int32_t request_url_size = _az_span_url_encode_calc_length(request_url);
-
-  az_span writable_buffer;
+  int32_t request_url_size = az_span_size(request_url);
+
+  // Add 1 for 0-terminated str. libcurl copies the url, so the scratch buffer can be used when it
+  // is large enough.
+  int32_t const url_final_size = request_url_size + 1;
+  bool const is_allocated = az_span_size(scratch) < url_final_size;
+  az_span writable_buffer = az_span_slice(scratch, 0, is_allocated ? 0 : url_final_size);
+  if (is_allocated)
   {
-    // Add 1 for 0-terminated str
-    int32_t const url_final_size = request_url_size + 1;
-
     // allocate buffer to add \0
     AZ_RETURN_IF_FAILED(_az_span_malloc(url_final_size, &writable_buffer));
   }
@@ -486,9 +1217,12 @@ _az_http_client_curl_setup_url(CURL* ref_curl, az_http_request const* request)
     result = _az_http_client_curl_code_to_result(curl_easy_setopt(ref_curl, CURLOPT_URL, buffer));
   }
 
-  // free used buffer before anything else
+  // clear used buffer before anything else
   memset(az_span_ptr(writable_buffer), 0, (size_t)az_span_size(writable_buffer));
-  _az_span_free(&writable_buffer);
+  if (is_allocated)
+  {
+    _az_span_free(&writable_buffer);
+  }
 
   return result;
 }
@@ -519,6 +1253,73 @@ _az_http_client_curl_setup_response_redirect(CURL* ref_curl, az_http_response* r
   return AZ_OK;
 }
 
+/**
+ * @brief sets up \p ref_curl with everything needed to send \p request and to write the response
+ * into \p ref_response, without sending it.
+ *
+ * @param ref_curl curl specific structure used to send an http request
+ * @param request http builder with specific data to build an http request
+ * @param ref_response pre-allocated buffer where to write http response
+ * @param scratch buffer where the url and the header list are laid out, to avoid allocating them.
+ * It must stay valid until the transfer is done.
+ * @param ref_headers curl headers list. It must be freed by the caller once the transfer is done,
+ * even on failure.
+ * @param ref_upload holds the state of the body upload for a PUT or POST request. It must stay
+ * valid until the transfer is done.
+ *
+ * @return AZ_OK if \p ref_curl is ready to perform the request
+ */
+static AZ_NODISCARD az_result _az_http_client_curl_setup_request(
+    CURL* ref_curl,
+    az_http_request const* request,
+    az_http_response* ref_response,
+    az_span scratch,
+    _az_http_client_curl_headers* ref_headers,
+    _az_http_client_curl_upload* ref_upload)
+{
+  _az_PRECONDITION_NOT_NULL(ref_curl);
+  _az_PRECONDITION_NOT_NULL(request);
+  _az_PRECONDITION_NOT_NULL(ref_headers);
+  _az_PRECONDITION_NOT_NULL(ref_upload);
+
+  // Only the read callback of an upload sets an error, once the attempt is done.
+  ref_upload->_internal.read_result = AZ_OK;
+
+  az_http_method method;
+  AZ_RETURN_IF_FAILED(az_http_request_get_method(request, &method));
+
+  bool const is_post = az_span_is_content_equal(method, az_http_method_post());
+  bool const is_put = az_span_is_content_equal(method, az_http_method_put());
+
+  AZ_RETURN_IF_FAILED(_az_http_client_curl_setup_headers(
+      ref_curl, request, is_post || is_put, &scratch, ref_headers));
+
+  AZ_RETURN_IF_FAILED(_az_http_client_curl_setup_url(ref_curl, request, scratch));
+
+  AZ_RETURN_IF_FAILED(_az_http_client_curl_setup_response_redirect(ref_curl, ref_response));
+
+  if (az_span_is_content_equal(method, az_http_method_get()))
+  {
+    return AZ_OK;
+  }
+  else if (az_span_is_content_equal(method, az_http_method_delete()))
+  {
+    return _az_http_client_curl_setup_delete_request(ref_curl);
+  }
+  else if (is_post)
+  {
+    return _az_http_client_curl_setup_post_request(ref_curl, request, ref_upload);
+  }
+  else if (is_put)
+  {
+    // As of CURL 7.12.1 CURLOPT_PUT is deprecated.  PUT requests should be made using
+    // CURLOPT_UPLOAD
+    return _az_http_client_curl_setup_upload_request(ref_curl, request, ref_upload);
+  }
+
+  return AZ_ERROR_HTTP_INVALID_METHOD_VERB;
+}
+
 /**
  * @brief use this method to group all the actions that we do with CURL so we can clean it after it
  * no matter is there is an error at any step.
@@ -537,46 +1338,668 @@ static AZ_NODISCARD az_result _az_http_client_curl_send_request_impl_process(
   _az_PRECONDITION_NOT_NULL(ref_curl);
   _az_PRECONDITION_NOT_NULL(request);
 
-  az_result result = AZ_ERROR_ARG;
+  // The transfer is done before returning, so the url and the header list are laid out on the
+  // stack instead of being allocated.
+  uint8_t scratch[_az_CURL_SCRATCH_BUFFER_SIZE];
+  _az_http_client_curl_headers headers = { 0 };
+  _az_http_client_curl_upload upload = { 0 };
 
-  struct curl_slist* list = NULL;
-  AZ_RETURN_IF_FAILED(_az_http_client_curl_setup_headers(ref_curl, &list, request));
+  az_result result = _az_http_client_curl_setup_request(
+      ref_curl, request, ref_response, AZ_SPAN_FROM_BUFFER(scratch), &headers, &upload);
 
-  AZ_RETURN_IF_FAILED(_az_http_client_curl_setup_url(ref_curl, request));
+  if (az_succeeded(result))
+  {
+    result = _az_http_client_curl_setup_timeout(ref_curl, request);
+  }
 
-  AZ_RETURN_IF_FAILED(_az_http_client_curl_setup_response_redirect(ref_curl, ref_response));
+  if (az_succeeded(result))
+  {
+    // curl_easy_perform does not return until the transfer, including any CURLOPT_READFUNCTION
+    // callback, completes.
+    result = _az_http_client_curl_attempt_code_to_result(
+        curl_easy_perform(ref_curl), request, ref_response, &upload);
+    _az_http_client_curl_record_metrics(ref_curl, request);
+    _az_http_client_curl_record_time_to_first_byte(ref_curl, request, 0);
+  }
 
-  az_http_method method;
-  AZ_RETURN_IF_FAILED(az_http_request_get_method(request, &method));
+  // Clean custom headers previously appended
+  _az_http_client_curl_headers_free(&headers);
 
-  if (az_span_is_content_equal(method, az_http_method_get()))
+  return result;
+}
+
+/**
+ * @brief Gets the asynchronous operation \p request is bound to, if any.
+ */
+static AZ_NODISCARD az_http_client_curl_async_operation*
+_az_http_client_curl_get_async_operation(az_http_request const* request)
+{
+  // The async state is the first member of the operation.
+  return (az_http_client_curl_async_operation*)_az_http_request_get_async_state(request);
+}
+
+/**
+ * @brief Releases the curl resources of an operation whose transfer is done, or that failed to
+ * start.
+ */
+static void _az_http_client_curl_async_end_transfer(az_http_client_curl_async_operation* operation)
+{
+  CURL* const curl = (CURL*)operation->_internal.curl;
+  if (curl != NULL && operation->_internal.is_transferring)
   {
-    result = _az_http_client_curl_send_get_request(ref_curl);
+    (void)curl_multi_remove_handle((CURLM*)operation->_internal.async->_internal.multi, curl);
   }
-  else if (az_span_is_content_equal(method, az_http_method_delete()))
+  operation->_internal.is_transferring = false;
+
+  _az_http_client_curl_headers_free(&operation->_internal.headers);
+}
+
+/**
+ * @brief Removes \p operation from the in-flight operations of its driver and tells the caller.
+ */
+static void _az_http_client_curl_async_finish(
+    az_http_client_curl_async_operation* operation,
+    az_result result)
+{
+  az_http_client_curl_async* const async = operation->_internal.async;
+
+  _az_http_client_curl_async_end_transfer(operation);
+
+  az_http_client_curl_async_operation** next = &async->_internal.operations;
+  while (*next != NULL && *next != operation)
+  {
+    next = &(*next)->_internal.next;
+  }
+  if (*next != NULL)
   {
-    result = _az_http_client_curl_send_delete_request(ref_curl);
+    *next = operation->_internal.next;
+    --async->_internal.operations_count;
   }
-  else if (az_span_is_content_equal(method, az_http_method_post()))
+  operation->_internal.next = NULL;
+  operation->_internal.is_in_flight = false;
+
+  if (operation->_internal.curl != NULL)
   {
-    AZ_RETURN_IF_FAILED(_az_http_client_curl_add_expect_header(ref_curl, &list));
-    result = _az_http_client_curl_send_post_request(ref_curl, request);
+    curl_easy_cleanup((CURL*)operation->_internal.curl);
+    operation->_internal.curl = NULL;
   }
-  else if (az_span_is_content_equal(method, az_http_method_put()))
+
+  if (operation->_internal.callback != NULL)
   {
-    // As of CURL 7.12.1 CURLOPT_PUT is deprecated.  PUT requests should be made using
-    // CURLOPT_UPLOAD
-    AZ_RETURN_IF_FAILED(_az_http_client_curl_add_expect_header(ref_curl, &list));
-    result = _az_http_client_curl_send_upload_request(ref_curl, request);
+    operation->_internal.callback(operation, result, operation->_internal.user_context);
+  }
+}
+
+/**
+ * @brief Gives the result of a transfer to the pipeline, which either completes the operation or
+ * sends the request again.
+ */
+static void _az_http_client_curl_async_complete(
+    az_http_client_curl_async_operation* operation,
+    az_result result)
+{
+  _az_http_client_curl_async_end_transfer(operation);
+
+  result = _az_http_async_state_complete(
+      &operation->_internal.state, result, operation->_internal.response);
+
+  if (result != AZ_HTTP_REQUEST_PENDING)
+  {
+    _az_http_client_curl_async_finish(operation, result);
+  }
+}
+
+/**
+ * @brief Starts the transfer of an operation once it is due.
+ */
+static AZ_NODISCARD az_result
+_az_http_client_curl_async_start_transfer(az_http_client_curl_async_operation* operation)
+{
+  // The attempt is timed from when it is sent, after its delay.
+  AZ_RETURN_IF_FAILED(_az_http_client_curl_setup_timeout(
+      (CURL*)operation->_internal.curl, &operation->_internal.state._internal.request));
+
+  CURLMcode const code = curl_multi_add_handle(
+      (CURLM*)operation->_internal.async->_internal.multi, (CURL*)operation->_internal.curl);
+  if (code != CURLM_OK)
+  {
+    return AZ_ERROR_HTTP_PLATFORM;
+  }
+
+  operation->_internal.is_transferring = true;
+  return AZ_OK;
+}
+
+/**
+ * @brief Sets up the transfer of \p request for \p operation and hands it to the driver. The
+ * transfer starts on the next call to az_http_client_curl_async_perform() after the delay set by
+ * the retry policy, if any.
+ */
+static AZ_NODISCARD az_result _az_http_client_curl_async_submit(
+    az_http_client_curl_async_operation* operation,
+    az_http_request const* request,
+    az_http_response* ref_response)
+{
+  az_http_client_curl_async* const async = operation->_internal.async;
+
+  if (az_context_has_expired(request->_internal.context, az_platform_clock_msec()))
+  {
+    return AZ_ERROR_CANCELED;
+  }
+
+  CURL* curl = (CURL*)operation->_internal.curl;
+  if (curl == NULL)
+  {
+    curl = curl_easy_init();
+    if (curl == NULL)
+    {
+      return AZ_ERROR_HTTP_PLATFORM;
+    }
+    operation->_internal.curl = curl;
   }
   else
   {
-    return AZ_ERROR_HTTP_INVALID_METHOD_VERB;
+    // Sending again after a retry, start from a clean handle.
+    curl_easy_reset(curl);
   }
 
-  // Clean custom headers previously appended
-  curl_slist_free_all(list);
+  az_http_client_curl_options const options = _az_http_client_curl_get_options();
+
+  // The url and the header list are laid out in the part of the operation buffer that the copy of
+  // the request doesn't use.
+  az_result result = _az_http_client_curl_setup_request(
+      curl,
+      request,
+      ref_response,
+      _az_http_async_state_get_scratch(&operation->_internal.state, request),
+      &operation->_internal.headers,
+      &operation->_internal.upload);
+
+  if (az_succeeded(result))
+  {
+    result = _az_http_client_curl_setup_connection(curl, &options);
+  }
+
+#if LIBCURL_VERSION_NUM >= 0x072B00 // 7.43.0
+  if (az_succeeded(result) && options.http_version != AZ_HTTP_CLIENT_CURL_HTTP_VERSION_1_1)
+  {
+    // Wait for a connection to the host that can be multiplexed, instead of opening a new one.
+    result = _az_http_client_curl_code_to_result(curl_easy_setopt(curl, CURLOPT_PIPEWAIT, 1L));
+  }
+#endif
+
+  if (az_succeeded(result))
+  {
+    result = _az_http_client_curl_code_to_result(
+        curl_easy_setopt(curl, CURLOPT_PRIVATE, (void*)operation));
+  }
+
+  if (az_failed(result))
+  {
+    _az_http_client_curl_async_end_transfer(operation);
+    return result;
+  }
+
+  operation->_internal.response = ref_response;
+
+  if (!operation->_internal.is_in_flight)
+  {
+    operation->_internal.is_in_flight = true;
+    operation->_internal.next = async->_internal.operations;
+    async->_internal.operations = operation;
+    ++async->_internal.operations_count;
+  }
+
+  return AZ_HTTP_REQUEST_PENDING;
+}
+
+AZ_NODISCARD az_result az_http_client_curl_async_init(az_http_client_curl_async* out_async)
+{
+  _az_PRECONDITION_NOT_NULL(out_async);
+
+  CURLM* const multi = curl_multi_init();
+  if (multi == NULL)
+  {
+    return AZ_ERROR_HTTP_PLATFORM;
+  }
+
+#if LIBCURL_VERSION_NUM >= 0x072B00 // 7.43.0
+  // Let concurrent HTTP/2 requests to the same host share a connection.
+  if (curl_multi_setopt(multi, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX) != CURLM_OK)
+  {
+    (void)curl_multi_cleanup(multi);
+    return AZ_ERROR_HTTP_PLATFORM;
+  }
+#endif
+
+  *out_async = (az_http_client_curl_async){
+    ._internal = {
+      .multi = multi,
+      .operations = NULL,
+      .operations_count = 0,
+    },
+  };
+
+  return AZ_OK;
+}
+
+void az_http_client_curl_async_cleanup(az_http_client_curl_async* ref_async)
+{
+  _az_PRECONDITION_NOT_NULL(ref_async);
+
+  while (ref_async->_internal.operations != NULL)
+  {
+    _az_http_client_curl_async_finish(ref_async->_internal.operations, AZ_ERROR_CANCELED);
+  }
+
+  (void)curl_multi_cleanup((CURLM*)ref_async->_internal.multi);
+  ref_async->_internal.multi = NULL;
+}
+
+AZ_NODISCARD az_result az_http_client_curl_async_operation_init(
+    az_http_client_curl_async_operation* out_operation,
+    az_http_client_curl_async* async,
+    az_context const* parent,
+    az_span buffer,
+    az_http_client_curl_async_callback callback,
+    void* user_context)
+{
+  _az_PRECONDITION_NOT_NULL(out_operation);
+  _az_PRECONDITION_NOT_NULL(async);
+  _az_PRECONDITION_NOT_NULL(callback);
+
+  *out_operation = (az_http_client_curl_async_operation){
+    ._internal = {
+      .async = async,
+      .callback = callback,
+      .user_context = user_context,
+      .response = NULL,
+      .curl = NULL,
+      .headers = { 0 },
+      .upload = { 0 },
+      .next = NULL,
+      .is_in_flight = false,
+      .is_transferring = false,
+    },
+  };
+
+  return _az_http_async_state_init(&out_operation->_internal.state, parent, buffer);
+}
+
+AZ_NODISCARD az_context* az_http_client_curl_async_operation_get_context(
+    az_http_client_curl_async_operation* operation)
+{
+  _az_PRECONDITION_NOT_NULL(operation);
+
+  return &operation->_internal.state._internal.context;
+}
+
+AZ_NODISCARD az_result az_http_client_curl_async_perform(
+    az_http_client_curl_async* ref_async,
+    int32_t timeout_msec,
+    int32_t* out_operations_count)
+{
+  _az_PRECONDITION_NOT_NULL(ref_async);
+  _az_PRECONDITION_NOT_NULL(out_operations_count);
+
+  CURLM* const multi = (CURLM*)ref_async->_internal.multi;
+
+  for (int32_t pass = 0; pass < 2; ++pass)
+  {
+    // Start the transfers that are due, and cancel the ones whose context has expired. Completing
+    // an operation may call back into the caller, which can submit more, so restart the walk.
+    int64_t const now_msec = az_platform_clock_msec();
+    int64_t next_due_msec = now_msec + timeout_msec;
+    int32_t transferring_count = 0;
+    bool restart = true;
+    while (restart)
+    {
+      restart = false;
+      transferring_count = 0;
+      for (az_http_client_curl_async_operation* operation = ref_async->_internal.operations;
+           operation != NULL;
+           operation = operation->_internal.next)
+      {
+        if (az_context_has_expired(&operation->_internal.state._internal.context, now_msec))
+        {
+          _az_http_client_curl_async_complete(operation, AZ_ERROR_CANCELED);
+          restart = true;
+          break;
+        }
+
+        // Wake up to cancel the operation once its context expires.
+        int64_t const expiration_msec
+            = az_context_get_expiration(&operation->_internal.state._internal.context);
+        next_due_msec = expiration_msec < next_due_msec ? expiration_msec : next_due_msec;
+
+        if (operation->_internal.is_transferring)
+        {
+          ++transferring_count;
+          continue;
+        }
+
+        int64_t const not_before_msec = operation->_internal.state._internal.not_before_msec;
+        if (not_before_msec > now_msec)
+        {
+          next_due_msec = not_before_msec < next_due_msec ? not_before_msec : next_due_msec;
+          continue;
+        }
+
+        az_result const result = _az_http_client_curl_async_start_transfer(operation);
+        if (az_failed(result))
+        {
+          _az_http_client_curl_async_complete(operation, result);
+          restart = true;
+          break;
+        }
+        ++transferring_count;
+      }
+    }
+
+    int running = 0;
+    if (curl_multi_perform(multi, &running) != CURLM_OK)
+    {
+      return AZ_ERROR_HTTP_PLATFORM;
+    }
+
+    int messages_left = 0;
+    CURLMsg* message = NULL;
+    while ((message = curl_multi_info_read(multi, &messages_left)) != NULL)
+    {
+      if (message->msg != CURLMSG_DONE)
+      {
+        continue;
+      }
+
+      void* operation = NULL;
+      (void)curl_easy_getinfo(message->easy_handle, CURLINFO_PRIVATE, (char**)&operation);
+      az_http_client_curl_async_operation* const completed
+          = (az_http_client_curl_async_operation*)operation;
+      _az_http_client_curl_async_complete(
+          completed,
+          _az_http_client_curl_attempt_code_to_result(
+              message->data.result,
+              &completed->_internal.state._internal.request,
+              completed->_internal.response,
+              &completed->_internal.upload));
+    }
+
+    // Wait for activity, or until the next delayed send is due, then run the transfers again.
+    int32_t const wait_msec = (int32_t)(next_due_msec - az_platform_clock_msec());
+    if (pass > 0 || ref_async->_internal.operations_count == 0 || wait_msec <= 0)
+    {
+      break;
+    }
+
+    if (transferring_count == 0)
+    {
+      // Only delayed retries are left, curl_multi_wait() would return right away.
+      az_platform_sleep_msec(wait_msec);
+    }
+    else if (curl_multi_wait(multi, NULL, 0, wait_msec, NULL) != CURLM_OK)
+    {
+      return AZ_ERROR_HTTP_PLATFORM;
+    }
+  }
+
+  *out_operations_count = ref_async->_internal.operations_count;
+  return AZ_OK;
+}
+
+/**
+ * @brief Gets a slot of the hedging pool, or \p temporary when they are all busy, with its
+ * handles created, and the options of the adapter.
+ */
+static AZ_NODISCARD az_result _az_http_client_curl_hedging_acquire(
+    _az_http_client_curl_hedging_slot* temporary,
+    _az_http_client_curl_hedging_slot** out_slot,
+    az_http_client_curl_options* out_options)
+{
+  _az_http_client_curl_hedging_slot* slot = temporary;
+
+  _az_spinlock_enter_writer(&_az_http_client_curl_pool_lock);
+  for (int32_t i = 0; i < _az_CURL_HEDGING_POOL_SIZE; ++i)
+  {
+    if (!_az_http_client_curl_hedging_pool[i].in_use)
+    {
+      slot = &_az_http_client_curl_hedging_pool[i];
+      slot->in_use = true;
+      break;
+    }
+  }
+  *out_options = _az_http_client_curl_pool_options;
+  _az_spinlock_exit_writer(&_az_http_client_curl_pool_lock);
+
+  if (slot->multi == NULL)
+  {
+    slot->multi = curl_multi_init();
+    slot->handles[0] = curl_easy_init();
+    slot->handles[1] = curl_easy_init();
+  }
+
+  *out_slot = slot;
+  return slot->multi != NULL && slot->handles[0] != NULL && slot->handles[1] != NULL
+      ? AZ_OK
+      : AZ_ERROR_HTTP_PLATFORM;
+}
+
+static void _az_http_client_curl_hedging_release(
+    _az_http_client_curl_hedging_slot* temporary,
+    _az_http_client_curl_hedging_slot* ref_slot,
+    az_result result)
+{
+  if (ref_slot == temporary || az_failed(result))
+  {
+    // The handles of a pooled slot are created again by the next hedged request.
+    _az_http_client_curl_hedging_slot_cleanup(ref_slot);
+  }
+
+  if (ref_slot != temporary)
+  {
+    _az_spinlock_enter_writer(&_az_http_client_curl_pool_lock);
+    ref_slot->in_use = false;
+    _az_spinlock_exit_writer(&_az_http_client_curl_pool_lock);
+  }
+}
+
+/**
+ * @brief One of the two transfers of a hedged request. The first one to receive a byte of response
+ * writes the response, the other one is aborted.
+ */
+typedef struct
+{
+  CURL* curl;
+  az_http_response* response;
+  int32_t* winner; // Index of the transfer writing the response, -1 until one receives a byte.
+  int32_t index;
+  int64_t start_msec;
+  bool is_started;
+  bool is_done;
+  CURLcode code;
+  _az_http_client_curl_headers headers;
+  _az_http_client_curl_upload upload;
+} _az_http_client_curl_hedged_transfer;
+
+static size_t _az_http_client_curl_write_hedged(
+    void* contents,
+    size_t size,
+    size_t nmemb,
+    void* userp)
+{
+  _az_http_client_curl_hedged_transfer const* const transfer
+      = (_az_http_client_curl_hedged_transfer const*)userp;
+
+  if (*transfer->winner < 0)
+  {
+    *transfer->winner = transfer->index;
+  }
+
+  // Writing less than was received aborts the transfer that lost the race.
+  return *transfer->winner == transfer->index
+      ? _az_http_client_curl_write_to_span(contents, size, nmemb, transfer->response)
+      : 0;
+}
+
+static AZ_NODISCARD az_result _az_http_client_curl_hedged_transfer_start(
+    CURLM* multi,
+    az_http_client_curl_options const* options,
+    az_http_request const* request,
+    az_span scratch,
+    _az_http_client_curl_hedged_transfer* ref_transfer)
+{
+  CURL* const curl = ref_transfer->curl;
+  curl_easy_reset(curl);
+
+  AZ_RETURN_IF_FAILED(_az_http_client_curl_setup_connection(curl, options));
+  AZ_RETURN_IF_FAILED(_az_http_client_curl_setup_request(
+      curl,
+      request,
+      ref_transfer->response,
+      scratch,
+      &ref_transfer->headers,
+      &ref_transfer->upload));
+  AZ_RETURN_IF_FAILED(_az_http_client_curl_setup_timeout(curl, request));
+
+  AZ_RETURN_IF_CURL_FAILED(
+      curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, _az_http_client_curl_write_hedged));
+  AZ_RETURN_IF_CURL_FAILED(curl_easy_setopt(curl, CURLOPT_HEADERDATA, (void*)ref_transfer));
+  AZ_RETURN_IF_CURL_FAILED(
+      curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, _az_http_client_curl_write_hedged));
+  AZ_RETURN_IF_CURL_FAILED(curl_easy_setopt(curl, CURLOPT_WRITEDATA, (void*)ref_transfer));
+
+  // Over HTTP/2, the hedge would be multiplexed on the connection of the first transfer, to the
+  // same server. It gets its own connection instead, cached for the next requests.
+  if (ref_transfer->index > 0 && options->http_version != AZ_HTTP_CLIENT_CURL_HTTP_VERSION_1_1)
+  {
+    AZ_RETURN_IF_CURL_FAILED(curl_easy_setopt(curl, CURLOPT_FRESH_CONNECT, 1L));
+  }
+
+  if (curl_multi_add_handle(multi, curl) != CURLM_OK)
+  {
+    return AZ_ERROR_HTTP_PLATFORM;
+  }
+
+  ref_transfer->start_msec = az_platform_clock_msec();
+  ref_transfer->is_started = true;
+  return AZ_OK;
+}
+
+/**
+ * @brief Sends \p request, and sends it a second time if no response started to be received after
+ * its hedge delay. The response that starts first is written to \p ref_response.
+ */
+static AZ_NODISCARD az_result _az_http_client_curl_send_hedged_request(
+    az_http_request const* request,
+    az_http_response* ref_response)
+{
+  _az_http_client_curl_hedging_slot temporary = { 0 };
+  _az_http_client_curl_hedging_slot* slot = NULL;
+  az_http_client_curl_options options = { 0 };
+  az_result result = _az_http_client_curl_hedging_acquire(&temporary, &slot, &options);
+  if (az_failed(result))
+  {
+    _az_http_client_curl_hedging_release(&temporary, slot, result);
+    return result;
+  }
+
+  CURLM* const multi = slot->multi;
+  int32_t winner = -1;
+  _az_http_client_curl_hedged_transfer transfers[2];
+  for (int32_t i = 0; i < 2; ++i)
+  {
+    transfers[i] = (_az_http_client_curl_hedged_transfer){
+      .curl = slot->handles[i],
+      .response = ref_response,
+      .winner = &winner,
+      .index = i,
+      .start_msec = 0,
+      .is_started = false,
+      .is_done = false,
+      .code = CURLE_OK,
+      .headers = { 0 },
+      .upload = { 0 },
+    };
+  }
+
+  // Both transfers are done before returning, so their urls and header lists are laid out on the
+  // stack.
+  uint8_t scratch[2][_az_CURL_SCRATCH_BUFFER_SIZE];
+  int64_t const hedge_at_msec = az_platform_clock_msec() + request->_internal.hedge_delay_msec;
+  bool is_hedge_sent = false;
+
+  result = _az_http_client_curl_hedged_transfer_start(
+      multi, &options, request, AZ_SPAN_FROM_BUFFER(scratch[0]), &transfers[0]);
+
+  while (az_succeeded(result))
+  {
+    int running = 0;
+    if (curl_multi_perform(multi, &running) != CURLM_OK)
+    {
+      result = AZ_ERROR_HTTP_PLATFORM;
+      break;
+    }
+
+    int messages_left = 0;
+    CURLMsg* message = NULL;
+    while ((message = curl_multi_info_read(multi, &messages_left)) != NULL)
+    {
+      if (message->msg == CURLMSG_DONE)
+      {
+        _az_http_client_curl_hedged_transfer* const done
+            = message->easy_handle == transfers[0].curl ? &transfers[0] : &transfers[1];
+        done->is_done = true;
+        done->code = message->data.result;
+      }
+    }
+
+    // Done once the transfer writing the response is, or once all the transfers failed before
+    // receiving anything.
+    _az_http_client_curl_hedged_transfer const* const last
+        = transfers[1].is_started ? &transfers[1] : &transfers[0];
+    if (winner >= 0 ? transfers[winner].is_done : transfers[0].is_done && last->is_done)
+    {
+      _az_http_client_curl_hedged_transfer const* const done
+          = winner >= 0 ? &transfers[winner] : last;
+      result = _az_http_client_curl_attempt_code_to_result(
+          done->code, request, ref_response, &done->upload);
+      _az_http_client_curl_record_metrics(done->curl, request);
+      _az_http_client_curl_record_time_to_first_byte(
+          done->curl, request, done->start_msec - transfers[0].start_msec);
+      break;
+    }
+
+    int64_t const now_msec = az_platform_clock_msec();
+    bool const can_hedge = winner < 0 && !is_hedge_sent && !transfers[0].is_done;
+    if (can_hedge && now_msec >= hedge_at_msec)
+    {
+      // The first transfer goes on alone if the hedge can't be sent.
+      is_hedge_sent = true;
+      if (az_succeeded(_az_http_client_curl_hedged_transfer_start(
+              multi, &options, request, AZ_SPAN_FROM_BUFFER(scratch[1]), &transfers[1])))
+      {
+        continue;
+      }
+    }
+
+    int const wait_msec = can_hedge && !is_hedge_sent ? (int)(hedge_at_msec - now_msec) : 1000;
+    if (curl_multi_wait(multi, NULL, 0, wait_msec, NULL) != CURLM_OK)
+    {
+      result = AZ_ERROR_HTTP_PLATFORM;
+    }
+  }
+
+  // The transfer that lost the race is aborted, if it hasn't been already, and its connection is
+  // closed.
+  for (int32_t i = 0; i < 2; ++i)
+  {
+    if (transfers[i].is_started)
+    {
+      (void)curl_multi_remove_handle(multi, transfers[i].curl);
+    }
+    _az_http_client_curl_headers_free(&transfers[i].headers);
+  }
 
+  _az_http_client_curl_hedging_release(&temporary, slot, result);
   return result;
 }
 
@@ -593,17 +2016,39 @@ az_http_client_send_request(az_http_request const* request, az_http_response* re
   _az_PRECONDITION_NOT_NULL(request);
   _az_PRECONDITION_NOT_NULL(ref_response);
 
-  CURL* curl = NULL;
+  az_http_client_curl_async_operation* const operation
+      = _az_http_client_curl_get_async_operation(request);
+  if (operation != NULL)
+  {
+    // A policy is being resumed with the response the driver received.
+    az_result completed_result = AZ_OK;
+    if (_az_http_async_state_take_result(&operation->_internal.state, &completed_result))
+    {
+      return completed_result;
+    }
+
+    return _az_http_client_curl_async_submit(operation, request, ref_response);
+  }
+
+  if (request->_internal.hedge_delay_msec > 0)
+  {
+    return _az_http_client_curl_send_hedged_request(request, ref_response);
+  }
+
+  az_span request_url = { 0 };
+  AZ_RETURN_IF_FAILED(az_http_request_get_url(request, &request_url));
 
-  // init curl
-  AZ_RETURN_IF_FAILED(_az_http_client_curl_init(&curl));
+  // get a handle from the pool, already connected to the host when possible
+  _az_http_client_curl_pooled_handle* entry = NULL;
+  CURL* curl = NULL;
+  AZ_RETURN_IF_FAILED(_az_http_client_curl_acquire(request_url, &entry, &curl));
 
   // process request
   az_result process_result
       = _az_http_client_curl_send_request_impl_process(curl, request, ref_response);
 
-  // no matter if error or not, call curl done before returning to let curl clean everything
-  AZ_RETURN_IF_FAILED(_az_http_client_curl_done(&curl));
+  // no matter if error or not, give the handle back (or close it) before returning
+  _az_http_client_curl_release(entry, curl, process_result);
 
   return process_result;
 }
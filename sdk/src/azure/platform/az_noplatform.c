@@ -7,6 +7,8 @@
 
 AZ_NODISCARD int64_t az_platform_clock_msec() { return 0; }
 
+AZ_NODISCARD int64_t az_platform_clock_usec() { return 0; }
+
 void az_platform_sleep_msec(int32_t milliseconds) { (void)milliseconds; }
 
 AZ_NODISCARD bool az_platform_atomic_compare_exchange(
@@ -12,9 +12,35 @@
 
 AZ_NODISCARD int64_t az_platform_clock_msec()
 {
+  // clock() measures the CPU time of the process, which doesn't advance while waiting on I/O or
+  // sleeping. Use the monotonic wall clock when available.
+#if defined(CLOCK_MONOTONIC)
+  struct timespec now = { 0 };
+  if (clock_gettime(CLOCK_MONOTONIC, &now) == 0)
+  {
+    return ((int64_t)now.tv_sec * _az_TIME_MILLISECONDS_PER_SECOND)
+        + ((int64_t)now.tv_nsec / (_az_TIME_MICROSECONDS_PER_MILLISECOND * 1000));
+  }
+#endif // CLOCK_MONOTONIC
+
   return (int64_t)((clock() / CLOCKS_PER_SEC) * _az_TIME_MILLISECONDS_PER_SECOND);
 }
 
+AZ_NODISCARD int64_t az_platform_clock_usec()
+{
+#if defined(CLOCK_MONOTONIC)
+  struct timespec now = { 0 };
+  if (clock_gettime(CLOCK_MONOTONIC, &now) == 0)
+  {
+    return ((int64_t)now.tv_sec * _az_TIME_MILLISECONDS_PER_SECOND
+            * _az_TIME_MICROSECONDS_PER_MILLISECOND)
+        + ((int64_t)now.tv_nsec / 1000);
+  }
+#endif // CLOCK_MONOTONIC
+
+  return az_platform_clock_msec() * _az_TIME_MICROSECONDS_PER_MILLISECOND;
+}
+
 void az_platform_sleep_msec(int32_t milliseconds)
 {
   (void)usleep((useconds_t)milliseconds * _az_TIME_MICROSECONDS_PER_MILLISECOND);
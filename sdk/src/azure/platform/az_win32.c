@@ -2,6 +2,7 @@
 // SPDX-License-Identifier: MIT
 
 #include <azure/core/az_platform.h>
+#include <azure/core/internal/az_config_internal.h>
 
 // Two macros below are not used in the code below, it is windows.h that consumes them.
 #define WIN32_LEAN_AND_MEAN
@@ -12,6 +13,22 @@
 
 AZ_NODISCARD int64_t az_platform_clock_msec() { return GetTickCount64(); }
 
+AZ_NODISCARD int64_t az_platform_clock_usec()
+{
+  LARGE_INTEGER frequency;
+  LARGE_INTEGER counter;
+  if (!QueryPerformanceFrequency(&frequency) || !QueryPerformanceCounter(&counter))
+  {
+    return (int64_t)GetTickCount64() * _az_TIME_MICROSECONDS_PER_MILLISECOND;
+  }
+
+  // The seconds and the rest of the counter are converted apart, so that it doesn't overflow.
+  int64_t const usec_per_sec
+      = (int64_t)_az_TIME_MILLISECONDS_PER_SECOND * _az_TIME_MICROSECONDS_PER_MILLISECOND;
+  return (counter.QuadPart / frequency.QuadPart) * usec_per_sec
+      + (counter.QuadPart % frequency.QuadPart) * usec_per_sec / frequency.QuadPart;
+}
+
 void az_platform_sleep_msec(int32_t milliseconds) { Sleep(milliseconds); }
 
 AZ_NODISCARD bool az_platform_atomic_compare_exchange(
@@ -44,6 +44,11 @@ AZ_NODISCARD az_storage_blobs_blob_client_options az_storage_blobs_blob_client_o
       .telemetry_options = _az_http_policy_telemetry_options_default(),
     },
     .retry_options = _az_http_policy_retry_options_default(),
+    .hedging = NULL,
+    .cache = NULL,
+    .single_flight = NULL,
+    .bulkhead = NULL,
+    .compression = NULL,
   };
 
   options.retry_options.max_retries = 5;
@@ -84,12 +89,42 @@ AZ_NODISCARD az_result az_storage_blobs_blob_client_init(
                 .options = &client->_internal.options._internal.telemetry_options,
               },
             },
+            {
+              ._internal = {
+                .process = az_http_pipeline_policy_cache,
+                .options = options->cache,
+              },
+            },
+            {
+              ._internal = {
+                .process = az_http_pipeline_policy_single_flight,
+                .options = options->single_flight,
+              },
+            },
+            {
+              ._internal = {
+                .process = az_http_pipeline_policy_bulkhead,
+                .options = options->bulkhead,
+              },
+            },
+            {
+              ._internal = {
+                .process = az_http_pipeline_policy_compression,
+                .options = options->compression,
+              },
+            },
             {
               ._internal = {
                 .process = az_http_pipeline_policy_retry,
                 .options = &client->_internal.options.retry_options,
               },
             },
+            {
+              ._internal = {
+                .process = az_http_pipeline_policy_hedging,
+                .options = options->hedging,
+              },
+            },
             {
               ._internal = {
                 .process = az_http_pipeline_policy_credential,
@@ -128,10 +163,15 @@ AZ_NODISCARD az_result az_storage_blobs_blob_client_init(
   return AZ_OK;
 }
 
-AZ_NODISCARD az_result az_storage_blobs_blob_upload(
+/**
+ * @brief Uploads a block blob whose content is read from \p content_source, or is \p content if it
+ * is `NULL`.
+ */
+static AZ_NODISCARD az_result _az_storage_blobs_blob_upload(
     az_storage_blobs_blob_client* client,
     az_context* context,
-    az_span content, /* Buffer of content*/
+    az_span content,
+    az_http_body_source const* content_source,
     az_storage_blobs_blob_upload_options* options,
     az_http_response* response)
 {
@@ -170,6 +210,13 @@ AZ_NODISCARD az_result az_storage_blobs_blob_upload(
       request_headers_span,
       content));
 
+  int64_t content_size = az_span_size(content);
+  if (content_source != NULL)
+  {
+    AZ_RETURN_IF_FAILED(az_http_request_set_body_source(&request, content_source));
+    content_size = az_http_body_source_get_length(content_source);
+  }
+
   // add blob type to request
   AZ_RETURN_IF_FAILED(az_http_request_append_header(
       &request, AZ_STORAGE_BLOBS_BLOB_HEADER_X_MS_BLOB_TYPE, AZ_STORAGE_BLOBS_BLOB_TYPE_BLOCKBLOB));
@@ -178,7 +225,7 @@ AZ_NODISCARD az_result az_storage_blobs_blob_upload(
   uint8_t content_length[_az_INT64_AS_STR_BUFFER_SIZE] = { 0 };
   az_span content_length_span = AZ_SPAN_FROM_BUFFER(content_length);
   az_span remainder;
-  AZ_RETURN_IF_FAILED(az_span_i64toa(content_length_span, az_span_size(content), &remainder));
+  AZ_RETURN_IF_FAILED(az_span_i64toa(content_length_span, content_size, &remainder));
   content_length_span
       = az_span_slice(content_length_span, 0, _az_span_diff(remainder, content_length_span));
 
@@ -193,3 +240,68 @@ AZ_NODISCARD az_result az_storage_blobs_blob_upload(
   // start pipeline
   return az_http_pipeline_process(&client->_internal.pipeline, &request, response);
 }
+
+AZ_NODISCARD az_result az_storage_blobs_blob_upload(
+    az_storage_blobs_blob_client* client,
+    az_context* context,
+    az_span content, /* Buffer of content*/
+    az_storage_blobs_blob_upload_options* options,
+    az_http_response* response)
+{
+  return _az_storage_blobs_blob_upload(client, context, content, NULL, options, response);
+}
+
+AZ_NODISCARD az_result az_storage_blobs_blob_upload_from_source(
+    az_storage_blobs_blob_client* client,
+    az_context* context,
+    az_http_body_source const* content_source,
+    az_storage_blobs_blob_upload_options* options,
+    az_http_response* response)
+{
+  _az_PRECONDITION_NOT_NULL(content_source);
+
+  return _az_storage_blobs_blob_upload(
+      client, context, AZ_SPAN_NULL, content_source, options, response);
+}
+
+AZ_NODISCARD az_result az_storage_blobs_blob_download(
+    az_storage_blobs_blob_client* client,
+    az_context* context,
+    az_storage_blobs_blob_download_options* options,
+    az_http_response* response)
+{
+  az_storage_blobs_blob_download_options opt;
+  if (options == NULL)
+  {
+    opt = az_storage_blobs_blob_download_options_default();
+  }
+  else
+  {
+    opt = *options;
+  }
+  (void)opt;
+
+  uint8_t url_buffer[AZ_HTTP_REQUEST_URL_BUFFER_SIZE];
+  az_span request_url_span = AZ_SPAN_FROM_BUFFER(url_buffer);
+  // copy url from client
+  int32_t uri_size = az_span_size(client->_internal.endpoint);
+  AZ_RETURN_IF_NOT_ENOUGH_SIZE(request_url_span, uri_size);
+  az_span_copy(request_url_span, client->_internal.endpoint);
+
+  uint8_t headers_buffer[_az_STORAGE_HTTP_REQUEST_HEADER_BUFFER_SIZE];
+  az_span request_headers_span = AZ_SPAN_FROM_BUFFER(headers_buffer);
+
+  // create request
+  az_http_request request;
+  AZ_RETURN_IF_FAILED(az_http_request_init(
+      &request,
+      context,
+      az_http_method_get(),
+      request_url_span,
+      uri_size,
+      request_headers_span,
+      AZ_SPAN_NULL));
+
+  // start pipeline
+  return az_http_pipeline_process(&client->_internal.pipeline, &request, response);
+}
@@ -279,6 +279,7 @@ az_result __wrap_az_http_client_send_request(
     az_http_request const* request,
     az_http_response* ref_response);
 int64_t __wrap_az_platform_clock_msec();
+int64_t __wrap_az_platform_clock_usec();
 
 az_result __wrap_az_http_client_send_request(
     az_http_request const* request,
@@ -288,6 +289,8 @@ az_result __wrap_az_http_client_send_request(
 }
 
 int64_t __wrap_az_platform_clock_msec() { return (int64_t)mock(); }
+
+int64_t __wrap_az_platform_clock_usec() { return (int64_t)mock(); }
 #endif // _az_MOCK_ENABLED
 
 int test_az_credential_client_secret()
@@ -786,6 +786,103 @@ static void test_http_response_header_validation_space(void** state)
   }
 }
 
+static void test_http_response_long_headers(void** state)
+{
+  (void)state;
+  {
+    az_http_response response = { 0 };
+    assert_return_code(
+        az_http_response_init(
+            &response,
+            AZ_SPAN_FROM_STR("HTTP/1.1 206 Partial Content\r\n"
+                             "x-ms-copy-source-authorization-error-details:\t"
+                             "The value of this header is longer than a vector\tregister.  \r\n"
+                             "Content-Range: bytes 0-1023/4096\r\n"
+                             "\r\n")),
+        AZ_OK);
+
+    az_http_response_status_line status_line = { 0 };
+    assert_return_code(az_http_response_get_status_line(&response, &status_line), AZ_OK);
+    assert_true(
+        az_span_is_content_equal(status_line.reason_phrase, AZ_SPAN_FROM_STR("Partial Content")));
+
+    az_pair header = { 0 };
+    assert_return_code(az_http_response_get_next_header(&response, &header), AZ_OK);
+    assert_true(az_span_is_content_equal(
+        header.key, AZ_SPAN_FROM_STR("x-ms-copy-source-authorization-error-details")));
+    assert_true(az_span_is_content_equal(
+        header.value,
+        AZ_SPAN_FROM_STR("The value of this header is longer than a vector\tregister.")));
+    assert_return_code(az_http_response_get_next_header(&response, &header), AZ_OK);
+    assert_true(az_span_is_content_equal(header.key, AZ_SPAN_FROM_STR("Content-Range")));
+    assert_true(az_span_is_content_equal(header.value, AZ_SPAN_FROM_STR("bytes 0-1023/4096")));
+    assert_true(
+        az_http_response_get_next_header(&response, &header) == AZ_ERROR_ITEM_NOT_FOUND);
+  }
+  {
+    // A control character far into a value.
+    az_http_response response = { 0 };
+    assert_return_code(
+        az_http_response_init(
+            &response,
+            AZ_SPAN_FROM_STR("HTTP/1.1 200 OK\r\n"
+                             "x-ms-meta-description: 0123456789012345678901234567890123\n456\r\n"
+                             "\r\n")),
+        AZ_OK);
+
+    az_http_response_status_line status_line = { 0 };
+    assert_return_code(az_http_response_get_status_line(&response, &status_line), AZ_OK);
+    az_pair header = { 0 };
+    assert_true(az_http_response_get_next_header(&response, &header) == AZ_ERROR_UNEXPECTED_CHAR);
+  }
+  {
+    // A line without a colon.
+    az_http_response response = { 0 };
+    assert_return_code(
+        az_http_response_init(
+            &response,
+            AZ_SPAN_FROM_STR("HTTP/1.1 200 OK\r\n"
+                             "x-ms-meta-without-colon-longer-than-a-vector-register\r\n"
+                             "\r\n")),
+        AZ_OK);
+
+    az_http_response_status_line status_line = { 0 };
+    assert_return_code(az_http_response_get_status_line(&response, &status_line), AZ_OK);
+    az_pair header = { 0 };
+    assert_true(
+        az_http_response_get_next_header(&response, &header)
+        == AZ_ERROR_HTTP_CORRUPT_RESPONSE_HEADER);
+  }
+}
+
+static void test_http_response_http2_status_line(void** state)
+{
+  (void)state;
+  {
+    az_http_response response = { 0 };
+    assert_return_code(
+        az_http_response_init(
+            &response,
+            AZ_SPAN_FROM_STR("HTTP/2 200 \r\n"
+                             "content-length: 2\r\n"
+                             "\r\n"
+                             "{}")),
+        AZ_OK);
+
+    az_http_response_status_line status_line = { 0 };
+    assert_return_code(az_http_response_get_status_line(&response, &status_line), AZ_OK);
+    assert_int_equal(status_line.major_version, 2);
+    assert_int_equal(status_line.minor_version, 0);
+    assert_int_equal(status_line.status_code, AZ_HTTP_STATUS_CODE_OK);
+    assert_int_equal(az_span_size(status_line.reason_phrase), 0);
+
+    az_pair header = { 0 };
+    assert_return_code(az_http_response_get_next_header(&response, &header), AZ_OK);
+    assert_true(az_span_is_content_equal(header.key, AZ_SPAN_FROM_STR("content-length")));
+    assert_true(az_span_is_content_equal(header.value, AZ_SPAN_FROM_STR("2")));
+  }
+}
+
 static void test_http_response_append(void** state)
 {
   (void)state;
@@ -840,6 +937,367 @@ static void test_http_response_append_overflow_on_second_call(void** state)
   }
 }
 
+typedef struct
+{
+  uint8_t buffer[64];
+  int32_t size;
+  int32_t calls;
+} test_body_sink;
+
+static az_result test_body_sink_write(az_span body_chunk, void* user_context)
+{
+  test_body_sink* sink = (test_body_sink*)user_context;
+  az_span remaining = az_span_slice_to_end(AZ_SPAN_FROM_BUFFER(sink->buffer), sink->size);
+  AZ_RETURN_IF_NOT_ENOUGH_SIZE(remaining, az_span_size(body_chunk));
+  az_span_copy(remaining, body_chunk);
+  sink->size += az_span_size(body_chunk);
+  ++sink->calls;
+  return AZ_OK;
+}
+
+static void test_http_response_body_callback(void** state)
+{
+  (void)state;
+  {
+    // The buffer only needs to hold the status line and headers.
+    uint8_t buffer[40] = { 0 };
+    test_body_sink sink = { 0 };
+    az_http_response response = { 0 };
+    assert_return_code(az_http_response_init(&response, AZ_SPAN_FROM_BUFFER(buffer)), AZ_OK);
+    assert_return_code(
+        az_http_response_set_body_callback(&response, test_body_sink_write, &sink), AZ_OK);
+
+    // An interim response is dropped, and the end of the headers is split between appends.
+    assert_return_code(
+        az_http_response_append(&response, AZ_SPAN_FROM_STR("HTTP/1.1 100 Continue\r\n\r\n")),
+        AZ_OK);
+    assert_return_code(
+        az_http_response_append(&response, AZ_SPAN_FROM_STR("HTTP/1.1 200 OK\r\nA: 1\r\n\r")),
+        AZ_OK);
+    assert_return_code(az_http_response_append(&response, AZ_SPAN_FROM_STR("\n0123")), AZ_OK);
+    az_span const rest_of_body = AZ_SPAN_FROM_STR("456789012345678901234567890123456789");
+    assert_return_code(az_http_response_append(&response, rest_of_body), AZ_OK);
+
+    assert_int_equal(sink.calls, 2);
+    assert_int_equal(sink.size, 40);
+    assert_memory_equal(sink.buffer, "0123456789", 10);
+
+    az_http_response_status_line status_line = { 0 };
+    assert_return_code(az_http_response_get_status_line(&response, &status_line), AZ_OK);
+    assert_int_equal(status_line.status_code, AZ_HTTP_STATUS_CODE_OK);
+
+    az_pair header = { 0 };
+    assert_return_code(az_http_response_get_next_header(&response, &header), AZ_OK);
+    assert_true(az_span_is_content_equal(header.key, AZ_SPAN_FROM_STR("A")));
+
+    az_span body = AZ_SPAN_NULL;
+    assert_return_code(az_http_response_get_body(&response, &body), AZ_OK);
+    assert_int_equal(az_span_size(body), 0);
+
+    // Resetting the response for another attempt keeps the callback.
+    _az_http_response_reset(&response);
+    assert_return_code(
+        az_http_response_append(&response, AZ_SPAN_FROM_STR("HTTP/1.1 200 OK\r\n\r\nabc")),
+        AZ_OK);
+    assert_int_equal(sink.size, 43);
+  }
+  {
+    // The body of an error response is written to the buffer.
+    uint8_t buffer[64] = { 0 };
+    test_body_sink sink = { 0 };
+    az_http_response response = { 0 };
+    assert_return_code(az_http_response_init(&response, AZ_SPAN_FROM_BUFFER(buffer)), AZ_OK);
+    assert_return_code(
+        az_http_response_set_body_callback(&response, test_body_sink_write, &sink), AZ_OK);
+
+    assert_return_code(
+        az_http_response_append(
+            &response, AZ_SPAN_FROM_STR("HTTP/1.1 404 Not Found\r\n\r\n{\"error\":1}")),
+        AZ_OK);
+    assert_int_equal(sink.calls, 0);
+
+    az_span body = AZ_SPAN_NULL;
+    assert_return_code(az_http_response_get_body(&response, &body), AZ_OK);
+    assert_true(az_span_is_content_equal(
+        az_span_slice(body, 0, 11), AZ_SPAN_FROM_STR("{\"error\":1}")));
+  }
+  {
+    // A failure of the callback fails the append, and is kept for the transport adapter.
+    uint8_t buffer[64] = { 0 };
+    test_body_sink sink = { 0 };
+    az_http_response response = { 0 };
+    assert_return_code(az_http_response_init(&response, AZ_SPAN_FROM_BUFFER(buffer)), AZ_OK);
+    assert_return_code(
+        az_http_response_set_body_callback(&response, test_body_sink_write, &sink), AZ_OK);
+
+    assert_return_code(
+        az_http_response_append(&response, AZ_SPAN_FROM_STR("HTTP/1.1 200 OK\r\n\r\n")), AZ_OK);
+    az_span const too_large = az_span_create(buffer, (int32_t)sizeof(sink.buffer) + 1);
+    assert_true(az_http_response_append(&response, too_large) == AZ_ERROR_INSUFFICIENT_SPAN_SIZE);
+    assert_true(response._internal.body.callback_result == AZ_ERROR_INSUFFICIENT_SPAN_SIZE);
+  }
+}
+
+static az_result test_body_source_read_one_byte(
+    void* user_context,
+    int64_t offset,
+    az_span destination,
+    int32_t* out_size)
+{
+  az_span_ptr(destination)[0] = (uint8_t)('a' + offset);
+  *out_size = user_context == NULL ? 1 : 0;
+  return AZ_OK;
+}
+
+static void test_http_request_body_source(void** state)
+{
+  (void)state;
+  {
+    // A request with an az_span body is read through a body source over it.
+    uint8_t headers_buffer[2 * sizeof(az_pair)];
+    az_http_request request = { 0 };
+    assert_return_code(
+        az_http_request_init(
+            &request,
+            &az_context_application,
+            az_http_method_put(),
+            request_url,
+            az_span_size(request_url),
+            AZ_SPAN_FROM_BUFFER(headers_buffer),
+            AZ_SPAN_FROM_STR("0123456789")),
+        AZ_OK);
+
+    az_http_body_source source = { 0 };
+    assert_return_code(az_http_request_get_body_source(&request, &source), AZ_OK);
+    assert_true(az_http_body_source_get_length(&source) == 10);
+
+    uint8_t buffer[4] = { 0 };
+    int32_t size = 0;
+    assert_return_code(
+        az_http_body_source_read(&source, 8, AZ_SPAN_FROM_BUFFER(buffer), &size), AZ_OK);
+    assert_int_equal(size, 2);
+    assert_memory_equal(buffer, "89", 2);
+
+    assert_return_code(
+        az_http_body_source_read(&source, 10, AZ_SPAN_FROM_BUFFER(buffer), &size), AZ_OK);
+    assert_int_equal(size, 0);
+
+    // Setting a body source replaces the az_span body.
+    az_http_body_source callback_source = { 0 };
+    assert_return_code(
+        az_http_body_source_init(&callback_source, 3, test_body_source_read_one_byte, NULL),
+        AZ_OK);
+    assert_return_code(az_http_request_set_body_source(&request, &callback_source), AZ_OK);
+
+    az_span body = AZ_SPAN_NULL;
+    assert_return_code(az_http_request_get_body(&request, &body), AZ_OK);
+    assert_int_equal(az_span_size(body), 0);
+
+    assert_return_code(az_http_request_get_body_source(&request, &source), AZ_OK);
+    assert_true(az_http_body_source_get_length(&source) == 3);
+
+    // Read it twice, as a retry would.
+    for (int i = 0; i < 2; ++i)
+    {
+      int32_t offset = 0;
+      while (offset < (int32_t)az_http_body_source_get_length(&source))
+      {
+        assert_return_code(
+            az_http_body_source_read(
+                &source, offset, az_span_slice_to_end(AZ_SPAN_FROM_BUFFER(buffer), offset), &size),
+            AZ_OK);
+        offset += size;
+      }
+      assert_memory_equal(buffer, "abc", 3);
+    }
+  }
+  {
+    // A source that stops before its length is an error.
+    az_http_body_source source = { 0 };
+    uint8_t user_context = 0;
+    assert_return_code(
+        az_http_body_source_init(&source, 3, test_body_source_read_one_byte, &user_context),
+        AZ_OK);
+
+    uint8_t buffer[4] = { 0 };
+    int32_t size = 0;
+    assert_true(
+        az_http_body_source_read(&source, 0, AZ_SPAN_FROM_BUFFER(buffer), &size) == AZ_ERROR_EOF);
+  }
+}
+
+static void test_http_response_header_index(void** state)
+{
+  (void)state;
+  az_span const raw_response = AZ_SPAN_FROM_STR("HTTP/1.1 200 OK\r\n"
+                                                "Content-Type: text/plain\r\n"
+                                                "ETag: \"0x8D\"\r\n"
+                                                "x-ms-request-id: abc\r\n"
+                                                "Set-Cookie: a=1\r\n"
+                                                "set-cookie: b=2\r\n"
+                                                "\r\n"
+                                                "body");
+
+  // With an index large enough for all the headers, with one too small, and without an index.
+  uint8_t large_index[AZ_HTTP_RESPONSE_HEADER_INDEX_BUFFER_SIZE(8)];
+  uint8_t small_index[AZ_HTTP_RESPONSE_HEADER_INDEX_BUFFER_SIZE(2)];
+  az_span const index_buffers[]
+      = { AZ_SPAN_FROM_BUFFER(large_index), AZ_SPAN_FROM_BUFFER(small_index), AZ_SPAN_NULL };
+
+  for (size_t i = 0; i < sizeof(index_buffers) / sizeof(index_buffers[0]); ++i)
+  {
+    uint8_t buffer[256] = { 0 };
+    az_http_response response = { 0 };
+    assert_return_code(az_http_response_init(&response, AZ_SPAN_FROM_BUFFER(buffer)), AZ_OK);
+    assert_return_code(az_http_response_set_header_index(&response, index_buffers[i]), AZ_OK);
+    assert_return_code(az_http_response_append(&response, raw_response), AZ_OK);
+
+    // Lookups don't change what get_next_header returns next.
+    az_http_response_status_line status_line = { 0 };
+    assert_return_code(az_http_response_get_status_line(&response, &status_line), AZ_OK);
+    az_pair header = { 0 };
+    assert_return_code(az_http_response_get_next_header(&response, &header), AZ_OK);
+
+    az_span value = AZ_SPAN_NULL;
+    assert_return_code(
+        az_http_response_get_header(&response, AZ_SPAN_FROM_STR("etag"), &value), AZ_OK);
+    assert_true(az_span_is_content_equal(value, AZ_SPAN_FROM_STR("\"0x8D\"")));
+    assert_return_code(
+        az_http_response_get_header(&response, AZ_SPAN_FROM_STR("X-MS-Request-Id"), &value),
+        AZ_OK);
+    assert_true(az_span_is_content_equal(value, AZ_SPAN_FROM_STR("abc")));
+    assert_return_code(
+        az_http_response_get_header(&response, AZ_SPAN_FROM_STR("SET-COOKIE"), &value), AZ_OK);
+    assert_true(az_span_is_content_equal(value, AZ_SPAN_FROM_STR("a=1")));
+    assert_true(
+        az_http_response_get_header(&response, AZ_SPAN_FROM_STR("Retry-After"), &value)
+        == AZ_ERROR_ITEM_NOT_FOUND);
+
+    assert_return_code(az_http_response_get_next_header(&response, &header), AZ_OK);
+    assert_true(az_span_is_content_equal(header.key, AZ_SPAN_FROM_STR("ETag")));
+
+    az_span body = AZ_SPAN_NULL;
+    assert_return_code(az_http_response_get_body(&response, &body), AZ_OK);
+    assert_true(az_span_is_content_equal(az_span_slice(body, 0, 4), AZ_SPAN_FROM_STR("body")));
+
+    // The index is rebuilt for the response of the next attempt.
+    _az_http_response_reset(&response);
+    assert_return_code(
+        az_http_response_append(&response, AZ_SPAN_FROM_STR("HTTP/1.1 503 Busy\r\n"
+                                                             "Retry-After: 2\r\n"
+                                                             "\r\n")),
+        AZ_OK);
+    assert_return_code(
+        az_http_response_get_header(&response, AZ_SPAN_FROM_STR("retry-after"), &value), AZ_OK);
+    assert_true(az_span_is_content_equal(value, AZ_SPAN_FROM_STR("2")));
+    assert_true(
+        az_http_response_get_header(&response, AZ_SPAN_FROM_STR("etag"), &value)
+        == AZ_ERROR_ITEM_NOT_FOUND);
+  }
+}
+
+static void test_http_parse_date(void** state)
+{
+  (void)state;
+
+  struct
+  {
+    char const* date;
+    int64_t unix_sec;
+  } const dates[] = {
+    { "Thu, 01 Jan 1970 00:00:00 GMT", 0 },
+    { "Sun, 06 Nov 1994 08:49:37 GMT", 784111777 },
+    { "Tue, 29 Feb 2000 12:00:00 GMT", 951825600 },
+    { "Wed, 14 Oct 2020 17:05:12 GMT", 1602695112 },
+    { "Fri, 31 Dec 2038 23:59:59 GMT", 2177452799 },
+  };
+
+  for (size_t i = 0; i < sizeof(dates) / sizeof(dates[0]); ++i)
+  {
+    int64_t unix_sec = -1;
+    assert_return_code(
+        _az_http_parse_date(az_span_create_from_str((char*)(uintptr_t)dates[i].date), &unix_sec),
+        AZ_OK);
+    assert_true(unix_sec == dates[i].unix_sec);
+  }
+
+  char const* const invalid_dates[] = {
+    "",
+    "120",
+    "Sun, 06 Nov 1994 08:49:37 UTC",
+    "Sunday, 06-Nov-94 08:49:37 GMT",
+    "Sun Nov  6 08:49:37 1994",
+    "Sun, 06 Nov 1994 08:49:37 GMT ",
+    "Abc, 06 Nov 1994 08:49:37 GMT",
+    "Sun, 06 Now 1994 08:49:37 GMT",
+    "Sun, 00 Nov 1994 08:49:37 GMT",
+    "Sun, 32 Nov 1994 08:49:37 GMT",
+    "Sun, 06 Nov 1994 24:49:37 GMT",
+    "Sun, 06 Nov 1994 08:60:37 GMT",
+    "Sun, 06 Nov 19x4 08:49:37 GMT",
+    "Sun, 06 Nov 1994 08-49-37 GMT",
+  };
+
+  for (size_t i = 0; i < sizeof(invalid_dates) / sizeof(invalid_dates[0]); ++i)
+  {
+    int64_t unix_sec = 0;
+    assert_true(
+        _az_http_parse_date(az_span_create_from_str((char*)(uintptr_t)invalid_dates[i]), &unix_sec)
+        == AZ_ERROR_UNEXPECTED_CHAR);
+  }
+}
+
+static void test_http_request_timeout(void** state)
+{
+  (void)state;
+
+  uint8_t url_buf[100];
+  uint8_t header_buf[(2 * sizeof(az_pair))];
+  az_span const url = AZ_SPAN_FROM_STR("https://account.blob.core.windows.net/container");
+  az_span_copy(AZ_SPAN_FROM_BUFFER(url_buf), url);
+
+  az_context context = az_context_create_with_expiration(&az_context_application, 10000);
+  az_http_request request;
+  assert_return_code(
+      az_http_request_init(
+          &request,
+          &az_context_application,
+          az_http_method_get(),
+          AZ_SPAN_FROM_BUFFER(url_buf),
+          az_span_size(url),
+          AZ_SPAN_FROM_BUFFER(header_buf),
+          AZ_SPAN_NULL),
+      AZ_OK);
+
+  // Without a deadline nor a per-try timeout, there is no limit.
+  int64_t timeout_msec = -1;
+  assert_return_code(_az_http_request_get_timeout(&request, 1000, &timeout_msec), AZ_OK);
+  assert_true(timeout_msec == 0);
+  assert_int_equal(
+      _az_http_request_get_timeout_result(&request, 1000), AZ_ERROR_HTTP_ATTEMPT_TIMEOUT);
+
+  request._internal.try_timeout_msec = 2000;
+  assert_return_code(_az_http_request_get_timeout(&request, 1000, &timeout_msec), AZ_OK);
+  assert_true(timeout_msec == 2000);
+
+  // The per-try timeout is capped by the time left before the context expires.
+  request._internal.context = &context;
+  assert_return_code(_az_http_request_get_timeout(&request, 1000, &timeout_msec), AZ_OK);
+  assert_true(timeout_msec == 2000);
+  assert_return_code(_az_http_request_get_timeout(&request, 9000, &timeout_msec), AZ_OK);
+  assert_true(timeout_msec == 1000);
+  assert_int_equal(
+      _az_http_request_get_timeout_result(&request, 9000), AZ_ERROR_HTTP_ATTEMPT_TIMEOUT);
+
+  request._internal.try_timeout_msec = 0;
+  assert_return_code(_az_http_request_get_timeout(&request, 1000, &timeout_msec), AZ_OK);
+  assert_true(timeout_msec == 9000);
+
+  // Once the context has expired, the request isn't sent.
+  assert_int_equal(_az_http_request_get_timeout(&request, 10000, &timeout_msec), AZ_ERROR_CANCELED);
+  assert_int_equal(_az_http_request_get_timeout_result(&request, 10000), AZ_ERROR_CANCELED);
+}
+
 int test_az_http()
 {
 #ifndef AZ_NO_PRECONDITION_CHECKING
@@ -859,9 +1317,16 @@ int test_az_http()
     cmocka_unit_test(test_http_response_header_validation),
     cmocka_unit_test(test_http_response_header_validation_fail),
     cmocka_unit_test(test_http_response_header_validation_space),
+    cmocka_unit_test(test_http_response_http2_status_line),
+    cmocka_unit_test(test_http_response_long_headers),
     cmocka_unit_test(test_http_response_append_overflow),
     cmocka_unit_test(test_http_response_append),
     cmocka_unit_test(test_http_response_append_overflow_on_second_call),
+    cmocka_unit_test(test_http_response_body_callback),
+    cmocka_unit_test(test_http_request_body_source),
+    cmocka_unit_test(test_http_response_header_index),
+    cmocka_unit_test(test_http_parse_date),
+    cmocka_unit_test(test_http_request_timeout),
   };
   return cmocka_run_group_tests_name("az_core_http", tests, NULL, NULL);
 }
@@ -837,6 +837,30 @@ static void test_json_reader(void** state)
     assert_true(az_json_reader_next_token(&reader) == AZ_ERROR_EOF);
     test_json_token_helper(reader.token, AZ_JSON_TOKEN_NONE, AZ_SPAN_NULL);
   }
+  {
+    // A string isn't terminated when the JSON ends right after its opening quote, as when it ends
+    // within the string.
+    az_json_reader reader = { 0 };
+    TEST_EXPECT_SUCCESS(az_json_reader_init(&reader, AZ_SPAN_FROM_STR("  \""), NULL));
+    assert_int_equal(az_json_reader_next_token(&reader), AZ_ERROR_EOF);
+
+    TEST_EXPECT_SUCCESS(az_json_reader_init(&reader, AZ_SPAN_FROM_STR("[\""), NULL));
+    TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+    assert_int_equal(az_json_reader_next_token(&reader), AZ_ERROR_EOF);
+
+    TEST_EXPECT_SUCCESS(az_json_reader_init(&reader, AZ_SPAN_FROM_STR("[\"a"), NULL));
+    TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+    assert_int_equal(az_json_reader_next_token(&reader), AZ_ERROR_EOF);
+
+    TEST_EXPECT_SUCCESS(az_json_reader_init(&reader, AZ_SPAN_FROM_STR("{\"a\":\""), NULL));
+    TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+    TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+    assert_int_equal(az_json_reader_next_token(&reader), AZ_ERROR_EOF);
+
+    TEST_EXPECT_SUCCESS(az_json_reader_init(&reader, AZ_SPAN_FROM_STR("{\""), NULL));
+    TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+    assert_int_equal(az_json_reader_next_token(&reader), AZ_ERROR_EOF);
+  }
   {
     az_json_reader reader = { 0 };
     TEST_EXPECT_SUCCESS(az_json_reader_init(&reader, AZ_SPAN_FROM_STR("  false"), NULL));
@@ -1321,7 +1345,7 @@ static void test_json_reader_invalid(void** state)
   test_json_reader_invalid_helper(AZ_SPAN_FROM_STR("trUe"), AZ_ERROR_UNEXPECTED_CHAR);
   test_json_reader_invalid_helper(AZ_SPAN_FROM_STR("False"), AZ_ERROR_UNEXPECTED_CHAR);
   test_json_reader_invalid_helper(AZ_SPAN_FROM_STR("age"), AZ_ERROR_UNEXPECTED_CHAR);
-  test_json_reader_invalid_helper(AZ_SPAN_FROM_STR("\""), AZ_ERROR_UNEXPECTED_CHAR);
+  test_json_reader_invalid_helper(AZ_SPAN_FROM_STR("\""), AZ_ERROR_EOF);
   test_json_reader_invalid_helper(AZ_SPAN_FROM_STR("\"age\":"), AZ_ERROR_UNEXPECTED_CHAR);
 
   // Invalid numbers
@@ -1384,6 +1408,474 @@ static void test_json_reader_invalid(void** state)
       AZ_SPAN_FROM_STR("{\r\n\"isActive\":false \"\r\n}"), AZ_ERROR_UNEXPECTED_CHAR);
 }
 
+// Using a macro instead of a helper method to retain line number
+// in call stack to help debug which line/test case failed.
+#define test_json_reader_utf8_helper(json, expected_result) \
+  do \
+  { \
+    az_json_reader_options options = az_json_reader_options_default(); \
+    options.validate_utf8 = true; \
+    az_json_reader reader = { 0 }; \
+    TEST_EXPECT_SUCCESS(az_json_reader_init(&reader, json, &options)); \
+    az_result result = AZ_OK; \
+    while (result == AZ_OK) \
+    { \
+      result = az_json_reader_next_token(&reader); \
+    } \
+    assert_int_equal(result, expected_result); \
+  } while (0)
+
+static void test_json_reader_utf8(void** state)
+{
+  (void)state;
+
+  // Sequences of 1 to 4 bytes, and the lowest and highest code points of each size.
+  test_json_reader_utf8_helper(
+      AZ_SPAN_FROM_STR("{\"caf\xC3\xA9\":\"\xE6\x97\xA5\xE6\x9C\xAC \xF0\x9F\x98\x80\"}"),
+      AZ_ERROR_JSON_READER_DONE);
+  test_json_reader_utf8_helper(
+      AZ_SPAN_FROM_STR(
+          "[\"\xC2\x80\xDF\xBF\xE0\xA0\x80\xEF\xBF\xBF\xF0\x90\x80\x80\xF4\x8F\xBF\xBF\"]"),
+      AZ_ERROR_JSON_READER_DONE);
+  test_json_reader_utf8_helper(
+      AZ_SPAN_FROM_STR("\"\xED\x9F\xBF\xEE\x80\x80\\u00e9\""), AZ_ERROR_JSON_READER_DONE);
+
+  // Continuation bytes without a lead byte, and lead bytes of overlong encodings.
+  test_json_reader_utf8_helper(AZ_SPAN_FROM_STR("[\"\x80\"]"), AZ_ERROR_UNEXPECTED_CHAR);
+  test_json_reader_utf8_helper(AZ_SPAN_FROM_STR("[\"\xBF\"]"), AZ_ERROR_UNEXPECTED_CHAR);
+  test_json_reader_utf8_helper(AZ_SPAN_FROM_STR("[\"\xC0\xAF\"]"), AZ_ERROR_UNEXPECTED_CHAR);
+  test_json_reader_utf8_helper(AZ_SPAN_FROM_STR("[\"\xC1\xBF\"]"), AZ_ERROR_UNEXPECTED_CHAR);
+  test_json_reader_utf8_helper(AZ_SPAN_FROM_STR("[\"\xE0\x9F\xBF\"]"), AZ_ERROR_UNEXPECTED_CHAR);
+  test_json_reader_utf8_helper(
+      AZ_SPAN_FROM_STR("[\"\xF0\x8F\xBF\xBF\"]"), AZ_ERROR_UNEXPECTED_CHAR);
+
+  // Surrogates, and code points above U+10FFFF.
+  test_json_reader_utf8_helper(AZ_SPAN_FROM_STR("[\"\xED\xA0\x80\"]"), AZ_ERROR_UNEXPECTED_CHAR);
+  test_json_reader_utf8_helper(AZ_SPAN_FROM_STR("[\"\xED\xBF\xBF\"]"), AZ_ERROR_UNEXPECTED_CHAR);
+  test_json_reader_utf8_helper(
+      AZ_SPAN_FROM_STR("[\"\xF4\x90\x80\x80\"]"), AZ_ERROR_UNEXPECTED_CHAR);
+  test_json_reader_utf8_helper(
+      AZ_SPAN_FROM_STR("[\"\xF5\x80\x80\x80\"]"), AZ_ERROR_UNEXPECTED_CHAR);
+  test_json_reader_utf8_helper(AZ_SPAN_FROM_STR("[\"\xFF\"]"), AZ_ERROR_UNEXPECTED_CHAR);
+
+  // Sequences cut short, within the string or by the end of the JSON.
+  test_json_reader_utf8_helper(AZ_SPAN_FROM_STR("[\"\xC3\"]"), AZ_ERROR_UNEXPECTED_CHAR);
+  test_json_reader_utf8_helper(AZ_SPAN_FROM_STR("[\"\xE6\x97 \"]"), AZ_ERROR_UNEXPECTED_CHAR);
+  test_json_reader_utf8_helper(AZ_SPAN_FROM_STR("{\"\xF0\x9F\x98\":1}"), AZ_ERROR_UNEXPECTED_CHAR);
+  test_json_reader_utf8_helper(AZ_SPAN_FROM_STR("[\"\xF0\x9F\x98"), AZ_ERROR_EOF);
+
+  // Bytes above 0x7F are only valid within strings.
+  test_json_reader_utf8_helper(AZ_SPAN_FROM_STR("[\xC3\xA9]"), AZ_ERROR_UNEXPECTED_CHAR);
+
+  // Without validation, strings are read as bytes.
+  test_json_reader_invalid_helper(
+      AZ_SPAN_FROM_STR("[\"\xC0\xAF\xFF\"]"), AZ_ERROR_JSON_READER_DONE);
+
+  // Sequences across the blocks the reader classifies at once.
+  uint8_t json_buffer[160];
+  for (int32_t offset = 0; offset < 70; ++offset)
+  {
+    int32_t size = 0;
+    json_buffer[size++] = '"';
+    for (int32_t i = 0; i < offset; ++i)
+    {
+      json_buffer[size++] = 'a';
+    }
+    uint8_t const sequences[] = { 0xF0, 0x9F, 0x98, 0x80, 0xE2, 0x82, 0xAC, 0xC3, 0xA9 };
+    for (size_t i = 0; i < sizeof(sequences); ++i)
+    {
+      json_buffer[size++] = sequences[i];
+    }
+    json_buffer[size++] = '"';
+
+    test_json_reader_utf8_helper(az_span_create(json_buffer, size), AZ_ERROR_JSON_READER_DONE);
+
+    json_buffer[size - 2] = 0xC3;
+    test_json_reader_utf8_helper(az_span_create(json_buffer, size), AZ_ERROR_UNEXPECTED_CHAR);
+    test_json_reader_utf8_helper(az_span_create(json_buffer, size - 2), AZ_ERROR_EOF);
+  }
+}
+
+// The reader classifies the JSON in blocks of 64 bytes, tokens are read across them.
+static void test_json_reader_blocks(void** state)
+{
+  (void)state;
+
+  uint8_t json_buffer[256];
+  for (int32_t whitespace_size = 0; whitespace_size < 70; whitespace_size += 3)
+  {
+    for (int32_t string_size = 0; string_size < 140; string_size += 7)
+    {
+      // [<whitespace>"<string>"<whitespace>], with an escaped quote in the string past the first
+      // 60 bytes.
+      int32_t size = 0;
+      json_buffer[size++] = '[';
+      for (int32_t i = 0; i < whitespace_size; ++i)
+      {
+        json_buffer[size++] = (uint8_t)(i % 2 == 0 ? ' ' : '\n');
+      }
+      json_buffer[size++] = '"';
+      int32_t const string_start = size;
+      for (int32_t i = 0; i < string_size; ++i)
+      {
+        json_buffer[size++] = (uint8_t)('a' + i % 26);
+      }
+      bool const has_escape = string_size > 60;
+      if (has_escape)
+      {
+        json_buffer[string_start + 60] = '\\';
+        json_buffer[string_start + 61] = '"';
+      }
+      int32_t const string_end = size;
+      json_buffer[size++] = '"';
+      for (int32_t i = 0; i < whitespace_size; ++i)
+      {
+        json_buffer[size++] = (uint8_t)(i % 2 == 0 ? '\t' : '\r');
+      }
+      json_buffer[size++] = ']';
+
+      az_json_reader reader = { 0 };
+      TEST_EXPECT_SUCCESS(az_json_reader_init(&reader, az_span_create(json_buffer, size), NULL));
+      TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+      assert_int_equal(reader.token.kind, AZ_JSON_TOKEN_BEGIN_ARRAY);
+      TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+      test_json_token_helper(
+          reader.token,
+          AZ_JSON_TOKEN_STRING,
+          az_span_create(json_buffer + string_start, string_end - string_start));
+      assert_true(reader.token._internal.string_has_escaped_chars == has_escape);
+      TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+      assert_int_equal(reader.token.kind, AZ_JSON_TOKEN_END_ARRAY);
+      assert_int_equal(az_json_reader_next_token(&reader), AZ_ERROR_JSON_READER_DONE);
+
+      // A control character or the end of the JSON within the string.
+      if (string_size > 0)
+      {
+        json_buffer[string_end - 1] = '\n';
+        TEST_EXPECT_SUCCESS(
+            az_json_reader_init(&reader, az_span_create(json_buffer, size), NULL));
+        TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+        assert_int_equal(az_json_reader_next_token(&reader), AZ_ERROR_UNEXPECTED_CHAR);
+
+        TEST_EXPECT_SUCCESS(
+            az_json_reader_init(&reader, az_span_create(json_buffer, string_end - 1), NULL));
+        TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+        assert_int_equal(az_json_reader_next_token(&reader), AZ_ERROR_EOF);
+      }
+    }
+  }
+}
+
+// Reads json with a chunked reader, in chunks of chunk_size bytes copied one after the other to
+// the same buffer, and checks that the tokens are the ones of a reader of the whole json.
+static void test_json_reader_chunked_helper(az_span json, int32_t chunk_size)
+{
+  az_json_reader expected_reader = { 0 };
+  TEST_EXPECT_SUCCESS(az_json_reader_init(&expected_reader, json, NULL));
+
+  uint8_t chunk_buffer[64] = { 0 };
+  uint8_t token_buffer[64] = { 0 };
+  az_json_reader reader = { 0 };
+  TEST_EXPECT_SUCCESS(
+      az_json_reader_chunked_init(&reader, AZ_SPAN_NULL, AZ_SPAN_FROM_BUFFER(token_buffer), NULL));
+
+  int32_t offset = 0;
+  while (true)
+  {
+    az_result result = az_json_reader_next_token(&reader);
+    if (result == AZ_ERROR_JSON_READER_NEED_MORE_DATA)
+    {
+      if (offset >= az_span_size(json))
+      {
+        az_json_reader_chunked_end(&reader);
+        continue;
+      }
+
+      // The reader keeps nothing of the previous chunk.
+      for (int32_t i = 0; i < (int32_t)sizeof(chunk_buffer); ++i)
+      {
+        chunk_buffer[i] = '?';
+      }
+      int32_t const size
+          = az_span_size(json) - offset < chunk_size ? az_span_size(json) - offset : chunk_size;
+      az_span const chunk = az_span_slice(AZ_SPAN_FROM_BUFFER(chunk_buffer), 0, size);
+      az_span_copy(chunk, az_span_slice(json, offset, offset + size));
+      offset += size;
+      TEST_EXPECT_SUCCESS(az_json_reader_chunked_append(&reader, chunk));
+      continue;
+    }
+
+    assert_int_equal(result, az_json_reader_next_token(&expected_reader));
+    if (result != AZ_OK)
+    {
+      break;
+    }
+
+    assert_int_equal(reader.token.kind, expected_reader.token.kind);
+    assert_true(az_span_is_content_equal(reader.token.slice, expected_reader.token.slice));
+    assert_true(
+        reader.token._internal.string_has_escaped_chars
+        == expected_reader.token._internal.string_has_escaped_chars);
+  }
+}
+
+static void test_json_reader_chunked(void** state)
+{
+  (void)state;
+
+  az_span const json = AZ_SPAN_FROM_STR(
+      "{\n  \"deviceId\": \"thermostat\",\n  \"version\": 87,\n  \"properties\": {\n"
+      "    \"desired\": { \"targetTemperature\": -21.5e+1, \"note\": \"a \\\"quoted\\\" "
+      "\\u00e9\" },\n    \"reported\": [true, false, null, 0, 1.25, [], {}]\n  }\n}");
+  int32_t const sizes[] = { 1, 2, 3, 5, 7, 16, 64 };
+  for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i)
+  {
+    test_json_reader_chunked_helper(json, sizes[i]);
+  }
+
+  // Buffers cut anywhere, tokens cut anywhere, and the end of the payload in a separate buffer.
+  for (int32_t cut = 0; cut <= az_span_size(json); ++cut)
+  {
+    az_json_reader expected_reader = { 0 };
+    TEST_EXPECT_SUCCESS(az_json_reader_init(&expected_reader, json, NULL));
+
+    uint8_t token_buffer[64] = { 0 };
+    az_json_reader reader = { 0 };
+    TEST_EXPECT_SUCCESS(az_json_reader_chunked_init(
+        &reader, az_span_slice(json, 0, cut), AZ_SPAN_FROM_BUFFER(token_buffer), NULL));
+
+    az_result result = AZ_OK;
+    while ((result = az_json_reader_next_token(&reader)) != AZ_ERROR_JSON_READER_NEED_MORE_DATA)
+    {
+      TEST_EXPECT_SUCCESS(result);
+      TEST_EXPECT_SUCCESS(az_json_reader_next_token(&expected_reader));
+      assert_int_equal(reader.token.kind, expected_reader.token.kind);
+    }
+
+    TEST_EXPECT_SUCCESS(az_json_reader_chunked_append(&reader, az_span_slice_to_end(json, cut)));
+    az_json_reader_chunked_end(&reader);
+    while ((result = az_json_reader_next_token(&reader)) == AZ_OK)
+    {
+      TEST_EXPECT_SUCCESS(az_json_reader_next_token(&expected_reader));
+      assert_int_equal(reader.token.kind, expected_reader.token.kind);
+      assert_true(az_span_is_content_equal(reader.token.slice, expected_reader.token.slice));
+    }
+    assert_int_equal(result, AZ_ERROR_JSON_READER_DONE);
+    assert_int_equal(az_json_reader_next_token(&expected_reader), AZ_ERROR_JSON_READER_DONE);
+  }
+
+  // Single values, which only end with the payload.
+  test_json_reader_chunked_helper(AZ_SPAN_FROM_STR("-1234.5e-6"), 3);
+  test_json_reader_chunked_helper(AZ_SPAN_FROM_STR("  \"single\"  "), 2);
+  test_json_reader_chunked_helper(AZ_SPAN_FROM_STR("true"), 1);
+
+  // Errors are the same as with the whole payload.
+  test_json_reader_chunked_helper(AZ_SPAN_FROM_STR("{\"a\":tx}"), 2);
+  test_json_reader_chunked_helper(AZ_SPAN_FROM_STR("[1,2"), 1);
+  test_json_reader_chunked_helper(AZ_SPAN_FROM_STR("[\"abc"), 2);
+  test_json_reader_chunked_helper(AZ_SPAN_FROM_STR("[1]]"), 1);
+  test_json_reader_chunked_helper(AZ_SPAN_FROM_STR("\""), 1);
+  test_json_reader_chunked_helper(AZ_SPAN_FROM_STR(" "), 1);
+
+  {
+    uint8_t token_buffer[8] = { 0 };
+    az_json_reader reader = { 0 };
+    TEST_EXPECT_SUCCESS(az_json_reader_chunked_init(
+        &reader, AZ_SPAN_FROM_STR("[\"abc"), AZ_SPAN_FROM_BUFFER(token_buffer), NULL));
+
+    // A buffer is only appended once the reader reached the end of the previous one.
+    assert_int_equal(
+        az_json_reader_chunked_append(&reader, AZ_SPAN_FROM_STR("def\"]")),
+        AZ_ERROR_JSON_INVALID_STATE);
+
+    TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+    assert_int_equal(
+        az_json_reader_next_token(&reader), AZ_ERROR_JSON_READER_NEED_MORE_DATA);
+    assert_int_equal(
+        az_json_reader_next_token(&reader), AZ_ERROR_JSON_READER_NEED_MORE_DATA);
+
+    // A token that doesn't fit in the token buffer.
+    TEST_EXPECT_SUCCESS(az_json_reader_chunked_append(&reader, AZ_SPAN_FROM_STR("defghij\"]")));
+    assert_int_equal(az_json_reader_next_token(&reader), AZ_ERROR_INSUFFICIENT_SPAN_SIZE);
+  }
+}
+
+static void test_json_index(void** state)
+{
+  (void)state;
+
+  az_span const json = AZ_SPAN_FROM_STR(
+      "{\"desired\":{\"$version\":12,\"thermostat1\":{\"targetTemperature\":21.5,\"modes\":"
+      "[\"heat\",\"cool\",[]]},\"fan\":null},\"reported\":{\"$version\":3},\"$id\":"
+      "\"device\",\"tags\":[{\"a\":1},{\"b\":true}]}");
+
+  // One more byte than needed, to check the entries are aligned.
+  uint8_t buffer[AZ_JSON_INDEX_BUFFER_SIZE(40) + 1];
+  az_json_index index;
+  TEST_EXPECT_SUCCESS(
+      az_json_index_init(&index, json, az_span_slice_to_end(AZ_SPAN_FROM_BUFFER(buffer), 1), NULL));
+
+  // The tokens are the ones of a reader, and skipping children moves to the same token.
+  az_json_reader reader = { 0 };
+  TEST_EXPECT_SUCCESS(az_json_reader_init(&reader, json, NULL));
+  int32_t count = 0;
+  while (az_succeeded(az_json_reader_next_token(&reader)))
+  {
+    az_json_token const token = az_json_index_get_token(&index, count);
+    assert_int_equal(token.kind, reader.token.kind);
+    assert_ptr_equal(az_span_ptr(token.slice), az_span_ptr(reader.token.slice));
+    assert_int_equal(az_span_size(token.slice), az_span_size(reader.token.slice));
+    assert_true(
+        token._internal.string_has_escaped_chars
+        == reader.token._internal.string_has_escaped_chars);
+
+    az_json_reader skipping_reader = reader;
+    TEST_EXPECT_SUCCESS(az_json_reader_skip_children(&skipping_reader));
+    int32_t last = count;
+    while (az_span_ptr(skipping_reader.token.slice)
+           != az_span_ptr(az_json_index_get_token(&index, last).slice))
+    {
+      last++;
+    }
+    assert_int_equal(az_json_index_skip_children(&index, count), last);
+    count++;
+  }
+  assert_int_equal(az_json_index_get_token_count(&index), count);
+
+  // Properties are found by name, among those of the object only.
+  int32_t desired = 0;
+  int32_t position = 0;
+  TEST_EXPECT_SUCCESS(
+      az_json_index_find_property(&index, 0, AZ_SPAN_FROM_STR("desired"), &desired));
+  TEST_EXPECT_SUCCESS(
+      az_json_index_find_property(&index, desired, AZ_SPAN_FROM_STR("$version"), &position));
+  int32_t version = 0;
+  az_json_token token = az_json_index_get_token(&index, position);
+  TEST_EXPECT_SUCCESS(az_json_token_get_int32(&token, &version));
+  assert_int_equal(version, 12);
+
+  TEST_EXPECT_SUCCESS(
+      az_json_index_find_property(&index, desired, AZ_SPAN_FROM_STR("fan"), &position));
+  assert_int_equal(az_json_index_get_token(&index, position).kind, AZ_JSON_TOKEN_NULL);
+  TEST_EXPECT_SUCCESS(az_json_index_find_property(&index, 0, AZ_SPAN_FROM_STR("$id"), &position));
+  token = az_json_index_get_token(&index, position);
+  assert_true(az_json_token_is_text_equal(&token, AZ_SPAN_FROM_STR("device")));
+  assert_int_equal(
+      az_json_index_find_property(&index, 0, AZ_SPAN_FROM_STR("targetTemperature"), &position),
+      AZ_ERROR_ITEM_NOT_FOUND);
+  assert_int_equal(
+      az_json_index_find_property(&index, desired, AZ_SPAN_FROM_STR("$versio"), &position),
+      AZ_ERROR_ITEM_NOT_FOUND);
+
+  // Too many tokens for the buffer, and invalid JSON.
+  uint8_t small_buffer[AZ_JSON_INDEX_BUFFER_SIZE(3)];
+  assert_int_equal(
+      az_json_index_init(&index, json, AZ_SPAN_FROM_BUFFER(small_buffer), NULL),
+      AZ_ERROR_INSUFFICIENT_SPAN_SIZE);
+  assert_int_equal(
+      az_json_index_init(&index, AZ_SPAN_FROM_STR("[1,2"), AZ_SPAN_FROM_BUFFER(buffer), NULL),
+      AZ_ERROR_EOF);
+  assert_int_equal(
+      az_json_index_init(&index, AZ_SPAN_FROM_STR("{\"a\"}"), AZ_SPAN_FROM_BUFFER(buffer), NULL),
+      AZ_ERROR_UNEXPECTED_CHAR);
+
+  // A single value.
+  TEST_EXPECT_SUCCESS(
+      az_json_index_init(&index, AZ_SPAN_FROM_STR(" 42 "), AZ_SPAN_FROM_BUFFER(buffer), NULL));
+  assert_int_equal(az_json_index_get_token_count(&index), 1);
+  assert_int_equal(az_json_index_skip_children(&index, 0), 0);
+}
+
+static void test_json_reader_find_paths(void** state)
+{
+  (void)state;
+
+  az_span const json = AZ_SPAN_FROM_STR(
+      "{\"desired\":{\"$version\":12,\"thermostat1\":{\"targetTemperature\":21.5,\"modes\":"
+      "[\"heat\",\"cool\",[]]},\"fan\":null},\"a/b~c\":1,\"e\\\"scaped\":2,\"tags\":"
+      "[{\"a\":1},{\"b\":true}],\"last\":0}");
+
+  // The values are found in a single pass, whatever the order of the paths.
+  az_span const paths[] = {
+    AZ_SPAN_LITERAL_FROM_STR("/tags/1/b"),
+    AZ_SPAN_LITERAL_FROM_STR("/desired/thermostat1/targetTemperature"),
+    AZ_SPAN_LITERAL_FROM_STR("/desired/$version"),
+    AZ_SPAN_LITERAL_FROM_STR("/desired/thermostat1/modes/2"),
+    AZ_SPAN_LITERAL_FROM_STR("/desired/thermostat1"),
+    AZ_SPAN_LITERAL_FROM_STR("/a~1b~0c"),
+    AZ_SPAN_LITERAL_FROM_STR("/e\"scaped"),
+    AZ_SPAN_LITERAL_FROM_STR(""),
+  };
+  az_json_token values[sizeof(paths) / sizeof(paths[0])];
+  az_json_reader reader = { 0 };
+  TEST_EXPECT_SUCCESS(az_json_reader_init(&reader, json, NULL));
+  TEST_EXPECT_SUCCESS(
+      az_json_reader_find_paths(&reader, paths, sizeof(paths) / sizeof(paths[0]), values));
+
+  assert_int_equal(values[0].kind, AZ_JSON_TOKEN_TRUE);
+  assert_true(az_span_is_content_equal(values[1].slice, AZ_SPAN_FROM_STR("21.5")));
+  int32_t version = 0;
+  TEST_EXPECT_SUCCESS(az_json_token_get_int32(&values[2], &version));
+  assert_int_equal(version, 12);
+  assert_int_equal(values[3].kind, AZ_JSON_TOKEN_BEGIN_ARRAY);
+  assert_int_equal(values[4].kind, AZ_JSON_TOKEN_BEGIN_OBJECT);
+  assert_true(az_span_is_content_equal(values[5].slice, AZ_SPAN_FROM_STR("1")));
+  assert_true(az_span_is_content_equal(values[6].slice, AZ_SPAN_FROM_STR("2")));
+  assert_int_equal(values[7].kind, AZ_JSON_TOKEN_BEGIN_OBJECT);
+
+  // The reader stops at the value found last, without reading further.
+  assert_ptr_equal(az_span_ptr(reader.token.slice), az_span_ptr(values[0].slice));
+  TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+  assert_int_equal(reader.token.kind, AZ_JSON_TOKEN_END_OBJECT);
+
+  // The paths not found are of kind none, the others are found anyway.
+  az_span const missing_paths[] = {
+    AZ_SPAN_LITERAL_FROM_STR("/last"),
+    AZ_SPAN_LITERAL_FROM_STR("/desired/thermostat1/targetTemperature/value"),
+    AZ_SPAN_LITERAL_FROM_STR("/tags/2"),
+    AZ_SPAN_LITERAL_FROM_STR("/tags/01"),
+    AZ_SPAN_LITERAL_FROM_STR("/tags/-"),
+    AZ_SPAN_LITERAL_FROM_STR("/desired/$version/"),
+    AZ_SPAN_LITERAL_FROM_STR("/a~2b~0c"),
+    AZ_SPAN_LITERAL_FROM_STR("desired"),
+  };
+  az_json_token missing_values[sizeof(missing_paths) / sizeof(missing_paths[0])];
+  TEST_EXPECT_SUCCESS(az_json_reader_init(&reader, json, NULL));
+  assert_int_equal(
+      az_json_reader_find_paths(
+          &reader,
+          missing_paths,
+          sizeof(missing_paths) / sizeof(missing_paths[0]),
+          missing_values),
+      AZ_ERROR_ITEM_NOT_FOUND);
+  assert_int_equal(missing_values[0].kind, AZ_JSON_TOKEN_NUMBER);
+  for (size_t i = 1; i < sizeof(missing_paths) / sizeof(missing_paths[0]); ++i)
+  {
+    assert_int_equal(missing_values[i].kind, AZ_JSON_TOKEN_NONE);
+  }
+  assert_int_equal(reader.token.kind, AZ_JSON_TOKEN_END_OBJECT);
+  assert_int_equal(reader._internal.bit_stack._internal.current_depth, 0);
+
+  // The paths start from the current value, or from the value of the current property name.
+  az_json_token value = { 0 };
+  TEST_EXPECT_SUCCESS(az_json_reader_init(&reader, json, NULL));
+  TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+  TEST_EXPECT_SUCCESS(az_json_reader_next_token(&reader));
+  TEST_EXPECT_SUCCESS(
+      az_json_reader_find_path(&reader, AZ_SPAN_FROM_STR("/thermostat1/modes/1"), &value));
+  assert_true(az_json_token_is_text_equal(&value, AZ_SPAN_FROM_STR("cool")));
+  assert_int_equal(
+      az_json_reader_find_path(&reader, AZ_SPAN_FROM_STR("/0"), &value), AZ_ERROR_ITEM_NOT_FOUND);
+
+  // A single value, and invalid JSON.
+  TEST_EXPECT_SUCCESS(az_json_reader_init(&reader, AZ_SPAN_FROM_STR(" 42 "), NULL));
+  assert_int_equal(
+      az_json_reader_find_path(&reader, AZ_SPAN_FROM_STR("/0"), &value), AZ_ERROR_ITEM_NOT_FOUND);
+  TEST_EXPECT_SUCCESS(az_json_reader_init(&reader, AZ_SPAN_FROM_STR("{\"a\":[1,}"), NULL));
+  assert_int_equal(
+      az_json_reader_find_path(&reader, AZ_SPAN_FROM_STR("/b"), &value), AZ_ERROR_UNEXPECTED_CHAR);
+}
+
 static void test_json_skip_children(void** state)
 {
   (void)state;
@@ -1566,6 +2058,11 @@ int test_az_json()
                                       cmocka_unit_test(test_json_writer_large_string_chunked),
                                       cmocka_unit_test(test_json_reader),
                                       cmocka_unit_test(test_json_reader_invalid),
+                                      cmocka_unit_test(test_json_reader_blocks),
+                                      cmocka_unit_test(test_json_reader_utf8),
+                                      cmocka_unit_test(test_json_reader_chunked),
+                                      cmocka_unit_test(test_json_index),
+                                      cmocka_unit_test(test_json_reader_find_paths),
                                       cmocka_unit_test(test_json_skip_children),
                                       cmocka_unit_test(test_json_value) };
   return cmocka_run_group_tests_name("az_core_json", tests, NULL, NULL);
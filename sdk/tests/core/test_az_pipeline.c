@@ -4,6 +4,7 @@
 #include "az_test_definitions.h"
 #include <azure/core/az_http.h>
 #include <azure/core/az_http_transport.h>
+#include <azure/core/az_metrics.h>
 #include <azure/core/az_span.h>
 #include <azure/core/internal/az_http_internal.h>
 
@@ -113,10 +114,75 @@ az_result test_policy_2(
   return AZ_OK;
 }
 
+#if defined(_az_MOCK_ENABLED) && !defined(AZ_NO_METRICS)
+
+static az_http_metrics test_metrics;
+static int32_t test_metrics_calls = 0;
+
+static void test_metrics_callback(az_http_metrics const* metrics)
+{
+  test_metrics = *metrics;
+  ++test_metrics_calls;
+}
+
+static void az_pipeline_metrics_test(void** state)
+{
+  (void)state;
+
+  az_metrics_histogram total;
+  az_metrics_histogram time_to_first_byte;
+  az_metrics_histogram_init(&total);
+  az_metrics_histogram_init(&time_to_first_byte);
+  az_metrics_set_callback(test_metrics_callback);
+  az_metrics_set_histograms(&total, &time_to_first_byte);
+
+  // Each policy is timed in microseconds: test_policy_1 from 0 to 50500, test_policy_2 from 10 to
+  // 40.
+  will_return(__wrap_az_platform_clock_usec, 0);
+  will_return(__wrap_az_platform_clock_usec, 10);
+  will_return(__wrap_az_platform_clock_usec, 40);
+  will_return(__wrap_az_platform_clock_usec, 50500);
+  test_metrics_calls = 0;
+  test_az_http_pipeline_process();
+
+  assert_int_equal(test_metrics_calls, 1);
+  assert_return_code(test_metrics.result, AZ_OK);
+  assert_int_equal(test_metrics.retry_count, 0);
+  assert_int_equal(test_metrics.total_msec, 50);
+  assert_int_equal(test_metrics.policy_elapsed_usec[0], 50500);
+  assert_int_equal(test_metrics.policy_elapsed_usec[1], 30);
+  assert_int_equal(test_metrics.policy_elapsed_usec[2], 0);
+  assert_int_equal(test_metrics.time_to_first_byte_usec, 0);
+
+  // 50.5ms is counted by the bucket up to 64ms. No response was received, it has no first byte.
+  for (int32_t i = 0; i < AZ_METRICS_HISTOGRAM_BUCKETS; ++i)
+  {
+    int64_t upper_bound_msec = 0;
+    int64_t count = 0;
+    az_metrics_histogram_get_bucket(&total, i, &upper_bound_msec, &count);
+    assert_int_equal(upper_bound_msec, i < AZ_METRICS_HISTOGRAM_BUCKETS - 1 ? 1 << i : INT64_MAX);
+    assert_int_equal(count, i == 6 ? 1 : 0);
+
+    az_metrics_histogram_get_bucket(&time_to_first_byte, i, &upper_bound_msec, &count);
+    assert_int_equal(count, 0);
+  }
+
+  // Without a callback nor a histogram, requests aren't measured.
+  az_metrics_set_callback(NULL);
+  az_metrics_set_histograms(NULL, NULL);
+  test_az_http_pipeline_process();
+  assert_int_equal(test_metrics_calls, 1);
+}
+
+#endif // defined(_az_MOCK_ENABLED) && !defined(AZ_NO_METRICS)
+
 int test_az_pipeline()
 {
   const struct CMUnitTest tests[] = {
     cmocka_unit_test(az_pipeline_test),
+#if defined(_az_MOCK_ENABLED) && !defined(AZ_NO_METRICS)
+    cmocka_unit_test(az_pipeline_metrics_test),
+#endif // defined(_az_MOCK_ENABLED) && !defined(AZ_NO_METRICS)
   };
   return cmocka_run_group_tests_name("az_core_pipeline", tests, NULL, NULL);
 }
@@ -1,18 +1,26 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // SPDX-License-Identifier: MIT
 
+#include "az_deflate_private.h"
 #include "az_test_definitions.h"
 #include <azure/core/az_credentials.h>
 #include <azure/core/az_http.h>
 #include <azure/core/az_http_transport.h>
 #include <azure/core/az_span.h>
 #include <azure/core/internal/az_http_internal.h>
+#include <azure/core/internal/az_retry_internal.h>
+#include <azure/core/internal/az_span_internal.h>
+#include <azure/core/internal/az_spinlock_internal.h>
 
 #include <setjmp.h>
 #include <stdarg.h>
 
 #include <cmocka.h>
 
+#ifdef _az_MOCK_ENABLED
+#include <pthread.h>
+#endif // _az_MOCK_ENABLED
+
 #include <azure/core/_az_cfg.h>
 
 #ifdef _az_MOCK_ENABLED
@@ -37,6 +45,15 @@ void test_az_http_pipeline_policy_credential(void** state);
 void test_az_http_pipeline_policy_retry(void** state);
 void test_az_http_pipeline_policy_retry_with_header(void** state);
 void test_az_http_pipeline_policy_retry_with_header_2(void** state);
+void test_az_http_pipeline_policy_retry_async(void** state);
+void test_az_http_pipeline_policy_retry_budget(void** state);
+void test_az_http_pipeline_policy_retry_circuit_breaker(void** state);
+void test_az_http_pipeline_policy_retry_rate_limiter(void** state);
+void test_az_http_pipeline_policy_hedging(void** state);
+void test_az_http_pipeline_policy_retry_timeout(void** state);
+void test_az_http_pipeline_policy_retry_timeout_streamed_body(void** state);
+void test_az_http_pipeline_policy_single_flight(void** state);
+void test_az_http_pipeline_policy_bulkhead(void** state);
 #endif // _az_MOCK_ENABLED
 
 static az_result test_policy_transport(
@@ -47,6 +64,9 @@ static az_result test_policy_transport(
 
 void test_az_http_pipeline_policy_apiversion(void** state);
 void test_az_http_pipeline_policy_telemetry(void** state);
+void test_az_retry_calc_decorrelated_delay(void** state);
+void test_az_http_pipeline_policy_cache(void** state);
+void test_az_http_pipeline_policy_compression(void** state);
 
 az_result test_policy_transport(
     _az_http_policy* ref_policies,
@@ -153,6 +173,331 @@ void test_az_http_pipeline_policy_apiversion(void** state)
       az_http_pipeline_policy_apiversion(policies, &api_version, &request, NULL), AZ_OK);
 }
 
+void test_az_retry_calc_decorrelated_delay(void** state)
+{
+  (void)state;
+
+  // The first delay is between the base delay and three times it.
+  assert_int_equal(_az_retry_calc_decorrelated_delay(0, 100, 10000, 0), 100);
+  assert_int_equal(_az_retry_calc_decorrelated_delay(0, 100, 10000, 200), 300);
+  assert_int_equal(_az_retry_calc_decorrelated_delay(0, 100, 10000, 201), 100);
+
+  // The next ones are up to three times the previous one.
+  assert_int_equal(_az_retry_calc_decorrelated_delay(1000, 100, 10000, 2900), 3000);
+  assert_int_equal(_az_retry_calc_decorrelated_delay(1000, 100, 10000, 2901), 100);
+
+  // Capped at the maximum delay.
+  for (uint32_t random = UINT32_MAX - 10; random != 0; ++random)
+  {
+    int32_t const delay = _az_retry_calc_decorrelated_delay(5000, 100, 10000, random);
+    assert_true(delay >= 100 && delay <= 10000);
+  }
+  assert_int_equal(_az_retry_calc_decorrelated_delay(0, 500, 300, 12345), 300);
+
+  // No overflow.
+  int32_t const delay = _az_retry_calc_decorrelated_delay(INT32_MAX, 1, INT32_MAX, UINT32_MAX);
+  assert_true(delay >= 1 && delay <= INT32_MAX);
+}
+
+static az_span test_cache_response;
+static az_span test_cache_if_none_match;
+
+// Checks the If-None-Match header of the request, and replies with test_cache_response.
+static az_result test_policy_transport_cache(
+    _az_http_policy* ref_policies,
+    void* ref_options,
+    az_http_request* ref_request,
+    az_http_response* ref_response)
+{
+  (void)ref_policies;
+  (void)ref_options;
+
+  az_span if_none_match = AZ_SPAN_NULL;
+  for (int32_t i = 0; i < az_http_request_headers_count(ref_request); ++i)
+  {
+    az_pair header = { 0 };
+    assert_return_code(az_http_request_get_header(ref_request, i, &header), AZ_OK);
+    if (az_span_is_content_equal(header.key, AZ_SPAN_FROM_STR("If-None-Match")))
+    {
+      if_none_match = header.value;
+    }
+  }
+  assert_true(az_span_is_content_equal(if_none_match, test_cache_if_none_match));
+
+  return az_http_response_append(ref_response, test_cache_response);
+}
+
+// Sends a request through the cache policy, and returns its status and body.
+static void test_policy_cache_send(
+    az_http_policy_cache* ref_cache,
+    az_http_method method,
+    az_span response_buffer,
+    az_http_status_code* out_status_code,
+    az_span* out_body)
+{
+  uint8_t url_buf[100];
+  uint8_t header_buf[(2 * sizeof(az_pair))];
+  az_span const url = AZ_SPAN_FROM_STR("https://account.blob.core.windows.net/container/blob");
+  az_span_copy(AZ_SPAN_FROM_BUFFER(url_buf), url);
+
+  az_http_request request;
+  assert_return_code(
+      az_http_request_init(
+          &request,
+          &az_context_application,
+          method,
+          AZ_SPAN_FROM_BUFFER(url_buf),
+          az_span_size(url),
+          AZ_SPAN_FROM_BUFFER(header_buf),
+          AZ_SPAN_NULL),
+      AZ_OK);
+
+  _az_http_policy policies[1] = {
+    {
+      ._internal = {
+        .process = test_policy_transport_cache,
+        .options = NULL,
+      },
+    },
+  };
+
+  az_http_response response;
+  assert_return_code(az_http_response_init(&response, response_buffer), AZ_OK);
+  assert_return_code(
+      az_http_pipeline_policy_cache(policies, ref_cache, &request, &response), AZ_OK);
+
+  // The conditional headers aren't left in the request.
+  assert_int_equal(az_http_request_headers_count(&request), 0);
+
+  az_http_response_status_line status_line = { 0 };
+  assert_return_code(az_http_response_get_status_line(&response, &status_line), AZ_OK);
+  *out_status_code = status_line.status_code;
+  assert_return_code(az_http_response_get_body(&response, out_body), AZ_OK);
+
+  // The body ends where the response written to the buffer ends.
+  *out_body = az_span_slice(
+      *out_body,
+      0,
+      response._internal.written
+          - (int32_t)(az_span_ptr(*out_body) - az_span_ptr(response_buffer)));
+}
+
+void test_az_http_pipeline_policy_cache(void** state)
+{
+  (void)state;
+
+  uint8_t cache_buffer[_az_HTTP_POLICY_CACHE_ENTRIES * 128];
+  az_http_policy_cache cache;
+  az_http_policy_cache_init(&cache, AZ_SPAN_FROM_BUFFER(cache_buffer));
+
+  uint8_t response_buffer[256];
+  az_http_status_code status_code = AZ_HTTP_STATUS_CODE_NONE;
+  az_span body = AZ_SPAN_NULL;
+
+  // The first response is cached.
+  test_cache_response
+      = AZ_SPAN_FROM_STR("HTTP/1.1 200 OK\r\nETag: \"1\"\r\nContent-Length: 4\r\n\r\nblob");
+  test_cache_if_none_match = AZ_SPAN_NULL;
+  test_policy_cache_send(
+      &cache, az_http_method_get(), AZ_SPAN_FROM_BUFFER(response_buffer), &status_code, &body);
+  assert_int_equal(status_code, AZ_HTTP_STATUS_CODE_OK);
+  assert_true(az_span_is_content_equal(body, AZ_SPAN_FROM_STR("blob")));
+
+  // The next request is conditional, and the cached response replaces the 304.
+  test_cache_response = AZ_SPAN_FROM_STR("HTTP/1.1 304 Not Modified\r\nETag: \"1\"\r\n\r\n");
+  test_cache_if_none_match = AZ_SPAN_FROM_STR("\"1\"");
+  test_policy_cache_send(
+      &cache, az_http_method_get(), AZ_SPAN_FROM_BUFFER(response_buffer), &status_code, &body);
+  assert_int_equal(status_code, AZ_HTTP_STATUS_CODE_OK);
+  assert_true(az_span_is_content_equal(body, AZ_SPAN_FROM_STR("blob")));
+
+  // Other methods aren't cached, nor made conditional.
+  test_cache_response = AZ_SPAN_FROM_STR("HTTP/1.1 201 Created\r\n\r\n");
+  test_cache_if_none_match = AZ_SPAN_NULL;
+  test_policy_cache_send(
+      &cache, az_http_method_put(), AZ_SPAN_FROM_BUFFER(response_buffer), &status_code, &body);
+  assert_int_equal(status_code, AZ_HTTP_STATUS_CODE_CREATED);
+
+  // A changed blob replaces the cached response.
+  test_cache_response
+      = AZ_SPAN_FROM_STR("HTTP/1.1 200 OK\r\nETag: \"2\"\r\nContent-Length: 5\r\n\r\nblob2");
+  test_cache_if_none_match = AZ_SPAN_FROM_STR("\"1\"");
+  test_policy_cache_send(
+      &cache, az_http_method_get(), AZ_SPAN_FROM_BUFFER(response_buffer), &status_code, &body);
+  assert_true(az_span_is_content_equal(body, AZ_SPAN_FROM_STR("blob2")));
+  assert_true(
+      az_span_is_content_equal(cache._internal.entries[0].etag, AZ_SPAN_FROM_STR("\"2\"")));
+
+  // Any other response evicts it.
+  test_cache_response = AZ_SPAN_FROM_STR("HTTP/1.1 404 Not Found\r\n\r\n");
+  test_cache_if_none_match = AZ_SPAN_FROM_STR("\"2\"");
+  test_policy_cache_send(
+      &cache, az_http_method_get(), AZ_SPAN_FROM_BUFFER(response_buffer), &status_code, &body);
+  assert_int_equal(status_code, AZ_HTTP_STATUS_CODE_NOT_FOUND);
+  assert_false(cache._internal.entries[0].is_used);
+
+  // Responses that don't fit in an entry aren't cached.
+  uint8_t small_cache_buffer[_az_HTTP_POLICY_CACHE_ENTRIES * 16];
+  az_http_policy_cache_init(&cache, AZ_SPAN_FROM_BUFFER(small_cache_buffer));
+  test_cache_response
+      = AZ_SPAN_FROM_STR("HTTP/1.1 200 OK\r\nETag: \"1\"\r\nContent-Length: 4\r\n\r\nblob");
+  test_cache_if_none_match = AZ_SPAN_NULL;
+  test_policy_cache_send(
+      &cache, az_http_method_get(), AZ_SPAN_FROM_BUFFER(response_buffer), &status_code, &body);
+  assert_false(cache._internal.entries[0].is_used);
+}
+
+static az_span test_compression_body;
+static az_span test_compression_content_encoding;
+static uint8_t test_compression_content_length_buffer[20];
+static az_span test_compression_content_length;
+
+// Records the body, and the Content-Encoding and Content-Length headers of the request.
+static az_result test_policy_transport_compression(
+    _az_http_policy* ref_policies,
+    void* ref_options,
+    az_http_request* ref_request,
+    az_http_response* ref_response)
+{
+  (void)ref_policies;
+  (void)ref_options;
+  (void)ref_response;
+
+  test_compression_content_encoding = AZ_SPAN_NULL;
+  test_compression_content_length = AZ_SPAN_NULL;
+  for (int32_t i = 0; i < az_http_request_headers_count(ref_request); ++i)
+  {
+    az_pair header = { 0 };
+    assert_return_code(az_http_request_get_header(ref_request, i, &header), AZ_OK);
+    if (az_span_is_content_equal(header.key, AZ_SPAN_FROM_STR("Content-Encoding")))
+    {
+      test_compression_content_encoding = header.value;
+    }
+    else if (az_span_is_content_equal(header.key, AZ_SPAN_FROM_STR("Content-Length")))
+    {
+      // The value may be on the stack of the policy.
+      az_span const buffer = AZ_SPAN_FROM_BUFFER(test_compression_content_length_buffer);
+      test_compression_content_length = az_span_slice(
+          buffer, 0, _az_span_diff(az_span_copy(buffer, header.value), buffer));
+    }
+  }
+
+  return az_http_request_get_body(ref_request, &test_compression_body);
+}
+
+// Sends a PUT request with body through the compression policy.
+static void
+test_policy_compression_send(az_http_policy_compression* ref_compression, az_span body)
+{
+  uint8_t url_buf[100];
+  uint8_t header_buf[(2 * sizeof(az_pair))];
+  az_span const url = AZ_SPAN_FROM_STR("https://account.blob.core.windows.net/container/blob");
+  az_span_copy(AZ_SPAN_FROM_BUFFER(url_buf), url);
+
+  az_http_request request;
+  assert_return_code(
+      az_http_request_init(
+          &request,
+          &az_context_application,
+          az_http_method_put(),
+          AZ_SPAN_FROM_BUFFER(url_buf),
+          az_span_size(url),
+          AZ_SPAN_FROM_BUFFER(header_buf),
+          body),
+      AZ_OK);
+  assert_return_code(
+      az_http_request_append_header(
+          &request, AZ_SPAN_FROM_STR("Content-Length"), AZ_SPAN_FROM_STR("original")),
+      AZ_OK);
+
+  _az_http_policy policies[1] = {
+    {
+      ._internal = {
+        .process = test_policy_transport_compression,
+        .options = NULL,
+      },
+    },
+  };
+
+  az_http_response response = { 0 };
+  assert_return_code(
+      az_http_pipeline_policy_compression(policies, ref_compression, &request, &response), AZ_OK);
+
+  // The request is left as it was.
+  az_pair header = { 0 };
+  assert_int_equal(az_http_request_headers_count(&request), 1);
+  assert_return_code(az_http_request_get_header(&request, 0, &header), AZ_OK);
+  assert_true(az_span_is_content_equal(header.value, AZ_SPAN_FROM_STR("original")));
+  assert_true(az_span_ptr(request._internal.body) == az_span_ptr(body));
+}
+
+void test_az_http_pipeline_policy_compression(void** state)
+{
+  (void)state;
+
+  // The check value of CRC-32.
+  assert_int_equal(_az_crc32(0, AZ_SPAN_FROM_STR("123456789")), 0xCBF43926);
+  assert_int_equal(
+      _az_crc32(_az_crc32(0, AZ_SPAN_FROM_STR("12345")), AZ_SPAN_FROM_STR("6789")), 0xCBF43926);
+
+  uint8_t body_buffer[512];
+  az_span remainder = AZ_SPAN_FROM_BUFFER(body_buffer);
+  for (int32_t i = 0; az_span_size(remainder) >= 32; ++i)
+  {
+    remainder = az_span_copy(remainder, AZ_SPAN_FROM_STR("{\"deviceId\":\"sensor\",\"t\":"));
+    remainder = az_span_copy_u8(remainder, (uint8_t)('0' + i % 10));
+    remainder = az_span_copy(remainder, AZ_SPAN_FROM_STR("},"));
+  }
+  az_span const body = az_span_slice(
+      AZ_SPAN_FROM_BUFFER(body_buffer),
+      0,
+      _az_span_diff(remainder, AZ_SPAN_FROM_BUFFER(body_buffer)));
+
+  uint8_t compression_buffer[256];
+  static az_http_policy_compression compression;
+  az_http_policy_compression_init(&compression, AZ_SPAN_FROM_BUFFER(compression_buffer), 64);
+
+  // The body is sent compressed, with its size.
+  test_policy_compression_send(&compression, body);
+  assert_true(
+      az_span_is_content_equal(test_compression_content_encoding, AZ_SPAN_FROM_STR("gzip")));
+  int32_t const size = az_span_size(test_compression_body);
+  assert_true(size < az_span_size(body) / 4);
+  int32_t content_length = 0;
+  assert_return_code(az_span_atoi32(test_compression_content_length, &content_length), AZ_OK);
+  assert_int_equal(content_length, size);
+
+  // A gzip member with the body in a single block of dynamic Huffman codes, followed by the CRC-32
+  // and the size of the body. gzip -d inflates it back to the body.
+  static uint8_t const expected_compressed[] = {
+    0x1F, 0x8B, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF, 0xD5, 0xD0,
+    0xBB, 0x11, 0x80, 0x20, 0x14, 0x45, 0xC1, 0x5E, 0x6E, 0x4C, 0x80, 0x7F,
+    0xA5, 0x03, 0xEB, 0x90, 0x17, 0x98, 0xE8, 0x8C, 0x38, 0x26, 0x0E, 0xBD,
+    0x53, 0x01, 0x27, 0x27, 0xDE, 0x6C, 0x7F, 0x45, 0xFB, 0xCE, 0xC3, 0xF6,
+    0xA8, 0xA0, 0x64, 0x57, 0xBA, 0x1F, 0x39, 0xBD, 0x0A, 0x3E, 0xBB, 0xAA,
+    0x75, 0x60, 0x3D, 0xD8, 0x00, 0x36, 0x82, 0x4D, 0x60, 0x33, 0xD8, 0x02,
+    0xB6, 0x82, 0x6D, 0x60, 0x1E, 0xAC, 0xA1, 0x97, 0x02, 0x68, 0xE8, 0x26,
+    0xFA, 0xF8, 0x01, 0x00, 0x00,
+  };
+  assert_int_equal(size, sizeof(expected_compressed));
+  assert_memory_equal(az_span_ptr(test_compression_body), expected_compressed, (size_t)size);
+  assert_false(compression._internal.is_busy);
+
+  // Smaller bodies, and bodies that don't get smaller, are sent as they are.
+  test_policy_compression_send(&compression, az_span_slice(body, 0, 63));
+  assert_true(az_span_size(test_compression_content_encoding) == 0);
+  assert_true(
+      az_span_is_content_equal(test_compression_content_length, AZ_SPAN_FROM_STR("original")));
+  assert_int_equal(az_span_size(test_compression_body), 63);
+
+  test_policy_compression_send(
+      &compression,
+      AZ_SPAN_FROM_STR("0123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ+/"));
+  assert_true(az_span_size(test_compression_content_encoding) == 0);
+  assert_int_equal(az_span_size(test_compression_body), 64);
+  assert_false(compression._internal.is_busy);
+}
+
 #ifdef _az_MOCK_ENABLED
 
 const az_span retry_response = AZ_SPAN_LITERAL_FROM_STR("HTTP/1.1 408 Request Timeout\r\n"
@@ -358,6 +703,1039 @@ void test_az_http_pipeline_policy_retry_with_header_2(void** state)
       az_http_pipeline_policy_retry(policies, &retry_options, &request, &response), AZ_OK);
 }
 
+static az_result test_policy_transport_async(
+    _az_http_policy* ref_policies,
+    void* ref_options,
+    az_http_request* ref_request,
+    az_http_response* ref_response)
+{
+  (void)ref_policies;
+  (void)ref_options;
+  (void)ref_response;
+
+  _az_http_async_state* const async_state = _az_http_request_get_async_state(ref_request);
+  assert_non_null(async_state);
+
+  az_span url = { 0 };
+  assert_return_code(az_http_request_get_url(ref_request, &url), AZ_OK);
+  assert_true(az_span_is_content_equal(url, AZ_SPAN_FROM_STR("url")));
+
+  az_pair header = { 0 };
+  assert_int_equal(az_http_request_headers_count(ref_request), 1);
+  assert_return_code(az_http_request_get_header(ref_request, 0, &header), AZ_OK);
+  assert_true(az_span_is_content_equal(header.key, AZ_SPAN_FROM_STR("key")));
+  assert_true(az_span_is_content_equal(header.value, AZ_SPAN_FROM_STR("value")));
+
+  az_result result = AZ_OK;
+  if (_az_http_async_state_take_result(async_state, &result))
+  {
+    return result;
+  }
+
+  return AZ_HTTP_REQUEST_PENDING;
+}
+
+void test_az_http_pipeline_policy_retry_async(void** state)
+{
+  (void)state;
+
+  uint8_t async_buf[256];
+  _az_http_async_state async_state;
+  assert_return_code(
+      _az_http_async_state_init(&async_state, NULL, AZ_SPAN_FROM_BUFFER(async_buf)), AZ_OK);
+
+  uint8_t buf[100];
+  uint8_t header_buf[(2 * sizeof(az_pair))];
+  uint8_t header_value_buf[5];
+  memset(buf, 0, sizeof(buf));
+  memset(header_buf, 0, sizeof(header_buf));
+
+  az_span url_span = AZ_SPAN_FROM_BUFFER(buf);
+  az_span_copy(url_span, AZ_SPAN_FROM_STR("url"));
+  az_span header_value = AZ_SPAN_FROM_BUFFER(header_value_buf);
+  az_span_copy(header_value, AZ_SPAN_FROM_STR("value"));
+  az_http_request request;
+
+  assert_return_code(
+      az_http_request_init(
+          &request,
+          &async_state._internal.context,
+          az_http_method_get(),
+          url_span,
+          3,
+          AZ_SPAN_FROM_BUFFER(header_buf),
+          AZ_SPAN_NULL),
+      AZ_OK);
+  assert_return_code(
+      az_http_request_append_header(&request, AZ_SPAN_FROM_STR("key"), header_value), AZ_OK);
+
+  az_http_policy_retry_options retry_options = _az_http_policy_retry_options_default();
+
+  _az_http_policy policies[1] = {
+    {
+      ._internal = {
+        .process = test_policy_transport_async,
+        .options = NULL,
+      },
+    },
+  };
+
+  uint8_t response_buf[10];
+  az_http_response response;
+  assert_return_code(az_http_response_init(&response, AZ_SPAN_FROM_BUFFER(response_buf)), AZ_OK);
+
+  // The request is submitted, the policy returns without waiting for the response.
+  assert_int_equal(
+      az_http_pipeline_policy_retry(policies, &retry_options, &request, &response),
+      AZ_HTTP_REQUEST_PENDING);
+  assert_int_equal(async_state._internal.attempt, 1);
+
+  // The caller's buffers are gone by the time the response is received.
+  memset(buf, 0, sizeof(buf));
+  memset(header_buf, 0, sizeof(header_buf));
+  memset(header_value_buf, 0, sizeof(header_value_buf));
+
+  // A retriable response gets the request sent again, after a delay set for the transport.
+  assert_return_code(az_http_response_init(&response, retry_response), AZ_OK);
+  will_return_count(__wrap_az_platform_clock_msec, 1000, 2);
+  assert_int_equal(
+      _az_http_async_state_complete(&async_state, AZ_OK, &response), AZ_HTTP_REQUEST_PENDING);
+  assert_int_equal(async_state._internal.attempt, 2);
+  assert_true(async_state._internal.not_before_msec > 1000);
+
+  // A successful response completes the request.
+  az_span const ok_response = AZ_SPAN_FROM_STR("HTTP/1.1 200 OK\r\n\r\n");
+  assert_return_code(az_http_response_init(&response, ok_response), AZ_OK);
+  assert_return_code(_az_http_async_state_complete(&async_state, AZ_OK, &response), AZ_OK);
+
+  az_http_response_status_line status_line = { 0 };
+  assert_return_code(az_http_response_get_status_line(&response, &status_line), AZ_OK);
+  assert_int_equal(status_line.status_code, AZ_HTTP_STATUS_CODE_OK);
+}
+
+static int32_t test_policy_transport_calls = 0;
+static az_span test_policy_transport_response = { 0 };
+
+static az_result test_policy_transport_counted(
+    _az_http_policy* ref_policies,
+    void* ref_options,
+    az_http_request* ref_request,
+    az_http_response* ref_response)
+{
+  (void)ref_policies;
+  (void)ref_options;
+  (void)ref_request;
+  ++test_policy_transport_calls;
+  assert_return_code(az_http_response_init(ref_response, test_policy_transport_response), AZ_OK);
+  return AZ_OK;
+}
+
+// Sends a request to url with context through the retry policy, the transport is process.
+static az_result test_policy_retry_send_with(
+    az_http_policy_retry_options* options,
+    az_context* context,
+    az_span url,
+    _az_http_policy_process_fn process,
+    az_span response)
+{
+  uint8_t url_buf[100];
+  uint8_t header_buf[(2 * sizeof(az_pair))];
+  az_span_copy(AZ_SPAN_FROM_BUFFER(url_buf), url);
+
+  az_http_request request;
+  assert_return_code(
+      az_http_request_init(
+          &request,
+          context,
+          az_http_method_get(),
+          AZ_SPAN_FROM_BUFFER(url_buf),
+          az_span_size(url),
+          AZ_SPAN_FROM_BUFFER(header_buf),
+          AZ_SPAN_NULL),
+      AZ_OK);
+
+  _az_http_policy policies[1] = {
+    {
+      ._internal = {
+        .process = process,
+        .options = NULL,
+      },
+    },
+  };
+
+  test_policy_transport_response = response;
+  az_http_response http_response;
+  return az_http_pipeline_policy_retry(policies, options, &request, &http_response);
+}
+
+// Sends a request to url through the retry policy, the transport returns response.
+static az_result test_policy_retry_send(
+    az_http_policy_retry_options* options,
+    az_span url,
+    az_span response)
+{
+  return test_policy_retry_send_with(
+      options, &az_context_application, url, test_policy_transport_counted, response);
+}
+
+void test_az_http_pipeline_policy_retry_budget(void** state)
+{
+  (void)state;
+
+  az_http_policy_retry_budget budget;
+  az_http_policy_retry_budget_init(&budget, 1);
+
+  az_http_policy_retry_options retry_options = _az_http_policy_retry_options_default();
+  retry_options.budget = &budget;
+
+  az_span const url = AZ_SPAN_FROM_STR("https://account.blob.core.windows.net/container");
+  az_span const ok_response = AZ_SPAN_FROM_STR("HTTP/1.1 200 OK\r\n\r\n");
+  test_policy_transport_calls = 0;
+
+  // The budget allows a single retry, then it is empty.
+  will_return(__wrap_az_platform_clock_msec, 0);
+  assert_return_code(test_policy_retry_send(&retry_options, url, retry_response), AZ_OK);
+  assert_int_equal(test_policy_transport_calls, 2);
+
+  assert_return_code(test_policy_retry_send(&retry_options, url, retry_response), AZ_OK);
+  assert_int_equal(test_policy_transport_calls, 3);
+
+  // Ten successful requests earn a retry back.
+  for (int32_t i = 0; i < 10; ++i)
+  {
+    assert_return_code(test_policy_retry_send(&retry_options, url, ok_response), AZ_OK);
+  }
+  assert_int_equal(test_policy_transport_calls, 13);
+
+  will_return(__wrap_az_platform_clock_msec, 0);
+  assert_return_code(test_policy_retry_send(&retry_options, url, retry_response), AZ_OK);
+  assert_int_equal(test_policy_transport_calls, 15);
+}
+
+static az_result test_policy_transport_failure = AZ_OK;
+
+// Fails with test_policy_transport_failure.
+static az_result test_policy_transport_failing(
+    _az_http_policy* ref_policies,
+    void* ref_options,
+    az_http_request* ref_request,
+    az_http_response* ref_response)
+{
+  (void)ref_policies;
+  (void)ref_options;
+  (void)ref_request;
+  (void)ref_response;
+  ++test_policy_transport_calls;
+  return test_policy_transport_failure;
+}
+
+void test_az_http_pipeline_policy_retry_circuit_breaker(void** state)
+{
+  (void)state;
+
+  az_http_policy_retry_circuit_breaker circuit_breaker;
+  az_http_policy_retry_circuit_breaker_init(&circuit_breaker, 2, 1000);
+
+  az_http_policy_retry_options retry_options = _az_http_policy_retry_options_default();
+  retry_options.circuit_breaker = &circuit_breaker;
+
+  az_span const url = AZ_SPAN_FROM_STR("https://account.blob.core.windows.net/container?comp=list");
+  az_span const other_url = AZ_SPAN_FROM_STR("https://other.blob.core.windows.net/container");
+  az_span const ok_response = AZ_SPAN_FROM_STR("HTTP/1.1 200 OK\r\n\r\n");
+  test_policy_transport_calls = 0;
+
+  // The second failed attempt opens the circuit, which stops the retries.
+  will_return(__wrap_az_platform_clock_msec, 0); // After the delay of the first retry.
+  will_return(__wrap_az_platform_clock_msec, 100); // When the circuit opens.
+  assert_return_code(test_policy_retry_send(&retry_options, url, retry_response), AZ_OK);
+  assert_int_equal(test_policy_transport_calls, 2);
+
+  // Requests to the host fail fast while the circuit is open.
+  will_return(__wrap_az_platform_clock_msec, 1099);
+  assert_int_equal(
+      test_policy_retry_send(&retry_options, url, ok_response), AZ_ERROR_HTTP_CIRCUIT_OPEN);
+  assert_int_equal(test_policy_transport_calls, 2);
+
+  // Other hosts aren't affected.
+  assert_return_code(test_policy_retry_send(&retry_options, other_url, ok_response), AZ_OK);
+  assert_int_equal(test_policy_transport_calls, 3);
+
+  // Once the open duration has elapsed, a probe goes through, its success closes the circuit.
+  will_return(__wrap_az_platform_clock_msec, 1100);
+  assert_return_code(test_policy_retry_send(&retry_options, url, ok_response), AZ_OK);
+  assert_int_equal(test_policy_transport_calls, 4);
+
+  assert_return_code(test_policy_retry_send(&retry_options, url, ok_response), AZ_OK);
+  assert_int_equal(test_policy_transport_calls, 5);
+
+  // A failed probe opens the circuit again.
+  will_return(__wrap_az_platform_clock_msec, 0);
+  will_return(__wrap_az_platform_clock_msec, 2000);
+  assert_return_code(test_policy_retry_send(&retry_options, url, retry_response), AZ_OK);
+  assert_int_equal(test_policy_transport_calls, 7);
+
+  will_return(__wrap_az_platform_clock_msec, 3000);
+  will_return(__wrap_az_platform_clock_msec, 3000);
+  assert_return_code(test_policy_retry_send(&retry_options, url, retry_response), AZ_OK);
+  assert_int_equal(test_policy_transport_calls, 8);
+
+  will_return(__wrap_az_platform_clock_msec, 3500);
+  assert_int_equal(
+      test_policy_retry_send(&retry_options, url, ok_response), AZ_ERROR_HTTP_CIRCUIT_OPEN);
+  assert_int_equal(test_policy_transport_calls, 8);
+
+  // The failures on the side of the client aren't counted, the ones of the transport are.
+  az_http_policy_retry_circuit_breaker_init(&circuit_breaker, 2, 1000);
+  retry_options.max_retries = 0;
+  test_policy_transport_calls = 0;
+  test_policy_transport_failure = AZ_ERROR_HTTP_RESPONSE_OVERFLOW;
+  for (int32_t i = 0; i < 2; ++i)
+  {
+    assert_int_equal(
+        test_policy_retry_send_with(
+            &retry_options,
+            &az_context_application,
+            url,
+            test_policy_transport_failing,
+            ok_response),
+        AZ_ERROR_HTTP_RESPONSE_OVERFLOW);
+  }
+
+  test_policy_transport_failure = AZ_ERROR_HTTP_PLATFORM;
+  assert_int_equal(
+      test_policy_retry_send_with(
+          &retry_options, &az_context_application, url, test_policy_transport_failing, ok_response),
+      AZ_ERROR_HTTP_PLATFORM);
+
+  will_return(__wrap_az_platform_clock_msec, 5000); // When the circuit opens.
+  assert_int_equal(
+      test_policy_retry_send_with(
+          &retry_options, &az_context_application, url, test_policy_transport_failing, ok_response),
+      AZ_ERROR_HTTP_PLATFORM);
+  assert_int_equal(test_policy_transport_calls, 4);
+
+  will_return(__wrap_az_platform_clock_msec, 5500);
+  assert_int_equal(
+      test_policy_retry_send(&retry_options, url, ok_response), AZ_ERROR_HTTP_CIRCUIT_OPEN);
+  assert_int_equal(test_policy_transport_calls, 4);
+
+  // Hosts whose hashes collide have circuits of their own.
+  az_http_policy_retry_circuit_breaker_init(&circuit_breaker, 1, 1000);
+  test_policy_transport_calls = 0;
+  will_return(__wrap_az_platform_clock_msec, 6000); // When the circuit opens.
+  assert_int_equal(
+      test_policy_retry_send_with(
+          &retry_options,
+          &az_context_application,
+          AZ_SPAN_FROM_STR("https://h84337.blob.core.windows.net/container"),
+          test_policy_transport_failing,
+          ok_response),
+      AZ_ERROR_HTTP_PLATFORM);
+
+  assert_return_code(
+      test_policy_retry_send(
+          &retry_options,
+          AZ_SPAN_FROM_STR("https://h1340180.blob.core.windows.net/container"),
+          ok_response),
+      AZ_OK);
+  assert_int_equal(test_policy_transport_calls, 2);
+}
+
+void test_az_http_pipeline_policy_retry_rate_limiter(void** state)
+{
+  (void)state;
+
+  az_http_policy_rate_limiter rate_limiter;
+  az_http_policy_rate_limiter_init(&rate_limiter);
+
+  az_http_policy_retry_options retry_options = _az_http_policy_retry_options_default();
+  retry_options.max_retries = 0;
+  retry_options.rate_limiter = &rate_limiter;
+
+  az_span const url = AZ_SPAN_FROM_STR("https://account.blob.core.windows.net/container");
+  az_span const ok_response = AZ_SPAN_FROM_STR("HTTP/1.1 200 OK\r\n\r\n");
+  az_span const throttled_response
+      = AZ_SPAN_FROM_STR("HTTP/1.1 503 Server Busy\r\n"
+                         "Date: Wed, 14 Oct 2020 17:05:12 GMT\r\n"
+                         "Retry-After: Wed, 14 Oct 2020 17:05:17 GMT\r\n"
+                         "\r\n");
+  az_span const throttled_response_without_header
+      = AZ_SPAN_FROM_STR("HTTP/1.1 429 Too Many Requests\r\n\r\n");
+
+  // Requests aren't paced until one is throttled. Each request reads the clock when it takes its
+  // turn, and when it gets its response.
+  will_return(__wrap_az_platform_clock_msec, 0);
+  will_return(__wrap_az_platform_clock_msec, 10);
+  assert_return_code(test_policy_retry_send(&retry_options, url, ok_response), AZ_OK);
+  assert_true(rate_limiter._internal.rate == 0);
+
+  // Two requests were sent in the first second, the rate is set to 70% of that, and no request is
+  // sent until the date in Retry-After, 5 seconds later.
+  will_return(__wrap_az_platform_clock_msec, 20);
+  will_return(__wrap_az_platform_clock_msec, 30);
+  assert_return_code(test_policy_retry_send(&retry_options, url, throttled_response), AZ_OK);
+  assert_true(rate_limiter._internal.rate == 1400);
+  assert_true(rate_limiter._internal.blocked_until_msec == 5030);
+
+  // The requests that were in flight don't decrease the rate again.
+  will_return(__wrap_az_platform_clock_msec, 40);
+  will_return(__wrap_az_platform_clock_msec, 50);
+  assert_return_code(
+      test_policy_retry_send(&retry_options, url, throttled_response_without_header), AZ_OK);
+  assert_true(rate_limiter._internal.rate == 1400);
+  assert_true(rate_limiter._internal.blocked_until_msec == 5030);
+  assert_true(rate_limiter._internal.next_send_usec == 5030000 + 714285);
+
+  // The next request is paced, and its success increases the rate.
+  will_return(__wrap_az_platform_clock_msec, 60);
+  will_return(__wrap_az_platform_clock_msec, 5750);
+  assert_return_code(test_policy_retry_send(&retry_options, url, ok_response), AZ_OK);
+  assert_true(rate_limiter._internal.next_send_usec == 5030000 + 2 * 714285);
+  assert_true(rate_limiter._internal.rate == 1400 + 715);
+}
+
+static int32_t test_policy_transport_hedge_delay_msec = -1;
+static int64_t test_policy_transport_time_to_first_byte_msec = -1;
+
+static az_result test_policy_transport_hedging(
+    _az_http_policy* ref_policies,
+    void* ref_options,
+    az_http_request* ref_request,
+    az_http_response* ref_response)
+{
+  (void)ref_policies;
+  (void)ref_options;
+  (void)ref_response;
+  test_policy_transport_hedge_delay_msec = ref_request->_internal.hedge_delay_msec;
+  if (ref_request->_internal.time_to_first_byte_msec != NULL
+      && test_policy_transport_time_to_first_byte_msec >= 0)
+  {
+    *ref_request->_internal.time_to_first_byte_msec = test_policy_transport_time_to_first_byte_msec;
+  }
+  return AZ_OK;
+}
+
+// Sends a request through the hedging policy, the transport records its hedge delay and reports
+// \p time_to_first_byte_msec, unless it is negative.
+static az_result test_policy_hedging_send(
+    az_http_policy_hedging* hedging,
+    az_http_method method,
+    int64_t time_to_first_byte_msec)
+{
+  uint8_t url_buf[100];
+  uint8_t header_buf[(2 * sizeof(az_pair))];
+  az_span const url = AZ_SPAN_FROM_STR("https://account.blob.core.windows.net/container/blob");
+  az_span_copy(AZ_SPAN_FROM_BUFFER(url_buf), url);
+
+  az_http_request request;
+  assert_return_code(
+      az_http_request_init(
+          &request,
+          &az_context_application,
+          method,
+          AZ_SPAN_FROM_BUFFER(url_buf),
+          az_span_size(url),
+          AZ_SPAN_FROM_BUFFER(header_buf),
+          AZ_SPAN_NULL),
+      AZ_OK);
+
+  _az_http_policy policies[1] = {
+    {
+      ._internal = {
+        .process = test_policy_transport_hedging,
+        .options = NULL,
+      },
+    },
+  };
+
+  test_policy_transport_hedge_delay_msec = -1;
+  test_policy_transport_time_to_first_byte_msec = time_to_first_byte_msec;
+  az_result const result = az_http_pipeline_policy_hedging(policies, hedging, &request, NULL);
+  assert_int_equal(request._internal.hedge_delay_msec, 0);
+  assert_null(request._internal.time_to_first_byte_msec);
+  return result;
+}
+
+void test_az_http_pipeline_policy_hedging(void** state)
+{
+  (void)state;
+
+  az_http_policy_hedging hedging;
+  az_http_policy_hedging_init(&hedging, 90, 5);
+
+  // Requests aren't hedged until enough times to first byte are known.
+  for (int32_t i = 1; i <= 20; ++i)
+  {
+    assert_return_code(test_policy_hedging_send(&hedging, az_http_method_get(), i), AZ_OK);
+    assert_int_equal(test_policy_transport_hedge_delay_msec, i <= 16 ? 0 : i - 2);
+  }
+
+  // Times to first byte of 1 to 20 msec: the 90th percentile is 18 msec.
+  assert_return_code(test_policy_hedging_send(&hedging, az_http_method_get(), 100), AZ_OK);
+  assert_int_equal(test_policy_transport_hedge_delay_msec, 18);
+
+  // Requests whose time to first byte the transport doesn't report aren't counted.
+  az_http_policy_hedging unmeasured_hedging;
+  az_http_policy_hedging_init(&unmeasured_hedging, 50, 5);
+  for (int32_t i = 0; i < 20; ++i)
+  {
+    assert_return_code(
+        test_policy_hedging_send(&unmeasured_hedging, az_http_method_get(), -1), AZ_OK);
+    assert_int_equal(test_policy_transport_hedge_delay_msec, 0);
+  }
+
+  // The delay isn't shorter than the minimum.
+  az_http_policy_hedging fast_hedging;
+  az_http_policy_hedging_init(&fast_hedging, 50, 5);
+  for (int32_t i = 0; i < 16; ++i)
+  {
+    assert_return_code(test_policy_hedging_send(&fast_hedging, az_http_method_get(), 0), AZ_OK);
+  }
+  assert_return_code(test_policy_hedging_send(&fast_hedging, az_http_method_head(), 0), AZ_OK);
+  assert_int_equal(test_policy_transport_hedge_delay_msec, 5);
+
+  // Requests that aren't idempotent aren't hedged.
+  assert_return_code(test_policy_hedging_send(&hedging, az_http_method_put(), 1), AZ_OK);
+  assert_int_equal(test_policy_transport_hedge_delay_msec, 0);
+  assert_return_code(test_policy_hedging_send(&hedging, az_http_method_post(), 1), AZ_OK);
+  assert_int_equal(test_policy_transport_hedge_delay_msec, 0);
+
+  // Nor are requests sent without hedging options.
+  assert_return_code(test_policy_hedging_send(NULL, az_http_method_get(), 1), AZ_OK);
+  assert_int_equal(test_policy_transport_hedge_delay_msec, 0);
+}
+
+// Times out on the first attempt, then returns test_policy_transport_response.
+static az_result test_policy_transport_timing_out(
+    _az_http_policy* ref_policies,
+    void* ref_options,
+    az_http_request* ref_request,
+    az_http_response* ref_response)
+{
+  assert_int_equal(ref_request->_internal.try_timeout_msec, 500);
+  if (test_policy_transport_calls == 0)
+  {
+    ++test_policy_transport_calls;
+    return AZ_ERROR_HTTP_ATTEMPT_TIMEOUT;
+  }
+
+  return test_policy_transport_counted(ref_policies, ref_options, ref_request, ref_response);
+}
+
+void test_az_http_pipeline_policy_retry_timeout(void** state)
+{
+  (void)state;
+
+  az_http_policy_retry_options retry_options = _az_http_policy_retry_options_default();
+  retry_options.try_timeout_msec = 500;
+  retry_options.retry_delay_msec = 100;
+  retry_options.max_retry_delay_msec = 100;
+
+  az_span const url = AZ_SPAN_FROM_STR("https://account.blob.core.windows.net/container");
+  az_span const ok_response = AZ_SPAN_FROM_STR("HTTP/1.1 200 OK\r\n\r\n");
+
+  // An attempt that timed out is retried.
+  test_policy_transport_calls = 0;
+  will_return(__wrap_az_platform_clock_msec, 0);
+  assert_return_code(
+      test_policy_retry_send_with(
+          &retry_options,
+          &az_context_application,
+          url,
+          test_policy_transport_timing_out,
+          ok_response),
+      AZ_OK);
+  assert_int_equal(test_policy_transport_calls, 2);
+
+  // A retry that would be sent after the deadline of the request isn't waited for, the last
+  // response is returned.
+  az_context context = az_context_create_with_expiration(&az_context_application, 1500);
+  test_policy_transport_calls = 0;
+  will_return(__wrap_az_platform_clock_msec, 1000); // Before the delay of the first retry.
+  will_return(__wrap_az_platform_clock_msec, 1100); // After it.
+  will_return(__wrap_az_platform_clock_msec, 1450); // Before the delay of the second retry.
+  assert_return_code(
+      test_policy_retry_send_with(
+          &retry_options, &context, url, test_policy_transport_counted, retry_response),
+      AZ_OK);
+  assert_int_equal(test_policy_transport_calls, 2);
+
+  // Nor is a retry once the deadline has passed.
+  test_policy_transport_calls = 0;
+  will_return(__wrap_az_platform_clock_msec, 1500);
+  assert_int_equal(
+      test_policy_retry_send_with(
+          &retry_options, &context, url, test_policy_transport_counted, retry_response),
+      AZ_ERROR_CANCELED);
+  assert_int_equal(test_policy_transport_calls, 1);
+}
+
+static int32_t test_streamed_body_size = 0;
+
+static az_result test_streamed_body_callback(az_span body_chunk, void* user_context)
+{
+  (void)user_context;
+  test_streamed_body_size += az_span_size(body_chunk);
+  return AZ_OK;
+}
+
+// Receives the status line and headers of test_policy_transport_response, and then the first
+// test_policy_transport_body_size bytes of its body, before the attempt times out.
+static int32_t test_policy_transport_body_size = 0;
+
+static az_result test_policy_transport_timing_out_in_body(
+    _az_http_policy* ref_policies,
+    void* ref_options,
+    az_http_request* ref_request,
+    az_http_response* ref_response)
+{
+  (void)ref_policies;
+  (void)ref_options;
+  (void)ref_request;
+  ++test_policy_transport_calls;
+
+  az_span const headers = AZ_SPAN_FROM_STR("HTTP/1.1 200 OK\r\nContent-Length: 6\r\n\r\n");
+  assert_return_code(az_http_response_append(ref_response, headers), AZ_OK);
+  assert_return_code(
+      az_http_response_append(
+          ref_response,
+          az_span_slice(AZ_SPAN_FROM_STR("abcdef"), 0, test_policy_transport_body_size)),
+      AZ_OK);
+  return AZ_ERROR_HTTP_ATTEMPT_TIMEOUT;
+}
+
+void test_az_http_pipeline_policy_retry_timeout_streamed_body(void** state)
+{
+  (void)state;
+
+  az_http_policy_retry_options retry_options = _az_http_policy_retry_options_default();
+  retry_options.try_timeout_msec = 500;
+  retry_options.retry_delay_msec = 100;
+  retry_options.max_retry_delay_msec = 100;
+  retry_options.max_retries = 1;
+
+  uint8_t url_buf[100];
+  uint8_t header_buf[(2 * sizeof(az_pair))];
+  az_span const url = AZ_SPAN_FROM_STR("https://account.blob.core.windows.net/container/blob");
+  az_span_copy(AZ_SPAN_FROM_BUFFER(url_buf), url);
+
+  az_http_request request;
+  assert_return_code(
+      az_http_request_init(
+          &request,
+          &az_context_application,
+          az_http_method_get(),
+          AZ_SPAN_FROM_BUFFER(url_buf),
+          az_span_size(url),
+          AZ_SPAN_FROM_BUFFER(header_buf),
+          AZ_SPAN_NULL),
+      AZ_OK);
+
+  _az_http_policy policies[1] = {
+    {
+      ._internal = {
+        .process = test_policy_transport_timing_out_in_body,
+        .options = NULL,
+      },
+    },
+  };
+
+  uint8_t response_buf[64];
+  az_http_response response;
+  assert_return_code(az_http_response_init(&response, AZ_SPAN_FROM_BUFFER(response_buf)), AZ_OK);
+  assert_return_code(
+      az_http_response_set_body_callback(&response, test_streamed_body_callback, NULL), AZ_OK);
+
+  // An attempt that timed out after its headers, before any of its body, is retried.
+  test_policy_transport_calls = 0;
+  test_policy_transport_body_size = 0;
+  test_streamed_body_size = 0;
+  will_return(__wrap_az_platform_clock_msec, 0);
+  assert_int_equal(
+      az_http_pipeline_policy_retry(policies, &retry_options, &request, &response),
+      AZ_ERROR_HTTP_ATTEMPT_TIMEOUT);
+  assert_int_equal(test_policy_transport_calls, 2);
+  assert_int_equal(test_streamed_body_size, 0);
+
+  // Once part of the body went to the callback, it isn't, it would be streamed again from its
+  // start.
+  test_policy_transport_calls = 0;
+  test_policy_transport_body_size = 3;
+  test_streamed_body_size = 0;
+  assert_int_equal(
+      az_http_pipeline_policy_retry(policies, &retry_options, &request, &response),
+      AZ_ERROR_HTTP_ATTEMPT_TIMEOUT);
+  assert_int_equal(test_policy_transport_calls, 1);
+  assert_int_equal(test_streamed_body_size, 3);
+}
+
+static az_http_policy_single_flight test_single_flight;
+static pthread_t test_single_flight_thread;
+static az_result test_single_flight_leader_result = AZ_OK;
+static az_result test_single_flight_follower_result = AZ_OK;
+static uint8_t test_single_flight_follower_buffer[64];
+static az_http_response test_single_flight_follower_response;
+static az_span const test_single_flight_response
+    = AZ_SPAN_LITERAL_FROM_STR("HTTP/1.1 200 OK\r\nContent-Length: 4\r\n\r\nblob");
+
+static az_result test_policy_transport_single_flight(
+    _az_http_policy* ref_policies,
+    void* ref_options,
+    az_http_request* ref_request,
+    az_http_response* ref_response);
+
+// Sends a GET request through the single-flight policy, with a x-ms-client-request-id header.
+static az_result test_policy_single_flight_send(
+    az_span client_request_id,
+    az_http_response* ref_response)
+{
+  uint8_t url_buf[100];
+  uint8_t header_buf[(2 * sizeof(az_pair))];
+  az_span const url = AZ_SPAN_FROM_STR("https://account.blob.core.windows.net/container/blob");
+  az_span_copy(AZ_SPAN_FROM_BUFFER(url_buf), url);
+
+  az_http_request request;
+  az_result result = az_http_request_init(
+      &request,
+      &az_context_application,
+      az_http_method_get(),
+      AZ_SPAN_FROM_BUFFER(url_buf),
+      az_span_size(url),
+      AZ_SPAN_FROM_BUFFER(header_buf),
+      AZ_SPAN_NULL);
+  if (az_succeeded(result))
+  {
+    result = az_http_request_append_header(
+        &request, AZ_SPAN_FROM_STR("x-ms-client-request-id"), client_request_id);
+  }
+  if (az_failed(result))
+  {
+    return result;
+  }
+
+  _az_http_policy policies[1] = {
+    {
+      ._internal = {
+        .process = test_policy_transport_single_flight,
+        .options = NULL,
+      },
+    },
+  };
+
+  return az_http_pipeline_policy_single_flight(
+      policies, &test_single_flight, &request, ref_response);
+}
+
+// Sends an identical request, with a different client request id, from another thread.
+static void* test_single_flight_follower(void* arg)
+{
+  (void)arg;
+  test_single_flight_follower_result = az_http_response_init(
+      &test_single_flight_follower_response,
+      AZ_SPAN_FROM_BUFFER(test_single_flight_follower_buffer));
+  if (az_succeeded(test_single_flight_follower_result))
+  {
+    test_single_flight_follower_result = test_policy_single_flight_send(
+        AZ_SPAN_FROM_STR("follower"), &test_single_flight_follower_response);
+  }
+  return NULL;
+}
+
+// The first request waits for a follower to join it, then returns test_single_flight_leader_result.
+static az_result test_policy_transport_single_flight(
+    _az_http_policy* ref_policies,
+    void* ref_options,
+    az_http_request* ref_request,
+    az_http_response* ref_response)
+{
+  (void)ref_policies;
+  (void)ref_options;
+  (void)ref_request;
+
+  if (test_policy_transport_calls++ == 0)
+  {
+    pthread_t follower;
+    assert_int_equal(pthread_create(&follower, NULL, test_single_flight_follower, NULL), 0);
+
+    bool is_joined = false;
+    while (!is_joined)
+    {
+      _az_spinlock_enter_reader(&test_single_flight._internal.lock);
+      is_joined = test_single_flight._internal.calls[0].followers == 1;
+      _az_spinlock_exit_reader(&test_single_flight._internal.lock);
+    }
+
+    az_result const result = test_single_flight_leader_result;
+    if (az_succeeded(result))
+    {
+      assert_return_code(az_http_response_append(ref_response, test_single_flight_response), AZ_OK);
+    }
+
+    // The follower is joined once the leader has returned, see below.
+    test_single_flight_thread = follower;
+    return result;
+  }
+
+  return az_http_response_append(ref_response, test_single_flight_response);
+}
+
+void test_az_http_pipeline_policy_single_flight(void** state)
+{
+  (void)state;
+  az_http_policy_single_flight_init(&test_single_flight);
+
+  // The follower gets a copy of the response of the leader, and isn't sent.
+  test_policy_transport_calls = 0;
+  test_single_flight_leader_result = AZ_OK;
+  uint8_t response_buffer[64];
+  az_http_response response;
+  assert_return_code(az_http_response_init(&response, AZ_SPAN_FROM_BUFFER(response_buffer)), AZ_OK);
+  assert_return_code(
+      test_policy_single_flight_send(AZ_SPAN_FROM_STR("leader"), &response), AZ_OK);
+  assert_int_equal(pthread_join(test_single_flight_thread, NULL), 0);
+  assert_return_code(test_single_flight_follower_result, AZ_OK);
+  assert_int_equal(test_policy_transport_calls, 1);
+
+  az_http_response_status_line status_line = { 0 };
+  assert_return_code(
+      az_http_response_get_status_line(&test_single_flight_follower_response, &status_line), AZ_OK);
+  assert_int_equal(status_line.status_code, AZ_HTTP_STATUS_CODE_OK);
+  az_span body = AZ_SPAN_NULL;
+  assert_return_code(
+      az_http_response_get_body(&test_single_flight_follower_response, &body), AZ_OK);
+  assert_true(az_span_is_content_equal(az_span_slice(body, 0, 4), AZ_SPAN_FROM_STR("blob")));
+  assert_false(test_single_flight._internal.calls[0].is_used);
+
+  // When the leader fails, the follower sends its own request.
+  test_policy_transport_calls = 0;
+  test_single_flight_leader_result = AZ_ERROR_HTTP_PLATFORM;
+  assert_int_equal(
+      test_policy_single_flight_send(AZ_SPAN_FROM_STR("leader"), &response),
+      AZ_ERROR_HTTP_PLATFORM);
+  assert_int_equal(pthread_join(test_single_flight_thread, NULL), 0);
+  assert_return_code(test_single_flight_follower_result, AZ_OK);
+  assert_int_equal(test_policy_transport_calls, 2);
+  assert_false(test_single_flight._internal.calls[0].is_used);
+}
+
+static az_http_policy_bulkhead test_bulkhead;
+static pthread_t test_bulkhead_thread;
+static az_result test_bulkhead_queued_result = AZ_OK;
+
+static az_result test_policy_transport_bulkhead(
+    _az_http_policy* ref_policies,
+    void* ref_options,
+    az_http_request* ref_request,
+    az_http_response* ref_response);
+
+// Sends a GET request to url with context through the bulkhead policy.
+static az_result test_policy_bulkhead_send(az_context* context, az_span url)
+{
+  uint8_t url_buf[100];
+  uint8_t header_buf[(2 * sizeof(az_pair))];
+  az_span_copy(AZ_SPAN_FROM_BUFFER(url_buf), url);
+
+  az_http_request request;
+  az_result const result = az_http_request_init(
+      &request,
+      context,
+      az_http_method_get(),
+      AZ_SPAN_FROM_BUFFER(url_buf),
+      az_span_size(url),
+      AZ_SPAN_FROM_BUFFER(header_buf),
+      AZ_SPAN_NULL);
+  if (az_failed(result))
+  {
+    return result;
+  }
+
+  _az_http_policy policies[1] = {
+    {
+      ._internal = {
+        .process = test_policy_transport_bulkhead,
+        .options = NULL,
+      },
+    },
+  };
+
+  az_http_response response = { 0 };
+  return az_http_pipeline_policy_bulkhead(policies, &test_bulkhead, &request, &response);
+}
+
+static void* test_bulkhead_queued(void* arg)
+{
+  (void)arg;
+  test_bulkhead_queued_result = test_policy_bulkhead_send(
+      &az_context_application, AZ_SPAN_FROM_STR("https://account.blob.core.windows.net/b"));
+  return NULL;
+}
+
+// While the first request is in flight, sends the requests that the bulkhead queues or rejects.
+static az_result test_policy_transport_bulkhead(
+    _az_http_policy* ref_policies,
+    void* ref_options,
+    az_http_request* ref_request,
+    az_http_response* ref_response)
+{
+  (void)ref_policies;
+  (void)ref_options;
+  (void)ref_request;
+  (void)ref_response;
+
+  if (test_policy_transport_calls++ > 0)
+  {
+    return AZ_OK;
+  }
+
+  pthread_t queued;
+  assert_int_equal(pthread_create(&queued, NULL, test_bulkhead_queued, NULL), 0);
+
+  bool is_queued = false;
+  while (!is_queued)
+  {
+    _az_spinlock_enter_reader(&test_bulkhead._internal.lock);
+    is_queued = test_bulkhead._internal.hosts[0].queued == 1;
+    _az_spinlock_exit_reader(&test_bulkhead._internal.lock);
+  }
+
+  // The queue of the host is full.
+  assert_int_equal(
+      test_policy_bulkhead_send(
+          &az_context_application, AZ_SPAN_FROM_STR("https://account.blob.core.windows.net/c")),
+      AZ_ERROR_HTTP_BULKHEAD_FULL);
+
+  // Other hosts aren't bounded by it.
+  assert_return_code(
+      test_policy_bulkhead_send(
+          &az_context_application, AZ_SPAN_FROM_STR("https://other.blob.core.windows.net/a")),
+      AZ_OK);
+
+  // The queued request is sent once this one completes, it is joined below.
+  assert_int_equal(test_bulkhead._internal.hosts[0].in_flight, 1);
+  assert_int_equal(test_policy_transport_calls, 2);
+  test_bulkhead_thread = queued;
+  return AZ_OK;
+}
+
+// Sends a request that waits in the queue of the host until its context expires.
+static az_result test_policy_transport_bulkhead_expired(
+    _az_http_policy* ref_policies,
+    void* ref_options,
+    az_http_request* ref_request,
+    az_http_response* ref_response)
+{
+  (void)ref_policies;
+  (void)ref_options;
+  (void)ref_request;
+  (void)ref_response;
+
+  az_context context = az_context_create_with_expiration(&az_context_application, 500);
+  will_return(__wrap_az_platform_clock_msec, 100);
+  will_return(__wrap_az_platform_clock_msec, 501);
+  assert_int_equal(
+      test_policy_bulkhead_send(
+          &context, AZ_SPAN_FROM_STR("https://account.blob.core.windows.net/b")),
+      AZ_ERROR_CANCELED);
+  assert_int_equal(test_bulkhead._internal.hosts[0].queued, 0);
+
+  return AZ_OK;
+}
+
+// Sends a request to a host whose hash collides with the one of the host in flight.
+static az_result test_policy_transport_bulkhead_colliding(
+    _az_http_policy* ref_policies,
+    void* ref_options,
+    az_http_request* ref_request,
+    az_http_response* ref_response)
+{
+  (void)ref_policies;
+  (void)ref_options;
+  (void)ref_request;
+  (void)ref_response;
+
+  assert_return_code(
+      test_policy_bulkhead_send(
+          &az_context_application,
+          AZ_SPAN_FROM_STR("https://h1340180.blob.core.windows.net/container")),
+      AZ_OK);
+
+  return AZ_OK;
+}
+
+void test_az_http_pipeline_policy_bulkhead(void** state)
+{
+  (void)state;
+  az_http_policy_bulkhead_init(&test_bulkhead, 1, 1);
+
+  test_policy_transport_calls = 0;
+  assert_return_code(
+      test_policy_bulkhead_send(
+          &az_context_application, AZ_SPAN_FROM_STR("https://account.blob.core.windows.net/a")),
+      AZ_OK);
+
+  // The slot of the host is freed once the queued request completes.
+  assert_int_equal(pthread_join(test_bulkhead_thread, NULL), 0);
+  assert_return_code(test_bulkhead_queued_result, AZ_OK);
+  assert_int_equal(test_policy_transport_calls, 3);
+  for (int32_t i = 0; i < _az_HTTP_POLICY_BULKHEAD_HOSTS; ++i)
+  {
+    assert_int_equal(test_bulkhead._internal.hosts[i].host_hash, 0);
+  }
+
+  // A queued request gives up once its context expires.
+  uint8_t url_buf[100];
+  uint8_t header_buf[(2 * sizeof(az_pair))];
+  az_span const url = AZ_SPAN_FROM_STR("https://account.blob.core.windows.net/a");
+  az_span_copy(AZ_SPAN_FROM_BUFFER(url_buf), url);
+
+  az_http_request request;
+  assert_return_code(
+      az_http_request_init(
+          &request,
+          &az_context_application,
+          az_http_method_get(),
+          AZ_SPAN_FROM_BUFFER(url_buf),
+          az_span_size(url),
+          AZ_SPAN_FROM_BUFFER(header_buf),
+          AZ_SPAN_NULL),
+      AZ_OK);
+
+  _az_http_policy policies[1] = {
+    {
+      ._internal = {
+        .process = test_policy_transport_bulkhead_expired,
+        .options = NULL,
+      },
+    },
+  };
+
+  az_http_response response = { 0 };
+  assert_return_code(
+      az_http_pipeline_policy_bulkhead(policies, &test_bulkhead, &request, &response), AZ_OK);
+  assert_int_equal(test_bulkhead._internal.hosts[0].host_hash, 0);
+
+  // Hosts whose hashes collide are bounded apart, with a queue full for both of them.
+  az_http_policy_bulkhead_init(&test_bulkhead, 1, 0);
+  az_span const colliding_url = AZ_SPAN_FROM_STR("https://h84337.blob.core.windows.net/container");
+  az_span_copy(AZ_SPAN_FROM_BUFFER(url_buf), colliding_url);
+  assert_return_code(
+      az_http_request_init(
+          &request,
+          &az_context_application,
+          az_http_method_get(),
+          AZ_SPAN_FROM_BUFFER(url_buf),
+          az_span_size(colliding_url),
+          AZ_SPAN_FROM_BUFFER(header_buf),
+          AZ_SPAN_NULL),
+      AZ_OK);
+
+  policies[0]._internal.process = test_policy_transport_bulkhead_colliding;
+  test_policy_transport_calls = 1; // test_policy_transport_bulkhead only completes the request.
+  assert_return_code(
+      az_http_pipeline_policy_bulkhead(policies, &test_bulkhead, &request, &response), AZ_OK);
+  assert_int_equal(test_policy_transport_calls, 2);
+}
+
 #endif // _az_MOCK_ENABLED
 
 int test_az_policy()
@@ -367,9 +1745,21 @@ int test_az_policy()
     cmocka_unit_test(test_az_http_pipeline_policy_retry),
     cmocka_unit_test(test_az_http_pipeline_policy_retry_with_header),
     cmocka_unit_test(test_az_http_pipeline_policy_retry_with_header_2),
+    cmocka_unit_test(test_az_http_pipeline_policy_retry_async),
+    cmocka_unit_test(test_az_http_pipeline_policy_retry_budget),
+    cmocka_unit_test(test_az_http_pipeline_policy_retry_circuit_breaker),
+    cmocka_unit_test(test_az_http_pipeline_policy_retry_rate_limiter),
+    cmocka_unit_test(test_az_http_pipeline_policy_hedging),
+    cmocka_unit_test(test_az_http_pipeline_policy_retry_timeout),
+    cmocka_unit_test(test_az_http_pipeline_policy_retry_timeout_streamed_body),
+    cmocka_unit_test(test_az_http_pipeline_policy_single_flight),
+    cmocka_unit_test(test_az_http_pipeline_policy_bulkhead),
 #endif // _az_MOCK_ENABLED
     cmocka_unit_test(test_az_http_pipeline_policy_apiversion),
     cmocka_unit_test(test_az_http_pipeline_policy_telemetry),
+    cmocka_unit_test(test_az_retry_calc_decorrelated_delay),
+    cmocka_unit_test(test_az_http_pipeline_policy_cache),
+    cmocka_unit_test(test_az_http_pipeline_policy_compression),
   };
   return cmocka_run_group_tests_name("az_core_policy", tests, NULL, NULL);
 }
@@ -1998,6 +1998,36 @@ static void test_az_span_token_success(void** state)
   assert_true(az_span_is_content_equal(token, AZ_SPAN_NULL));
 }
 
+static void test_az_span_find_delimiter_or_control(void** state)
+{
+  (void)state;
+  // Longer than two AVX2 blocks, so that every scanned position is tested in a block and in the
+  // remainder. Tabs and bytes above 0x7F aren't matched.
+  uint8_t buffer[80];
+  for (int32_t i = 0; i < (int32_t)sizeof(buffer); ++i)
+  {
+    buffer[i] = (uint8_t)(i % 3 == 0 ? '\t' : (i % 3 == 1 ? 0xFF : 'a'));
+  }
+  az_span const span = AZ_SPAN_FROM_BUFFER(buffer);
+
+  assert_int_equal(_az_span_find_delimiter_or_control(span, ':'), -1);
+  assert_int_equal(_az_span_find_delimiter_or_control(AZ_SPAN_NULL, ':'), -1);
+
+  uint8_t const matches[] = { ':', '\r', '\n', '\0', 0x1F };
+  for (size_t m = 0; m < sizeof(matches); ++m)
+  {
+    for (int32_t i = 0; i < (int32_t)sizeof(buffer); ++i)
+    {
+      uint8_t const saved = buffer[i];
+      buffer[i] = matches[m];
+      assert_int_equal(_az_span_find_delimiter_or_control(span, ':'), i);
+      // Only the bytes of the span are scanned.
+      assert_int_equal(_az_span_find_delimiter_or_control(az_span_slice(span, 0, i), ':'), -1);
+      buffer[i] = saved;
+    }
+  }
+}
+
 int test_az_span()
 {
   const struct CMUnitTest tests[] = {
@@ -2060,6 +2090,7 @@ int test_az_span()
     cmocka_unit_test(az_span_trim_zero),
     cmocka_unit_test(az_span_trim_null),
     cmocka_unit_test(test_az_span_token_success),
+    cmocka_unit_test(test_az_span_find_delimiter_or_control),
     cmocka_unit_test(az_span_trim_start),
     cmocka_unit_test(az_span_trim_end),
     cmocka_unit_test(az_span_trim_unicode),
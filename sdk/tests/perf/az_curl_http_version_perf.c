@@ -0,0 +1,219 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file az_curl_http_version_perf.c
+ *
+ * @brief Compares HTTP/1.1 and HTTP/2 throughput of the libcurl transport adapter, when many small
+ * requests are sent concurrently through an #az_http_client_curl_async driver.
+ *
+ * Usage: az_curl_http_version_perf <url> [requests] [concurrency]
+ *
+ * The server at <url> must accept both HTTP/1.1 and HTTP/2. For an `http://` url, HTTP/2 is used
+ * with prior knowledge (h2c). See README.md for how to run a local server.
+ */
+
+#include <azure/core/az_context.h>
+#include <azure/core/az_http.h>
+#include <azure/core/az_http_transport.h>
+#include <azure/core/az_platform.h>
+#include <azure/core/az_span.h>
+#include <azure/core/internal/az_http_internal.h>
+#include <azure/platform/az_curl.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <curl/curl.h>
+
+#include <azure/core/_az_cfg.h>
+
+enum
+{
+  _az_PERF_MAX_CONCURRENCY = 1000,
+  _az_PERF_RESPONSE_BUFFER_SIZE = 4 * 1024,
+  _az_PERF_OPERATION_BUFFER_SIZE = 1024,
+};
+
+typedef struct
+{
+  az_http_client_curl_async_operation operation;
+  az_http_request request;
+  az_http_response response;
+  az_pair headers_buffer[1];
+  uint8_t operation_buffer[_az_PERF_OPERATION_BUFFER_SIZE];
+  uint8_t response_buffer[_az_PERF_RESPONSE_BUFFER_SIZE];
+} perf_slot;
+
+typedef struct
+{
+  az_http_client_curl_async* async;
+  az_span url;
+  int32_t requests_to_send;
+  int32_t requests_sent;
+  int32_t requests_failed;
+} perf_run;
+
+static perf_slot slots[_az_PERF_MAX_CONCURRENCY];
+static perf_run run;
+
+static void send_next(perf_slot* slot);
+
+static void on_done(az_http_client_curl_async_operation* operation, az_result result, void* slot)
+{
+  (void)operation;
+
+  az_http_response_status_line status_line = { 0 };
+  if (az_failed(result)
+      || az_failed(az_http_response_get_status_line(&((perf_slot*)slot)->response, &status_line))
+      || status_line.status_code != AZ_HTTP_STATUS_CODE_OK)
+  {
+    ++run.requests_failed;
+  }
+
+  send_next((perf_slot*)slot);
+}
+
+static void send_next(perf_slot* slot)
+{
+  if (run.requests_sent == run.requests_to_send)
+  {
+    return;
+  }
+  ++run.requests_sent;
+
+  az_result result = az_http_client_curl_async_operation_init(
+      &slot->operation,
+      run.async,
+      NULL,
+      AZ_SPAN_FROM_BUFFER(slot->operation_buffer),
+      on_done,
+      slot);
+
+  if (az_succeeded(result))
+  {
+    result = az_http_response_init(&slot->response, AZ_SPAN_FROM_BUFFER(slot->response_buffer));
+  }
+
+  if (az_succeeded(result))
+  {
+    result = az_http_request_init(
+        &slot->request,
+        az_http_client_curl_async_operation_get_context(&slot->operation),
+        az_http_method_get(),
+        run.url,
+        az_span_size(run.url),
+        az_span_create((uint8_t*)slot->headers_buffer, (int32_t)sizeof(slot->headers_buffer)),
+        AZ_SPAN_NULL);
+  }
+
+  if (az_succeeded(result))
+  {
+    result = az_http_client_send_request(&slot->request, &slot->response);
+  }
+
+  if (result != AZ_HTTP_REQUEST_PENDING)
+  {
+    ++run.requests_failed;
+  }
+}
+
+static int run_benchmark(
+    char const* name,
+    az_http_client_curl_http_version http_version,
+    int32_t requests,
+    int32_t concurrency)
+{
+  az_http_client_curl_options options = az_http_client_curl_options_default();
+  options.http_version = http_version;
+  if (az_failed(az_http_client_curl_set_options(&options)))
+  {
+    printf("%-10s not supported by libcurl\n", name);
+    return 1;
+  }
+
+  az_http_client_curl_async async;
+  if (az_failed(az_http_client_curl_async_init(&async)))
+  {
+    return 1;
+  }
+
+  run.async = &async;
+  run.requests_to_send = requests;
+  run.requests_sent = 0;
+  run.requests_failed = 0;
+
+  int64_t const start_msec = az_platform_clock_msec();
+
+  for (int32_t i = 0; i < concurrency; ++i)
+  {
+    send_next(&slots[i]);
+  }
+
+  int32_t in_flight = concurrency;
+  while (in_flight > 0)
+  {
+    if (az_failed(az_http_client_curl_async_perform(&async, 1000, &in_flight)))
+    {
+      az_http_client_curl_async_cleanup(&async);
+      return 1;
+    }
+  }
+
+  int64_t const elapsed_msec = az_platform_clock_msec() - start_msec;
+  az_http_client_curl_async_cleanup(&async);
+
+  printf(
+      "%-10s %8d requests  %6d failed  %8lld ms  %10.0f req/s\n",
+      name,
+      requests,
+      run.requests_failed,
+      (long long)elapsed_msec,
+      elapsed_msec > 0 ? (double)requests * 1000.0 / (double)elapsed_msec : 0.0);
+
+  return run.requests_failed == 0 ? 0 : 1;
+}
+
+int main(int argc, char** argv)
+{
+  if (argc < 2)
+  {
+    printf("Usage: %s <url> [requests] [concurrency]\n", argv[0]);
+    return 1;
+  }
+
+  int32_t const requests = argc > 2 ? atoi(argv[2]) : 10000;
+  int32_t concurrency = argc > 3 ? atoi(argv[3]) : 100;
+  if (requests <= 0 || concurrency <= 0)
+  {
+    printf("requests and concurrency must be positive\n");
+    return 1;
+  }
+  concurrency = concurrency > _az_PERF_MAX_CONCURRENCY ? _az_PERF_MAX_CONCURRENCY : concurrency;
+  concurrency = concurrency > requests ? requests : concurrency;
+
+  run.url = az_span_create((uint8_t*)argv[1], (int32_t)strlen(argv[1]));
+  bool const is_https = strncmp(argv[1], "https://", 8) == 0;
+
+  if (curl_global_init(CURL_GLOBAL_ALL) != CURLE_OK)
+  {
+    return 1;
+  }
+
+  printf("%s, concurrency %d\n", argv[1], concurrency);
+
+  int result = run_benchmark(
+      "HTTP/1.1", AZ_HTTP_CLIENT_CURL_HTTP_VERSION_1_1, requests, concurrency);
+  result |= run_benchmark(
+      "HTTP/2",
+      is_https ? AZ_HTTP_CLIENT_CURL_HTTP_VERSION_2
+               : AZ_HTTP_CLIENT_CURL_HTTP_VERSION_2_PRIOR_KNOWLEDGE,
+      requests,
+      concurrency);
+
+  az_http_client_curl_cleanup();
+  curl_global_cleanup();
+
+  return result;
+}
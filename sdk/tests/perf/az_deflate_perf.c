@@ -0,0 +1,150 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file az_deflate_perf.c
+ *
+ * @brief Measures the throughput and the ratio of the gzip compression of the request bodies
+ * (#az_http_policy_compression), on JSON telemetry of several sizes, and compares them with zlib
+ * when it is found.
+ *
+ * Usage: az_deflate_perf [megabytes]
+ */
+
+#include "az_deflate_private.h"
+
+#include <azure/core/az_result.h>
+#include <azure/core/az_span.h>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#ifdef AZ_PERF_ZLIB
+#include <zlib.h>
+#endif // AZ_PERF_ZLIB
+
+#include <azure/core/_az_cfg.h>
+
+enum
+{
+  MAX_BODY_SIZE = 256 * 1024,
+};
+
+static uint8_t body_buffer[MAX_BODY_SIZE];
+static uint8_t compressed_buffer[MAX_BODY_SIZE + 1024];
+static _az_deflate_encoder encoder;
+
+// Writes telemetry messages of devices, as an IoT or logging client would upload them.
+static az_span make_body(int32_t size)
+{
+  uint32_t random = 12345;
+  int32_t written = 0;
+  for (int32_t i = 0; written < size; ++i)
+  {
+    random = random * 1103515245U + 12345U;
+    char message[160];
+    int const length = snprintf(
+        message,
+        sizeof(message),
+        "{\"deviceId\":\"sensor-%04d\",\"timestamp\":\"2020-10-14T17:%02d:%02d.%03dZ\","
+        "\"temperature\":%d.%02d,\"humidity\":%d,\"status\":\"%s\"},",
+        i % 64,
+        (i / 60) % 60,
+        i % 60,
+        (int)(random >> 8) % 1000,
+        18 + (int)(random >> 16) % 8,
+        (int)(random >> 4) % 100,
+        30 + (int)(random >> 12) % 40,
+        (random >> 20) % 16 == 0 ? "warning" : "ok");
+    for (int j = 0; j < length && written < size; ++j)
+    {
+      body_buffer[written++] = (uint8_t)message[j];
+    }
+  }
+
+  return az_span_create(body_buffer, size);
+}
+
+static int32_t compress_az(az_span body)
+{
+  az_span compressed = AZ_SPAN_NULL;
+  if (az_failed(_az_gzip_compress(
+          &encoder, body, AZ_SPAN_FROM_BUFFER(compressed_buffer), &compressed)))
+  {
+    return -1;
+  }
+
+  return az_span_size(compressed);
+}
+
+#ifdef AZ_PERF_ZLIB
+static int32_t compress_zlib(az_span body, int level)
+{
+  uLongf size = sizeof(compressed_buffer);
+  return compress2(compressed_buffer, &size, az_span_ptr(body), (uLong)az_span_size(body), level)
+          == Z_OK
+      ? (int32_t)size
+      : -1;
+}
+
+static int32_t compress_zlib_1(az_span body) { return compress_zlib(body, 1); }
+static int32_t compress_zlib_6(az_span body) { return compress_zlib(body, 6); }
+#endif // AZ_PERF_ZLIB
+
+static int run_benchmark(
+    char const* name,
+    int32_t (*compress)(az_span),
+    int32_t body_size,
+    int64_t total_bytes)
+{
+  az_span const body = make_body(body_size);
+  int64_t const iterations = total_bytes / body_size > 0 ? total_bytes / body_size : 1;
+
+  int32_t compressed_size = 0;
+  clock_t const start = clock();
+  for (int64_t i = 0; i < iterations; ++i)
+  {
+    compressed_size = compress(body);
+    if (compressed_size < 0)
+    {
+      printf("%-12s failed to compress %d bytes\n", name, body_size);
+      return 1;
+    }
+  }
+  double const elapsed_sec = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+  printf(
+      "%-12s %8d bytes -> %7d  ratio %5.2f  %8.1f MB/s\n",
+      name,
+      body_size,
+      compressed_size,
+      (double)body_size / compressed_size,
+      elapsed_sec > 0 ? (double)(iterations * body_size) / elapsed_sec / 1e6 : 0.0);
+
+  return 0;
+}
+
+int main(int argc, char** argv)
+{
+  int64_t const megabytes = argc > 1 ? atoi(argv[1]) : 200;
+  if (megabytes <= 0)
+  {
+    printf("megabytes must be positive\n");
+    return 1;
+  }
+
+  static int32_t const body_sizes[] = { 1024, 16 * 1024, MAX_BODY_SIZE };
+  int result = 0;
+  for (size_t i = 0; i < sizeof(body_sizes) / sizeof(body_sizes[0]); ++i)
+  {
+    result |= run_benchmark("az_gzip", compress_az, body_sizes[i], megabytes * 1000000);
+#ifdef AZ_PERF_ZLIB
+    result |= run_benchmark("zlib -1", compress_zlib_1, body_sizes[i], megabytes * 1000000);
+    result |= run_benchmark("zlib -6", compress_zlib_6, body_sizes[i], megabytes * 1000000);
+#endif // AZ_PERF_ZLIB
+  }
+
+  return result;
+}
@@ -0,0 +1,385 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file az_http_client_perf.c
+ *
+ * @brief Sends requests with az_http_pipeline_process() and az_storage_blobs_blob_upload() to an
+ * in-process transport and, with the libcurl transport adapter, to an HTTP server on the loopback
+ * interface. Both reply with the same scripts of responses: successes only, and throttled (429)
+ * and unavailable (503) responses that are retried.
+ *
+ * For each transport, operation and script, it prints the requests per second, the allocations
+ * per request (of the SDK, and of libcurl) and the percentiles of the request latency.
+ *
+ * Usage: az_http_client_perf [requests] [latency_msec] [body_size]
+ */
+
+#include "az_perf_transport.h"
+
+#include <azure/core/az_context.h>
+#include <azure/core/az_credentials.h>
+#include <azure/core/az_http.h>
+#include <azure/core/az_http_transport.h>
+#include <azure/core/az_result.h>
+#include <azure/core/az_span.h>
+#include <azure/core/internal/az_http_internal.h>
+#include <azure/storage/az_storage_blobs.h>
+
+#ifdef TRANSPORT_CURL
+#include <azure/platform/az_curl.h>
+
+#include <curl/curl.h>
+#endif // TRANSPORT_CURL
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <azure/core/_az_cfg.h>
+
+enum
+{
+  _az_PERF_URL_BUFFER_SIZE = 256,
+  _az_PERF_RESPONSE_BUFFER_SIZE = 1024,
+  _az_PERF_MAX_BODY_SIZE = 64 * 1024 * 1024,
+};
+
+// The allocations made by the SDK, which is linked with -Wl,--wrap=malloc (and calloc, realloc),
+// and by libcurl, which allocates with these functions too (see main()).
+static int64_t allocations = 0;
+
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t count, size_t size);
+void* __real_realloc(void* ptr, size_t size);
+void* __wrap_malloc(size_t size);
+void* __wrap_calloc(size_t count, size_t size);
+void* __wrap_realloc(void* ptr, size_t size);
+
+void* __wrap_malloc(size_t size)
+{
+  __atomic_fetch_add(&allocations, 1, __ATOMIC_RELAXED);
+  return __real_malloc(size);
+}
+
+void* __wrap_calloc(size_t count, size_t size)
+{
+  __atomic_fetch_add(&allocations, 1, __ATOMIC_RELAXED);
+  return __real_calloc(count, size);
+}
+
+void* __wrap_realloc(void* ptr, size_t size)
+{
+  __atomic_fetch_add(&allocations, 1, __ATOMIC_RELAXED);
+  return __real_realloc(ptr, size);
+}
+
+static int64_t clock_nsec()
+{
+  struct timespec now;
+  (void)clock_gettime(CLOCK_MONOTONIC, &now);
+  return (int64_t)now.tv_sec * 1000000000 + now.tv_nsec;
+}
+
+static int compare_int64(void const* left, void const* right)
+{
+  int64_t const l = *(int64_t const*)left;
+  int64_t const r = *(int64_t const*)right;
+  return l < r ? -1 : (l > r ? 1 : 0);
+}
+
+// Successes only.
+static az_http_status_code const script_ok[] = {
+  AZ_HTTP_STATUS_CODE_NONE,
+  AZ_HTTP_STATUS_CODE_END_OF_LIST,
+};
+
+// One request out of eight is throttled then unavailable, and succeeds on its second retry.
+static az_http_status_code const script_throttled[] = {
+  AZ_HTTP_STATUS_CODE_TOO_MANY_REQUESTS,
+  AZ_HTTP_STATUS_CODE_SERVICE_UNAVAILABLE,
+  AZ_HTTP_STATUS_CODE_NONE,
+  AZ_HTTP_STATUS_CODE_NONE,
+  AZ_HTTP_STATUS_CODE_NONE,
+  AZ_HTTP_STATUS_CODE_NONE,
+  AZ_HTTP_STATUS_CODE_NONE,
+  AZ_HTTP_STATUS_CODE_NONE,
+  AZ_HTTP_STATUS_CODE_NONE,
+  AZ_HTTP_STATUS_CODE_NONE,
+  AZ_HTTP_STATUS_CODE_END_OF_LIST,
+};
+
+typedef struct
+{
+  az_span url;
+  az_span body;
+  int64_t* latencies_nsec;
+  _az_http_policy_apiversion_options api_version;
+  _az_http_policy_telemetry_options telemetry;
+  az_http_policy_retry_options retry;
+  _az_http_pipeline pipeline;
+  az_storage_blobs_blob_client client;
+} perf_run;
+
+// Sends a GET request through the policies of the blob client.
+static az_result send_with_pipeline(perf_run* run, az_http_response* ref_response)
+{
+  uint8_t url_buffer[_az_PERF_URL_BUFFER_SIZE];
+  az_pair headers[4];
+  az_span_copy(AZ_SPAN_FROM_BUFFER(url_buffer), run->url);
+
+  az_http_request request;
+  AZ_RETURN_IF_FAILED(az_http_request_init(
+      &request,
+      &az_context_application,
+      az_http_method_get(),
+      AZ_SPAN_FROM_BUFFER(url_buffer),
+      az_span_size(run->url),
+      az_span_create((uint8_t*)headers, (int32_t)sizeof(headers)),
+      AZ_SPAN_NULL));
+
+  return az_http_pipeline_process(&run->pipeline, &request, ref_response);
+}
+
+static az_result send_with_blob_upload(perf_run* run, az_http_response* ref_response)
+{
+  return az_storage_blobs_blob_upload(
+      &run->client, &az_context_application, run->body, NULL, ref_response);
+}
+
+static int run_benchmark(
+    char const* transport_name,
+    char const* operation_name,
+    az_result (*send)(perf_run*, az_http_response*),
+    char const* script_name,
+    perf_run* run,
+    int32_t requests)
+{
+  int32_t failed = 0;
+  uint8_t response_buffer[_az_PERF_RESPONSE_BUFFER_SIZE];
+
+  // The first request opens the connection, it isn't measured.
+  az_http_response response;
+  if (az_failed(az_http_response_init(&response, AZ_SPAN_FROM_BUFFER(response_buffer)))
+      || az_failed(send(run, &response)))
+  {
+    printf(
+        "%-10s %-12s %-9s failed to send a request\n",
+        transport_name,
+        operation_name,
+        script_name);
+    return 1;
+  }
+
+  int64_t const start_allocations = __atomic_load_n(&allocations, __ATOMIC_RELAXED);
+  int64_t const start_nsec = clock_nsec();
+
+  for (int32_t i = 0; i < requests; ++i)
+  {
+    int64_t const request_start_nsec = clock_nsec();
+
+    az_http_response_status_line status_line = { 0 };
+    if (az_failed(az_http_response_init(&response, AZ_SPAN_FROM_BUFFER(response_buffer)))
+        || az_failed(send(run, &response))
+        || az_failed(az_http_response_get_status_line(&response, &status_line))
+        || status_line.status_code >= AZ_HTTP_STATUS_CODE_MULTIPLE_CHOICES)
+    {
+      ++failed;
+    }
+
+    run->latencies_nsec[i] = clock_nsec() - request_start_nsec;
+  }
+
+  int64_t const elapsed_nsec = clock_nsec() - start_nsec;
+  int64_t const request_allocations
+      = __atomic_load_n(&allocations, __ATOMIC_RELAXED) - start_allocations;
+
+  qsort(run->latencies_nsec, (size_t)requests, sizeof(int64_t), compare_int64);
+  printf(
+      "%-10s %-12s %-9s %8d %6d %10.0f %7.2f %9.1f %9.1f %9.1f %9.1f\n",
+      transport_name,
+      operation_name,
+      script_name,
+      requests,
+      failed,
+      (double)requests * 1e9 / (double)elapsed_nsec,
+      (double)request_allocations / requests,
+      (double)run->latencies_nsec[requests / 2] / 1000.0,
+      (double)run->latencies_nsec[(int64_t)requests * 90 / 100] / 1000.0,
+      (double)run->latencies_nsec[(int64_t)requests * 99 / 100] / 1000.0,
+      (double)run->latencies_nsec[requests - 1] / 1000.0);
+
+  return failed == 0 ? 0 : 1;
+}
+
+// Runs the benchmarks of both operations and scripts, with \p script given to the transport at
+// \p url.
+static int run_benchmarks(
+    char const* transport_name,
+    az_span url,
+    az_perf_script* script,
+    int32_t latency_msec,
+    perf_run* run,
+    int32_t requests)
+{
+  run->url = url;
+  az_storage_blobs_blob_client_options options = az_storage_blobs_blob_client_options_default();
+  if (az_failed(
+          az_storage_blobs_blob_client_init(&run->client, url, AZ_CREDENTIAL_ANONYMOUS, &options)))
+  {
+    return 1;
+  }
+
+  int result = 0;
+  *script = az_perf_script_create(script_ok, latency_msec);
+  result |= run_benchmark(transport_name, "pipeline", send_with_pipeline, "200", run, requests);
+  result |= run_benchmark(
+      transport_name, "blob upload", send_with_blob_upload, "201", run, requests);
+
+  *script = az_perf_script_create(script_throttled, latency_msec);
+  result |= run_benchmark(
+      transport_name, "pipeline", send_with_pipeline, "429/503", run, requests);
+  result |= run_benchmark(
+      transport_name, "blob upload", send_with_blob_upload, "429/503", run, requests);
+
+  return result;
+}
+
+#ifdef TRANSPORT_CURL
+// libcurl allocates with the wrapped functions, and its allocations are counted.
+static void* perf_curl_malloc(size_t size) { return malloc(size); }
+static void* perf_curl_calloc(size_t count, size_t size) { return calloc(count, size); }
+static void* perf_curl_realloc(void* ptr, size_t size) { return realloc(ptr, size); }
+static void perf_curl_free(void* ptr) { free(ptr); }
+
+static char* perf_curl_strdup(char const* str)
+{
+  size_t const size = strlen(str) + 1;
+  char* const copy = (char*)malloc(size);
+  if (copy != NULL)
+  {
+    memcpy(copy, str, size);
+  }
+  return copy;
+}
+#endif // TRANSPORT_CURL
+
+int main(int argc, char** argv)
+{
+  int32_t const requests = argc > 1 ? atoi(argv[1]) : 100000;
+  int32_t const latency_msec = argc > 2 ? atoi(argv[2]) : 0;
+  int32_t const body_size = argc > 3 ? atoi(argv[3]) : 1024;
+  if (requests <= 0 || latency_msec < 0 || body_size < 0 || body_size > _az_PERF_MAX_BODY_SIZE)
+  {
+    printf("Usage: %s [requests] [latency_msec] [body_size]\n", argv[0]);
+    return 1;
+  }
+
+  static perf_run run;
+  run.latencies_nsec = (int64_t*)malloc((size_t)requests * sizeof(int64_t));
+  uint8_t* const body = (uint8_t*)malloc(body_size > 0 ? (size_t)body_size : 1);
+  if (run.latencies_nsec == NULL || body == NULL)
+  {
+    return 1;
+  }
+  memset(body, 'a', (size_t)body_size);
+  run.body = az_span_create(body, body_size);
+
+  // The policies of the pipeline are the ones of the blob client, but the ones disabled by default
+  // (hedging, single-flight and bulkhead).
+  run.api_version = (_az_http_policy_apiversion_options){
+    ._internal = {
+      .option_location = _az_http_policy_apiversion_option_location_header,
+      .name = AZ_SPAN_FROM_STR("x-ms-version"),
+      .version = AZ_STORAGE_API_VERSION,
+    },
+  };
+  run.telemetry = _az_http_policy_telemetry_options_default();
+  run.retry = _az_http_policy_retry_options_default();
+  run.pipeline = (_az_http_pipeline){
+    ._internal = {
+      .policies = {
+        { ._internal = { .process = az_http_pipeline_policy_apiversion,
+                         .options = &run.api_version } },
+        { ._internal = { .process = az_http_pipeline_policy_telemetry,
+                         .options = &run.telemetry } },
+        { ._internal = { .process = az_http_pipeline_policy_retry, .options = &run.retry } },
+        { ._internal = { .process = az_http_pipeline_policy_credential,
+                         .options = AZ_CREDENTIAL_ANONYMOUS } },
+#ifndef AZ_NO_LOGGING
+        { ._internal = { .process = az_http_pipeline_policy_logging, .options = NULL } },
+#endif // AZ_NO_LOGGING
+        { ._internal = { .process = az_http_pipeline_policy_transport, .options = NULL } },
+      },
+    },
+  };
+
+  printf(
+      "%d requests, %d ms latency, %d bytes uploaded, latencies in microseconds\n",
+      requests,
+      latency_msec,
+      body_size);
+  printf(
+      "%-10s %-12s %-9s %8s %6s %10s %7s %9s %9s %9s %9s\n",
+      "transport",
+      "operation",
+      "responses",
+      "requests",
+      "failed",
+      "req/s",
+      "allocs",
+      "p50",
+      "p90",
+      "p99",
+      "max");
+
+  static az_perf_script script;
+  az_perf_transport_set_script(&script);
+  int result = run_benchmarks(
+      "in-process",
+      AZ_SPAN_FROM_STR("https://account.blob.core.windows.net/container/blob"),
+      &script,
+      latency_msec,
+      &run,
+      requests);
+  az_perf_transport_set_script(NULL);
+
+#ifdef TRANSPORT_CURL
+  if (curl_global_init_mem(
+          CURL_GLOBAL_ALL,
+          perf_curl_malloc,
+          perf_curl_free,
+          perf_curl_realloc,
+          perf_curl_strdup,
+          perf_curl_calloc)
+      != CURLE_OK)
+  {
+    return 1;
+  }
+
+  static az_perf_loopback_server server;
+  uint8_t url_buffer[_az_PERF_URL_BUFFER_SIZE];
+  az_span url = AZ_SPAN_NULL;
+  if (az_failed(az_perf_loopback_server_start(&server, &script))
+      || az_failed(az_perf_loopback_server_get_url(
+          &server, AZ_SPAN_FROM_STR("container/blob"), AZ_SPAN_FROM_BUFFER(url_buffer), &url)))
+  {
+    printf("loopback   failed to start the server\n");
+    return 1;
+  }
+
+  result |= run_benchmarks("loopback", url, &script, latency_msec, &run, requests);
+
+  // Closes the connections before the server is stopped.
+  az_http_client_curl_cleanup();
+  az_perf_loopback_server_stop(&server);
+  curl_global_cleanup();
+#endif // TRANSPORT_CURL
+
+  free(body);
+  free(run.latencies_nsec);
+
+  return result;
+}
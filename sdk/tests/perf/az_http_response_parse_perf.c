@@ -0,0 +1,212 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file az_http_response_parse_perf.c
+ *
+ * @brief Measures how many headers per second #az_http_response_get_next_header parses, on
+ * responses of Azure Storage, and compares it with scanning the headers one byte at a time.
+ *
+ * Usage: az_http_response_parse_perf [iterations]
+ *
+ * The SIMD instruction set is chosen when the SDK is compiled, see README.md.
+ */
+
+#include "az_http_header_validation_private.h"
+#include "az_simd_private.h"
+#include "az_span_private.h"
+
+#include <azure/core/az_http.h>
+#include <azure/core/az_result.h>
+#include <azure/core/az_span.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include <azure/core/_az_cfg.h>
+
+// A Get Blob response with user metadata, and a Put Blob response.
+static char const get_blob_response[]
+    = "HTTP/1.1 200 OK\r\n"
+      "Content-Length: 1048576\r\n"
+      "Content-Type: application/octet-stream\r\n"
+      "Content-MD5: sQqNsWTgdUEFt6mb5y4/5Q==\r\n"
+      "Last-Modified: Wed, 14 Oct 2020 17:03:53 GMT\r\n"
+      "Accept-Ranges: bytes\r\n"
+      "ETag: \"0x8D87065D52F2A4B\"\r\n"
+      "Vary: Origin\r\n"
+      "Server: Windows-Azure-Blob/1.0 Microsoft-HTTPAPI/2.0\r\n"
+      "x-ms-request-id: 4f1e3a0c-701e-0059-2c4c-a23c8b000000\r\n"
+      "x-ms-client-request-id: 7b3c8f9e-0e4a-4f43-9c1d-2f8e6a0b5d11\r\n"
+      "x-ms-version: 2019-02-02\r\n"
+      "x-ms-creation-time: Wed, 14 Oct 2020 17:03:53 GMT\r\n"
+      "x-ms-meta-project: azure-sdk-for-c\r\n"
+      "x-ms-meta-description: Firmware image for the temperature sensors of building 42\r\n"
+      "x-ms-lease-status: unlocked\r\n"
+      "x-ms-lease-state: available\r\n"
+      "x-ms-blob-type: BlockBlob\r\n"
+      "x-ms-server-encrypted: true\r\n"
+      "Access-Control-Expose-Headers: x-ms-request-id,x-ms-client-request-id,Server,"
+      "x-ms-version,Content-Type,Last-Modified,ETag,x-ms-creation-time,x-ms-meta-project,"
+      "x-ms-meta-description,x-ms-lease-status,x-ms-lease-state,x-ms-blob-type,"
+      "x-ms-server-encrypted,Accept-Ranges,Content-Length,Date,Transfer-Encoding\r\n"
+      "Access-Control-Allow-Origin: *\r\n"
+      "Date: Wed, 14 Oct 2020 17:05:12 GMT\r\n"
+      "\r\n";
+
+static char const put_blob_response[]
+    = "HTTP/1.1 201 Created\r\n"
+      "Content-Length: 0\r\n"
+      "Content-MD5: sQqNsWTgdUEFt6mb5y4/5Q==\r\n"
+      "Last-Modified: Wed, 14 Oct 2020 17:03:53 GMT\r\n"
+      "ETag: \"0x8D87065D52F2A4B\"\r\n"
+      "Server: Windows-Azure-Blob/1.0 Microsoft-HTTPAPI/2.0\r\n"
+      "x-ms-request-id: 4f1e3a0c-701e-0059-2c4c-a23c8b000000\r\n"
+      "x-ms-client-request-id: 7b3c8f9e-0e4a-4f43-9c1d-2f8e6a0b5d11\r\n"
+      "x-ms-version: 2019-02-02\r\n"
+      "x-ms-content-crc64: 77uWZTolTHU=\r\n"
+      "x-ms-request-server-encrypted: true\r\n"
+      "Date: Wed, 14 Oct 2020 17:03:52 GMT\r\n"
+      "\r\n";
+
+// The predicates the parser used before the headers were scanned a block of bytes at a time.
+static az_result is_colon_or_invalid(az_span slice)
+{
+  uint8_t const c = az_span_ptr(slice)[0];
+  return c == ':' ? AZ_OK
+                  : (az_http_valid_token[c] ? AZ_CONTINUE : AZ_ERROR_HTTP_CORRUPT_RESPONSE_HEADER);
+}
+
+static az_result is_not_whitespace(az_span slice)
+{
+  uint8_t const c = az_span_ptr(slice)[0];
+  return c == ' ' || c == '\t' ? AZ_CONTINUE : AZ_OK;
+}
+
+static az_result is_carriage_return_or_invalid(az_span slice)
+{
+  uint8_t const c = az_span_ptr(slice)[0];
+  return c == '\r' ? AZ_OK : (c < ' ' && c != '\t' ? AZ_ERROR_UNEXPECTED_CHAR : AZ_CONTINUE);
+}
+
+// Parses the headers after the status line one byte at a time, returns how many there are.
+static int32_t parse_bytewise(az_span response)
+{
+  int32_t count = 0;
+  int32_t offset = 0;
+  if (az_failed(_az_span_scan_until(response, is_carriage_return_or_invalid, &offset)))
+  {
+    return -1;
+  }
+  response = az_span_slice_to_end(response, offset + 2);
+
+  while (az_span_ptr(response)[0] != '\r')
+  {
+    if (az_failed(_az_span_scan_until(response, is_colon_or_invalid, &offset)))
+    {
+      return -1;
+    }
+    response = az_span_slice_to_end(response, offset + 1);
+    if (az_failed(_az_span_scan_until(response, is_not_whitespace, &offset)))
+    {
+      return -1;
+    }
+    response = az_span_slice_to_end(response, offset);
+    if (az_failed(_az_span_scan_until(response, is_carriage_return_or_invalid, &offset)))
+    {
+      return -1;
+    }
+    response = az_span_slice_to_end(response, offset + 2);
+    ++count;
+  }
+
+  return count;
+}
+
+// Parses the status line and the headers with az_http_response, returns how many headers there
+// are.
+static int32_t parse_with_response(az_span response)
+{
+  az_http_response http_response = { 0 };
+  if (az_failed(az_http_response_init(&http_response, response)))
+  {
+    return -1;
+  }
+
+  az_http_response_status_line status_line = { 0 };
+  if (az_failed(az_http_response_get_status_line(&http_response, &status_line)))
+  {
+    return -1;
+  }
+
+  int32_t count = 0;
+  az_pair header = { 0 };
+  az_result result = AZ_OK;
+  while (az_succeeded(result = az_http_response_get_next_header(&http_response, &header)))
+  {
+    ++count;
+  }
+
+  return result == AZ_ERROR_ITEM_NOT_FOUND ? count : -1;
+}
+
+static int run_benchmark(
+    char const* name,
+    int32_t (*parse)(az_span),
+    az_span const* responses,
+    int32_t responses_count,
+    int32_t iterations)
+{
+  int64_t headers = 0;
+  clock_t const start = clock();
+  for (int32_t i = 0; i < iterations; ++i)
+  {
+    int32_t const count = parse(responses[i % responses_count]);
+    if (count < 0)
+    {
+      printf("%-28s failed to parse a response\n", name);
+      return 1;
+    }
+    headers += count;
+  }
+  double const elapsed_sec = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+  printf(
+      "%-28s %10lld headers  %8.3f s  %12.0f headers/s\n",
+      name,
+      (long long)headers,
+      elapsed_sec,
+      elapsed_sec > 0 ? (double)headers / elapsed_sec : 0.0);
+
+  return 0;
+}
+
+int main(int argc, char** argv)
+{
+  int32_t const iterations = argc > 1 ? atoi(argv[1]) : 2000000;
+  if (iterations <= 0)
+  {
+    printf("iterations must be positive\n");
+    return 1;
+  }
+
+  az_span const responses[] = {
+    az_span_create((uint8_t*)(uintptr_t)get_blob_response, (int32_t)sizeof(get_blob_response) - 1),
+    az_span_create((uint8_t*)(uintptr_t)put_blob_response, (int32_t)sizeof(put_blob_response) - 1),
+  };
+  int32_t const responses_count = (int32_t)(sizeof(responses) / sizeof(responses[0]));
+
+  printf("%d responses, SDK compiled with %s scanning\n", iterations, _az_SIMD_NAME);
+
+  int result
+      = run_benchmark("byte at a time", parse_bytewise, responses, responses_count, iterations);
+  result |= run_benchmark(
+      "az_http_response (" _az_SIMD_NAME ")",
+      parse_with_response,
+      responses,
+      responses_count,
+      iterations);
+
+  return result;
+}
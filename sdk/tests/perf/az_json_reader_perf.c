@@ -0,0 +1,477 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file az_json_reader_perf.c
+ *
+ * @brief Measures how many megabytes of JSON per second #az_json_reader_next_token reads, on
+ * device twins (compact and indented), on Device Provisioning Service responses and on messages in
+ * several languages, with and without UTF-8 validation, and on a device twin received in MQTT
+ * packets of 1 KiB (#az_json_reader_chunked_init). Then measures the time to look up properties of
+ * a device twin, read again for each lookup, read once for all of them
+ * (#az_json_reader_find_paths), or indexed once (#az_json_index).
+ *
+ * Usage: az_json_reader_perf [megabytes]
+ *
+ * The SIMD instruction set is chosen when the SDK is compiled, see README.md.
+ */
+
+#include "az_simd_private.h"
+
+#include <azure/core/az_json.h>
+#include <azure/core/az_result.h>
+#include <azure/core/az_span.h>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include <azure/core/_az_cfg.h>
+
+enum
+{
+  DOCUMENT_BUFFER_SIZE = 64 * 1024,
+};
+
+static char twin_buffer[DOCUMENT_BUFFER_SIZE];
+static char indented_twin_buffer[DOCUMENT_BUFFER_SIZE];
+static char registration_buffer[DOCUMENT_BUFFER_SIZE];
+static char messages_buffer[DOCUMENT_BUFFER_SIZE];
+
+// Appends to buffer the text printed by snprintf.
+#define APPEND(buffer, length, ...) \
+  length += snprintf(buffer + length, sizeof(buffer) - (size_t)length, __VA_ARGS__)
+
+// Writes a device twin with properties for a number of sensors, and the metadata of each of them.
+static az_span make_twin(char* buffer, size_t buffer_size, char const* newline, char const* indent)
+{
+  int length = 0;
+  uint32_t random = 12345;
+  length += snprintf(buffer + length, buffer_size - (size_t)length, "{%s", newline);
+  length += snprintf(
+      buffer + length,
+      buffer_size - (size_t)length,
+      "%s\"deviceId\": \"thermostat-0042\",%s%s\"etag\": \"AAAAAAAAAAc=\",%s%s\"version\": 87,%s"
+      "%s\"properties\": {%s%s%s\"reported\": {%s",
+      indent,
+      newline,
+      indent,
+      newline,
+      indent,
+      newline,
+      indent,
+      newline,
+      indent,
+      indent,
+      newline);
+
+  for (int i = 0; i < 120; ++i)
+  {
+    random = random * 1103515245U + 12345U;
+    length += snprintf(
+        buffer + length,
+        buffer_size - (size_t)length,
+        "%s%s%s\"sensor%03d\": {%s"
+        "%s%s%s%s\"temperature\": %d.%02d,%s"
+        "%s%s%s%s\"humidity\": %d,%s"
+        "%s%s%s%s\"firmware\": \"1.%d.%d\",%s"
+        "%s%s%s%s\"online\": %s,%s"
+        "%s%s%s%s\"$lastUpdated\": \"2020-10-14T17:%02d:%02d.%07dZ\"%s"
+        "%s%s%s}%s%s",
+        indent,
+        indent,
+        indent,
+        i,
+        newline,
+        indent,
+        indent,
+        indent,
+        indent,
+        18 + (int)(random >> 16) % 8,
+        (int)(random >> 4) % 100,
+        newline,
+        indent,
+        indent,
+        indent,
+        indent,
+        30 + (int)(random >> 12) % 40,
+        newline,
+        indent,
+        indent,
+        indent,
+        indent,
+        (int)(random >> 20) % 4,
+        (int)(random >> 8) % 10,
+        newline,
+        indent,
+        indent,
+        indent,
+        indent,
+        (random >> 24) % 8 == 0 ? "false" : "true",
+        newline,
+        indent,
+        indent,
+        indent,
+        indent,
+        i % 60,
+        (i * 7) % 60,
+        (int)(random >> 4) % 10000000,
+        newline,
+        indent,
+        indent,
+        indent,
+        i < 119 ? "," : "",
+        newline);
+  }
+
+  length += snprintf(
+      buffer + length,
+      buffer_size - (size_t)length,
+      "%s%s}%s%s}%s}",
+      indent,
+      indent,
+      newline,
+      indent,
+      newline);
+  return az_span_create((uint8_t*)buffer, length);
+}
+
+// Writes a registration state returned by the Device Provisioning Service, with the certificate
+// chain of the device.
+static az_span make_registration()
+{
+  int length = 0;
+  APPEND(
+      registration_buffer,
+      length,
+      "{\"operationId\":\"4.d0a671905ea5b2c8.e7173b7b-0e54-4aa0-9d20-aeb1b89e6c7d\","
+      "\"status\":\"assigned\",\"registrationState\":{\"x509\":{\"enrollmentGroupId\":"
+      "\"building-42\",\"signingCertificateInfo\":{\"subjectName\":\"CN=building-42-intermediate\","
+      "\"sha1Thumbprint\":\"A3E0C1B2D4F5E6A7B8C9D0E1F2A3B4C5D6E7F8A9\",\"sha256Thumbprint\":"
+      "\"3F2E1D0C9B8A7F6E5D4C3B2A1F0E9D8C7B6A5F4E3D2C1B0A9F8E7D6C5B4A3F2E\","
+      "\"issuerName\":\"CN=contoso-root\",\"notBeforeUtc\":\"2020-10-01T00:00:00Z\","
+      "\"notAfterUtc\":\"2021-10-01T00:00:00Z\",\"serialNumber\":\"5B1F2C3D4E5F6A7B\","
+      "\"version\":3},\"certificateChain\":[");
+
+  uint32_t random = 54321;
+  for (int certificate = 0; certificate < 3; ++certificate)
+  {
+    APPEND(registration_buffer, length, "%s\"", certificate == 0 ? "" : ",");
+    for (int i = 0; i < 1200; ++i)
+    {
+      static char const base64[]
+          = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+      random = random * 1103515245U + 12345U;
+      registration_buffer[length++] = base64[(random >> 16) % 64];
+    }
+    APPEND(registration_buffer, length, "\"");
+  }
+
+  APPEND(
+      registration_buffer,
+      length,
+      "]},\"registrationId\":\"thermostat-0042\",\"createdDateTimeUtc\":"
+      "\"2020-10-14T17:03:53.6504436Z\",\"assignedHub\":\"contoso-hub.azure-devices.net\","
+      "\"deviceId\":\"thermostat-0042\",\"status\":\"assigned\","
+      "\"substatus\":\"initialAssignment\","
+      "\"lastUpdatedDateTimeUtc\":\"2020-10-14T17:03:53.8930296Z\",\"etag\":"
+      "\"IjE0MDBhMmU0LTAwMDAtMDMwMC0wMDAwLTVmODczNWU5MDAwMCI=\",\"payload\":{\"hubName\":"
+      "\"contoso-hub\",\"note\":\"Provisioned by the building 42 enrollment group\\r\\n"
+      "see \\\"https://contoso.example/devices\\\" \\u00e9\"}}}");
+
+  return az_span_create((uint8_t*)registration_buffer, length);
+}
+
+// Writes an array of messages sent to devices, in English, French, Greek, Japanese and with emoji.
+static az_span make_messages()
+{
+  static char const* const texts[] = {
+    "The temperature of the room is above the target, the fan is turned on.",
+    "La temp\xC3\xA9rature de la pi\xC3\xA8""ce d\xC3\xA9passe la consigne, le ventilateur "
+    "d\xC3\xA9marre.",
+    "\xCE\x97 \xCE\xB8\xCE\xB5\xCF\x81\xCE\xBC\xCE\xBF\xCE\xBA\xCF\x81\xCE\xB1\xCF\x83"
+    "\xCE\xAF\xCE\xB1 \xCE\xB5\xCE\xAF\xCE\xBD\xCE\xB1\xCE\xB9 \xCF\x85\xCF\x88\xCE\xB7"
+    "\xCE\xBB\xCE\xAE.",
+    "\xE9\x83\xA8\xE5\xB1\x8B\xE3\x81\xAE\xE6\xB8\xA9\xE5\xBA\xA6\xE3\x81\x8C\xE8\xA8"
+    "\xAD\xE5\xAE\x9A\xE5\x80\xA4\xE3\x82\x92\xE8\xB6\x85\xE3\x81\x88\xE3\x81\xA6\xE3"
+    "\x81\x84\xE3\x81\xBE\xE3\x81\x99\xE3\x80\x82",
+    "Fan on \xF0\x9F\x8C\xA1\xEF\xB8\x8F \xF0\x9F\x94\xA5 \xE2\x86\x92 \xE2\x9D\x84\xEF"
+    "\xB8\x8F",
+  };
+
+  int length = 0;
+  APPEND(messages_buffer, length, "[");
+  for (int i = 0; i < 100; ++i)
+  {
+    APPEND(
+        messages_buffer,
+        length,
+        "%s{\"id\":%d,\"lang\":%d,\"text\":\"%s\"}",
+        i == 0 ? "" : ",",
+        i,
+        i % 5,
+        texts[i % 5]);
+  }
+  APPEND(messages_buffer, length, "]");
+
+  return az_span_create((uint8_t*)messages_buffer, length);
+}
+
+// Reads the next token of a reader of json in buffers of chunk_size bytes, as a device receives
+// it in MQTT packets, the first *ref_offset bytes of which are already given to the reader.
+static az_result next_chunked_token(
+    az_json_reader* ref_reader,
+    az_span json,
+    int32_t chunk_size,
+    int32_t* ref_offset)
+{
+  while (true)
+  {
+    az_result const result = az_json_reader_next_token(ref_reader);
+    if (result != AZ_ERROR_JSON_READER_NEED_MORE_DATA)
+    {
+      return result;
+    }
+
+    if (*ref_offset == az_span_size(json))
+    {
+      az_json_reader_chunked_end(ref_reader);
+      continue;
+    }
+
+    int32_t const end = az_span_size(json) - *ref_offset > chunk_size ? *ref_offset + chunk_size
+                                                                     : az_span_size(json);
+    AZ_RETURN_IF_FAILED(
+        az_json_reader_chunked_append(ref_reader, az_span_slice(json, *ref_offset, end)));
+    *ref_offset = end;
+  }
+}
+
+// Reads json whole, or in buffers of chunk_size bytes if it isn't 0.
+static int run_benchmark(
+    char const* name,
+    az_span json,
+    az_json_reader_options const* options,
+    int32_t chunk_size,
+    int64_t total_bytes)
+{
+  static uint8_t token_buffer[256];
+
+  int64_t const iterations
+      = total_bytes / az_span_size(json) > 0 ? total_bytes / az_span_size(json) : 1;
+
+  int64_t tokens = 0;
+  clock_t const start = clock();
+  for (int64_t i = 0; i < iterations; ++i)
+  {
+    az_json_reader reader;
+    int32_t offset = chunk_size == 0 || chunk_size > az_span_size(json) ? az_span_size(json)
+                                                                         : chunk_size;
+    if (az_failed(
+            chunk_size == 0
+                ? az_json_reader_init(&reader, json, options)
+                : az_json_reader_chunked_init(
+                    &reader,
+                    az_span_slice(json, 0, offset),
+                    AZ_SPAN_FROM_BUFFER(token_buffer),
+                    options)))
+    {
+      printf("%-18s failed to initialize the reader\n", name);
+      return 1;
+    }
+
+    az_result result;
+    while (az_succeeded(
+        result = chunk_size == 0 ? az_json_reader_next_token(&reader)
+                                 : next_chunked_token(&reader, json, chunk_size, &offset)))
+    {
+      ++tokens;
+    }
+
+    if (result != AZ_ERROR_JSON_READER_DONE)
+    {
+      printf("%-18s failed to read the document (0x%08x)\n", name, (unsigned)result);
+      return 1;
+    }
+  }
+  double const elapsed_sec = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+  printf(
+      "%-18s %-6s %6d bytes %5lld tokens  %8.1f MB/s\n",
+      name,
+      chunk_size != 0 ? "1 KiB" : options->validate_utf8 ? "utf-8" : "",
+      az_span_size(json),
+      (long long)(tokens / iterations),
+      elapsed_sec > 0 ? (double)(iterations * az_span_size(json)) / elapsed_sec / 1e6 : 0.0);
+
+  return 0;
+}
+
+// The properties looked up in the twin, the names of the objects they are in, then theirs.
+static az_span const lookups[][4] = {
+  { AZ_SPAN_LITERAL_FROM_STR("version") },
+  { AZ_SPAN_LITERAL_FROM_STR("properties"),
+    AZ_SPAN_LITERAL_FROM_STR("reported"),
+    AZ_SPAN_LITERAL_FROM_STR("sensor060"),
+    AZ_SPAN_LITERAL_FROM_STR("online") },
+  { AZ_SPAN_LITERAL_FROM_STR("properties"),
+    AZ_SPAN_LITERAL_FROM_STR("reported"),
+    AZ_SPAN_LITERAL_FROM_STR("sensor119"),
+    AZ_SPAN_LITERAL_FROM_STR("temperature") },
+};
+
+// The same properties, as JSON pointers.
+static az_span const lookup_pointers[] = {
+  AZ_SPAN_LITERAL_FROM_STR("/version"),
+  AZ_SPAN_LITERAL_FROM_STR("/properties/reported/sensor060/online"),
+  AZ_SPAN_LITERAL_FROM_STR("/properties/reported/sensor119/temperature"),
+};
+
+// Finds a property of the twin with a reader, skipping the values of the other properties.
+static az_result lookup_with_reader(az_span json, az_span const* names, az_json_token* out_value)
+{
+  az_json_reader reader;
+  AZ_RETURN_IF_FAILED(az_json_reader_init(&reader, json, NULL));
+  AZ_RETURN_IF_FAILED(az_json_reader_next_token(&reader));
+  for (int32_t i = 0; i < 4 && az_span_size(names[i]) > 0; ++i)
+  {
+    AZ_RETURN_IF_FAILED(az_json_reader_next_token(&reader));
+    while (!az_json_token_is_text_equal(&reader.token, names[i]))
+    {
+      if (reader.token.kind != AZ_JSON_TOKEN_PROPERTY_NAME)
+      {
+        return AZ_ERROR_ITEM_NOT_FOUND;
+      }
+      AZ_RETURN_IF_FAILED(az_json_reader_skip_children(&reader));
+      AZ_RETURN_IF_FAILED(az_json_reader_next_token(&reader));
+    }
+    AZ_RETURN_IF_FAILED(az_json_reader_next_token(&reader));
+  }
+
+  *out_value = reader.token;
+  return AZ_OK;
+}
+
+// Finds a property of the twin in its index.
+static az_result lookup_in_index(
+    az_json_index const* index,
+    az_span const* names,
+    az_json_token* out_value)
+{
+  int32_t position = 0;
+  for (int32_t i = 0; i < 4 && az_span_size(names[i]) > 0; ++i)
+  {
+    AZ_RETURN_IF_FAILED(az_json_index_find_property(index, position, names[i], &position));
+  }
+
+  *out_value = az_json_index_get_token(index, position);
+  return AZ_OK;
+}
+
+static int run_lookup_benchmark(az_span json, int64_t lookups_count)
+{
+  static uint8_t index_buffer[AZ_JSON_INDEX_BUFFER_SIZE(2048)];
+  int32_t const lookups_size = (int32_t)(sizeof(lookups) / sizeof(lookups[0]));
+  az_json_token value;
+
+  clock_t start = clock();
+  for (int64_t i = 0; i < lookups_count; ++i)
+  {
+    if (az_failed(lookup_with_reader(json, lookups[i % lookups_size], &value)))
+    {
+      printf("lookup (reader) failed\n");
+      return 1;
+    }
+  }
+  double const reader_sec = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+  // All the properties are found in one pass.
+  az_json_token values[sizeof(lookup_pointers) / sizeof(lookup_pointers[0])];
+  start = clock();
+  for (int64_t i = 0; i < lookups_count; i += lookups_size)
+  {
+    az_json_reader reader;
+    if (az_failed(az_json_reader_init(&reader, json, NULL))
+        || az_failed(az_json_reader_find_paths(&reader, lookup_pointers, lookups_size, values)))
+    {
+      printf("lookup (pointers) failed\n");
+      return 1;
+    }
+  }
+  double const pointers_sec = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+  // Indexing is about as long as reading, so it's repeated less.
+  int64_t const indexes_count = lookups_count / 100 > 0 ? lookups_count / 100 : 1;
+  az_json_index index;
+  start = clock();
+  for (int64_t i = 0; i < indexes_count; ++i)
+  {
+    if (az_failed(az_json_index_init(&index, json, AZ_SPAN_FROM_BUFFER(index_buffer), NULL)))
+    {
+      printf("index failed\n");
+      return 1;
+    }
+  }
+  double const index_sec = (double)(clock() - start) / CLOCKS_PER_SEC / (double)indexes_count;
+
+  start = clock();
+  for (int64_t i = 0; i < lookups_count; ++i)
+  {
+    if (az_failed(lookup_in_index(&index, lookups[i % lookups_size], &value)))
+    {
+      printf("lookup (index) failed\n");
+      return 1;
+    }
+  }
+  double const lookup_sec = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+  printf(
+      "lookup (reader)    %8.0f ns\n"
+      "lookup (pointers)  %8.0f ns, %d at once\n"
+      "index              %8.0f ns, %d tokens\n"
+      "lookup (index)     %8.0f ns\n",
+      reader_sec * 1e9 / (double)lookups_count,
+      pointers_sec * 1e9 / (double)lookups_count,
+      (int)lookups_size,
+      index_sec * 1e9,
+      az_json_index_get_token_count(&index),
+      lookup_sec * 1e9 / (double)lookups_count);
+
+  return 0;
+}
+
+int main(int argc, char** argv)
+{
+  int64_t const megabytes = argc > 1 ? atoi(argv[1]) : 500;
+  if (megabytes <= 0)
+  {
+    printf("megabytes must be positive\n");
+    return 1;
+  }
+
+  printf("SIMD instruction set: %s\n", _az_SIMD_NAME);
+
+  az_span const documents[] = {
+    make_twin(twin_buffer, sizeof(twin_buffer), "", ""),
+    make_twin(indented_twin_buffer, sizeof(indented_twin_buffer), "\n", "  "),
+    make_registration(),
+    make_messages(),
+  };
+  static char const* const names[] = { "twin", "twin (indented)", "registration", "messages" };
+
+  int result = 0;
+  for (size_t i = 0; i < sizeof(documents) / sizeof(documents[0]); ++i)
+  {
+    az_json_reader_options options = az_json_reader_options_default();
+    result |= run_benchmark(names[i], documents[i], &options, 0, megabytes * 1000000);
+    options.validate_utf8 = true;
+    result |= run_benchmark(names[i], documents[i], &options, 0, megabytes * 1000000);
+  }
+
+  az_json_reader_options const options = az_json_reader_options_default();
+  result |= run_benchmark(names[0], documents[0], &options, 1024, megabytes * 1000000);
+  result |= run_lookup_benchmark(documents[0], megabytes * 1000);
+
+  return result;
+}
@@ -0,0 +1,385 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "az_perf_transport.h"
+
+#include <azure/core/az_http.h>
+#include <azure/core/az_http_transport.h>
+#include <azure/core/az_platform.h>
+#include <azure/core/az_result.h>
+#include <azure/core/az_span.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <azure/core/_az_cfg.h>
+
+enum
+{
+  _az_PERF_REQUEST_BUFFER_SIZE = 8 * 1024,
+  _az_PERF_RESPONSE_BUFFER_SIZE = 512,
+};
+
+static az_span const _az_PERF_HTTP_VERSION = AZ_SPAN_LITERAL_FROM_STR("HTTP/1.1 ");
+
+// The headers of all the responses, which have no body.
+static az_span const _az_PERF_HEADERS
+    = AZ_SPAN_LITERAL_FROM_STR("Content-Length: 0\r\n"
+                               "x-ms-request-id: 6f4d2a7e-301e-0071-2a5b-5bb5a3000000\r\n"
+                               "x-ms-version: 2019-02-02\r\n");
+
+// The header of the responses that are retried, so that the retries don't wait for the delays of
+// the retry policy.
+static az_span const _az_PERF_RETRY_AFTER_HEADER
+    = AZ_SPAN_LITERAL_FROM_STR("x-ms-retry-after-ms: 1\r\n");
+
+static az_span _az_perf_get_reason_phrase(az_http_status_code status_code)
+{
+  switch (status_code)
+  {
+    case AZ_HTTP_STATUS_CODE_OK:
+      return AZ_SPAN_FROM_STR("OK");
+    case AZ_HTTP_STATUS_CODE_CREATED:
+      return AZ_SPAN_FROM_STR("Created");
+    case AZ_HTTP_STATUS_CODE_TOO_MANY_REQUESTS:
+      return AZ_SPAN_FROM_STR("Too Many Requests");
+    case AZ_HTTP_STATUS_CODE_INTERNAL_SERVER_ERROR:
+      return AZ_SPAN_FROM_STR("Internal Server Error");
+    case AZ_HTTP_STATUS_CODE_SERVICE_UNAVAILABLE:
+      return AZ_SPAN_FROM_STR("Service Unavailable");
+    default:
+      return AZ_SPAN_FROM_STR("Status");
+  }
+}
+
+AZ_NODISCARD az_result az_perf_script_next_response(
+    az_perf_script* ref_script,
+    az_span method,
+    az_span buffer,
+    az_span* out_response)
+{
+  // The in-process transport and the loopback server run on different threads.
+  int32_t index = __atomic_fetch_add(&ref_script->_internal.next, 1, __ATOMIC_RELAXED);
+  int32_t count = 0;
+  while (ref_script->status_codes[count] != AZ_HTTP_STATUS_CODE_END_OF_LIST)
+  {
+    ++count;
+  }
+  index %= count;
+
+  az_http_status_code status_code = ref_script->status_codes[index];
+  if (status_code == AZ_HTTP_STATUS_CODE_NONE)
+  {
+    status_code = az_span_is_content_equal(method, az_http_method_put())
+        ? AZ_HTTP_STATUS_CODE_CREATED
+        : AZ_HTTP_STATUS_CODE_OK;
+  }
+
+  if (ref_script->latency_msec > 0)
+  {
+    az_platform_sleep_msec(ref_script->latency_msec);
+  }
+
+  // HTTP/1.1 <status code> <reason phrase>\r\n<headers>\r\n
+  az_span const reason_phrase = _az_perf_get_reason_phrase(status_code);
+  bool const is_retried = status_code >= AZ_HTTP_STATUS_CODE_TOO_MANY_REQUESTS;
+  int32_t const required_size = az_span_size(_az_PERF_HTTP_VERSION) + 3 + 1
+      + az_span_size(reason_phrase) + 2 + az_span_size(_az_PERF_HEADERS)
+      + (is_retried ? az_span_size(_az_PERF_RETRY_AFTER_HEADER) : 0) + 2;
+  if (az_span_size(buffer) < required_size)
+  {
+    return AZ_ERROR_INSUFFICIENT_SPAN_SIZE;
+  }
+
+  az_span remainder = az_span_copy(buffer, _az_PERF_HTTP_VERSION);
+  if (az_failed(az_span_i32toa(remainder, (int32_t)status_code, &remainder)))
+  {
+    return AZ_ERROR_INSUFFICIENT_SPAN_SIZE;
+  }
+  remainder = az_span_copy_u8(remainder, ' ');
+  remainder = az_span_copy(remainder, reason_phrase);
+  remainder = az_span_copy(remainder, AZ_SPAN_FROM_STR("\r\n"));
+  remainder = az_span_copy(remainder, _az_PERF_HEADERS);
+  if (is_retried)
+  {
+    remainder = az_span_copy(remainder, _az_PERF_RETRY_AFTER_HEADER);
+  }
+  remainder = az_span_copy(remainder, AZ_SPAN_FROM_STR("\r\n"));
+
+  *out_response = az_span_slice(buffer, 0, az_span_size(buffer) - az_span_size(remainder));
+  return AZ_OK;
+}
+
+static az_perf_script* _az_perf_transport_script = NULL;
+
+void az_perf_transport_set_script(az_perf_script* ref_script)
+{
+  _az_perf_transport_script = ref_script;
+}
+
+AZ_NODISCARD az_result __real_az_http_client_send_request(
+    az_http_request const* request,
+    az_http_response* ref_response);
+
+AZ_NODISCARD az_result __wrap_az_http_client_send_request(
+    az_http_request const* request,
+    az_http_response* ref_response);
+
+AZ_NODISCARD az_result __wrap_az_http_client_send_request(
+    az_http_request const* request,
+    az_http_response* ref_response)
+{
+  if (_az_perf_transport_script == NULL)
+  {
+    return __real_az_http_client_send_request(request, ref_response);
+  }
+
+  az_span method = AZ_SPAN_NULL;
+  AZ_RETURN_IF_FAILED(az_http_request_get_method(request, &method));
+
+  // The response is written to the response buffer, as the HTTP client would.
+  uint8_t buffer[_az_PERF_RESPONSE_BUFFER_SIZE];
+  az_span response = AZ_SPAN_NULL;
+  AZ_RETURN_IF_FAILED(az_perf_script_next_response(
+      _az_perf_transport_script, method, AZ_SPAN_FROM_BUFFER(buffer), &response));
+
+  return az_http_response_append(ref_response, response);
+}
+
+// Reads the requests of a connection, and replies to each of them once it is read.
+static void* _az_perf_loopback_server_serve(void* arg)
+{
+  _az_perf_loopback_connection* const slot = (_az_perf_loopback_connection*)arg;
+  int const connection = slot->socket;
+  az_perf_script* const script = slot->script;
+
+  uint8_t request[_az_PERF_REQUEST_BUFFER_SIZE];
+  uint8_t response_buffer[_az_PERF_RESPONSE_BUFFER_SIZE];
+  int32_t received = 0;
+
+  while (true)
+  {
+    az_span const received_span = az_span_create(request, received);
+    int32_t const headers_end = az_span_find(received_span, AZ_SPAN_FROM_STR("\r\n\r\n"));
+    if (headers_end < 0)
+    {
+      if (received == (int32_t)sizeof(request))
+      {
+        break; // The headers of the request are too large.
+      }
+
+      ssize_t const size
+          = recv(connection, request + received, sizeof(request) - (size_t)received, 0);
+      if (size <= 0)
+      {
+        break;
+      }
+      received += (int32_t)size;
+      continue;
+    }
+
+    // The request body is discarded as it is received.
+    az_span const headers = az_span_slice(received_span, 0, headers_end + 2);
+    int32_t const content_length_start
+        = az_span_find(headers, AZ_SPAN_FROM_STR("\r\nContent-Length:"));
+    uint64_t body_size = 0;
+    if (content_length_start >= 0)
+    {
+      az_span value = az_span_slice_to_end(
+          headers, content_length_start + (int32_t)sizeof("\r\nContent-Length:") - 1);
+      value = az_span_slice(value, 0, az_span_find(value, AZ_SPAN_FROM_STR("\r\n")));
+      while (az_span_size(value) > 0 && az_span_ptr(value)[0] == ' ')
+      {
+        value = az_span_slice_to_end(value, 1);
+      }
+      if (az_failed(az_span_atou64(value, &body_size)))
+      {
+        break;
+      }
+    }
+
+    // The method is copied, the body is received over the request.
+    uint8_t method_buffer[8] = { 0 };
+    int32_t const method_end = az_span_find(headers, AZ_SPAN_FROM_STR(" "));
+    if (method_end < 0 || method_end > (int32_t)sizeof(method_buffer))
+    {
+      break;
+    }
+    az_span_copy(AZ_SPAN_FROM_BUFFER(method_buffer), az_span_slice(headers, 0, method_end));
+    az_span const method = az_span_create(method_buffer, method_end);
+
+    int32_t const request_end = headers_end + 4;
+    uint64_t const buffered_body_size = (uint64_t)(received - request_end);
+    uint64_t body_left = body_size > buffered_body_size ? body_size - buffered_body_size : 0;
+    while (body_left > 0)
+    {
+      size_t const size_to_receive
+          = body_left < sizeof(request) ? (size_t)body_left : sizeof(request);
+      ssize_t const size = recv(connection, request, size_to_receive, 0);
+      if (size <= 0)
+      {
+        break;
+      }
+      body_left -= (uint64_t)size;
+    }
+    if (body_left > 0)
+    {
+      break;
+    }
+
+    az_span response = AZ_SPAN_NULL;
+    if (az_failed(az_perf_script_next_response(
+            script, method, AZ_SPAN_FROM_BUFFER(response_buffer), &response))
+        || send(connection, az_span_ptr(response), (size_t)az_span_size(response), MSG_NOSIGNAL)
+            != (ssize_t)az_span_size(response))
+    {
+      break;
+    }
+
+    // Keep the start of the next request, if it was received with this one.
+    int32_t const consumed = request_end
+        + (int32_t)(body_size < buffered_body_size ? body_size : buffered_body_size);
+    memmove(request, request + consumed, (size_t)(received - consumed));
+    received -= consumed;
+  }
+
+  close(connection);
+  __atomic_store_n(&slot->socket, -1, __ATOMIC_RELEASE);
+  return NULL;
+}
+
+static void* _az_perf_loopback_server_accept(void* arg)
+{
+  az_perf_loopback_server* const server = (az_perf_loopback_server*)arg;
+
+  while (true)
+  {
+    int const connection = accept(server->_internal.listen_socket, NULL, NULL);
+    if (connection < 0)
+    {
+      break; // The server is stopped.
+    }
+
+    int const no_delay = 1;
+    (void)setsockopt(connection, IPPROTO_TCP, TCP_NODELAY, &no_delay, sizeof(no_delay));
+
+    // The connection is served in a free slot, or closed when there's none.
+    _az_perf_loopback_connection* slot = NULL;
+    for (int32_t i = 0; i < AZ_PERF_LOOPBACK_MAX_CONNECTIONS; ++i)
+    {
+      if (__atomic_load_n(&server->_internal.connections[i].socket, __ATOMIC_ACQUIRE) < 0)
+      {
+        slot = &server->_internal.connections[i];
+        break;
+      }
+    }
+
+    pthread_t thread;
+    if (slot == NULL)
+    {
+      close(connection);
+      continue;
+    }
+    slot->script = server->_internal.script;
+    slot->socket = connection;
+    if (pthread_create(&thread, NULL, _az_perf_loopback_server_serve, slot) != 0)
+    {
+      slot->socket = -1;
+      close(connection);
+      continue;
+    }
+    (void)pthread_detach(thread);
+  }
+
+  return NULL;
+}
+
+AZ_NODISCARD az_result
+az_perf_loopback_server_start(az_perf_loopback_server* out_server, az_perf_script* ref_script)
+{
+  out_server->_internal.script = ref_script;
+  out_server->_internal.listen_socket = -1;
+  out_server->_internal.port = 0;
+  out_server->_internal.is_started = false;
+  for (int32_t i = 0; i < AZ_PERF_LOOPBACK_MAX_CONNECTIONS; ++i)
+  {
+    out_server->_internal.connections[i].script = ref_script;
+    out_server->_internal.connections[i].socket = -1;
+  }
+
+  int const listen_socket = socket(AF_INET, SOCK_STREAM, 0);
+  if (listen_socket < 0)
+  {
+    return AZ_ERROR_NOT_SUPPORTED;
+  }
+
+  struct sockaddr_in address = { 0 };
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  address.sin_port = 0;
+  socklen_t address_size = sizeof(address);
+
+  pthread_t thread;
+  if (bind(listen_socket, (struct sockaddr*)&address, sizeof(address)) != 0
+      || listen(listen_socket, SOMAXCONN) != 0
+      || getsockname(listen_socket, (struct sockaddr*)&address, &address_size) != 0)
+  {
+    close(listen_socket);
+    return AZ_ERROR_NOT_SUPPORTED;
+  }
+
+  out_server->_internal.listen_socket = listen_socket;
+  out_server->_internal.port = ntohs(address.sin_port);
+
+  if (pthread_create(&thread, NULL, _az_perf_loopback_server_accept, out_server) != 0)
+  {
+    close(listen_socket);
+    return AZ_ERROR_NOT_SUPPORTED;
+  }
+  (void)pthread_detach(thread);
+
+  out_server->_internal.is_started = true;
+  return AZ_OK;
+}
+
+AZ_NODISCARD az_result az_perf_loopback_server_get_url(
+    az_perf_loopback_server const* server,
+    az_span path,
+    az_span buffer,
+    az_span* out_url)
+{
+  int const size = snprintf(
+      (char*)az_span_ptr(buffer),
+      (size_t)az_span_size(buffer),
+      "http://127.0.0.1:%u/%.*s",
+      (unsigned)server->_internal.port,
+      (int)az_span_size(path),
+      (char const*)az_span_ptr(path));
+  if (size < 0 || size >= az_span_size(buffer))
+  {
+    return AZ_ERROR_INSUFFICIENT_SPAN_SIZE;
+  }
+
+  *out_url = az_span_slice(buffer, 0, size);
+  return AZ_OK;
+}
+
+void az_perf_loopback_server_stop(az_perf_loopback_server* ref_server)
+{
+  if (ref_server->_internal.is_started)
+  {
+    // Makes accept() fail in the thread of the server.
+    (void)shutdown(ref_server->_internal.listen_socket, SHUT_RDWR);
+    close(ref_server->_internal.listen_socket);
+    ref_server->_internal.is_started = false;
+  }
+}
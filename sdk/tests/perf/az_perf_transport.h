@@ -0,0 +1,136 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file az_perf_transport.h
+ *
+ * @brief Transports the benchmarks send requests to without a network: an in-process transport,
+ * which replaces the HTTP client of the SDK, and an HTTP server listening on the loopback
+ * interface. Both reply to each request with the next response of the same script.
+ *
+ * The in-process transport is `__wrap_az_http_client_send_request`, the benchmarks using it are
+ * linked with `-Wl,--wrap=az_http_client_send_request`. Requests are sent to the HTTP client of the
+ * SDK (e.g. libcurl) while it is disabled.
+ */
+
+#ifndef _az_PERF_TRANSPORT_H
+#define _az_PERF_TRANSPORT_H
+
+#include <azure/core/az_http.h>
+#include <azure/core/az_http_transport.h>
+#include <azure/core/az_result.h>
+#include <azure/core/az_span.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <azure/core/_az_cfg_prefix.h>
+
+/**
+ * @brief The responses of a transport, which replies to the successive attempts with the statuses
+ * of the script, repeated.
+ */
+typedef struct
+{
+  /// Statuses of the responses, terminated by #AZ_HTTP_STATUS_CODE_END_OF_LIST.
+  /// #AZ_HTTP_STATUS_CODE_NONE is the success of the request method: `201 Created` for `PUT`
+  /// requests, `200 OK` otherwise. Throttled and failed responses are retried after 1 ms.
+  az_http_status_code const* status_codes;
+
+  /// Time in milliseconds the transport waits before it replies.
+  int32_t latency_msec;
+
+  struct
+  {
+    int32_t next; // Index of the status of the next response.
+  } _internal;
+} az_perf_script;
+
+/**
+ * @brief Initializes a script replying with \p status_codes after \p latency_msec.
+ */
+AZ_NODISCARD AZ_INLINE az_perf_script
+az_perf_script_create(az_http_status_code const* status_codes, int32_t latency_msec)
+{
+  return (az_perf_script){
+    .status_codes = status_codes,
+    .latency_msec = latency_msec,
+    ._internal = { .next = 0 },
+  };
+}
+
+/**
+ * @brief Writes the next response of \p ref_script to a request with \p method, after waiting for
+ * the latency of the script. It can be called from several threads.
+ *
+ * @return The response, the start of \p buffer.
+ */
+AZ_NODISCARD az_result az_perf_script_next_response(
+    az_perf_script* ref_script,
+    az_span method,
+    az_span buffer,
+    az_span* out_response);
+
+/**
+ * @brief Makes the in-process transport reply to requests with \p ref_script, or the HTTP client
+ * of the SDK send them when \p ref_script is `NULL`.
+ */
+void az_perf_transport_set_script(az_perf_script* ref_script);
+
+enum
+{
+  /// The number of connections a loopback server serves at once, others are closed when accepted.
+  AZ_PERF_LOOPBACK_MAX_CONNECTIONS = 64,
+};
+
+// A connection of a loopback server, and the script it replies with.
+typedef struct
+{
+  az_perf_script* script;
+  int socket; // -1 while the slot of the connection is free.
+} _az_perf_loopback_connection;
+
+/**
+ * @brief An HTTP/1.1 server, replying on the loopback interface with the responses of a script.
+ * Each connection is served by a thread and kept alive until the client closes it.
+ */
+typedef struct
+{
+  struct
+  {
+    az_perf_script* script;
+    int listen_socket;
+    uint16_t port;
+    bool is_started;
+    _az_perf_loopback_connection connections[AZ_PERF_LOOPBACK_MAX_CONNECTIONS];
+  } _internal;
+} az_perf_loopback_server;
+
+/**
+ * @brief Starts \p out_server, listening on an ephemeral port of 127.0.0.1 and replying with
+ * \p ref_script.
+ *
+ * @return #AZ_OK, or #AZ_ERROR_NOT_SUPPORTED when the server can't listen.
+ */
+AZ_NODISCARD az_result
+az_perf_loopback_server_start(az_perf_loopback_server* out_server, az_perf_script* ref_script);
+
+/**
+ * @brief Writes the url of \p path on \p server, e.g. `http://127.0.0.1:port/path`, to
+ * \p buffer.
+ */
+AZ_NODISCARD az_result az_perf_loopback_server_get_url(
+    az_perf_loopback_server const* server,
+    az_span path,
+    az_span buffer,
+    az_span* out_url);
+
+/**
+ * @brief Stops accepting connections. The connections still open are served until they are
+ * closed.
+ */
+void az_perf_loopback_server_stop(az_perf_loopback_server* ref_server);
+
+#include <azure/core/_az_cfg_suffix.h>
+
+#endif // _az_PERF_TRANSPORT_H
@@ -0,0 +1,271 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "az_deflate_private.h"
+
+#include <setjmp.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cmocka.h>
+
+#include <azure/core/az_context.h>
+#include <azure/core/az_http.h>
+#include <azure/core/az_http_transport.h>
+#include <azure/core/az_span.h>
+#include <azure/core/internal/az_http_internal.h>
+#include <azure/platform/az_curl.h>
+
+#include "test_az_curl.h"
+
+#include <azure/core/_az_cfg.h>
+
+// Replies to a single request on the loopback interface with the response it was given, and records
+// whether the request asked for compressed responses.
+typedef struct
+{
+  int listen_socket;
+  uint16_t port;
+  az_span response;
+  bool accepts_gzip;
+  pthread_t thread;
+} test_loopback_server;
+
+static void* test_loopback_server_reply(void* arg)
+{
+  test_loopback_server* const server = (test_loopback_server*)arg;
+  int const connection = accept(server->listen_socket, NULL, NULL);
+  if (connection < 0)
+  {
+    return NULL;
+  }
+
+  char request[4 * 1024] = { 0 };
+  size_t received = 0;
+  while (received < sizeof(request) - 1 && strstr(request, "\r\n\r\n") == NULL)
+  {
+    ssize_t const size = recv(connection, request + received, sizeof(request) - 1 - received, 0);
+    if (size <= 0)
+    {
+      break;
+    }
+    received += (size_t)size;
+  }
+
+  server->accepts_gzip = strstr(request, "Accept-Encoding: gzip, deflate\r\n") != NULL;
+  (void)send(connection, az_span_ptr(server->response), (size_t)az_span_size(server->response), 0);
+  close(connection);
+
+  return NULL;
+}
+
+static void test_loopback_server_start(test_loopback_server* out_server, az_span response)
+{
+  struct sockaddr_in address = { 0 };
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  socklen_t address_size = sizeof(address);
+
+  out_server->listen_socket = socket(AF_INET, SOCK_STREAM, 0);
+  assert_true(out_server->listen_socket >= 0);
+  assert_int_equal(bind(out_server->listen_socket, (struct sockaddr*)&address, address_size), 0);
+  assert_int_equal(listen(out_server->listen_socket, 1), 0);
+  assert_int_equal(
+      getsockname(out_server->listen_socket, (struct sockaddr*)&address, &address_size), 0);
+
+  out_server->port = ntohs(address.sin_port);
+  out_server->response = response;
+  out_server->accepts_gzip = false;
+  assert_int_equal(
+      pthread_create(&out_server->thread, NULL, test_loopback_server_reply, out_server), 0);
+}
+
+static void test_loopback_server_stop(test_loopback_server* ref_server)
+{
+  shutdown(ref_server->listen_socket, SHUT_RDWR);
+  pthread_join(ref_server->thread, NULL);
+  close(ref_server->listen_socket);
+}
+
+// Sends a GET request to the loopback server, or a PUT request with the body of \p body_source
+// when it isn't NULL, with a response buffer of \p response_size bytes.
+static az_result send_loopback_request(
+    test_loopback_server const* server,
+    az_http_body_source const* body_source,
+    uint8_t* response_buffer,
+    int32_t response_size,
+    az_http_response* out_response)
+{
+  uint8_t url_buffer[AZ_HTTP_REQUEST_URL_BUFFER_SIZE];
+  int const url_size = snprintf(
+      (char*)url_buffer, sizeof(url_buffer), "http://127.0.0.1:%u/devices", server->port);
+  az_pair headers[2];
+
+  az_http_request request = { 0 };
+  assert_return_code(
+      az_http_request_init(
+          &request,
+          &az_context_application,
+          body_source == NULL ? az_http_method_get() : az_http_method_put(),
+          AZ_SPAN_FROM_BUFFER(url_buffer),
+          url_size,
+          az_span_create((uint8_t*)headers, (int32_t)sizeof(headers)),
+          AZ_SPAN_NULL),
+      AZ_OK);
+
+  if (body_source != NULL)
+  {
+    assert_return_code(az_http_request_set_body_source(&request, body_source), AZ_OK);
+  }
+
+  assert_return_code(
+      az_http_response_init(out_response, az_span_create(response_buffer, response_size)), AZ_OK);
+
+  return az_http_client_send_request(&request, out_response);
+}
+
+static void test_curl_decompress_responses(void** state)
+{
+  (void)state;
+
+  static char const device[] = "{\"deviceId\":\"sensor\",\"status\":\"ok\"},";
+  static uint8_t body_buffer[4 * 1024];
+  for (size_t i = 0; i < sizeof(body_buffer); ++i)
+  {
+    body_buffer[i] = (uint8_t)device[i % (sizeof(device) - 1)];
+  }
+  az_span const body = AZ_SPAN_FROM_BUFFER(body_buffer);
+
+  // The body is compressed by the encoder of az_http_policy_compression, and inflated by zlib.
+  static uint8_t response_buffer[1024];
+  static _az_deflate_encoder encoder;
+  az_span const head = AZ_SPAN_FROM_STR("HTTP/1.1 200 OK\r\n"
+                                        "Content-Encoding: gzip\r\n"
+                                        "Connection: close\r\n"
+                                        "\r\n");
+  az_span compressed = AZ_SPAN_NULL;
+  assert_return_code(
+      _az_gzip_compress(
+          &encoder,
+          body,
+          az_span_copy(AZ_SPAN_FROM_BUFFER(response_buffer), head),
+          &compressed),
+      AZ_OK);
+  az_span const response_span
+      = az_span_create(response_buffer, az_span_size(head) + az_span_size(compressed));
+
+  az_http_client_curl_options options = az_http_client_curl_options_default();
+  options.decompress_responses = true;
+  assert_return_code(az_http_client_curl_set_options(&options), AZ_OK);
+
+  // The inflated body is written to the response buffer.
+  {
+    static uint8_t buffer[8 * 1024];
+    test_loopback_server server;
+    test_loopback_server_start(&server, response_span);
+
+    az_http_response response;
+    assert_return_code(
+        send_loopback_request(&server, NULL, buffer, (int32_t)sizeof(buffer), &response), AZ_OK);
+    test_loopback_server_stop(&server);
+    assert_true(server.accepts_gzip);
+
+    az_http_response_status_line status_line;
+    assert_return_code(az_http_response_get_status_line(&response, &status_line), AZ_OK);
+    assert_int_equal(status_line.status_code, AZ_HTTP_STATUS_CODE_OK);
+
+    az_span response_body = AZ_SPAN_NULL;
+    assert_return_code(az_http_response_get_body(&response, &response_body), AZ_OK);
+    // The body is followed by the rest of the buffer.
+    response_body = az_span_slice(
+        response_body,
+        0,
+        response._internal.written - (int32_t)(az_span_ptr(response_body) - buffer));
+    assert_true(az_span_is_content_equal(response_body, body));
+  }
+
+  // A buffer that fits the compressed response but not the inflated one overflows.
+  {
+    static uint8_t buffer[2 * 1024];
+    test_loopback_server server;
+    test_loopback_server_start(&server, response_span);
+
+    az_http_response response;
+    assert_int_equal(
+        send_loopback_request(&server, NULL, buffer, (int32_t)sizeof(buffer), &response),
+        AZ_ERROR_HTTP_RESPONSE_OVERFLOW);
+    test_loopback_server_stop(&server);
+  }
+
+  // Without the option, the request doesn't ask for compressed responses.
+  assert_return_code(az_http_client_curl_set_options(NULL), AZ_OK);
+  {
+    static uint8_t buffer[8 * 1024];
+    test_loopback_server server;
+    test_loopback_server_start(&server, response_span);
+
+    az_http_response response;
+    assert_return_code(
+        send_loopback_request(&server, NULL, buffer, (int32_t)sizeof(buffer), &response), AZ_OK);
+    test_loopback_server_stop(&server);
+    assert_false(server.accepts_gzip);
+  }
+
+  az_http_client_curl_cleanup();
+}
+
+static az_result test_body_source_read_fails(
+    void* user_context,
+    int64_t offset,
+    az_span destination,
+    int32_t* out_size)
+{
+  (void)user_context;
+  (void)offset;
+  (void)destination;
+  (void)out_size;
+
+  return AZ_ERROR_NOT_IMPLEMENTED;
+}
+
+static void test_curl_upload_body_source_fails(void** state)
+{
+  (void)state;
+
+  az_http_body_source body_source;
+  assert_return_code(
+      az_http_body_source_init(&body_source, 1024, test_body_source_read_fails, NULL), AZ_OK);
+
+  // The upload is aborted by the read callback, the request fails with the error of the body
+  // source rather than as an attempt that timed out.
+  uint8_t buffer[1024];
+  test_loopback_server server;
+  test_loopback_server_start(&server, AZ_SPAN_FROM_STR("HTTP/1.1 200 OK\r\n\r\n"));
+
+  az_http_response response;
+  assert_int_equal(
+      send_loopback_request(&server, &body_source, buffer, (int32_t)sizeof(buffer), &response),
+      AZ_ERROR_NOT_IMPLEMENTED);
+  test_loopback_server_stop(&server);
+
+  az_http_client_curl_cleanup();
+}
+
+int test_az_curl_loopback()
+{
+  const struct CMUnitTest tests[] = {
+    cmocka_unit_test(test_curl_decompress_responses),
+    cmocka_unit_test(test_curl_upload_body_source_fails),
+  };
+  return cmocka_run_group_tests_name("az_curl_loopback", tests, NULL, NULL);
+}
@@ -0,0 +1,298 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include <setjmp.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <cmocka.h>
+
+#include <azure/core/az_context.h>
+#include <azure/core/az_http.h>
+#include <azure/core/az_http_transport.h>
+#include <azure/core/az_span.h>
+#include <azure/core/internal/az_http_internal.h>
+#include <azure/platform/az_curl.h>
+
+#include "test_az_curl.h"
+
+#include <azure/core/_az_cfg.h>
+
+// Nothing listens on this port: the transfer fails right after the request is set up, which is
+// where the adapter would allocate.
+#define TEST_URL "http://127.0.0.1:1/container/blob?comp=metadata"
+
+static void init_request(
+    az_http_request* out_request,
+    az_context* context,
+    az_http_method method,
+    az_span url_buffer,
+    az_span headers_buffer,
+    az_span large_value)
+{
+  az_span const url = AZ_SPAN_FROM_STR(TEST_URL);
+  az_span_copy(url_buffer, url);
+
+  assert_return_code(
+      az_http_request_init(
+          out_request,
+          context,
+          method,
+          url_buffer,
+          az_span_size(url),
+          headers_buffer,
+          AZ_SPAN_FROM_STR("{}")),
+      AZ_OK);
+
+  assert_return_code(
+      az_http_request_append_header(
+          out_request, AZ_SPAN_FROM_STR("x-ms-version"), AZ_SPAN_FROM_STR("2019-02-02")),
+      AZ_OK);
+  assert_return_code(
+      az_http_request_append_header(
+          out_request, AZ_SPAN_FROM_STR("x-ms-blob-type"), AZ_SPAN_FROM_STR("BlockBlob")),
+      AZ_OK);
+  assert_return_code(
+      az_http_request_append_header(
+          out_request, AZ_SPAN_FROM_STR("Content-Type"), AZ_SPAN_FROM_STR("application/json")),
+      AZ_OK);
+
+  if (az_span_size(large_value) > 0)
+  {
+    assert_return_code(
+        az_http_request_append_header(
+            out_request, AZ_SPAN_FROM_STR("x-ms-meta-large"), large_value),
+        AZ_OK);
+  }
+}
+
+#ifdef _az_MOCK_ENABLED
+enum
+{
+  TEST_LARGE_HEADER_SIZE = 8 * 1024, // Larger than the scratch buffer of a synchronous request.
+};
+
+static uint8_t large_header_value[TEST_LARGE_HEADER_SIZE];
+
+static void test_curl_sync_request_allocations(void** state)
+{
+  (void)state;
+  az_http_method const methods[] = {
+    az_http_method_get(),
+    az_http_method_put(),
+    az_http_method_post(),
+    az_http_method_delete(),
+  };
+
+  int64_t const allocation_count = _az_http_client_curl_get_allocation_count();
+
+  for (size_t i = 0; i < sizeof(methods) / sizeof(methods[0]); ++i)
+  {
+    uint8_t url_buffer[AZ_HTTP_REQUEST_URL_BUFFER_SIZE];
+    az_pair headers[4];
+    uint8_t response_buffer[1024];
+
+    az_http_request request = { 0 };
+    init_request(
+        &request,
+        &az_context_application,
+        methods[i],
+        AZ_SPAN_FROM_BUFFER(url_buffer),
+        az_span_create((uint8_t*)headers, (int32_t)sizeof(headers)),
+        AZ_SPAN_NULL);
+
+    az_http_response response = { 0 };
+    assert_return_code(
+        az_http_response_init(&response, AZ_SPAN_FROM_BUFFER(response_buffer)), AZ_OK);
+
+    assert_true(az_failed(az_http_client_send_request(&request, &response)));
+  }
+
+  assert_true(_az_http_client_curl_get_allocation_count() == allocation_count);
+
+  // Headers that don't fit in the scratch buffer are allocated.
+  {
+    memset(large_header_value, 'a', sizeof(large_header_value));
+
+    uint8_t url_buffer[AZ_HTTP_REQUEST_URL_BUFFER_SIZE];
+    az_pair headers[4];
+    uint8_t response_buffer[1024];
+
+    az_http_request request = { 0 };
+    init_request(
+        &request,
+        &az_context_application,
+        az_http_method_put(),
+        AZ_SPAN_FROM_BUFFER(url_buffer),
+        az_span_create((uint8_t*)headers, (int32_t)sizeof(headers)),
+        AZ_SPAN_FROM_BUFFER(large_header_value));
+
+    az_http_response response = { 0 };
+    assert_return_code(
+        az_http_response_init(&response, AZ_SPAN_FROM_BUFFER(response_buffer)), AZ_OK);
+
+    assert_true(az_failed(az_http_client_send_request(&request, &response)));
+    assert_true(_az_http_client_curl_get_allocation_count() > allocation_count);
+  }
+
+  az_http_client_curl_cleanup();
+}
+#endif // _az_MOCK_ENABLED
+
+static void test_curl_hedged_request(void** state)
+{
+  (void)state;
+#ifdef _az_MOCK_ENABLED
+  int64_t const allocation_count = _az_http_client_curl_get_allocation_count();
+#endif // _az_MOCK_ENABLED
+
+  // The pooled hedging handles are created, then reused.
+  for (int32_t i = 0; i < 2; ++i)
+  {
+    uint8_t url_buffer[AZ_HTTP_REQUEST_URL_BUFFER_SIZE];
+    az_pair headers[4];
+    uint8_t response_buffer[1024];
+
+    az_http_request request = { 0 };
+    init_request(
+        &request,
+        &az_context_application,
+        az_http_method_get(),
+        AZ_SPAN_FROM_BUFFER(url_buffer),
+        az_span_create((uint8_t*)headers, (int32_t)sizeof(headers)),
+        AZ_SPAN_NULL);
+    request._internal.hedge_delay_msec = 1;
+
+    az_http_response response = { 0 };
+    assert_return_code(
+        az_http_response_init(&response, AZ_SPAN_FROM_BUFFER(response_buffer)), AZ_OK);
+
+    // The request fails to connect, whether or not it is hedged before.
+    assert_true(az_failed(az_http_client_send_request(&request, &response)));
+  }
+
+#ifdef _az_MOCK_ENABLED
+  assert_true(_az_http_client_curl_get_allocation_count() == allocation_count);
+#endif // _az_MOCK_ENABLED
+
+  az_http_client_curl_cleanup();
+}
+
+static void test_curl_request_expired_context(void** state)
+{
+  (void)state;
+
+  // The request isn't sent once the deadline of its context has passed.
+  az_context context = az_context_create_with_expiration(&az_context_application, 0);
+
+  uint8_t url_buffer[AZ_HTTP_REQUEST_URL_BUFFER_SIZE];
+  az_pair headers[4];
+  uint8_t response_buffer[1024];
+
+  az_http_request request = { 0 };
+  init_request(
+      &request,
+      &context,
+      az_http_method_get(),
+      AZ_SPAN_FROM_BUFFER(url_buffer),
+      az_span_create((uint8_t*)headers, (int32_t)sizeof(headers)),
+      AZ_SPAN_NULL);
+  request._internal.try_timeout_msec = 100;
+
+  az_http_response response = { 0 };
+  assert_return_code(az_http_response_init(&response, AZ_SPAN_FROM_BUFFER(response_buffer)), AZ_OK);
+
+  assert_int_equal(az_http_client_send_request(&request, &response), AZ_ERROR_CANCELED);
+
+  az_http_client_curl_cleanup();
+}
+
+#ifdef _az_MOCK_ENABLED
+static void on_operation_done(
+    az_http_client_curl_async_operation* operation,
+    az_result result,
+    void* user_context)
+{
+  (void)operation;
+  *(az_result*)user_context = result;
+}
+
+// Sends a PUT request through an async driver, with an operation buffer of \p buffer_size bytes.
+static void send_async_request(int32_t buffer_size)
+{
+  static uint8_t operation_buffer[2 * 1024];
+  assert_true(buffer_size <= (int32_t)sizeof(operation_buffer));
+
+  az_http_client_curl_async async;
+  assert_return_code(az_http_client_curl_async_init(&async), AZ_OK);
+
+  az_result operation_result = AZ_HTTP_REQUEST_PENDING;
+  az_http_client_curl_async_operation operation;
+  assert_return_code(
+      az_http_client_curl_async_operation_init(
+          &operation,
+          &async,
+          NULL,
+          az_span_create(operation_buffer, buffer_size),
+          on_operation_done,
+          &operation_result),
+      AZ_OK);
+
+  uint8_t url_buffer[AZ_HTTP_REQUEST_URL_BUFFER_SIZE];
+  az_pair headers[4];
+  uint8_t response_buffer[1024];
+
+  az_http_request request = { 0 };
+  init_request(
+      &request,
+      az_http_client_curl_async_operation_get_context(&operation),
+      az_http_method_put(),
+      AZ_SPAN_FROM_BUFFER(url_buffer),
+      az_span_create((uint8_t*)headers, (int32_t)sizeof(headers)),
+      AZ_SPAN_NULL);
+
+  az_http_response response = { 0 };
+  assert_return_code(az_http_response_init(&response, AZ_SPAN_FROM_BUFFER(response_buffer)), AZ_OK);
+
+  assert_true(az_http_client_send_request(&request, &response) == AZ_HTTP_REQUEST_PENDING);
+
+  int32_t in_flight = 1;
+  while (in_flight > 0)
+  {
+    assert_return_code(az_http_client_curl_async_perform(&async, 100, &in_flight), AZ_OK);
+  }
+
+  assert_true(az_failed(operation_result) && operation_result != AZ_HTTP_REQUEST_PENDING);
+
+  az_http_client_curl_async_cleanup(&async);
+}
+
+static void test_curl_async_request_allocations(void** state)
+{
+  (void)state;
+  int64_t const allocation_count = _az_http_client_curl_get_allocation_count();
+
+  // The url and the headers are laid out in the operation buffer.
+  send_async_request(2 * 1024);
+  assert_true(_az_http_client_curl_get_allocation_count() == allocation_count);
+
+  // Without room for them, they are allocated.
+  send_async_request(0);
+  assert_true(_az_http_client_curl_get_allocation_count() > allocation_count);
+}
+#endif // _az_MOCK_ENABLED
+
+int test_az_curl()
+{
+  const struct CMUnitTest tests[] = {
+#ifdef _az_MOCK_ENABLED
+    cmocka_unit_test(test_curl_sync_request_allocations),
+    cmocka_unit_test(test_curl_async_request_allocations),
+#endif // _az_MOCK_ENABLED
+    cmocka_unit_test(test_curl_hedged_request),
+    cmocka_unit_test(test_curl_request_expired_context),
+  };
+  return cmocka_run_group_tests_name("az_curl", tests, NULL, NULL);
+}
@@ -0,0 +1,26 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+#include <stdlib.h>
+
+#include <setjmp.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <cmocka.h>
+
+#include "test_az_curl.h"
+
+#include <azure/core/_az_cfg.h>
+
+int main()
+{
+  int result = 0;
+
+  result += test_az_curl();
+#ifdef AZ_CURL_LOOPBACK_TESTS
+  result += test_az_curl_loopback();
+#endif // AZ_CURL_LOOPBACK_TESTS
+
+  return result;
+}
@@ -0,0 +1,8 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+int test_az_curl();
+
+#ifdef AZ_CURL_LOOPBACK_TESTS
+int test_az_curl_loopback();
+#endif // AZ_CURL_LOOPBACK_TESTS